@@ -0,0 +1,366 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef BENCHMARKSCENES_H
+#define BENCHMARKSCENES_H
+
+#include "Mercury3D.h"
+#include "Chute.h"
+#include "Particles/BaseParticle.h"
+#include "Walls/InfiniteWall.h"
+#include "Walls/AxisymmetricIntersectionOfWalls.h"
+#include "Boundaries/PeriodicBoundary.h"
+#include "Boundaries/LeesEdwardsBoundary.h"
+#include "Species/LinearViscoelasticSpecies.h"
+#include "Species/LinearViscoelasticSlidingFrictionSpecies.h"
+#include "Logger.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*!
+ * \file BenchmarkScenes.h
+ * \brief The scenes of the benchmark suite, shared by Benchmarks.cpp and Scalability.cpp.
+ * \details Each scene is set up for a requested number of particles N, in 
+ * dimensionless units (particle diameter 1, particle mass 1, collision time 0.05, 
+ * time step 0.001). The initial conditions only depend on N (each scene has its 
+ * own random number generator), so two runs of a scene with the same N are 
+ * identical.
+ */
+
+///Diameter of the (mean) particle
+const Mdouble diameter = 1.0;
+///Collision time of two mean particles; the time step is 1/50 of it
+const Mdouble collisionTime = 0.05;
+///Restitution coefficient of two mean particles
+const Mdouble restitutionCoefficient = 0.8;
+
+/*!
+ * \brief Places N particles on a cubic lattice in the box [min,max], starting at the bottom.
+ * \details The lattice spacing is the diameter of the largest particle times 
+ * spacingRatio. Lattice points where isInside returns false are skipped. The 
+ * particles get a random radius in [minRadius,maxRadius] and a random velocity 
+ * with components in [-velocity,velocity].
+ */
+inline void placeOnLattice(DPMBase& problem, unsigned int N, Vec3D min, Vec3D max, Mdouble minRadius, Mdouble maxRadius,
+                    Mdouble velocity, Mdouble spacingRatio = 1.1, std::function<bool(const Vec3D&)> isInside = nullptr)
+{
+    BaseParticle p;
+    p.setSpecies(problem.speciesHandler.getObject(0));
+    Mdouble spacing = 2.0 * maxRadius * spacingRatio;
+    unsigned int nx = std::max(1, static_cast<int>((max.X - min.X) / spacing));
+    unsigned int ny = std::max(1, static_cast<int>((max.Y - min.Y) / spacing));
+    for (unsigned int i = 0; problem.particleHandler.getNumberOfObjects() < N; i++)
+    {
+        Vec3D position = min + spacing * Vec3D(i % nx + 0.5, (i / nx) % ny + 0.5, i / nx / ny + 0.5);
+        if (position.Z > max.Z)
+            logger(FATAL, "placeOnLattice: the box is too small for % particles", N);
+        if (isInside && !isInside(position))
+            continue;
+        p.setRadius(problem.random.getRandomNumber(minRadius, maxRadius));
+        p.setPosition(position);
+        p.setVelocity(velocity * Vec3D(problem.random.getRandomNumber(-1, 1), problem.random.getRandomNumber(-1, 1), problem.random.getRandomNumber(-1, 1)));
+        problem.particleHandler.copyAndAddObject(p);
+    }
+}
+
+/*!
+ * \brief Sets a linear viscoelastic species (with sliding friction if friction>0) of unit density and 
+ * the time step, such that the scenes are comparable.
+ */
+inline void setSpeciesAndTimeStep(DPMBase& problem, Mdouble friction = 0)
+{
+    Mdouble mass = 1.0;
+    if (friction > 0)
+    {
+        LinearViscoelasticSlidingFrictionSpecies species;
+        species.setDensity(6.0 / constants::pi);
+        species.setCollisionTimeAndRestitutionCoefficient(collisionTime, restitutionCoefficient, mass);
+        species.setSlidingStiffness(2.0 / 7.0 * species.getStiffness());
+        species.setSlidingDissipation(2.0 / 7.0 * species.getDissipation());
+        species.setSlidingFrictionCoefficient(friction);
+        problem.speciesHandler.copyAndAddObject(species);
+    }
+    else
+    {
+        LinearViscoelasticSpecies species;
+        species.setDensity(6.0 / constants::pi);
+        species.setCollisionTimeAndRestitutionCoefficient(collisionTime, restitutionCoefficient, mass);
+        problem.speciesHandler.copyAndAddObject(species);
+    }
+    problem.setTimeStep(collisionTime / 50.0);
+    problem.setSystemDimensions(3);
+}
+
+/*!
+ * \brief Adds six walls around the domain.
+ */
+inline void addBoxWalls(DPMBase& problem)
+{
+    InfiniteWall w;
+    w.setSpecies(problem.speciesHandler.getObject(0));
+    w.set(Vec3D(-1, 0, 0), Vec3D(problem.getXMin(), 0, 0));
+    problem.wallHandler.copyAndAddObject(w);
+    w.set(Vec3D(1, 0, 0), Vec3D(problem.getXMax(), 0, 0));
+    problem.wallHandler.copyAndAddObject(w);
+    w.set(Vec3D(0, -1, 0), Vec3D(0, problem.getYMin(), 0));
+    problem.wallHandler.copyAndAddObject(w);
+    w.set(Vec3D(0, 1, 0), Vec3D(0, problem.getYMax(), 0));
+    problem.wallHandler.copyAndAddObject(w);
+    w.set(Vec3D(0, 0, -1), Vec3D(0, 0, problem.getZMin()));
+    problem.wallHandler.copyAndAddObject(w);
+    w.set(Vec3D(0, 0, 1), Vec3D(0, 0, problem.getZMax()));
+    problem.wallHandler.copyAndAddObject(w);
+}
+
+/*!
+ * \brief Free cooling of a dilute granular gas in a closed box (cf. FreeCooling3DDemo).
+ */
+class FreeCoolingBenchmark : public Mercury3D
+{
+public:
+    FreeCoolingBenchmark(unsigned int N)
+            : N_(N)
+    {
+        setSpeciesAndTimeStep(*this);
+        setGravity(Vec3D(0, 0, 0));
+        Mdouble length = std::ceil(std::cbrt(N)) * 1.5 * diameter;
+        setXMax(length);
+        setYMax(length);
+        setZMax(length);
+    }
+
+    void setupInitialConditions()
+    {
+        addBoxWalls(*this);
+        placeOnLattice(*this, N_, Vec3D(getXMin(), getYMin(), getZMin()), Vec3D(getXMax(), getYMax(), getZMax()),
+                       0.5 * diameter, 0.5 * diameter, 1.0, 1.5);
+    }
+
+private:
+    unsigned int N_;
+};
+
+/*!
+ * \brief Discharge of a cylindrical silo with a conical contraction (cf. HourGlass3DDemo).
+ * \details The column of particles is about four times as high as the silo radius; the outlet 
+ * radius is half the silo radius. Particles leaving the outlet keep falling.
+ */
+class SiloBenchmark : public Mercury3D
+{
+public:
+    SiloBenchmark(unsigned int N)
+            : N_(N)
+    {
+        setSpeciesAndTimeStep(*this, 0.5);
+        setGravity(Vec3D(0, 0, -1));
+        Mdouble spacing = 1.1 * diameter;
+        siloRadius_ = std::max(5.0 * diameter, std::cbrt(N * mathsFunc::cubic(spacing) / (4.0 * constants::pi)));
+        setXMin(-siloRadius_);
+        setYMin(-siloRadius_);
+        setZMin(-siloRadius_);
+        setXMax(siloRadius_);
+        setYMax(siloRadius_);
+        setZMax(6.0 * siloRadius_);
+    }
+
+    void setupInitialConditions()
+    {
+        AxisymmetricIntersectionOfWalls cylinder;
+        cylinder.setSpecies(speciesHandler.getObject(0));
+        cylinder.setPosition(Vec3D(0, 0, 0));
+        cylinder.setOrientation(Vec3D(0, 0, 1));
+        cylinder.addObject(Vec3D(1, 0, 0), Vec3D(siloRadius_, 0, 0));
+        wallHandler.copyAndAddObject(cylinder);
+
+        AxisymmetricIntersectionOfWalls contraction;
+        contraction.setSpecies(speciesHandler.getObject(0));
+        contraction.setPosition(Vec3D(0, 0, 0));
+        contraction.setOrientation(Vec3D(0, 0, 1));
+        std::vector<Vec3D> points(3);
+        points[0] = Vec3D(siloRadius_, 0, 0.5 * siloRadius_);
+        points[1] = Vec3D(0.5 * siloRadius_, 0, 0);
+        points[2] = Vec3D(siloRadius_, 0, -0.5 * siloRadius_);
+        contraction.createOpenPrism(points);
+        wallHandler.copyAndAddObject(contraction);
+
+        Mdouble radius = siloRadius_;
+        placeOnLattice(*this, N_, Vec3D(getXMin(), getYMin(), 0.5 * siloRadius_), Vec3D(getXMax(), getYMax(), getZMax()),
+                       0.45 * diameter, 0.5 * diameter, 0.1, 1.1,
+                       [radius] (const Vec3D& p) { return p.X * p.X + p.Y * p.Y < mathsFunc::square(radius - 0.6); });
+    }
+
+private:
+    unsigned int N_;
+    Mdouble siloRadius_;
+};
+
+/*!
+ * \brief Flow down an inclined chute with a rough bottom, periodic in x and y.
+ * \details The flow is about ten particle layers deep; the chute is inclined by 24 degrees.
+ * The chute is aspectRatio times longer (in x) than wide (in y), and the 
+ * possible contacts are found by the given broad phase.
+ */
+class ChuteBenchmark : public Chute
+{
+public:
+    ChuteBenchmark(unsigned int N, unsigned int aspectRatio = 1, BroadPhase broadPhase = BroadPhase::HGRID)
+            : N_(N)
+    {
+        setSpeciesAndTimeStep(*this, 0.5);
+        setChuteAngleAndMagnitudeOfGravity(24, 1);
+        setFixedParticleRadius(0.5 * diameter);
+        setRoughBottomType(MONOLAYER_DISORDERED);
+        setInflowParticleRadius(0.5 * diameter);
+        makeChutePeriodic();
+        setBroadPhase(broadPhase);
+        Mdouble width = std::ceil(std::sqrt(N / 10.0 / aspectRatio)) * 1.1 * diameter;
+        Mdouble length = aspectRatio * width;
+        setXMax(length);
+        setYMax(width);
+        setZMax(2.0 * std::ceil(N / (length / (1.1 * diameter) * width / (1.1 * diameter))) * 1.1 * diameter);
+    }
+
+    void setupInitialConditions()
+    {
+        setupSideWalls();
+        PeriodicBoundary b;
+        b.set(Vec3D(1, 0, 0), getXMin(), getXMax());
+        boundaryHandler.copyAndAddObject(b);
+        createBottom();
+        //the fixed bottom particles are not counted in N
+        N_ += particleHandler.getNumberOfObjects();
+        placeOnLattice(*this, N_, Vec3D(getXMin(), getYMin(), 1.5 * diameter), Vec3D(getXMax(), getYMax(), getZMax()),
+                       0.5 * diameter, 0.5 * diameter, 0.1);
+    }
+
+private:
+    unsigned int N_;
+};
+
+/*!
+ * \brief Settling of a polydisperse packing (size ratio 3) in a closed box under gravity.
+ * \details The wide size distribution exercises the multi-level hierarchical grid.
+ */
+class PolydisperseBoxBenchmark : public Mercury3D
+{
+public:
+    PolydisperseBoxBenchmark(unsigned int N)
+            : N_(N)
+    {
+        setSpeciesAndTimeStep(*this);
+        setGravity(Vec3D(0, 0, -1));
+        Mdouble spacing = 1.5 * 1.1 * diameter;
+        Mdouble length = std::ceil(std::cbrt(N / 2.0)) * spacing;
+        setXMax(length);
+        setYMax(length);
+        setZMax(std::ceil(N / mathsFunc::square(std::floor(length / spacing)) + 1) * spacing);
+        setHGridMaxLevels(3);
+    }
+
+    void setupInitialConditions()
+    {
+        addBoxWalls(*this);
+        placeOnLattice(*this, N_, Vec3D(getXMin(), getYMin(), getZMin()), Vec3D(getXMax(), getYMax(), getZMax()),
+                       0.25 * diameter, 0.75 * diameter, 0.1);
+    }
+
+private:
+    unsigned int N_;
+};
+
+/*!
+ * \brief Simple shear of a moderately dense packing by a LeesEdwardsBoundary in the xy-plane, periodic in z.
+ * \details The shear rate is one (in units of the time scale set by the particle diameter and mass).
+ */
+class LeesEdwardsBenchmark : public Mercury3D
+{
+public:
+    LeesEdwardsBenchmark(unsigned int N)
+            : N_(N)
+    {
+        setSpeciesAndTimeStep(*this);
+        setGravity(Vec3D(0, 0, 0));
+        Mdouble length = std::ceil(std::cbrt(N)) * 1.1 * diameter;
+        setXMax(length);
+        setYMax(length);
+        setZMax(length);
+    }
+
+    void setupInitialConditions()
+    {
+        Mdouble velocity = getYMax() - getYMin();
+        LeesEdwardsBoundary leesEdwards;
+        leesEdwards.set([velocity] (double time) { return time * velocity; },
+                        [velocity] (double time UNUSED) { return velocity; },
+                        getXMin(), getXMax(), getYMin(), getYMax());
+        boundaryHandler.copyAndAddObject(leesEdwards);
+        PeriodicBoundary b;
+        b.set(Vec3D(0, 0, 1), getZMin(), getZMax());
+        boundaryHandler.copyAndAddObject(b);
+        placeOnLattice(*this, N_, Vec3D(getXMin(), getYMin(), getZMin()), Vec3D(getXMax(), getYMax(), getZMax()),
+                       0.5 * diameter, 0.5 * diameter, 0.1);
+    }
+
+private:
+    unsigned int N_;
+};
+
+
+/*!
+ * \brief Returns the names of all benchmark scenes.
+ */
+inline std::vector<std::string> getBenchmarkScenes()
+{
+    return {"FreeCooling", "Silo", "Chute", "ChuteSortAndSweep", "LongChute", "LongChuteSortAndSweep", "PolydisperseBox",
+            "LeesEdwards"};
+}
+
+/*!
+ * \brief Creates a scene with N particles, or returns nullptr if the scene does not exist.
+ */
+inline std::unique_ptr<DPMBase> createBenchmarkScene(const std::string& scene, unsigned int N)
+{
+    if (scene == "FreeCooling")
+        return std::unique_ptr<DPMBase>(new FreeCoolingBenchmark(N));
+    else if (scene == "Silo")
+        return std::unique_ptr<DPMBase>(new SiloBenchmark(N));
+    else if (scene == "Chute")
+        return std::unique_ptr<DPMBase>(new ChuteBenchmark(N));
+    else if (scene == "ChuteSortAndSweep")
+        return std::unique_ptr<DPMBase>(new ChuteBenchmark(N, 1, BroadPhase::SORT_AND_SWEEP));
+    else if (scene == "LongChute")
+        return std::unique_ptr<DPMBase>(new ChuteBenchmark(N, 20));
+    else if (scene == "LongChuteSortAndSweep")
+        return std::unique_ptr<DPMBase>(new ChuteBenchmark(N, 20, BroadPhase::SORT_AND_SWEEP));
+    else if (scene == "PolydisperseBox")
+        return std::unique_ptr<DPMBase>(new PolydisperseBoxBenchmark(N));
+    else if (scene == "LeesEdwards")
+        return std::unique_ptr<DPMBase>(new LeesEdwardsBenchmark(N));
+    return nullptr;
+}
+
+#endif
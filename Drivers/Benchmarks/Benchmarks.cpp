@@ -0,0 +1,269 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "BenchmarkScenes.h"
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <cstring>
+#ifdef UNIX
+#include <sys/resource.h>
+#endif
+
+/*!
+ * \file Benchmarks.cpp
+ * \brief The standard benchmark suite of MercuryDPM, run by the target "make benchmark".
+ * \details Each scene (see BenchmarkScenes.h) runs for a fixed number of time 
+ * steps without file output, with the SolveProfiler enabled. Each run prints a one-line summary and appends
+ * a JSON object with the particle updates per second, the time per stage of the
+ * time loop and the peak memory to a JSON array, so results can be compared 
+ * across commits and problem sizes.
+ *
+ * Usage: Benchmarks [-scene name] [-N number] [-steps number] [-json file] [-repeat number] [-baseline file] [-tolerance number]
+ * 
+ * Without -scene, all scenes are run (in the same process, so the peak memory 
+ * is that of the largest run so far). With -repeat, each scene is run several
+ * times and the best throughput counts.
+ *
+ * With -baseline, the program is a performance-regression test: it fails 
+ * (returns 1) if the best throughput of a scene is more than the given 
+ * tolerance (default 0.25, i.e. 25%) below the best throughput stored for the 
+ * same scene and N in the baseline file, a JSON file written by this program.
+ */
+
+/*!
+ * \brief Returns the peak resident memory of the process in kB, or 0 if it cannot be measured.
+ */
+long getPeakMemory()
+{
+#ifdef UNIX
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+}
+
+/*!
+ * \brief Appends an object to the JSON array stored in fileName; creates the file if it does not exist.
+ */
+void appendToJSONArray(const std::string& fileName, const std::string& object)
+{
+    std::string content;
+    std::ifstream in(fileName.c_str());
+    if (in)
+        content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    in.close();
+
+    std::ofstream out(fileName.c_str());
+    if (!out)
+        logger(FATAL, "could not open %", fileName);
+    std::size_t end = content.rfind(']');
+    if (end == std::string::npos)
+    {
+        out << "[\n" << object << "\n]\n";
+    }
+    else
+    {
+        content.erase(end);
+        content.erase(content.find_last_not_of(" \n\r\t") + 1);
+        out << content << (content.size() > 1 ? ",\n" : "\n") << object << "\n]\n";
+    }
+}
+
+/*!
+ * \brief Runs a scene for the given number of time steps with the profiler enabled, prints a 
+ * summary and appends the results to jsonFile.
+ * \return The number of particle updates per second.
+ */
+Mdouble runBenchmark(DPMBase& problem, const std::string& scene, unsigned int N, unsigned int numberOfTimeSteps, const std::string& jsonFile)
+{
+    problem.setName("Benchmark" + scene);
+    problem.setFileType(FileType::NO_FILE);
+    problem.setSaveCount(numberOfTimeSteps + 1);
+    //stop half a time step early, such that rounding errors do not add a time step
+    problem.setTimeMax((numberOfTimeSteps - 0.5) * problem.getTimeStep());
+    problem.profiler.setEnabled(true);
+    problem.solve();
+
+    const SolveProfiler& profiler = problem.profiler;
+    unsigned int numberOfParticles = problem.particleHandler.getNumberOfObjects();
+    Mdouble wallTime = profiler.getTimeLoopTime();
+    Mdouble particleUpdatesPerSecond = wallTime > 0 ? numberOfParticles * static_cast<Mdouble>(profiler.getNumberOfTimeSteps()) / wallTime : 0;
+    long peakMemory = getPeakMemory();
+
+    std::ostringstream json;
+    json << "  {\n"
+        << "    \"scene\": \"" << scene << "\",\n"
+        << "    \"N\": " << N << ",\n"
+        << "    \"particles\": " << numberOfParticles << ",\n"
+        << "    \"timeSteps\": " << profiler.getNumberOfTimeSteps() << ",\n"
+        << "    \"wallTime\": " << wallTime << ",\n"
+        << "    \"particleUpdatesPerSecond\": " << particleUpdatesPerSecond << ",\n"
+        << "    \"peakMemoryKB\": " << peakMemory << ",\n"
+        << "    \"stages\": {";
+    Mdouble other = wallTime;
+    for (unsigned int i = 0; i < static_cast<unsigned int>(SolvePhase::NUMBER_OF_PHASES); i++)
+    {
+        SolvePhase phase = static_cast<SolvePhase>(i);
+        json << "\n      \"" << SolveProfiler::getName(phase) << "\": " << profiler.getTime(phase) << ",";
+        other -= profiler.getTime(phase);
+    }
+    json << "\n      \"other\": " << std::max(other, Mdouble(0)) << "\n    }\n  }";
+    appendToJSONArray(jsonFile, json.str());
+
+    std::cout << "BENCHMARK " << scene << " N=" << numberOfParticles << " steps=" << profiler.getNumberOfTimeSteps()
+        << " time=" << wallTime << "s updates/s=" << particleUpdatesPerSecond << " memory=" << peakMemory << "kB" << std::endl;
+    return particleUpdatesPerSecond;
+}
+
+/*!
+ * \brief Creates and runs a scene; returns false if the scene does not exist.
+ * \param[out] particleUpdatesPerSecond The throughput of the run.
+ */
+bool runScene(const std::string& scene, unsigned int N, unsigned int numberOfTimeSteps, const std::string& jsonFile, Mdouble& particleUpdatesPerSecond)
+{
+    std::unique_ptr<DPMBase> problem = createBenchmarkScene(scene, N);
+    if (!problem)
+        return false;
+    particleUpdatesPerSecond = runBenchmark(*problem, scene, N, numberOfTimeSteps, jsonFile);
+    return true;
+}
+
+/*!
+ * \brief Returns the best throughput stored for a scene and N in a JSON file written by runBenchmark, or 0 if there is none.
+ * \details The file is read line by line, relying on the layout written by runBenchmark (one key per line).
+ */
+Mdouble readBaseline(const std::string& fileName, const std::string& scene, unsigned int N)
+{
+    std::ifstream file(fileName.c_str());
+    if (!file)
+    {
+        logger(WARN, "could not open the baseline file %", fileName);
+        return 0;
+    }
+    Mdouble best = 0;
+    std::string line, currentScene;
+    unsigned int currentN = 0;
+    while (std::getline(file, line))
+    {
+        std::size_t colon = line.find(':');
+        if (colon == std::string::npos)
+            continue;
+        std::string key = line.substr(0, colon);
+        std::string value = line.substr(colon + 1);
+        if (key.find("\"scene\"") != std::string::npos)
+        {
+            std::size_t begin = value.find('"') + 1;
+            currentScene = value.substr(begin, value.rfind('"') - begin);
+        }
+        else if (key.find("\"N\"") != std::string::npos)
+        {
+            currentN = atoi(value.c_str());
+        }
+        else if (key.find("\"particleUpdatesPerSecond\"") != std::string::npos && currentScene == scene && currentN == N)
+        {
+            best = std::max(best, static_cast<Mdouble>(atof(value.c_str())));
+        }
+    }
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string scene = "";
+    unsigned int N = 1000;
+    unsigned int numberOfTimeSteps = 1000;
+    std::string jsonFile = "benchmark.json";
+    unsigned int numberOfRepetitions = 1;
+    std::string baselineFile = "";
+    Mdouble tolerance = 0.25;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (!strcmp(argv[i], "-scene"))
+            scene = argv[i + 1];
+        else if (!strcmp(argv[i], "-N"))
+            N = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "-steps"))
+            numberOfTimeSteps = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "-json"))
+            jsonFile = argv[i + 1];
+        else if (!strcmp(argv[i], "-repeat"))
+            numberOfRepetitions = std::max(1, atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "-baseline"))
+            baselineFile = argv[i + 1];
+        else if (!strcmp(argv[i], "-tolerance"))
+            tolerance = atof(argv[i + 1]);
+        else
+            logger(FATAL, "unknown argument %; usage: % [-scene name] [-N number] [-steps number] [-json file] "
+                "[-repeat number] [-baseline file] [-tolerance number]", argv[i], argv[0]);
+    }
+
+    std::vector<std::string> scenes;
+    if (scene.empty())
+        scenes = getBenchmarkScenes();
+    else
+        scenes = {scene};
+
+    bool isSlower = false;
+    for (const std::string& s : scenes)
+    {
+        Mdouble best = 0;
+        for (unsigned int r = 0; r < numberOfRepetitions; r++)
+        {
+            Mdouble particleUpdatesPerSecond = 0;
+            if (!runScene(s, N, numberOfTimeSteps, jsonFile, particleUpdatesPerSecond))
+                logger(FATAL, "unknown scene %; the scenes are FreeCooling, Silo, Chute, ChuteSortAndSweep, LongChute, "
+                       "LongChuteSortAndSweep, PolydisperseBox and LeesEdwards", s);
+            best = std::max(best, particleUpdatesPerSecond);
+        }
+
+        if (!baselineFile.empty())
+        {
+            Mdouble baseline = readBaseline(baselineFile, s, N);
+            if (baseline <= 0)
+            {
+                logger(WARN, "% contains no result for scene % with N=%", baselineFile, s, N);
+                isSlower = true;
+            }
+            else if (best < (1.0 - tolerance) * baseline)
+            {
+                logger(WARN, "% is slower than the baseline: % instead of % particle updates per second (tolerance %)", s, best, baseline, tolerance);
+                isSlower = true;
+            }
+            else
+            {
+                std::cout << "PERFORMANCE " << s << " " << best / baseline << " times the baseline throughput" << std::endl;
+            }
+        }
+    }
+    return isSlower ? 1 : 0;
+}
@@ -0,0 +1,285 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "BenchmarkScenes.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+/*!
+ * \file Scalability.cpp
+ * \brief Measures how the benchmark scenes scale with the number of threads and the number of particles.
+ * \details For each scene, number of particles N and number of threads T, T 
+ * replicas of the scene are run concurrently, one per thread, for a fixed 
+ * number of time steps with the SolveProfiler enabled:
+ *  - weak scaling: each replica has N particles, so the work grows with T;
+ *  - strong scaling: each replica has N/T particles, so the total work is fixed.
+ * 
+ * As the time loop of a single simulation is sequential, the replicas are 
+ * independent simulations; the measurement shows how well the solver stages 
+ * share the memory bandwidth and caches of the machine, which bounds the 
+ * scaling of any parallel mode. Relative to the run with one thread, the 
+ * speedup is T*t(1)/t(T) for weak scaling and t(1)/t(T) for strong scaling, 
+ * and the parallel efficiency is speedup/T. Per stage of the time loop, the 
+ * time of the slowest thread is used, and the imbalance is the time of the 
+ * slowest thread divided by the mean time of the threads.
+ * 
+ * The final state (positions and velocities) of every replica is compared 
+ * to a sequential reference run of the same scene and size, using the 
+ * tolerances of Scripts/fpdiff.py: two numbers are equivalent if both are 
+ * smaller than -small in magnitude, or if their difference is at most 
+ * -tolerance percent of the larger one. The program returns 1 if a replica 
+ * is not equivalent. This relies on the replicas sharing no mutable state, 
+ * so counters in the kernel have to be members, not function-local statics.
+ * 
+ * The results are written as CSV, one line per scene, mode, N, T and stage 
+ * (plus a line "total" for the whole time loop).
+ * 
+ * Usage: Scalability [-scenes name,...] [-N number,...] [-threads number,...] [-steps number] 
+ *                    [-mode weak|strong|both] [-csv file] [-tolerance percent] [-small number]
+ */
+
+/*!
+ * \brief The results of one replica.
+ */
+struct ReplicaResult
+{
+    ///Wall-clock time of the time loop
+    Mdouble timeLoopTime;
+    ///Wall-clock time of each stage of the time loop
+    std::vector<Mdouble> stageTimes;
+    ///Number of particles at the end of the run
+    unsigned int numberOfParticles;
+    ///Positions and velocities of all particles at the end of the run
+    std::vector<Mdouble> finalState;
+};
+
+/*!
+ * \brief Runs a scene with N particles for the given number of time steps and returns its timings and final state.
+ */
+ReplicaResult runReplica(const std::string& scene, unsigned int N, unsigned int numberOfTimeSteps, const std::string& name)
+{
+    std::unique_ptr<DPMBase> problem = createBenchmarkScene(scene, N);
+    problem->setName(name);
+    problem->setFileType(FileType::NO_FILE);
+    problem->setSaveCount(numberOfTimeSteps + 1);
+    //stop half a time step early, such that rounding errors do not add a time step
+    problem->setTimeMax((numberOfTimeSteps - 0.5) * problem->getTimeStep());
+    problem->profiler.setEnabled(true);
+    problem->solve();
+
+    ReplicaResult result;
+    result.timeLoopTime = problem->profiler.getTimeLoopTime();
+    for (unsigned int i = 0; i < static_cast<unsigned int>(SolvePhase::NUMBER_OF_PHASES); i++)
+        result.stageTimes.push_back(problem->profiler.getTime(static_cast<SolvePhase>(i)));
+    result.numberOfParticles = problem->particleHandler.getNumberOfObjects();
+    for (const BaseParticle* p : problem->particleHandler)
+    {
+        const Vec3D& x = p->getPosition();
+        const Vec3D& v = p->getVelocity();
+        result.finalState.insert(result.finalState.end(), {x.X, x.Y, x.Z, v.X, v.Y, v.Z});
+    }
+    return result;
+}
+
+/*!
+ * \brief Returns the number of values that differ by more than the fpdiff tolerances, or the number of values of the 
+ * longer state if the states have different lengths.
+ */
+unsigned int countDifferences(const std::vector<Mdouble>& a, const std::vector<Mdouble>& b, Mdouble tolerance, Mdouble small)
+{
+    if (a.size() != b.size())
+        return std::max(a.size(), b.size());
+    unsigned int numberOfDifferences = 0;
+    for (unsigned int i = 0; i < a.size(); i++)
+    {
+        if (std::abs(a[i]) <= small && std::abs(b[i]) <= small)
+            continue;
+        if (100.0 * std::abs(a[i] - b[i]) / std::max(std::abs(a[i]), std::abs(b[i])) > tolerance)
+            numberOfDifferences++;
+    }
+    return numberOfDifferences;
+}
+
+/*!
+ * \brief Splits a comma-separated list of numbers.
+ */
+std::vector<unsigned int> readNumbers(const std::string& list)
+{
+    std::vector<unsigned int> numbers;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        numbers.push_back(atoi(item.c_str()));
+    return numbers;
+}
+
+/*!
+ * \brief Splits a comma-separated list of names.
+ */
+std::vector<std::string> readNames(const std::string& list)
+{
+    std::vector<std::string> names;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        names.push_back(item);
+    return names;
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> scenes = getBenchmarkScenes();
+    std::vector<unsigned int> sizes = {1000, 8000};
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int t = 1; t <= std::max(1u, std::thread::hardware_concurrency()); t *= 2)
+        threadCounts.push_back(t);
+    unsigned int numberOfTimeSteps = 200;
+    std::string mode = "both";
+    std::string csvFile = "scalability.csv";
+    Mdouble tolerance = 0.1;
+    Mdouble small = 1e-14;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (!strcmp(argv[i], "-scenes"))
+            scenes = readNames(argv[i + 1]);
+        else if (!strcmp(argv[i], "-N"))
+            sizes = readNumbers(argv[i + 1]);
+        else if (!strcmp(argv[i], "-threads"))
+            threadCounts = readNumbers(argv[i + 1]);
+        else if (!strcmp(argv[i], "-steps"))
+            numberOfTimeSteps = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "-mode"))
+            mode = argv[i + 1];
+        else if (!strcmp(argv[i], "-csv"))
+            csvFile = argv[i + 1];
+        else if (!strcmp(argv[i], "-tolerance"))
+            tolerance = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "-small"))
+            small = atof(argv[i + 1]);
+        else
+            logger(FATAL, "unknown argument %; usage: % [-scenes name,...] [-N number,...] [-threads number,...] "
+                "[-steps number] [-mode weak|strong|both] [-csv file] [-tolerance percent] [-small number]", argv[i], argv[0]);
+    }
+    for (const std::string& scene : scenes)
+    {
+        if (!createBenchmarkScene(scene, 1))
+            logger(FATAL, "unknown scene %; the scenes are FreeCooling, Silo, Chute, ChuteSortAndSweep, LongChute, "
+                   "LongChuteSortAndSweep, PolydisperseBox and LeesEdwards", scene);
+    }
+    //the speedup is relative to the run with one thread, so that run is done first
+    threadCounts.erase(std::remove(threadCounts.begin(), threadCounts.end(), 0u), threadCounts.end());
+    threadCounts.erase(std::remove(threadCounts.begin(), threadCounts.end(), 1u), threadCounts.end());
+    threadCounts.insert(threadCounts.begin(), 1u);
+    std::vector<std::string> modes;
+    if (mode == "weak" || mode == "both")
+        modes.push_back("weak");
+    if (mode == "strong" || mode == "both")
+        modes.push_back("strong");
+    if (modes.empty())
+        logger(FATAL, "unknown mode %; the modes are weak, strong and both", mode);
+
+    std::ofstream csv(csvFile.c_str());
+    if (!csv)
+        logger(FATAL, "could not open %", csvFile);
+    csv << "scene,mode,N,threads,particlesPerThread,stage,time,speedup,efficiency,imbalance,equivalent" << std::endl;
+
+    const unsigned int numberOfStages = static_cast<unsigned int>(SolvePhase::NUMBER_OF_PHASES);
+    bool isEquivalent = true;
+    for (const std::string& scene : scenes)
+    {
+        //sequential reference states, per number of particles of a replica
+        std::map<unsigned int, std::vector<Mdouble> > references;
+        for (unsigned int N : sizes)
+        {
+            for (const std::string& m : modes)
+            {
+                //time per stage (the last entry is the whole time loop) of the slowest thread with one thread
+                std::vector<Mdouble> sequentialTimes;
+                for (unsigned int T : threadCounts)
+                {
+                    unsigned int particlesPerThread = m == "weak" ? N : std::max(1u, N / T);
+                    if (references.find(particlesPerThread) == references.end())
+                        references[particlesPerThread] = runReplica(scene, particlesPerThread, numberOfTimeSteps, "Scalability" + scene).finalState;
+
+                    std::vector<ReplicaResult> results(T);
+                    std::vector<std::thread> threads;
+                    for (unsigned int t = 0; t < T; t++)
+                    {
+                        std::string name = "Scalability" + scene + std::to_string(t);
+                        threads.emplace_back([&results, t, scene, particlesPerThread, numberOfTimeSteps, name]() {
+                            results[t] = runReplica(scene, particlesPerThread, numberOfTimeSteps, name);
+                        });
+                    }
+                    for (std::thread& thread : threads)
+                        thread.join();
+
+                    unsigned int numberOfDifferences = 0;
+                    for (const ReplicaResult& result : results)
+                        numberOfDifferences += countDifferences(result.finalState, references[particlesPerThread], tolerance, small);
+                    if (numberOfDifferences > 0)
+                    {
+                        logger(WARN, "% (% scaling, N=%, % threads): % values of the final states differ from the sequential run",
+                               scene, m, N, T, numberOfDifferences);
+                        isEquivalent = false;
+                    }
+
+                    for (unsigned int stage = 0; stage <= numberOfStages; stage++)
+                    {
+                        Mdouble maximum = 0, sum = 0;
+                        for (const ReplicaResult& result : results)
+                        {
+                            Mdouble time = stage < numberOfStages ? result.stageTimes[stage] : result.timeLoopTime;
+                            maximum = std::max(maximum, time);
+                            sum += time;
+                        }
+                        if (T == 1)
+                            sequentialTimes.push_back(maximum);
+                        Mdouble speedup = maximum > 0 ? sequentialTimes[stage] / maximum : 0;
+                        if (m == "weak")
+                            speedup *= T;
+                        csv << scene << ',' << m << ',' << N << ',' << T << ',' << particlesPerThread << ','
+                            << (stage < numberOfStages ? SolveProfiler::getName(static_cast<SolvePhase>(stage)) : "total") << ','
+                            << maximum << ',' << speedup << ',' << speedup / T << ','
+                            << (sum > 0 ? maximum * T / sum : 1) << ',' << (numberOfDifferences == 0 ? 1 : 0) << std::endl;
+                        if (stage == numberOfStages)
+                        {
+                            std::cout << "SCALABILITY " << scene << " " << m << " N=" << N << " threads=" << T
+                                << " time=" << maximum << "s speedup=" << speedup << " efficiency=" << speedup / T
+                                << " imbalance=" << (sum > 0 ? maximum * T / sum : 1)
+                                << (numberOfDifferences == 0 ? "" : " NOT EQUIVALENT") << std::endl;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return isEquivalent ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Mercury3D.h"
+#include "StatisticsVector.h"
+#include "Particles/BaseParticle.h"
+#include "Species/LinearViscoelasticSpecies.h"
+#include "Logger.h"
+#include <cmath>
+
+/*!
+ * \brief A ring of resting particles around the z-axis.
+ */
+class ParticleRing : public Mercury3D
+{
+public:
+
+    void setupInitialConditions()
+    {
+        setXMin(-1.5);
+        setYMin(-1.5);
+        setZMin(0);
+        setXMax(1.5);
+        setYMax(1.5);
+        setZMax(1);
+
+        BaseParticle p;
+        p.setSpecies(speciesHandler.getObject(0));
+        p.setRadius(radius);
+        for (unsigned int i = 0; i < N; i++)
+        {
+            Mdouble phi = 2.0 * constants::pi * i / N;
+            p.setPosition(Vec3D(ringRadius * std::cos(phi), ringRadius * std::sin(phi), ringHeight));
+            particleHandler.copyAndAddObject(p);
+        }
+    }
+
+    unsigned int N = 50;
+    Mdouble radius = 0.05;
+    Mdouble ringRadius = 1.0;
+    Mdouble ringHeight = 0.5;
+};
+
+/*!
+ * \brief Gives access to the time-averaged fields of the axisymmetric statistics.
+ */
+class RingStatistics : public StatisticsVector<RZ>
+{
+public:
+    RingStatistics(std::string name)
+            : StatisticsVector<RZ>(name)
+    {
+    }
+
+    const std::vector<StatisticsPoint<RZ> >& getTimeAverage() const
+    {
+        return timeAverage;
+    }
+};
+
+/*!
+ * \brief Checks the axisymmetric (RZ) statistics of a ring of particles against the analytical density.
+ * \details The integral of the density over the volume, \f$\int\rho\,2\pi r\,dr\,dz\f$, has to equal the total mass of
+ * the ring, and the density at the ring has to be that of a line mass \f$M/(2\pi r_0)\f$, smeared by a 2D Gaussian
+ * of width w. The kernel is azimuthally averaged, so the result may not depend on the theta-range of the grid.
+ */
+void checkRingDensity(const ParticleRing& problem, Mdouble thetaMin, Mdouble thetaMax)
+{
+    const Mdouble mass = problem.N * problem.particleHandler.getObject(0)->getMass();
+    const Mdouble w = 0.1;
+
+    RingStatistics stats("CylindricalStatisticsUnitTest");
+    stats.setXMinStat(0);
+    stats.setXMaxStat(2);
+    if (!std::isnan(thetaMin))
+    {
+        stats.setYMinStat(thetaMin);
+        stats.setYMaxStat(thetaMax);
+    }
+    stats.setZMinStat(0);
+    stats.setZMaxStat(1);
+    stats.setNX(40);
+    stats.setNZ(20);
+    stats.setCGShape("Gaussian");
+    stats.setCGWidth(w);
+    stats.setTimeMaxStat(1e20);
+    stats.statistics_from_fstat_and_data();
+
+    //the grid points are cell centres, so the volume integral is a midpoint rule
+    const Mdouble dr = 2.0 / 40;
+    const Mdouble dz = 1.0 / 20;
+    Mdouble integral = 0;
+    Mdouble peak = 0;
+    Vec3D peakPosition;
+    for (const StatisticsPoint<RZ>& p : stats.getTimeAverage())
+    {
+        Mdouble r = p.getPosition().getCylindricalCoordinates().X;
+        integral += p.Density * 2.0 * constants::pi * r * dr * dz;
+        if (p.Density > peak)
+        {
+            peak = p.Density;
+            peakPosition = Vec3D(r, 0, p.getPosition().Z);
+        }
+    }
+    if (std::fabs(integral / mass - 1) > 1e-2)
+    {
+        logger(FATAL, "theta=[%,%]: the integrated density % does not match the mass % of the ring", thetaMin, thetaMax, integral, mass);
+    }
+    if (std::fabs(peakPosition.X - problem.ringRadius) > dr || std::fabs(peakPosition.Z - problem.ringHeight) > dz)
+    {
+        logger(FATAL, "theta=[%,%]: the density peaks at r=%, z=% instead of at the ring", thetaMin, thetaMax, peakPosition.X, peakPosition.Z);
+    }
+
+    //the grid points closest to the ring are a distance (dr/2,dz/2) away from it
+    Mdouble distance2 = 0.25 * (dr * dr + dz * dz);
+    Mdouble expectedPeak = mass / (2.0 * constants::pi * std::sqrt(problem.ringRadius * peakPosition.X))
+        / (2.0 * constants::pi * w * w) * std::exp(-distance2 / (2.0 * w * w)) / (1.0 - std::exp(-4.5));
+    if (std::fabs(peak / expectedPeak - 1) > 1e-2)
+    {
+        logger(FATAL, "theta=[%,%]: the peak density % does not match the line density %", thetaMin, thetaMax, peak, expectedPeak);
+    }
+}
+
+int main(int argc UNUSED, char *argv[] UNUSED)
+{
+    ParticleRing problem;
+    problem.setName("CylindricalStatisticsUnitTest");
+    LinearViscoelasticSpecies* species = problem.speciesHandler.copyAndAddObject(LinearViscoelasticSpecies());
+    species->setDensity(2000);
+    species->setStiffness(1e5);
+    problem.setGravity(Vec3D(0, 0, 0));
+    problem.setTimeStep(1e-4);
+    problem.setTimeMax(1e-3);
+    problem.setSaveCount(5);
+    problem.solve();
+
+    //default theta-range [-pi,pi]
+    checkRingDensity(problem, NAN, NAN);
+    //a theta-range that is not symmetric about 0
+    checkRingDensity(problem, 0.3, 2.5);
+    return 0;
+}
@@ -0,0 +1,114 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "DPMBase.h"
+#include "CandidateBatch.h"
+#include "Particles/BaseParticle.h"
+#include "Species/LinearViscoelasticSpecies.h"
+#include "Math/RNG.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cmath>
+
+/*!
+ * \brief Checks that the vectorised overlap test of the CandidateBatch finds 
+ *        every pair that BaseParticle::getInteractionWith would accept.
+ * \details For random polydisperse particles, the overlaps found for each 
+ * particle with the particles after it in the batch are compared to a direct 
+ * test of all pairs: every pair closer than the sum of the interaction radii
+ * has to be found, and no pair that is clearly separated. A pair that overlaps
+ * by round-off only has to be found as well.
+ */
+int main(int argc UNUSED, char *argv[] UNUSED)
+{
+    DPMBase problem;
+    LinearViscoelasticSpecies* species = problem.speciesHandler.copyAndAddObject(LinearViscoelasticSpecies());
+    species->setDensity(1.0);
+    species->setStiffness(1.0);
+
+    RNG random;
+    random.setRandomSeed(5);
+    std::vector<BaseParticle> particles(300);
+    CandidateBatch batch;
+    for (BaseParticle& p : particles)
+    {
+        p.setSpecies(species);
+        p.setRadius(random.getRandomNumber(0.2, 0.6));
+        p.setPosition(Vec3D(random.getRandomNumber(0, 6), random.getRandomNumber(0, 6), random.getRandomNumber(0, 6)));
+        batch.add(&p);
+    }
+    if (batch.getSize() != particles.size())
+        logger(FATAL, "the batch contains % instead of % particles", batch.getSize(), particles.size());
+
+    unsigned int numberOfContacts = 0;
+    for (unsigned int i = 0; i < particles.size(); i++)
+    {
+        unsigned int numberOfOverlaps = batch.findOverlaps(particles[i], i + 1);
+        std::vector<unsigned int> overlaps;
+        for (unsigned int k = 0; k < numberOfOverlaps; k++)
+        {
+            overlaps.push_back(batch.getOverlapIndex(k));
+            if (batch.getOverlap(k) != &particles[overlaps.back()])
+                logger(FATAL, "overlap % of particle % is not particle %", k, i, overlaps.back());
+        }
+        if (!std::is_sorted(overlaps.begin(), overlaps.end()) || (!overlaps.empty() && overlaps.front() <= i))
+            logger(FATAL, "the overlaps of particle % are not sorted or include particles before it", i);
+        for (unsigned int j = i + 1; j < particles.size(); j++)
+        {
+            Mdouble distanceSquared = Vec3D::getDistanceSquared(particles[i].getPosition(), particles[j].getPosition());
+            Mdouble sumOfRadii = particles[i].getInteractionRadius() + particles[j].getInteractionRadius();
+            bool isFound = std::binary_search(overlaps.begin(), overlaps.end(), j);
+            if (distanceSquared < sumOfRadii * sumOfRadii)
+            {
+                numberOfContacts++;
+                if (!isFound || batch.getParticle(j) != &particles[j])
+                    logger(FATAL, "the contact of particles % and % was not found", i, j);
+            }
+            else if (distanceSquared > sumOfRadii * sumOfRadii * (1.0 + 1e-10) && isFound)
+            {
+                logger(FATAL, "particles % and % are separated, but were found", i, j);
+            }
+        }
+    }
+    logger(INFO, "% contacts among % particles", numberOfContacts, particles.size());
+    if (numberOfContacts == 0)
+        logger(FATAL, "the random particles have no contacts");
+
+    //two particles that overlap by round-off only
+    batch.clear();
+    particles[0].setRadius(0.5);
+    particles[1].setRadius(0.5);
+    particles[0].setPosition(Vec3D(0, 0, 0));
+    particles[1].setPosition(Vec3D(std::nextafter(1.0, 0.0), 0, 0));
+    batch.add(&particles[1]);
+    if (batch.findOverlaps(particles[0]) != 1)
+        logger(FATAL, "two particles overlapping by round-off are not found");
+    particles[1].setPosition(Vec3D(1.001, 0, 0));
+    batch.clear();
+    batch.add(&particles[1]);
+    if (batch.findOverlaps(particles[0]) != 0)
+        logger(FATAL, "two separated particles are found");
+    return 0;
+}
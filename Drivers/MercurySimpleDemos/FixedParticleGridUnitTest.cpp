@@ -0,0 +1,166 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Mercury3D.h"
+#include "Particles/BaseParticle.h"
+#include "Species/LinearViscoelasticSpecies.h"
+#include "Logger.h"
+
+/*!
+ * \brief Compares the contact detection with and without the grid of static particles.
+ * \details A block of particles falls onto a rough bottom of fixed particles;
+ * halfway, one of the fixed particles is removed. With the grid, the fixed 
+ * particles are not in the HGrid; they are found by the falling particles 
+ * through ParticleHandler::getCandidateFixedParticles. The contacts and the 
+ * positions of the falling particles have to be the same as without the grid
+ * (up to round-off, as the forces are summed in a different order), and the 
+ * grid should only be rebuilt when a fixed particle is removed.
+ */
+class FixedParticleGridUnitTest : public Mercury3D
+{
+public:
+
+    FixedParticleGridUnitTest()
+    {
+        auto species = speciesHandler.copyAndAddObject(LinearViscoelasticSpecies());
+        species->setDensity(6.0 / constants::pi);
+        species->setCollisionTimeAndRestitutionCoefficient(0.05, 0.5, 1.0);
+        setSystemDimensions(3);
+        setGravity(Vec3D(0, 0, -10));
+        setTimeStep(0.001);
+        setTimeMax(0.6);
+        setFileType(FileType::NO_FILE);
+        setXMin(0);
+        setYMin(0);
+        setZMin(0);
+        setXMax(10);
+        setYMax(10);
+        setZMax(6);
+    }
+
+    void setupInitialConditions()
+    {
+        BaseParticle p;
+        p.setSpecies(speciesHandler.getObject(0));
+        p.setRadius(0.5);
+        for (int i = 0; i < 10; i++)
+            for (int j = 0; j < 10; j++)
+            {
+                p.setPosition(Vec3D(i + 0.5, j + 0.5, 0.1 * ((i * 7 + j * 3) % 5)));
+                particleHandler.copyAndAddObject(p)->fixParticle();
+            }
+        p.setRadius(0.45);
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++)
+                for (int k = 0; k < 3; k++)
+                {
+                    p.setPosition(Vec3D(3.0 + i + 0.1 * k, 3.0 + j + 0.05 * i, 1.5 + k));
+                    p.setVelocity(Vec3D(0.2 * (j - 1.5), 0.2 * (k - 1.0), 0.0));
+                    particleHandler.copyAndAddObject(p);
+                }
+    }
+
+    ///Removes a fixed particle under the falling block halfway
+    void actionsAfterTimeStep()
+    {
+        if (getNtimeSteps() == 300)
+        {
+            particleHandler.removeObject(55);
+        }
+    }
+};
+
+int main(int argc UNUSED, char *argv[] UNUSED)
+{
+    FixedParticleGridUnitTest reference;
+    reference.setName("FixedParticleGridUnitTest_Reference");
+    reference.solve();
+
+    FixedParticleGridUnitTest problem;
+    problem.setName("FixedParticleGridUnitTest");
+    problem.particleHandler.getFixedParticleGrid().setEnabled(true);
+    problem.solve();
+
+    const FixedParticleGrid& grid = problem.particleHandler.getFixedParticleGrid();
+    logger(INFO, "% static particles in % cells, built % times", grid.getNumberOfParticles(), grid.getNumberOfCells(), grid.getNumberOfBuilds());
+    if (grid.getNumberOfParticles() != 99)
+        logger(FATAL, "% particles are stored in the grid instead of 99", grid.getNumberOfParticles());
+    //once at the start, once after the removal
+    if (grid.getNumberOfBuilds() != 2)
+        logger(FATAL, "the grid was built % times instead of twice", grid.getNumberOfBuilds());
+
+    if (problem.particleHandler.getNumberOfObjects() != reference.particleHandler.getNumberOfObjects())
+        logger(FATAL, "there are % particles instead of %", problem.particleHandler.getNumberOfObjects(), reference.particleHandler.getNumberOfObjects());
+    if (problem.interactionHandler.getNumberOfObjects() != reference.interactionHandler.getNumberOfObjects())
+        logger(FATAL, "there are % contacts instead of %", problem.interactionHandler.getNumberOfObjects(), reference.interactionHandler.getNumberOfObjects());
+    unsigned int numberOfContactsWithBottom = 0;
+    for (BaseInteraction* c : problem.interactionHandler)
+    {
+        if (static_cast<BaseParticle*>(c->getP())->isFixed() || static_cast<BaseParticle*>(c->getI())->isFixed())
+            numberOfContactsWithBottom++;
+    }
+    logger(INFO, "% contacts, % of them with the bottom", problem.interactionHandler.getNumberOfObjects(), numberOfContactsWithBottom);
+    if (numberOfContactsWithBottom == 0)
+        logger(FATAL, "the particles did not reach the bottom");
+
+    for (unsigned int i = 0; i < reference.particleHandler.getNumberOfObjects(); i++)
+    {
+        const BaseParticle* p = problem.particleHandler.getObject(i);
+        const BaseParticle* q = reference.particleHandler.getObject(i);
+        if (!p->getPosition().isEqualTo(q->getPosition(), 1e-10))
+            logger(FATAL, "particle % is at % with the grid, but at % without", i, p->getPosition(), q->getPosition());
+        if (p->isFixed() && (p->getForce().getLength() != 0.0 || !problem.particleHandler.isInFixedParticleGrid(p)))
+            logger(FATAL, "fixed particle % is not handled by the grid", i);
+    }
+
+    //the fixed particles are not in the HGrid, but still prevent insertion
+    BaseParticle p;
+    p.setSpecies(problem.speciesHandler.getObject(0));
+    p.setRadius(0.45);
+    p.setPosition(Vec3D(0.5, 0.5, 0.8));
+    if (problem.checkParticleForInteraction(p))
+        logger(FATAL, "a particle overlapping with the bottom can be inserted");
+    p.setPosition(Vec3D(0.5, 0.5, 1.5));
+    if (!problem.checkParticleForInteraction(p))
+        logger(FATAL, "a particle above the bottom cannot be inserted");
+
+    //a fixed particle that is added is treated like all other particles until the grid is updated
+    BaseParticle* added = problem.particleHandler.copyAndAddObject(*problem.particleHandler.getObject(0));
+    added->setPosition(Vec3D(9.5, 9.5, -1.0));
+    if (problem.particleHandler.isInFixedParticleGrid(added))
+        logger(FATAL, "an added fixed particle is reported to be in the grid before the grid is updated");
+    if (!problem.particleHandler.updateFixedParticleGrid() || !problem.particleHandler.isInFixedParticleGrid(added))
+        logger(FATAL, "an added fixed particle is not in the grid after the grid is updated");
+
+    //reordering the particles (e.g. along a space-filling curve) does not change the static particles
+    const unsigned int numberOfBuilds = grid.getNumberOfBuilds();
+    std::vector<unsigned int> order(problem.particleHandler.getNumberOfObjects());
+    for (unsigned int i = 0; i < order.size(); i++)
+        order[i] = order.size() - 1 - i;
+    problem.particleHandler.reorderObjects(order);
+    if (problem.particleHandler.updateFixedParticleGrid() || grid.getNumberOfBuilds() != numberOfBuilds)
+        logger(FATAL, "the grid is rebuilt after the particles have been reordered");
+    return 0;
+}
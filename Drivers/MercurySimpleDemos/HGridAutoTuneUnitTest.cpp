@@ -0,0 +1,143 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Mercury3D.h"
+#include "Particles/BaseParticle.h"
+#include "Species/LinearViscoelasticSpecies.h"
+#include "Logger.h"
+
+/*!
+ * \brief Checks the automatic tuning of the HGrid for a bidisperse mixture to which small particles are added.
+ * \details At the start, 100 large and 100 small particles are placed on a 
+ * lattice without contacts; the tuned grid has to have at most hGridMaxLevels 
+ * levels, and its largest cells have to fit the largest particle. After 20 time
+ * steps, 400 smaller particles are added; at the next check the tuner has to 
+ * detect the change of the size distribution and rebuild the grid, which has to
+ * fit the new smallest particles. The forces have to be the same as without tuning.
+ */
+class HGridAutoTuneUnitTest : public Mercury3D
+{
+public:
+
+    HGridAutoTuneUnitTest()
+    {
+        auto species = speciesHandler.copyAndAddObject(LinearViscoelasticSpecies());
+        species->setDensity(6.0 / constants::pi);
+        species->setCollisionTimeAndRestitutionCoefficient(0.05, 0.5, 1.0);
+        setSystemDimensions(3);
+        setTimeStep(0.001);
+        setTimeMax(0.0395);
+        setSaveCount(100);
+        setFileType(FileType::NO_FILE);
+        setGravity(Vec3D(0, 0, -1));
+        setXMin(0);
+        setYMin(0);
+        setZMin(0);
+        setXMax(20);
+        setYMax(20);
+        setZMax(20);
+    }
+
+    void setupInitialConditions()
+    {
+        BaseParticle p;
+        p.setSpecies(speciesHandler.getObject(0));
+        for (int i = 0; i < 10; i++)
+            for (int j = 0; j < 10; j++)
+                for (int k = 0; k < 2; k++)
+                {
+                    p.setRadius(k == 0 ? 0.8 : 0.2);
+                    p.setPosition(Vec3D(1 + 2 * i, 1 + 2 * j, 1 + 2 * k));
+                    particleHandler.copyAndAddObject(p);
+                }
+    }
+
+    void actionsAfterTimeStep()
+    {
+        if (getNtimeSteps() == 10 && getHGrid() != nullptr)
+        {
+            initialCellSizes = getHGrid()->getCellSizes();
+        }
+        if (getNtimeSteps() == 20)
+        {
+            BaseParticle p;
+            p.setSpecies(speciesHandler.getObject(0));
+            p.setRadius(0.1);
+            for (int i = 0; i < 20; i++)
+                for (int j = 0; j < 20; j++)
+                {
+                    p.setPosition(Vec3D(0.5 + i, 0.5 + j, 10));
+                    particleHandler.copyAndAddObject(p);
+                }
+        }
+    }
+
+    const HGrid* getGrid() const
+    {
+        return getHGrid();
+    }
+
+    ///The cell sizes of the grid before the small particles are added
+    std::vector<Mdouble> initialCellSizes;
+};
+
+int main(int argc UNUSED, char *argv[] UNUSED)
+{
+    HGridAutoTuneUnitTest problem;
+    problem.setName("HGridAutoTuneUnitTest");
+    problem.setHGridMaxLevels(3);
+    problem.setHGridAutoTune(true);
+    problem.setHGridAutoTuneInterval(10);
+    if (!problem.getHGridStatistics().isEnabled())
+        logger(FATAL, "the tuner did not enable the HGrid statistics");
+    problem.solve();
+    if (problem.initialCellSizes.size() < 1 || problem.initialCellSizes.size() > 3)
+        logger(FATAL, "the tuned grid had % levels", problem.initialCellSizes.size());
+    if (problem.initialCellSizes.back() < 1.6 || problem.initialCellSizes.front() < 0.4)
+        logger(FATAL, "the cell sizes of the tuned grid ranged from % to %", problem.initialCellSizes.front(), problem.initialCellSizes.back());
+
+    const HGrid* grid = problem.getGrid();
+    const HGridStatistics& statistics = problem.getHGridStatistics();
+    if (statistics.getNumberOfRebuilds(HGridRebuildReason::SIZE_DISTRIBUTION_CHANGED) != 1)
+        logger(FATAL, "the grid was rebuilt % times for a changed size distribution instead of once",
+               statistics.getNumberOfRebuilds(HGridRebuildReason::SIZE_DISTRIBUTION_CHANGED));
+    if (grid->getCellSizes().back() < 1.6 || grid->getCellSizes().front() < 0.2)
+        logger(FATAL, "the cell sizes of the tuned grid range from % to %", grid->getCellSizes().front(), grid->getCellSizes().back());
+    if (problem.particleHandler.getNumberOfObjects() != 600)
+        logger(FATAL, "there are % particles instead of 600", problem.particleHandler.getNumberOfObjects());
+
+    //the same simulation without tuning has to give the same result
+    HGridAutoTuneUnitTest reference;
+    reference.setName("HGridAutoTuneUnitTest_Reference");
+    reference.solve();
+    for (unsigned int i = 0; i < problem.particleHandler.getNumberOfObjects(); i++)
+    {
+        Vec3D difference = problem.particleHandler.getObject(i)->getPosition() - reference.particleHandler.getObject(i)->getPosition();
+        if (difference.getLength() > 1e-10)
+            logger(FATAL, "particle % is at % with tuning and at % without",
+                   i, problem.particleHandler.getObject(i)->getPosition(), reference.particleHandler.getObject(i)->getPosition());
+    }
+    return 0;
+}
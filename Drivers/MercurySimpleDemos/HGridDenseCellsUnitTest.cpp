@@ -0,0 +1,230 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Mercury2D.h"
+#include "Mercury3D.h"
+#include "Particles/BaseParticle.h"
+#include "Species/LinearViscoelasticSpecies.h"
+#include "Logger.h"
+#include <limits>
+
+/*!
+ * \brief Checks the direct-indexed cells of the HGrid for a cubic lattice of 
+ * 4x4x4 slightly overlapping particles.
+ * \details As in HGridStatisticsUnitTest, there are 144 contacts. With dense 
+ * cells, the domain [0,4]^3 gets its own buckets, so there are no hash 
+ * collisions and the particles end up where they end up with a hashed grid. 
+ * If part of the lattice is outside the domain, those particles are hashed, 
+ * but all contacts are still found. An unbounded domain falls back to hashing,
+ * and changing the domain during the simulation rebuilds the grid.
+ */
+class HGridDenseCells3DUnitTest : public Mercury3D
+{
+public:
+
+    HGridDenseCells3DUnitTest()
+            : newZMax_(0)
+    {
+        auto species = speciesHandler.copyAndAddObject(LinearViscoelasticSpecies());
+        species->setDensity(6.0 / constants::pi);
+        species->setCollisionTimeAndRestitutionCoefficient(0.05, 0.5, 1.0);
+        setSystemDimensions(3);
+        setTimeStep(0.001);
+        setTimeMax(0.0095);
+        setSaveCount(5);
+        setFileType(FileType::NO_FILE);
+        setXMin(0);
+        setYMin(0);
+        setZMin(0);
+        setXMax(4);
+        setYMax(4);
+        setZMax(4);
+        getHGridStatistics().setEnabled(true);
+    }
+
+    void setupInitialConditions()
+    {
+        BaseParticle p;
+        p.setSpecies(speciesHandler.getObject(0));
+        p.setRadius(0.5);
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++)
+                for (int k = 0; k < 4; k++)
+                {
+                    p.setPosition(0.99 * Vec3D(i, j, k) + Vec3D(0.5, 0.5, 0.5));
+                    p.setVelocity(0.01 * Vec3D(k % 2, i % 3, j % 2));
+                    particleHandler.copyAndAddObject(p);
+                }
+    }
+
+    ///Enlarges the domain halfway through the simulation, if newZMax_ is set
+    void actionsAfterTimeStep()
+    {
+        if (newZMax_ > 0 && getNtimeSteps() == 5)
+        {
+            setZMax(newZMax_);
+        }
+    }
+
+    void setNewZMax(Mdouble newZMax)
+    {
+        newZMax_ = newZMax;
+    }
+
+    ///Gives access to the grid, which is protected in MercuryBase
+    const HGrid* getGrid() const
+    {
+        return getHGrid();
+    }
+
+private:
+    ///The upper z-bound of the domain after the domain is enlarged; the domain is not changed if zero
+    Mdouble newZMax_;
+};
+
+///The same lattice in 2D, which has 2*4*3=24 contacts
+class HGridDenseCells2DUnitTest : public Mercury2D
+{
+public:
+
+    HGridDenseCells2DUnitTest()
+    {
+        auto species = speciesHandler.copyAndAddObject(LinearViscoelasticSpecies());
+        species->setDensity(4.0 / constants::pi);
+        species->setCollisionTimeAndRestitutionCoefficient(0.05, 0.5, 1.0);
+        setTimeStep(0.001);
+        setTimeMax(0.0095);
+        setFileType(FileType::NO_FILE);
+        setXMin(0);
+        setYMin(0);
+        setXMax(4);
+        setYMax(4);
+        getHGridStatistics().setEnabled(true);
+    }
+
+    void setupInitialConditions()
+    {
+        BaseParticle p;
+        p.setSpecies(speciesHandler.getObject(0));
+        p.setRadius(0.5);
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++)
+            {
+                p.setPosition(0.99 * Vec3D(i, j, 0) + Vec3D(0.5, 0.5, 0));
+                particleHandler.copyAndAddObject(p);
+            }
+    }
+
+    ///Gives access to the grid, which is protected in MercuryBase
+    const HGrid* getGrid() const
+    {
+        return getHGrid();
+    }
+};
+
+void checkContacts(const MercuryBase& problem, unsigned int numberOfContacts)
+{
+    if (problem.interactionHandler.getNumberOfObjects() != numberOfContacts)
+        logger(FATAL, "%: there are % contacts instead of %", problem.getName(), problem.interactionHandler.getNumberOfObjects(), numberOfContacts);
+}
+
+template<class Problem>
+void checkDense(const Problem& problem, bool dense)
+{
+    if ((problem.getGrid()->getNumberOfDenseCells() > 0) != dense)
+        logger(FATAL, "%: the grid has % dense cells", problem.getName(), problem.getGrid()->getNumberOfDenseCells());
+    if (problem.getGrid()->getNumberOfBuckets() != problem.getGrid()->getNumberOfDenseCells() + problem.getGrid()->getNumberOfHashBuckets())
+        logger(FATAL, "%: % buckets are neither dense nor hashed", problem.getName(), problem.getGrid()->getNumberOfBuckets());
+}
+
+int main(int argc UNUSED, char *argv[] UNUSED)
+{
+    HGridDenseCells3DUnitTest hashed;
+    hashed.setName("HGridDenseCellsUnitTest_Hashed");
+    hashed.solve();
+    checkContacts(hashed, 144);
+    checkDense(hashed, false);
+
+    HGridDenseCells3DUnitTest dense;
+    dense.setName("HGridDenseCellsUnitTest_Dense");
+    dense.setHGridDenseCells(true);
+    dense.solve();
+    checkContacts(dense, 144);
+    checkDense(dense, true);
+    //one level of cells of size 1+, padded by one cell on each side
+    if (dense.getGrid()->getNumberOfDenseCells() != 6 * 6 * 6)
+        logger(FATAL, "the dense grid has % cells instead of 216", dense.getGrid()->getNumberOfDenseCells());
+    if (dense.getHGridStatistics().getNumberOfHashCollisions() != 0)
+        logger(FATAL, "the dense grid has % hash collisions", dense.getHGridStatistics().getNumberOfHashCollisions());
+    for (unsigned int i = 0; i < dense.particleHandler.getNumberOfObjects(); i++)
+    {
+        const Vec3D& position = dense.particleHandler.getObject(i)->getPosition();
+        const Vec3D& reference = hashed.particleHandler.getObject(i)->getPosition();
+        if (!position.isEqualTo(reference, 1e-12))
+            logger(FATAL, "particle % is at % with a dense grid, but at % with a hashed grid", i, position, reference);
+    }
+
+    //half of the lattice is outside the domain; these cells are hashed
+    HGridDenseCells3DUnitTest partial;
+    partial.setName("HGridDenseCellsUnitTest_Partial");
+    partial.setHGridDenseCells(true);
+    partial.setXMax(1);
+    partial.solve();
+    checkContacts(partial, 144);
+    checkDense(partial, true);
+
+    //an unbounded domain falls back to hashing
+    HGridDenseCells3DUnitTest unbounded;
+    unbounded.setName("HGridDenseCellsUnitTest_Unbounded");
+    unbounded.setHGridDenseCells(true);
+    unbounded.setZMax(std::numeric_limits<Mdouble>::infinity());
+    unbounded.solve();
+    checkContacts(unbounded, 144);
+    checkDense(unbounded, false);
+    if (unbounded.getHGridStatistics().getNumberOfRebuilds() != 1)
+        logger(FATAL, "the unbounded grid was rebuilt % times instead of once", unbounded.getHGridStatistics().getNumberOfRebuilds());
+
+    //changing the domain rebuilds the grid
+    HGridDenseCells3DUnitTest resized;
+    resized.setName("HGridDenseCellsUnitTest_Resized");
+    resized.setHGridDenseCells(true);
+    resized.setNewZMax(8);
+    resized.solve();
+    checkContacts(resized, 144);
+    if (resized.getHGridStatistics().getNumberOfRebuilds(HGridRebuildReason::PARAMETERS_CHANGED) != 1)
+        logger(FATAL, "changing the domain caused % rebuilds", resized.getHGridStatistics().getNumberOfRebuilds(HGridRebuildReason::PARAMETERS_CHANGED));
+    if (resized.getGrid()->getNumberOfDenseCells() != 6 * 6 * 10)
+        logger(FATAL, "the enlarged dense grid has % cells instead of 360", resized.getGrid()->getNumberOfDenseCells());
+
+    HGridDenseCells2DUnitTest dense2D;
+    dense2D.setName("HGridDenseCellsUnitTest_2D");
+    dense2D.setHGridDenseCells(true);
+    dense2D.solve();
+    checkContacts(dense2D, 24);
+    checkDense(dense2D, true);
+    if (dense2D.getHGridStatistics().getNumberOfHashCollisions() != 0)
+        logger(FATAL, "the 2D dense grid has % hash collisions", dense2D.getHGridStatistics().getNumberOfHashCollisions());
+    return 0;
+}
@@ -0,0 +1,156 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Mercury3D.h"
+#include "Particles/BaseParticle.h"
+#include "Species/LinearViscoelasticSpecies.h"
+#include "Logger.h"
+
+/*!
+ * \brief Compares the incremental update of the HGrid with the full update.
+ * \details A 5x5x5 lattice of touching particles moves with different 
+ * velocities, such that particles collide and change cell. Halfway, one 
+ * particle is removed and another one added. With incremental updates, each
+ * particle is stored exactly once, in the bucket of its current cell, and the
+ * particles end up where they end up with full updates (up to round-off, as 
+ * the forces are summed in a different order). As most particles stay in 
+ * their cell during a time step, far fewer particles are inserted in a bucket.
+ */
+class HGridIncrementalUpdateUnitTest : public Mercury3D
+{
+public:
+
+    HGridIncrementalUpdateUnitTest()
+    {
+        auto species = speciesHandler.copyAndAddObject(LinearViscoelasticSpecies());
+        species->setDensity(6.0 / constants::pi);
+        species->setCollisionTimeAndRestitutionCoefficient(0.05, 0.8, 1.0);
+        setSystemDimensions(3);
+        setTimeStep(0.001);
+        setTimeMax(0.2);
+        setFileType(FileType::NO_FILE);
+        setXMin(0);
+        setYMin(0);
+        setZMin(0);
+        setXMax(5);
+        setYMax(5);
+        setZMax(5);
+        getHGridStatistics().setEnabled(true);
+    }
+
+    void setupInitialConditions()
+    {
+        BaseParticle p;
+        p.setSpecies(speciesHandler.getObject(0));
+        p.setRadius(0.5);
+        for (int i = 0; i < 5; i++)
+            for (int j = 0; j < 5; j++)
+                for (int k = 0; k < 5; k++)
+                {
+                    p.setPosition(Vec3D(i, j, k) + Vec3D(0.5, 0.5, 0.5));
+                    p.setVelocity(3.0 * Vec3D((i + 2 * j) % 3 - 1.0, (j + 2 * k) % 3 - 1.0, (k + 2 * i) % 3 - 1.0));
+                    particleHandler.copyAndAddObject(p);
+                }
+    }
+
+    ///Removes particle 10 and adds a particle outside the lattice halfway
+    void actionsAfterTimeStep()
+    {
+        if (getNtimeSteps() == 100)
+        {
+            particleHandler.removeObject(10);
+            BaseParticle p;
+            p.setSpecies(speciesHandler.getObject(0));
+            p.setRadius(0.5);
+            p.setPosition(Vec3D(6, 2.5, 2.5));
+            p.setVelocity(Vec3D(-1, 0, 0));
+            particleHandler.copyAndAddObject(p);
+        }
+    }
+
+    ///Checks that each particle is stored exactly once, in the bucket of its cell
+    void checkBuckets() const
+    {
+        const HGrid* grid = getHGrid();
+        unsigned int numberOfStoredParticles = 0;
+        for (unsigned int bucket = 0; bucket < grid->getNumberOfBuckets(); bucket++)
+        {
+            const BaseParticle* previous = nullptr;
+            for (const BaseParticle* p = grid->getFirstBaseParticleInBucket(bucket); p != nullptr; p = p->getHGridNextObject())
+            {
+                numberOfStoredParticles++;
+                if (p->getHGridPrevObject() != previous)
+                    logger(FATAL, "particle % in bucket % does not point back to its predecessor", p->getId(), bucket);
+                if (grid->computeHashBucketIndex(p->getHGridX(), p->getHGridY(), p->getHGridZ(), p->getHGridLevel()) != bucket)
+                    logger(FATAL, "particle % is stored in bucket %, which is not the bucket of its cell", p->getId(), bucket);
+                Mdouble invCellSize = grid->getInvCellSize(p->getHGridLevel());
+                if (p->getHGridX() != static_cast<int>(std::floor(p->getPosition().X * invCellSize)))
+                    logger(FATAL, "particle % is stored in cell %, but it is in cell %", p->getId(), p->getHGridX(), std::floor(p->getPosition().X * invCellSize));
+                previous = p;
+            }
+        }
+        if (numberOfStoredParticles != particleHandler.getNumberOfObjects())
+            logger(FATAL, "% particles are stored in the buckets instead of %", numberOfStoredParticles, particleHandler.getNumberOfObjects());
+    }
+};
+
+int main(int argc UNUSED, char *argv[] UNUSED)
+{
+    HGridIncrementalUpdateUnitTest full;
+    full.setName("HGridIncrementalUpdateUnitTest_Full");
+    full.solve();
+
+    HGridIncrementalUpdateUnitTest incremental;
+    incremental.setName("HGridIncrementalUpdateUnitTest_Incremental");
+    incremental.setHGridIncrementalUpdate(true);
+    incremental.solve();
+    //update the grid once more, as the particles moved in the last time step
+    incremental.hGridActionsBeforeTimeStep();
+    incremental.checkBuckets();
+
+    if (incremental.particleHandler.getNumberOfObjects() != full.particleHandler.getNumberOfObjects())
+        logger(FATAL, "there are % particles instead of %", incremental.particleHandler.getNumberOfObjects(), full.particleHandler.getNumberOfObjects());
+    if (incremental.interactionHandler.getNumberOfObjects() != full.interactionHandler.getNumberOfObjects())
+        logger(FATAL, "there are % contacts instead of %", incremental.interactionHandler.getNumberOfObjects(), full.interactionHandler.getNumberOfObjects());
+    for (unsigned int i = 0; i < full.particleHandler.getNumberOfObjects(); i++)
+    {
+        const Vec3D& position = incremental.particleHandler.getObject(i)->getPosition();
+        const Vec3D& reference = full.particleHandler.getObject(i)->getPosition();
+        if (!position.isEqualTo(reference, 1e-10))
+            logger(FATAL, "particle % is at % with incremental updates, but at % with full updates", i, position, reference);
+    }
+
+    unsigned long fullInsertions = full.getHGridStatistics().getNumberOfParticleInsertions();
+    unsigned long incrementalInsertions = incremental.getHGridStatistics().getNumberOfParticleInsertions();
+    logger(INFO, "particle insertions: % with full updates, % with incremental updates", fullInsertions, incrementalInsertions);
+    if (fullInsertions < 125 * full.getHGridStatistics().getNumberOfTimeSteps())
+        logger(FATAL, "only % particles were inserted with full updates", fullInsertions);
+    //the 125 particles of the lattice and the added particle are inserted once, the others when they changed cell
+    if (incrementalInsertions <= 126)
+        logger(FATAL, "no particle changed cell");
+    if (10 * incrementalInsertions > fullInsertions)
+        logger(FATAL, "% particles were inserted with incremental updates, % with full updates", incrementalInsertions, fullInsertions);
+    return 0;
+}
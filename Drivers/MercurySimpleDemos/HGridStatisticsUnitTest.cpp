@@ -0,0 +1,142 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Mercury3D.h"
+#include "Particles/BaseParticle.h"
+#include "Species/LinearViscoelasticSpecies.h"
+#include "Logger.h"
+#include <fstream>
+
+/*!
+ * \brief Checks the HGridStatistics for a cubic lattice of 4x4x4 slightly overlapping particles.
+ * \details Each particle overlaps with its face neighbours, so there are 
+ * 3*4*4*3=144 contacts. Every contact has to be found in a tested pair that is 
+ * not a hash collision, the grid has to be built once (as there is no grid at 
+ * the start) and with a very small number of buckets there have to be hash 
+ * collisions. The file name.hgrid has to contain a header and one line per 
+ * saveCount time steps. If the statistics are disabled, no pairs are counted.
+ */
+class HGridStatisticsUnitTest : public Mercury3D
+{
+public:
+
+    HGridStatisticsUnitTest(unsigned int numberOfBuckets)
+            : numberOfBuckets_(numberOfBuckets)
+    {
+        auto species = speciesHandler.copyAndAddObject(LinearViscoelasticSpecies());
+        species->setDensity(6.0 / constants::pi);
+        species->setCollisionTimeAndRestitutionCoefficient(0.05, 0.5, 1.0);
+        setSystemDimensions(3);
+        setTimeStep(0.001);
+        setTimeMax(0.0095);
+        setSaveCount(5);
+        setFileType(FileType::NO_FILE);
+        setXMin(0);
+        setYMin(0);
+        setZMin(0);
+        setXMax(4);
+        setYMax(4);
+        setZMax(4);
+    }
+
+    void setupInitialConditions()
+    {
+        BaseParticle p;
+        p.setSpecies(speciesHandler.getObject(0));
+        p.setRadius(0.5);
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++)
+                for (int k = 0; k < 4; k++)
+                {
+                    p.setPosition(0.99 * Vec3D(i, j, k) + Vec3D(0.5, 0.5, 0.5));
+                    particleHandler.copyAndAddObject(p);
+                }
+    }
+
+    unsigned int getHGridTargetNumberOfBuckets() const override
+    {
+        return numberOfBuckets_ > 0 ? numberOfBuckets_ : Mercury3D::getHGridTargetNumberOfBuckets();
+    }
+
+private:
+    ///The number of buckets of the grid; the default is used if zero
+    unsigned int numberOfBuckets_;
+};
+
+void checkStatistics(HGridStatisticsUnitTest& problem)
+{
+    const HGridStatistics& statistics = problem.getHGridStatistics();
+    if (problem.interactionHandler.getNumberOfObjects() != 144)
+        logger(FATAL, "there are % contacts instead of 144", problem.interactionHandler.getNumberOfObjects());
+    //the contacts are counted during the force computation, not taken from the interactionHandler
+    if (problem.getNumberOfParticleContacts() != 144)
+        logger(FATAL, "% contacts were counted instead of 144", problem.getNumberOfParticleContacts());
+    //the forces are computed once before the time loop and once in each of the 10 time steps
+    if (statistics.getNumberOfTimeSteps() != 11)
+        logger(FATAL, "% time steps were counted instead of 11", statistics.getNumberOfTimeSteps());
+    if (statistics.getNumberOfPairsTested() - statistics.getNumberOfHashCollisions() < 144 * statistics.getNumberOfTimeSteps())
+        logger(FATAL, "only % pairs were tested, of which % hash collisions", statistics.getNumberOfPairsTested(), statistics.getNumberOfHashCollisions());
+    if (statistics.getNumberOfBucketsVisited() == 0)
+        logger(FATAL, "no buckets were visited");
+    if (statistics.getNumberOfRebuilds() != 1 || statistics.getNumberOfRebuilds(HGridRebuildReason::NO_GRID) != 1)
+        logger(FATAL, "the grid was rebuilt % times instead of once", statistics.getNumberOfRebuilds());
+}
+
+int main(int argc UNUSED, char *argv[] UNUSED)
+{
+    HGridStatisticsUnitTest problem(0);
+    problem.setName("HGridStatisticsUnitTest");
+    problem.getHGridStatistics().setEnabled(true);
+    problem.solve();
+    checkStatistics(problem);
+
+    //one line for the header and one for every 5 of the 10 time steps, including the first and the last
+    std::ifstream file("HGridStatisticsUnitTest.hgrid");
+    std::string line;
+    unsigned int numberOfLines = 0;
+    while (std::getline(file, line))
+        numberOfLines++;
+    if (numberOfLines != 4)
+        logger(FATAL, "HGridStatisticsUnitTest.hgrid contains % lines instead of 4", numberOfLines);
+
+    //with two buckets, most particle pairs in a bucket are in different cells
+    HGridStatisticsUnitTest smallProblem(2);
+    smallProblem.setName("HGridStatisticsUnitTest_SmallGrid");
+    smallProblem.getHGridStatistics().setEnabled(true);
+    smallProblem.solve();
+    checkStatistics(smallProblem);
+    if (smallProblem.getHGridStatistics().getNumberOfHashCollisions() <= problem.getHGridStatistics().getNumberOfHashCollisions())
+        logger(FATAL, "a grid with two buckets has % hash collisions, the default grid %",
+               smallProblem.getHGridStatistics().getNumberOfHashCollisions(), problem.getHGridStatistics().getNumberOfHashCollisions());
+    smallProblem.hGridInfo();
+
+    //the grid of the first run is reused, so it is not rebuilt
+    problem.getHGridStatistics().setEnabled(false);
+    problem.solve();
+    if (problem.getHGridStatistics().getNumberOfPairsTested() != 0 || problem.getHGridStatistics().getNumberOfRebuilds() != 0)
+        logger(FATAL, "the disabled statistics counted % pairs and % rebuilds",
+               problem.getHGridStatistics().getNumberOfPairsTested(), problem.getHGridStatistics().getNumberOfRebuilds());
+    return 0;
+}
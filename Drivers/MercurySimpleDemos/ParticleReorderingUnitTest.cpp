@@ -0,0 +1,181 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Mercury3D.h"
+#include "Particles/BaseParticle.h"
+#include "Species/LinearViscoelasticSpecies.h"
+#include "Walls/InfiniteWall.h"
+#include "Logger.h"
+#include <algorithm>
+
+/*!
+ * \brief Checks that sorting the particles along a space-filling curve does not change the simulation.
+ * \details An 8x8x8 lattice of colliding particles in a box is inserted in a
+ * scrambled order. With the reordering, the particles end up at the same positions as 
+ * without (up to round-off, as the forces are summed in a different order), 
+ * the indices in the handlers are consistent, and the particles that are in 
+ * contact are close to each other in the ParticleHandler.
+ */
+class ParticleReorderingUnitTest : public Mercury3D
+{
+public:
+
+    ParticleReorderingUnitTest()
+    {
+        auto species = speciesHandler.copyAndAddObject(LinearViscoelasticSpecies());
+        species->setDensity(6.0 / constants::pi);
+        species->setCollisionTimeAndRestitutionCoefficient(0.05, 0.8, 1.0);
+        setSystemDimensions(3);
+        setTimeStep(0.001);
+        setTimeMax(0.3);
+        setFileType(FileType::NO_FILE);
+        setXMin(0);
+        setYMin(0);
+        setZMin(0);
+        setXMax(8);
+        setYMax(8);
+        setZMax(8);
+    }
+
+    void setupInitialConditions()
+    {
+        BaseParticle p;
+        p.setSpecies(speciesHandler.getObject(0));
+        p.setRadius(0.5);
+        for (unsigned int n = 0; n < 512; n++)
+        {
+            //301 and 512 are coprime, so each lattice site is used once
+            const int m = (301 * n) % 512;
+            const int i = m % 8, j = (m / 8) % 8, k = m / 64;
+            p.setPosition(Vec3D(i, j, k) + Vec3D(0.5, 0.5, 0.5));
+            p.setVelocity(Vec3D((i + 2 * j) % 3 - 1.0, (j + 2 * k) % 3 - 1.0, (k + 2 * i) % 3 - 1.0));
+            particleHandler.copyAndAddObject(p);
+        }
+        InfiniteWall w;
+        w.setSpecies(speciesHandler.getObject(0));
+        for (unsigned int d = 0; d < 3; d++)
+        {
+            Vec3D normal;
+            normal.setComponent(d, 1.0);
+            w.set(-normal, Vec3D(0, 0, 0));
+            wallHandler.copyAndAddObject(w);
+            w.set(normal, Vec3D(8, 8, 8));
+            wallHandler.copyAndAddObject(w);
+        }
+    }
+
+    ///Checks that the index of each particle and interaction is its position in the handler
+    void checkIndices() const
+    {
+        for (unsigned int i = 0; i < particleHandler.getNumberOfObjects(); i++)
+            if (particleHandler.getObject(i)->getIndex() != i)
+                logger(FATAL, "particle % has index %", i, particleHandler.getObject(i)->getIndex());
+        for (unsigned int i = 0; i < interactionHandler.getNumberOfObjects(); i++)
+            if (interactionHandler.getObject(i)->getIndex() != i)
+                logger(FATAL, "interaction % has index %", i, interactionHandler.getObject(i)->getIndex());
+    }
+};
+
+///Checks that consecutive cells of an n^dimensions grid along the Hilbert curve are neighbours
+void checkHilbertCurve(unsigned int n, unsigned int dimensions)
+{
+    std::vector<std::pair<uint64_t, Vec3D> > cells;
+    for (unsigned int x = 0; x < n; x++)
+        for (unsigned int y = 0; y < n; y++)
+            for (unsigned int z = 0; z < (dimensions == 3 ? n : 1); z++)
+                cells.push_back({ParticleReordering::computeKey(SpaceFillingCurve::HILBERT, x, y, z, dimensions), Vec3D(x, y, z)});
+    std::sort(cells.begin(), cells.end(), [] (const std::pair<uint64_t, Vec3D>& a, const std::pair<uint64_t, Vec3D>& b)
+    {
+        return a.first < b.first;
+    });
+    //the curve starts at the origin, so it fills the first n^dimensions keys before leaving the corner
+    if (cells.back().first != cells.size() - 1)
+        logger(FATAL, "the largest Hilbert key in a corner of % cells is %", cells.size(), cells.back().first);
+    for (unsigned int i = 1; i < cells.size(); i++)
+    {
+        if (cells[i].first == cells[i - 1].first || Vec3D::getDistanceSquared(cells[i].second, cells[i - 1].second) != 1.0)
+            logger(FATAL, "% and % are consecutive on the Hilbert curve, but not neighbours", cells[i - 1].second, cells[i].second);
+    }
+}
+
+int main(int argc UNUSED, char *argv[] UNUSED)
+{
+    checkHilbertCurve(8, 3);
+    checkHilbertCurve(16, 2);
+    if (ParticleReordering::computeKey(SpaceFillingCurve::MORTON, 1, 0, 0, 3) != 4 
+        || ParticleReordering::computeKey(SpaceFillingCurve::MORTON, 0, 1, 0, 3) != 2
+        || ParticleReordering::computeKey(SpaceFillingCurve::MORTON, 0, 0, 1, 3) != 1
+        || ParticleReordering::computeKey(SpaceFillingCurve::MORTON, 3, 0, 1, 3) != 0x25)
+        logger(FATAL, "the Morton keys do not interleave the bits of the coordinates");
+
+    ParticleReorderingUnitTest reference;
+    reference.setName("ParticleReorderingUnitTest_Reference");
+    reference.solve();
+
+    ParticleReorderingUnitTest reordered;
+    reordered.setName("ParticleReorderingUnitTest_Interval");
+    reordered.particleReordering.setEnabled(true);
+    reordered.particleReordering.setInterval(50);
+    reordered.solve();
+    reordered.checkIndices();
+
+    ParticleReorderingUnitTest automatic;
+    automatic.setName("ParticleReorderingUnitTest_Automatic");
+    automatic.particleReordering.setEnabled(true);
+    automatic.particleReordering.setCurve(SpaceFillingCurve::MORTON);
+    automatic.solve();
+    automatic.checkIndices();
+
+    //the particles are sorted at the first time step and then every 50 steps
+    if (reordered.particleReordering.getNumberOfReorders() != 6)
+        logger(FATAL, "the particles were sorted % times instead of 6", reordered.particleReordering.getNumberOfReorders());
+    logger(INFO, "automatic: % reorders, miss rate %, baseline %", automatic.particleReordering.getNumberOfReorders(), automatic.particleReordering.getMissRate(), automatic.particleReordering.getBaselineMissRate());
+    if (automatic.particleReordering.getNumberOfReorders() < 1 || automatic.particleReordering.getMissRate() <= 0.0)
+        logger(FATAL, "the automatic reordering did not measure the miss rate");
+
+    for (const ParticleReorderingUnitTest* problem : {&reordered, &automatic})
+    {
+        if (problem->interactionHandler.getNumberOfObjects() != reference.interactionHandler.getNumberOfObjects())
+            logger(FATAL, "there are % contacts instead of %", problem->interactionHandler.getNumberOfObjects(), reference.interactionHandler.getNumberOfObjects());
+        for (const BaseParticle* p : reference.particleHandler)
+        {
+            const BaseParticle* q = nullptr;
+            for (const BaseParticle* r : problem->particleHandler)
+                if (r->getId() == p->getId())
+                    q = r;
+            if (q == nullptr || !q->getPosition().isEqualTo(p->getPosition(), 1e-10))
+                logger(FATAL, "particle with id % is not at %", p->getId(), p->getPosition());
+        }
+    }
+
+    Mdouble referenceMissRate = ParticleReordering::getContactLocalityMissRate(reference.interactionHandler);
+    Mdouble hilbertMissRate = ParticleReordering::getContactLocalityMissRate(reordered.interactionHandler);
+    Mdouble mortonMissRate = ParticleReordering::getContactLocalityMissRate(automatic.interactionHandler);
+    logger(INFO, "contacts between particles more than 64 apart in the handler: scrambled %, Hilbert %, Morton % (% reorders)",
+           referenceMissRate, hilbertMissRate, mortonMissRate, automatic.particleReordering.getNumberOfReorders());
+    if (hilbertMissRate > 0.5 * referenceMissRate || mortonMissRate > 0.5 * referenceMissRate)
+        logger(FATAL, "the reordering did not bring the particles in contact closer together");
+    return 0;
+}
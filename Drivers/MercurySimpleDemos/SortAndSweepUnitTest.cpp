@@ -0,0 +1,189 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Mercury3D.h"
+#include "Particles/BaseParticle.h"
+#include "Walls/InfiniteWall.h"
+#include "Boundaries/PeriodicBoundary.h"
+#include "Species/LinearViscoelasticSpecies.h"
+#include "Logger.h"
+#include <sstream>
+
+/*!
+ * \brief Compares the contact detection by the SortAndSweep with the one by the HGrid.
+ * \details Particles flow down a long, narrow channel, periodic in x, with a 
+ * rough bottom of fixed particles and flat side walls. During the flow, a 
+ * particle is inserted (checking for overlaps first) and another one is 
+ * removed. With the SortAndSweep, with and without the grid of static 
+ * particles, the contacts and positions have to be the same as with the HGrid
+ * (up to round-off, as the forces are summed in a different order); the 
+ * particles should be sorted along x, and only sorted from scratch once.
+ */
+class SortAndSweepUnitTest : public Mercury3D
+{
+public:
+
+    SortAndSweepUnitTest()
+    {
+        auto species = speciesHandler.copyAndAddObject(LinearViscoelasticSpecies());
+        species->setDensity(6.0 / constants::pi);
+        species->setCollisionTimeAndRestitutionCoefficient(0.05, 0.5, 1.0);
+        setSystemDimensions(3);
+        setGravity(Vec3D(3, 0, -9.5));
+        setTimeStep(0.001);
+        setTimeMax(0.6);
+        setFileType(FileType::NO_FILE);
+        setXMin(0);
+        setYMin(0);
+        setZMin(0);
+        setXMax(40);
+        setYMax(2);
+        setZMax(5);
+    }
+
+    void setupInitialConditions()
+    {
+        InfiniteWall w;
+        w.setSpecies(speciesHandler.getObject(0));
+        w.set(Vec3D(0, -1, 0), Vec3D(0, getYMin(), 0));
+        wallHandler.copyAndAddObject(w);
+        w.set(Vec3D(0, 1, 0), Vec3D(0, getYMax(), 0));
+        wallHandler.copyAndAddObject(w);
+        PeriodicBoundary b;
+        b.set(Vec3D(1, 0, 0), getXMin(), getXMax());
+        boundaryHandler.copyAndAddObject(b);
+
+        BaseParticle p;
+        p.setSpecies(speciesHandler.getObject(0));
+        p.setRadius(0.5);
+        for (int i = 0; i < 40; i++)
+            for (int j = 0; j < 2; j++)
+            {
+                p.setPosition(Vec3D(i + 0.5, j + 0.5, 0.1 * ((i * 7 + j * 3) % 5)));
+                particleHandler.copyAndAddObject(p)->fixParticle();
+            }
+        p.setRadius(0.45);
+        for (int i = 0; i < 38; i++)
+            for (int j = 0; j < 2; j++)
+                for (int k = 0; k < 3; k++)
+                {
+                    p.setPosition(Vec3D(0.5 + i + 0.05 * k, 0.5 + j, 1.2 + k));
+                    p.setVelocity(Vec3D(1.0, 0.1 * (j - 0.5), 0.1 * (i % 3 - 1)));
+                    particleHandler.copyAndAddObject(p);
+                }
+    }
+
+    ///Inserts a particle above the flow and removes one from the flow
+    void actionsAfterTimeStep()
+    {
+        if (getNtimeSteps() == 200)
+        {
+            BaseParticle p;
+            p.setSpecies(speciesHandler.getObject(0));
+            p.setRadius(0.45);
+            p.setPosition(Vec3D(20.0, 1.0, 4.0));
+            if (!checkParticleForInteraction(p))
+                logger(FATAL, "the particle above the flow cannot be inserted");
+            particleHandler.copyAndAddObject(p);
+        }
+        else if (getNtimeSteps() == 400)
+        {
+            particleHandler.removeObject(100);
+        }
+    }
+};
+
+///Compares a run with the reference run with the HGrid
+void compare(const SortAndSweepUnitTest& problem, const SortAndSweepUnitTest& reference)
+{
+    const SortAndSweep& sortAndSweep = problem.getSortAndSweep();
+    logger(INFO, "%: % particles sorted along axis %, sorted from scratch % times, % swaps at the last update", 
+           problem.getName(), sortAndSweep.getNumberOfParticles(), sortAndSweep.getAxis(), 
+           sortAndSweep.getNumberOfRebuilds(), sortAndSweep.getNumberOfSwaps());
+    if (sortAndSweep.getAxis() != 0)
+        logger(FATAL, "the particles are sorted along axis % instead of along x", sortAndSweep.getAxis());
+    if (sortAndSweep.getNumberOfRebuilds() != 1)
+        logger(FATAL, "the particles were sorted from scratch % times instead of once", sortAndSweep.getNumberOfRebuilds());
+    
+    if (problem.particleHandler.getNumberOfObjects() != reference.particleHandler.getNumberOfObjects())
+        logger(FATAL, "there are % particles instead of %", problem.particleHandler.getNumberOfObjects(), reference.particleHandler.getNumberOfObjects());
+    if (problem.interactionHandler.getNumberOfObjects() != reference.interactionHandler.getNumberOfObjects())
+        logger(FATAL, "there are % contacts instead of %", problem.interactionHandler.getNumberOfObjects(), reference.interactionHandler.getNumberOfObjects());
+    for (unsigned int i = 0; i < reference.particleHandler.getNumberOfObjects(); i++)
+    {
+        const BaseParticle* p = problem.particleHandler.getObject(i);
+        const BaseParticle* q = reference.particleHandler.getObject(i);
+        if (!p->getPosition().isEqualTo(q->getPosition(), 1e-10))
+            logger(FATAL, "particle % is at % with the SortAndSweep, but at % with the HGrid", i, p->getPosition(), q->getPosition());
+    }
+}
+
+int main(int argc UNUSED, char *argv[] UNUSED)
+{
+    SortAndSweepUnitTest reference;
+    reference.setName("SortAndSweepUnitTest_Reference");
+    reference.solve();
+    logger(INFO, "% particles, % contacts", reference.particleHandler.getNumberOfObjects(), reference.interactionHandler.getNumberOfObjects());
+
+    SortAndSweepUnitTest problem;
+    problem.setName("SortAndSweepUnitTest");
+    problem.setBroadPhase(BroadPhase::SORT_AND_SWEEP);
+    problem.solve();
+    compare(problem, reference);
+    //the periodic images are sorted as well
+    if (problem.getSortAndSweep().getNumberOfParticles() <= problem.particleHandler.getNumberOfObjects())
+        logger(FATAL, "% particles are sorted, but there are % particles and their periodic images", 
+               problem.getSortAndSweep().getNumberOfParticles(), problem.particleHandler.getNumberOfObjects());
+
+    SortAndSweepUnitTest fixedGridProblem;
+    fixedGridProblem.setName("SortAndSweepUnitTest_FixedParticleGrid");
+    fixedGridProblem.setBroadPhase(BroadPhase::SORT_AND_SWEEP);
+    fixedGridProblem.particleHandler.getFixedParticleGrid().setEnabled(true);
+    fixedGridProblem.solve();
+    compare(fixedGridProblem, reference);
+    
+    //the fixed particles are not sorted, but still prevent insertion
+    BaseParticle p;
+    p.setSpecies(fixedGridProblem.speciesHandler.getObject(0));
+    p.setRadius(0.45);
+    p.setPosition(Vec3D(10.5, 0.5, 0.6));
+    if (fixedGridProblem.checkParticleForInteraction(p))
+        logger(FATAL, "a particle overlapping with the bottom can be inserted");
+    p.setPosition(Vec3D(10.5, 0.5, 4.5));
+    if (!fixedGridProblem.checkParticleForInteraction(p))
+        logger(FATAL, "a particle above the flow cannot be inserted");
+
+    //the broad phase is kept when restarting; the particles are not needed for that
+    SortAndSweepUnitTest original;
+    original.setName("SortAndSweepUnitTest_Restart");
+    original.setBroadPhase(BroadPhase::SORT_AND_SWEEP);
+    std::stringstream restartFile;
+    original.write(restartFile, true);
+    SortAndSweepUnitTest restarted;
+    restarted.read(restartFile);
+    if (restarted.getBroadPhase() != BroadPhase::SORT_AND_SWEEP)
+        logger(FATAL, "the broad phase is not read from the restart file");
+    return 0;
+}
@@ -0,0 +1,126 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "DPMBase.h"
+#include "Particles/BaseParticle.h"
+#include "Boundaries/PeriodicBoundary.h"
+#include "Species/LinearViscoelasticSpecies.h"
+#include "Logger.h"
+#include <cmath>
+
+/*!
+ * \brief Checks the ContactLifetimeStatistics for a head-on collision of two particles.
+ * \details The collision time is 0.01 and the time step 1e-5, so the contact 
+ * lasts about 1000 time steps, which is counted in the duration bin [512,1024).
+ * The impact velocity is the relative velocity of the particles (1), and the 
+ * maximum overlap is a small fraction of the radius. Since the contact is 
+ * resolved in many more than 50 time steps, checkTimeStep warns that the time
+ * step could be increased.
+ * 
+ * If isPeriodic is true, the particles move away from each other and collide 
+ * through a periodic boundary instead, so the contact is computed with a ghost
+ * particle, whose interactions are removed at every time step; it still has 
+ * to be counted as one contact with the same duration.
+ */
+class ContactLifetimeStatisticsUnitTest : public DPMBase
+{
+public:
+
+    ContactLifetimeStatisticsUnitTest(bool isPeriodic) : isPeriodic_(isPeriodic)
+    {
+    }
+
+    void setupInitialConditions()
+    {
+        setXMin(-1);
+        setYMin(-1);
+        setZMin(-1);
+        setXMax(1);
+        setYMax(1);
+        setZMax(1);
+
+        //without the periodic boundary, the particles are 0.25 apart and approach each other;
+        //with it, they are 0.25 apart through the boundary and move towards it
+        const Mdouble x = isPeriodic_ ? 0.875 : 0.125;
+        const Mdouble v = isPeriodic_ ? 0.5 : -0.5;
+        if (isPeriodic_)
+        {
+            PeriodicBoundary b;
+            b.set(Vec3D(1, 0, 0), getXMin(), getXMax());
+            boundaryHandler.copyAndAddObject(b);
+        }
+
+        BaseParticle p;
+        p.setSpecies(speciesHandler.getObject(0));
+        p.setRadius(0.1);
+        p.setPosition(Vec3D(-x, 0, 0));
+        p.setVelocity(Vec3D(-v, 0, 0));
+        particleHandler.copyAndAddObject(p);
+        p.setPosition(Vec3D(x, 0, 0));
+        p.setVelocity(Vec3D(v, 0, 0));
+        particleHandler.copyAndAddObject(p);
+    }
+
+private:
+    bool isPeriodic_;
+};
+
+void checkHeadOnCollision(bool isPeriodic)
+{
+    ContactLifetimeStatisticsUnitTest problem(isPeriodic);
+    problem.setName("ContactLifetimeStatisticsUnitTest");
+    auto species = problem.speciesHandler.copyAndAddObject(LinearViscoelasticSpecies());
+    species->setDensity(6.0 / constants::pi);
+    const Mdouble collisionTime = 0.01;
+    species->setCollisionTimeAndRestitutionCoefficient(collisionTime, 0.5, species->getMassFromRadius(0.1));
+    problem.setSystemDimensions(3);
+    problem.setTimeStep(1e-5);
+    problem.setTimeMax(0.1);
+    problem.setFileType(FileType::NO_FILE);
+    problem.interactionHandler.getContactLifetimeStatistics().setEnabled(true);
+    problem.solve();
+
+    const ContactLifetimeStatistics& statistics = problem.interactionHandler.getContactLifetimeStatistics();
+    const std::string collision = isPeriodic ? "periodic collision" : "collision";
+    if (statistics.getNumberOfContacts() != 1)
+        logger(FATAL, "%: % contacts ended instead of 1", collision, statistics.getNumberOfContacts());
+    if (std::abs(statistics.getMeanDuration() - collisionTime / problem.getTimeStep()) > 10)
+        logger(FATAL, "%: the contact lasted % time steps instead of %", collision, statistics.getMeanDuration(), collisionTime / problem.getTimeStep());
+    if (statistics.getDurationHistogram()[9] != 1)
+        logger(FATAL, "%: the contact is not counted in the duration bin [512,1024)", collision);
+    if (statistics.getDurationQuantile(0.05) != 512)
+        logger(FATAL, "%: the 5 percent quantile of the duration is % instead of 512", collision, statistics.getDurationQuantile(0.05));
+    if (std::abs(statistics.getMaximumImpactVelocity() - 1) > 1e-3)
+        logger(FATAL, "%: the impact velocity is % instead of 1", collision, statistics.getMaximumImpactVelocity());
+    if (statistics.getMaximumRelativeOverlap() <= 0 || statistics.getMaximumRelativeOverlap() > 0.1)
+        logger(FATAL, "%: the maximum overlap relative to the radius is %", collision, statistics.getMaximumRelativeOverlap());
+}
+
+int main(int argc UNUSED, char *argv[] UNUSED)
+{
+    checkHeadOnCollision(false);
+    checkHeadOnCollision(true);
+    return 0;
+}
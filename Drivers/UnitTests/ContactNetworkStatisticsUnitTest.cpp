@@ -0,0 +1,157 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "DPMBase.h"
+#include "Particles/BaseParticle.h"
+#include "Walls/InfiniteWall.h"
+#include "Boundaries/PeriodicBoundary.h"
+#include "Species/LinearViscoelasticSlidingFrictionSpecies.h"
+#include "Math/RNG.h"
+#include "Logger.h"
+#include <cmath>
+#include <sstream>
+
+/*!
+ * \brief Checks that the incrementally updated ContactNetworkStatistics agree
+ * with a direct count over all interactions.
+ * \details A small frictional packing with periodic boundaries in x and y 
+ * settles on a flat wall. After every time step, the number of 
+ * particle-particle, particle-wall and sliding contacts and the orientation 
+ * histogram are recounted from the InteractionHandler and compared to the 
+ * counters maintained by the ContactNetworkStatistics.
+ */
+class ContactNetworkStatisticsUnitTest : public DPMBase
+{
+public:
+
+    void setupInitialConditions()
+    {
+        setXMin(0);
+        setYMin(0);
+        setZMin(0);
+        setXMax(1);
+        setYMax(1);
+        setZMax(1);
+
+        PeriodicBoundary b;
+        b.set(Vec3D(1, 0, 0), getXMin(), getXMax());
+        boundaryHandler.copyAndAddObject(b);
+        b.set(Vec3D(0, 1, 0), getYMin(), getYMax());
+        boundaryHandler.copyAndAddObject(b);
+
+        InfiniteWall w;
+        w.setSpecies(speciesHandler.getObject(0));
+        w.set(Vec3D(0, 0, -1), Vec3D(0, 0, getZMin()));
+        wallHandler.copyAndAddObject(w);
+
+        RNG random;
+        BaseParticle p;
+        p.setSpecies(speciesHandler.getObject(0));
+        p.setRadius(0.1);
+        for (int i = 0; i < 5; i++)
+            for (int j = 0; j < 5; j++)
+                for (int k = 0; k < 4; k++)
+                {
+                    p.setPosition(Vec3D(0.1 + 0.2 * i, 0.1 + 0.2 * j, 0.1 + 0.21 * k));
+                    p.setVelocity(Vec3D(random.getRandomNumber(-0.1, 0.1), random.getRandomNumber(-0.1, 0.1), random.getRandomNumber(-0.1, 0.1)));
+                    particleHandler.copyAndAddObject(p);
+                }
+    }
+
+    void actionsAfterTimeStep()
+    {
+        const ContactNetworkStatistics& network = interactionHandler.getContactNetworkStatistics();
+        unsigned int numberOfParticleContacts = 0, numberOfWallContacts = 0, numberOfSlidingContacts = 0;
+        std::vector<unsigned int> histogram(network.getNumberOfBins(), 0);
+        for (BaseInteraction* i : interactionHandler)
+        {
+            if (dynamic_cast<BaseParticle*>(i->getI()) != nullptr)
+                numberOfParticleContacts++;
+            else
+                numberOfWallContacts++;
+            if (i->isSliding())
+                numberOfSlidingContacts++;
+            Mdouble angle = std::atan2(i->getNormal().Z, i->getNormal().X);
+            if (angle < 0)
+                angle += constants::pi;
+            histogram[std::min(static_cast<unsigned int>(angle / constants::pi * histogram.size()), static_cast<unsigned int>(histogram.size() - 1))]++;
+        }
+        
+        if (network.getNumberOfParticleContacts() != numberOfParticleContacts)
+            logger(FATAL, "t=%: % particle contacts counted, but % exist", getTime(), network.getNumberOfParticleContacts(), numberOfParticleContacts);
+        if (network.getNumberOfWallContacts() != numberOfWallContacts)
+            logger(FATAL, "t=%: % wall contacts counted, but % exist", getTime(), network.getNumberOfWallContacts(), numberOfWallContacts);
+        if (network.getNumberOfSlidingContacts() != numberOfSlidingContacts)
+            logger(FATAL, "t=%: % sliding contacts counted, but % exist", getTime(), network.getNumberOfSlidingContacts(), numberOfSlidingContacts);
+        for (unsigned int b = 0; b < histogram.size(); b++)
+            if (network.getOrientationHistogram()[b] != histogram[b])
+                logger(FATAL, "t=%: orientation bin % contains % contacts, but should contain %", getTime(), b, network.getOrientationHistogram()[b], histogram[b]);
+        
+        maximumNumberOfSlidingContacts = std::max(maximumNumberOfSlidingContacts, numberOfSlidingContacts);
+    }
+
+    unsigned int maximumNumberOfSlidingContacts = 0;
+};
+
+int main(int argc, char *argv[])
+{
+    ContactNetworkStatisticsUnitTest problem;
+    problem.setName("ContactNetworkStatisticsUnitTest");
+    auto species = problem.speciesHandler.copyAndAddObject(LinearViscoelasticSlidingFrictionSpecies());
+    species->setDensity(6.0 / constants::pi);
+    species->setCollisionTimeAndRestitutionCoefficient(0.01, 0.5, species->getMassFromRadius(0.1));
+    species->setSlidingStiffness(2.0 / 7.0 * species->getStiffness());
+    species->setSlidingFrictionCoefficient(0.2);
+    problem.setGravity(Vec3D(0, 0, -1));
+    problem.setSystemDimensions(3);
+    problem.setTimeStep(0.0005);
+    problem.setTimeMax(1.0);
+    problem.setSaveCount(100);
+    problem.setFileType(FileType::NO_FILE);
+    problem.interactionHandler.setContactNetworkStatisticsEnabled(true);
+    problem.solve(argc, argv);
+
+    if (problem.maximumNumberOfSlidingContacts == 0)
+        logger(FATAL, "No sliding contacts occurred, so the sliding counter has not been tested");
+
+    logger(INFO, "Final coordination number %, sliding fraction %",
+           problem.interactionHandler.getContactNetworkStatistics().getCoordinationNumber(problem.particleHandler.getNumberOfObjects()),
+           problem.interactionHandler.getContactNetworkStatistics().getSlidingFraction());
+
+    //reading the interactions from a restart file must not count them twice, and clearing them resets the counts
+    const ContactNetworkStatistics& network = problem.interactionHandler.getContactNetworkStatistics();
+    const unsigned int numberOfParticleContacts = network.getNumberOfParticleContacts();
+    const unsigned int numberOfWallContacts = network.getNumberOfWallContacts();
+    std::stringstream restart;
+    problem.interactionHandler.write(restart);
+    problem.interactionHandler.read(restart);
+    if (network.getNumberOfParticleContacts() != numberOfParticleContacts || network.getNumberOfWallContacts() != numberOfWallContacts)
+        logger(FATAL, "after reading the interactions, % particle and % wall contacts are counted instead of % and %",
+               network.getNumberOfParticleContacts(), network.getNumberOfWallContacts(), numberOfParticleContacts, numberOfWallContacts);
+    problem.interactionHandler.clear();
+    if (network.getNumberOfParticleContacts() != 0 || network.getNumberOfWallContacts() != 0 || network.getNumberOfSlidingContacts() != 0)
+        logger(FATAL, "the contact network statistics are not reset by InteractionHandler::clear");
+    return 0;
+}
@@ -0,0 +1,121 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "DPMBase.h"
+#include "Particles/BaseParticle.h"
+#include "Walls/Screw.h"
+#include "Walls/Coil.h"
+#include "Walls/HelixParameterTable.h"
+#include "Species/LinearViscoelasticSpecies.h"
+#include "Logger.h"
+#include <random>
+
+/*!
+ * \brief Checks that the warm-started and the tabulated Newton iterations of Screw and Coil find the same contacts as the default one.
+ * \details Particles move along short random paths near a rotating helical 
+ * wall. At each step, the distance and normal computed without initial guess 
+ * by the wall itself are compared with those of getInteractionWith, which 
+ * starts from the helix parameter of the last time step, and with those of a 
+ * copy of the wall that uses the tabulated initial guess.
+ */
+template<class Wall>
+unsigned int checkHelixWall(DPMBase& problem, Wall& wall, Wall& tabulatedWall, std::mt19937& generator)
+{
+    std::uniform_real_distribution<Mdouble> coordinate(-1.2, 1.2);
+    std::uniform_real_distribution<Mdouble> height(-0.2, 2.2);
+    std::uniform_real_distribution<Mdouble> velocity(-1.0, 1.0);
+    BaseParticle& p = *problem.particleHandler.getObject(0);
+    const Mdouble timeStep = 0.002;
+    unsigned int numberOfContacts = 0;
+    for (unsigned int path = 0; path < 2000; path++)
+    {
+        p.setPosition(Vec3D(coordinate(generator), coordinate(generator), height(generator)));
+        const Vec3D v(velocity(generator), velocity(generator), velocity(generator));
+        for (unsigned int step = 0; step < 20; step++)
+        {
+            p.move(v * timeStep);
+            wall.move_time(timeStep);
+            tabulatedWall.move_time(timeStep);
+            
+            Mdouble distance, tabulatedDistance;
+            Vec3D normal, tabulatedNormal;
+            const bool isInContact = wall.getDistanceAndNormal(p, distance, normal);
+            if (tabulatedWall.getDistanceAndNormal(p, tabulatedDistance, tabulatedNormal) != isInContact)
+                logger(FATAL, "%: the tabulated guess changes the contact of a particle at %", wall.getName(), p.getPosition());
+            BaseInteraction* c = wall.getInteractionWith(&p, path * 20 + step, &problem.interactionHandler);
+            if ((c != nullptr) != isInContact)
+                logger(FATAL, "%: the warm start changes the contact of a particle at %", wall.getName(), p.getPosition());
+            if (!isInContact)
+                continue;
+            numberOfContacts++;
+            if (std::abs(tabulatedDistance - distance) > 1e-10 || (tabulatedNormal - normal).getLength() > 1e-8)
+                logger(FATAL, "%: the tabulated guess gives distance % and normal % instead of % and % for a particle at %",
+                       wall.getName(), tabulatedDistance, tabulatedNormal, distance, normal, p.getPosition());
+            if (std::abs(c->getDistance() - distance) > 1e-10 || (c->getNormal() + normal).getLength() > 1e-8)
+                logger(FATAL, "%: the warm start gives distance % and normal % instead of % and % for a particle at %",
+                       wall.getName(), c->getDistance(), -c->getNormal(), distance, normal, p.getPosition());
+        }
+    }
+    return numberOfContacts;
+}
+
+int main(int argc UNUSED, char *argv[] UNUSED)
+{
+    DPMBase problem;
+    LinearViscoelasticSpecies species;
+    species.setDensity(1.0);
+    species.setStiffness(1.0);
+    problem.speciesHandler.copyAndAddObject(species);
+
+    BaseParticle particle;
+    particle.setSpecies(problem.speciesHandler.getObject(0));
+    particle.setRadius(0.15);
+    problem.particleHandler.copyAndAddObject(particle);
+
+    Screw screw(Vec3D(0, 0, 0), 2, 1, 2, 1, 0.05);
+    screw.setSpecies(problem.speciesHandler.getObject(0));
+    Screw* screwInHandler = problem.wallHandler.copyAndAddObject(screw);
+    Screw tabulatedScrew(screw);
+    tabulatedScrew.setUseTabulatedInitialGuess(true);
+
+    Coil coil(Vec3D(0, 0, 0), 2, 0.8, 3, 1, 0.05);
+    coil.setSpecies(problem.speciesHandler.getObject(0));
+    Coil* coilInHandler = problem.wallHandler.copyAndAddObject(coil);
+    Coil tabulatedCoil(coil);
+    tabulatedCoil.setUseTabulatedInitialGuess(true);
+
+    std::mt19937 generator(7);
+    const unsigned int screwContacts = checkHelixWall(problem, *screwInHandler, tabulatedScrew, generator);
+    const unsigned int coilContacts = checkHelixWall(problem, *coilInHandler, tabulatedCoil, generator);
+    if (screwContacts < 1000 || coilContacts < 1000)
+        logger(FATAL, "only % screw and % coil contacts were tested", screwContacts, coilContacts);
+    logger(INFO, "% screw and % coil contacts agree", screwContacts, coilContacts);
+
+    //the table covers the range of beta and gives a guess in smooth regions
+    const HelixParameterTable& table = HelixParameterTable::getCoilTable();
+    if (std::isnan(table.getPhase(1.0, 0.3)) || std::abs(table.getPhase(0.0, 0.3) - 0.3) > 1e-12)
+        logger(FATAL, "the coil table does not return the minimum of the parabola for kappa=0");
+    return 0;
+}
@@ -0,0 +1,139 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "DPMBase.h"
+#include "Walls/IntersectionOfWalls.h"
+#include "Walls/AxisymmetricIntersectionOfWalls.h"
+#include "Particles/BaseParticle.h"
+#include "Species/LinearViscoelasticSpecies.h"
+#include "Logger.h"
+#include <random>
+
+/*!
+ * \brief Returns the distance of a position outside the box [min,max] to the box and the normal pointing from the position to the box.
+ */
+Mdouble getDistanceToBox(const Vec3D& position, const Vec3D& min, const Vec3D& max, Vec3D& normal)
+{
+    const Vec3D closest(std::min(std::max(position.X, min.X), max.X),
+                        std::min(std::max(position.Y, min.Y), max.Y),
+                        std::min(std::max(position.Z, min.Z), max.Z));
+    normal = closest - position;
+    const Mdouble distance = normal.getLength();
+    normal /= distance;
+    return distance;
+}
+
+/*!
+ * \brief Compares the contacts of a cube [min,min+1]^3 with the exact distance for random positions outside the cube.
+ */
+void checkCube(const IntersectionOfWalls& cube, const Vec3D& min, Mdouble radius, std::mt19937& generator)
+{
+    std::uniform_real_distribution<Mdouble> coordinate(-1.0, 2.0);
+    const Vec3D max = min + Vec3D(1, 1, 1);
+    for (unsigned int n = 0; n < 100000; n++)
+    {
+        const Vec3D position = min + Vec3D(coordinate(generator), coordinate(generator), coordinate(generator));
+        if (position.X > min.X && position.X < max.X && position.Y > min.Y && position.Y < max.Y && position.Z > min.Z && position.Z < max.Z)
+            continue;
+        Vec3D exactNormal, normal;
+        const Mdouble exactDistance = getDistanceToBox(position, min, max, exactNormal);
+        Mdouble distance;
+        const bool isInContact = cube.getDistanceAndNormal(position, radius, distance, normal);
+        //positions at the edge of the interaction range may go either way due to rounding
+        if (std::abs(exactDistance - radius) < 1e-12)
+            continue;
+        if (isInContact != (exactDistance < radius))
+            logger(FATAL, "position % at distance % from the cube: contact is %", position, exactDistance, isInContact);
+        if (isInContact && !(std::abs(distance - exactDistance) <= 1e-12 && (normal - exactNormal).getLength() <= 1e-10))
+            logger(FATAL, "position %: distance % and normal % instead of % and %", position, distance, normal, exactDistance, exactNormal);
+    }
+}
+
+int main(int argc UNUSED, char *argv[] UNUSED)
+{
+    //a unit cube, whose walls are ordered such that walls 0, 1 and 2 meet in the vertex at the origin
+    IntersectionOfWalls cube;
+    cube.addObject(Vec3D(1, 0, 0), Vec3D(0, 0, 0));
+    cube.addObject(Vec3D(0, 1, 0), Vec3D(0, 0, 0));
+    cube.addObject(Vec3D(0, 0, 1), Vec3D(0, 0, 0));
+    cube.addObject(Vec3D(-1, 0, 0), Vec3D(1, 0, 0));
+    cube.addObject(Vec3D(0, -1, 0), Vec3D(0, 1, 0));
+    cube.addObject(Vec3D(0, 0, -1), Vec3D(0, 0, 1));
+
+    //the vertex contact has to be found for any order of the distances to the three walls
+    const Mdouble d[3] = {0.02, 0.03, 0.04};
+    const unsigned int permutations[6][3] = {{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+    for (const auto& permutation : permutations)
+    {
+        const Vec3D position(-d[permutation[0]], -d[permutation[1]], -d[permutation[2]]);
+        Mdouble distance;
+        Vec3D normal;
+        if (!cube.getDistanceAndNormal(position, 0.1, distance, normal) || !(std::abs(distance - position.getLength()) <= 1e-14))
+            logger(FATAL, "the distance of % to the vertex of the cube is % instead of %", position, distance, position.getLength());
+    }
+
+    std::mt19937 generator(3);
+    checkCube(cube, Vec3D(0, 0, 0), 0.1, generator);
+    //a larger interaction radius than before
+    checkCube(cube, Vec3D(0, 0, 0), 0.3, generator);
+    cube.move(Vec3D(3, -2, 1));
+    checkCube(cube, Vec3D(3, -2, 1), 0.2, generator);
+
+    //a ring with 1<r<2 and 0<z<0.5 around the z-axis; positions in the hole are not in contact
+    AxisymmetricIntersectionOfWalls ring;
+    ring.addObject(Vec3D(1, 0, 0), Vec3D(1, 0, 0));
+    ring.addObject(Vec3D(-1, 0, 0), Vec3D(2, 0, 0));
+    ring.addObject(Vec3D(0, 0, 1), Vec3D(0, 0, 0));
+    ring.addObject(Vec3D(0, 0, -1), Vec3D(0, 0, 0.5));
+    ring.setPosition(Vec3D(0, 0, 0));
+    ring.setOrientation(Vec3D(0, 0, 1));
+    DPMBase problem;
+    LinearViscoelasticSpecies species;
+    species.setDensity(1.0);
+    species.setStiffness(1.0);
+    problem.speciesHandler.copyAndAddObject(species);
+    BaseParticle p;
+    p.setSpecies(problem.speciesHandler.getObject(0));
+    p.setRadius(0.1);
+    std::uniform_real_distribution<Mdouble> coordinate(-2.5, 2.5);
+    for (unsigned int n = 0; n < 100000; n++)
+    {
+        p.setPosition(Vec3D(coordinate(generator), coordinate(generator), 0.25 * coordinate(generator)));
+        const Vec3D cylindrical(std::sqrt(p.getPosition().X * p.getPosition().X + p.getPosition().Y * p.getPosition().Y), 0.0, p.getPosition().Z);
+        if (cylindrical.X > 1 && cylindrical.X < 2 && cylindrical.Z > 0 && cylindrical.Z < 0.5)
+            continue;
+        Vec3D exactNormal, normal;
+        const Mdouble exactDistance = getDistanceToBox(cylindrical, Vec3D(1, -1, 0), Vec3D(2, 1, 0.5), exactNormal);
+        Mdouble distance;
+        const bool isInContact = ring.getDistanceAndNormal(p, distance, normal);
+        if (std::abs(exactDistance - p.getWallInteractionRadius()) < 1e-12)
+            continue;
+        if (isInContact != (exactDistance < p.getWallInteractionRadius()))
+            logger(FATAL, "position % at distance % from the ring: contact is %", p.getPosition(), exactDistance, isInContact);
+        if (isInContact && !(std::abs(distance - exactDistance) <= 1e-12))
+            logger(FATAL, "position %: distance % instead of %", p.getPosition(), distance, exactDistance);
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "DPMBase.h"
+#include "Particles/BaseParticle.h"
+#include "Walls/InfiniteWall.h"
+#include "Boundaries/PeriodicBoundary.h"
+#include "Species/LinearViscoelasticSpecies.h"
+#include "Logger.h"
+
+/*!
+ * \brief Checks the memory accounting for a few particles settling on a wall in a periodic box.
+ * \details Four of the eight particles are close to the periodic boundary, so
+ * during the time loop four ghost particles exist; they are removed at the end 
+ * of each time step, so only their peak memory usage remains. The memory used 
+ * by the particles has to grow by at least sizeof(BaseParticle) per added 
+ * particle, and no peak can be smaller than the current value.
+ */
+class MemoryUsageUnitTest : public DPMBase
+{
+public:
+
+    void setupInitialConditions()
+    {
+        setXMin(0);
+        setYMin(0);
+        setZMin(0);
+        setXMax(1);
+        setYMax(1);
+        setZMax(1);
+
+        InfiniteWall w;
+        w.setSpecies(speciesHandler.getObject(0));
+        w.set(Vec3D(0, 0, -1), Vec3D(0, 0, getZMin()));
+        wallHandler.copyAndAddObject(w);
+
+        PeriodicBoundary b;
+        b.set(Vec3D(1, 0, 0), getXMin(), getXMax());
+        boundaryHandler.copyAndAddObject(b);
+
+        BaseParticle p;
+        p.setSpecies(speciesHandler.getObject(0));
+        p.setRadius(0.1);
+        for (int i = 0; i < 2; i++)
+            for (int j = 0; j < 4; j++)
+            {
+                p.setPosition(Vec3D(0.05 + 0.5 * i, 0.125 + 0.25 * j, 0.1 + 0.05 * j));
+                particleHandler.copyAndAddObject(p);
+            }
+    }
+};
+
+int main(int argc UNUSED, char *argv[] UNUSED)
+{
+    MemoryUsageUnitTest problem;
+    problem.setName("MemoryUsageUnitTest");
+    auto species = problem.speciesHandler.copyAndAddObject(LinearViscoelasticSpecies());
+    species->setDensity(6.0 / constants::pi);
+    species->setCollisionTimeAndRestitutionCoefficient(0.01, 0.5, species->getMassFromRadius(0.1));
+    problem.setGravity(Vec3D(0, 0, -1));
+    problem.setSystemDimensions(3);
+    problem.setTimeStep(0.0005);
+    problem.setTimeMax(0.5);
+    problem.setSaveCount(100);
+    problem.setFileType(FileType::NO_FILE);
+    problem.memoryUsage.setEnabled(true);
+    problem.solve();
+
+    const MemoryUsage& memoryUsage = problem.memoryUsage;
+    if (memoryUsage.getBytes("particles") < 8 * sizeof(BaseParticle))
+        logger(FATAL, "the particles use % bytes, less than 8*sizeof(BaseParticle)", memoryUsage.getBytes("particles"));
+    if (memoryUsage.getBytes("ghostParticles") != 0)
+        logger(FATAL, "the ghost particles use % bytes after the time loop, instead of 0", memoryUsage.getBytes("ghostParticles"));
+    if (memoryUsage.getPeakBytes("ghostParticles") < 4 * sizeof(BaseParticle))
+        logger(FATAL, "the peak memory of the ghost particles is % bytes, less than 4*sizeof(BaseParticle)", memoryUsage.getPeakBytes("ghostParticles"));
+    if (memoryUsage.getPeakBytes("interactions") == 0)
+        logger(FATAL, "no memory was used by the interactions");
+    if (memoryUsage.getBytes("walls") == 0 || memoryUsage.getBytes("species") == 0 || memoryUsage.getBytes("boundaries") == 0)
+        logger(FATAL, "the walls, species or boundaries use no memory");
+    if (memoryUsage.getPeakTotalBytes() < memoryUsage.getTotalBytes())
+        logger(FATAL, "the peak total memory (% bytes) is smaller than the current total (% bytes)", memoryUsage.getPeakTotalBytes(), memoryUsage.getTotalBytes());
+    if (problem.particleHandler.getPeakMemoryUsage() < problem.particleHandler.getMemoryUsage())
+        logger(FATAL, "the peak memory of the particleHandler is smaller than its current memory");
+
+    //the memory of the particles grows with the number of particles
+    std::size_t particleBytes = problem.particleHandler.getMemoryUsage();
+    BaseParticle p;
+    p.setSpecies(problem.speciesHandler.getObject(0));
+    p.setRadius(0.1);
+    for (int i = 0; i < 8; i++)
+    {
+        p.setPosition(Vec3D(0.3, 0.125 + 0.1 * i, 0.5));
+        problem.particleHandler.copyAndAddObject(p);
+    }
+    if (problem.particleHandler.getMemoryUsage() < particleBytes + 8 * sizeof(BaseParticle))
+        logger(FATAL, "adding 8 particles increased the memory from % to % bytes only", particleBytes, problem.particleHandler.getMemoryUsage());
+    return 0;
+}
@@ -0,0 +1,134 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "DPMBase.h"
+#include "Particles/BaseParticle.h"
+#include "Walls/InfiniteWall.h"
+#include "Species/LinearViscoelasticSpecies.h"
+#include "Logger.h"
+#include <fstream>
+
+/*!
+ * \brief Checks the timings of the SolveProfiler for a few particles settling on a wall.
+ * \details The time of each phase has to be non-negative, the force computation 
+ * has to take some time, and the phases together cannot take longer than the 
+ * time loop. The file name.prof has to contain a header and one line per 
+ * saveCount time steps. If the hardware counters are available, they have to 
+ * count the instructions of the force computation; if not, the profiler still 
+ * has to measure the wall-clock times. If the profiler is disabled, no time is 
+ * measured.
+ */
+class SolveProfilerUnitTest : public DPMBase
+{
+public:
+
+    void setupInitialConditions()
+    {
+        setXMin(0);
+        setYMin(0);
+        setZMin(0);
+        setXMax(1);
+        setYMax(1);
+        setZMax(1);
+
+        InfiniteWall w;
+        w.setSpecies(speciesHandler.getObject(0));
+        w.set(Vec3D(0, 0, -1), Vec3D(0, 0, getZMin()));
+        wallHandler.copyAndAddObject(w);
+
+        BaseParticle p;
+        p.setSpecies(speciesHandler.getObject(0));
+        p.setRadius(0.1);
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++)
+            {
+                p.setPosition(Vec3D(0.125 + 0.25 * i, 0.125 + 0.25 * j, 0.1 + 0.05 * i));
+                particleHandler.copyAndAddObject(p);
+            }
+    }
+};
+
+int main(int argc UNUSED, char *argv[] UNUSED)
+{
+    SolveProfilerUnitTest problem;
+    problem.setName("SolveProfilerUnitTest");
+    auto species = problem.speciesHandler.copyAndAddObject(LinearViscoelasticSpecies());
+    species->setDensity(6.0 / constants::pi);
+    species->setCollisionTimeAndRestitutionCoefficient(0.01, 0.5, species->getMassFromRadius(0.1));
+    problem.setGravity(Vec3D(0, 0, -1));
+    problem.setSystemDimensions(3);
+    problem.setTimeStep(0.0005);
+    problem.setTimeMax(0.5);
+    problem.setSaveCount(100);
+    problem.setFileType(FileType::NO_FILE);
+    //the profile is written whenever the data file is
+    problem.dataFile.setFileType(FileType::ONE_FILE);
+    problem.profiler.setEnabled(true);
+    problem.solve();
+
+    Mdouble sum = 0;
+    for (unsigned int i = 0; i < static_cast<unsigned int>(SolvePhase::NUMBER_OF_PHASES); i++)
+    {
+        SolvePhase phase = static_cast<SolvePhase>(i);
+        if (problem.profiler.getTime(phase) < 0)
+            logger(FATAL, "the time spent in % is negative", SolveProfiler::getName(phase));
+        sum += problem.profiler.getTime(phase);
+    }
+    if (problem.profiler.getTime(SolvePhase::COMPUTE_ALL_FORCES) <= 0)
+        logger(FATAL, "no time was spent in computeAllForces");
+    if (sum > problem.profiler.getTimeLoopTime())
+        logger(FATAL, "the phases took % s, longer than the time loop (% s)", sum, problem.profiler.getTimeLoopTime());
+
+    //one line for the header and one for every data file output, i.e. every 100 of the 1000 time steps, including the first and the last
+    std::ifstream file("SolveProfilerUnitTest.prof");
+    std::string line;
+    unsigned int numberOfLines = 0;
+    while (std::getline(file, line))
+        numberOfLines++;
+    if (numberOfLines != 12)
+        logger(FATAL, "SolveProfilerUnitTest.prof contains % lines instead of 12", numberOfLines);
+
+    //the hardware counters are optional: if they are available, the force computation has to execute instructions
+    problem.profiler.setHardwareCountersEnabled(true);
+    problem.solve();
+    if (HardwareCounters::getThreadCounters().isAvailable(HardwareCounter::INSTRUCTIONS))
+    {
+        if (problem.profiler.getCount(SolvePhase::COMPUTE_ALL_FORCES, HardwareCounter::INSTRUCTIONS) == 0)
+            logger(FATAL, "no instructions were counted in computeAllForces");
+        if (problem.profiler.getNumberOfCountedThreads() != 1)
+            logger(FATAL, "counts were recorded for % threads instead of 1", problem.profiler.getNumberOfCountedThreads());
+    }
+    else if (problem.profiler.getNumberOfCountedThreads() != 0)
+    {
+        logger(FATAL, "counts were recorded although the hardware counters are not available");
+    }
+    problem.profiler.setHardwareCountersEnabled(false);
+
+    problem.profiler.setEnabled(false);
+    problem.solve();
+    if (problem.profiler.getTime(SolvePhase::COMPUTE_ALL_FORCES) != 0)
+        logger(FATAL, "the disabled profiler measured % s in computeAllForces", problem.profiler.getTime(SolvePhase::COMPUTE_ALL_FORCES));
+    return 0;
+}
@@ -0,0 +1,123 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "DPMBase.h"
+#include "Particles/BaseParticle.h"
+#include "Walls/InfiniteWall.h"
+#include "Boundaries/PeriodicBoundary.h"
+#include "Species/LinearViscoelasticSpecies.h"
+#include "Logger.h"
+#include <fstream>
+#include <thread>
+
+/*!
+ * \brief Checks the telemetry file for a few particles settling on a wall in a periodic box.
+ * \details Each time step takes at least 0.1 ms (see actionsAfterTimeStep), so
+ * with an interval of 5 ms, the 200 time steps are reported in a few lines, 
+ * plus the final line. Each line has to be a JSON object with all fields; the
+ * final line has to report the real particles, the ghost particles (which are 
+ * removed at the end of the time step, so there are none) and a zero eta.
+ */
+class TelemetryUnitTest : public DPMBase
+{
+public:
+
+    void setupInitialConditions()
+    {
+        setXMin(0);
+        setYMin(0);
+        setZMin(0);
+        setXMax(1);
+        setYMax(1);
+        setZMax(1);
+
+        InfiniteWall w;
+        w.setSpecies(speciesHandler.getObject(0));
+        w.set(Vec3D(0, 0, -1), Vec3D(0, 0, getZMin()));
+        wallHandler.copyAndAddObject(w);
+
+        PeriodicBoundary b;
+        b.set(Vec3D(1, 0, 0), getXMin(), getXMax());
+        boundaryHandler.copyAndAddObject(b);
+
+        BaseParticle p;
+        p.setSpecies(speciesHandler.getObject(0));
+        p.setRadius(0.1);
+        for (int i = 0; i < 2; i++)
+            for (int j = 0; j < 4; j++)
+            {
+                p.setPosition(Vec3D(0.05 + 0.5 * i, 0.125 + 0.25 * j, 0.1 + 0.05 * j));
+                particleHandler.copyAndAddObject(p);
+            }
+    }
+
+    void actionsAfterTimeStep()
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+};
+
+int main(int argc UNUSED, char *argv[] UNUSED)
+{
+    TelemetryUnitTest problem;
+    problem.setName("TelemetryUnitTest");
+    auto species = problem.speciesHandler.copyAndAddObject(LinearViscoelasticSpecies());
+    species->setDensity(6.0 / constants::pi);
+    species->setCollisionTimeAndRestitutionCoefficient(0.01, 0.5, species->getMassFromRadius(0.1));
+    problem.setGravity(Vec3D(0, 0, -1));
+    problem.setSystemDimensions(3);
+    problem.setTimeStep(0.0005);
+    problem.setTimeMax(0.1);
+    problem.setSaveCount(100);
+    problem.setFileType(FileType::NO_FILE);
+    problem.telemetry.setEnabled(true);
+    problem.telemetry.setInterval(0.005);
+    problem.solve();
+
+    std::ifstream file("TelemetryUnitTest.telemetry");
+    std::string line, lastLine;
+    unsigned int numberOfLines = 0;
+    const char* fields[] = {"\"time\":", "\"wallTime\":", "\"stepsPerSecond\":", "\"particleStepsPerSecond\":",
+                            "\"particles\":", "\"ghosts\":", "\"contacts\":", "\"memoryBytes\":", "\"eta\":"};
+    while (std::getline(file, line))
+    {
+        numberOfLines++;
+        if (line.front() != '{' || line.back() != '}')
+            logger(FATAL, "line % is not a JSON object: %", numberOfLines, line);
+        for (const char* field : fields)
+        {
+            if (line.find(field) == std::string::npos)
+                logger(FATAL, "line % does not contain %", numberOfLines, field);
+        }
+        lastLine = line;
+    }
+    //the 200 time steps take at least 20 ms, so there are at least 4 intervals of 5 ms, plus the final line
+    if (numberOfLines < 3 || numberOfLines > 201)
+        logger(FATAL, "TelemetryUnitTest.telemetry contains % lines", numberOfLines);
+    if (lastLine.find("\"timeSteps\":200,") == std::string::npos || lastLine.find("\"particles\":8,") == std::string::npos
+        || lastLine.find("\"ghosts\":0,") == std::string::npos || lastLine.find("\"eta\":0}") == std::string::npos)
+        logger(FATAL, "unexpected final line %", lastLine);
+    return 0;
+}
@@ -0,0 +1,184 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "DPMBase.h"
+#include "Particles/BaseParticle.h"
+#include "Walls/TriangulatedWall.h"
+#include "Species/LinearViscoelasticSpecies.h"
+#include "Logger.h"
+#include <cstdint>
+#include <fstream>
+#include <random>
+
+/*!
+ * \brief Checks the contacts of a triangulated cube with particles outside it.
+ * \details A unit cube is triangulated (12 triangles); for particles at random
+ * positions outside the cube, the contacts, including those with its edges 
+ * and vertices, have to agree with the exact closest point of the cube, which 
+ * is the position clamped to the cube. This is repeated for the cube read from
+ * an ASCII and a binary STL file, after the cube has been rotated and moved, 
+ * and after a restart.
+ */
+
+///The 8 vertices of the cube [-0.5,0.5]^3
+Vec3D vertex(unsigned int i)
+{
+    return Vec3D((i & 1) ? 0.5 : -0.5, (i & 2) ? 0.5 : -0.5, (i & 4) ? 0.5 : -0.5);
+}
+
+///The 12 triangles of the cube, as indices of the vertices
+const unsigned int triangles[12][3] = {{0, 1, 3}, {0, 3, 2}, {4, 7, 5}, {4, 6, 7}, {0, 5, 1}, {0, 4, 5},
+                                       {2, 3, 7}, {2, 7, 6}, {0, 2, 6}, {0, 6, 4}, {1, 5, 7}, {1, 7, 3}};
+
+void writeASCII(const std::string& fileName)
+{
+    std::ofstream file(fileName.c_str());
+    file << "solid cube\n";
+    for (const auto& t : triangles)
+    {
+        file << "  facet normal 0 0 0\n    outer loop\n";
+        for (unsigned int i : t)
+            file << "      vertex " << vertex(i) << "\n";
+        file << "    endloop\n  endfacet\n";
+    }
+    file << "endsolid cube\n";
+}
+
+void writeBinary(const std::string& fileName)
+{
+    std::ofstream file(fileName.c_str(), std::ios::binary);
+    char header[80] = "binary cube";
+    file.write(header, 80);
+    uint32_t n = 12;
+    file.write(reinterpret_cast<const char*>(&n), 4);
+    for (const auto& t : triangles)
+    {
+        float data[12] = {0, 0, 0};
+        for (unsigned int i = 0; i < 3; i++)
+        {
+            data[3 + 3 * i] = vertex(t[i]).X;
+            data[4 + 3 * i] = vertex(t[i]).Y;
+            data[5 + 3 * i] = vertex(t[i]).Z;
+        }
+        file.write(reinterpret_cast<const char*>(data), sizeof(data));
+        uint16_t attribute = 0;
+        file.write(reinterpret_cast<const char*>(&attribute), 2);
+    }
+}
+
+/*!
+ * \brief Compares the contacts of the wall to the exact ones for particles at random positions outside the cube.
+ * \param[in] rotation The rotation of the cube.
+ * \param[in] shift The position of the centre of the cube.
+ */
+void compare(DPMBase& problem, const BaseWall& mesh, const Matrix3D& rotation, const Vec3D& shift)
+{
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<Mdouble> coordinate(-1.0, 1.0);
+    BaseParticle& p = *problem.particleHandler.getObject(0);
+    unsigned int numberOfContacts = 0;
+    for (unsigned int n = 0; n < 20000; n++)
+    {
+        Vec3D x(coordinate(generator), coordinate(generator), coordinate(generator));
+        if (std::abs(x.X) < 0.5 && std::abs(x.Y) < 0.5 && std::abs(x.Z) < 0.5)
+            continue;
+        p.setPosition(rotation * x + shift);
+        Vec3D closestPoint(std::min(std::max(x.X, -0.5), 0.5), std::min(std::max(x.Y, -0.5), 0.5), std::min(std::max(x.Z, -0.5), 0.5));
+        Mdouble exactDistance = Vec3D::getDistance(closestPoint, x);
+        Vec3D exactNormal = rotation * (closestPoint - x) / exactDistance;
+        Mdouble distance;
+        Vec3D normal;
+        bool isContact = mesh.getDistanceAndNormal(p, distance, normal);
+        if (isContact != (exactDistance < p.getWallInteractionRadius()))
+            logger(FATAL, "at % (distance %), the TriangulatedWall % a contact", x, exactDistance, isContact ? "detects" : "does not detect");
+        if (!isContact)
+            continue;
+        numberOfContacts++;
+        if (std::abs(distance - exactDistance) > 1e-10 || !normal.isEqualTo(exactNormal, 1e-10))
+            logger(FATAL, "at %, the TriangulatedWall has distance % and normal % instead of % and %",
+                   x, distance, normal, exactDistance, exactNormal);
+    }
+    if (numberOfContacts < 1000)
+        logger(FATAL, "only % contacts were tested", numberOfContacts);
+}
+
+int main(int argc UNUSED, char *argv[] UNUSED)
+{
+    DPMBase problem;
+    LinearViscoelasticSpecies species;
+    species.setDensity(1.0);
+    species.setStiffness(1.0);
+    problem.speciesHandler.copyAndAddObject(species);
+    BaseParticle particle;
+    particle.setSpecies(problem.speciesHandler.getObject(0));
+    particle.setRadius(0.3);
+    problem.particleHandler.copyAndAddObject(particle);
+
+    TriangulatedWall mesh;
+    mesh.setSpecies(problem.speciesHandler.getObject(0));
+    for (const auto& t : triangles)
+        mesh.addTriangle(vertex(t[0]), vertex(t[1]), vertex(t[2]));
+
+    const Matrix3D identity(1, 0, 0, 0, 1, 0, 0, 0, 1);
+    compare(problem, mesh, identity, Vec3D(0, 0, 0));
+
+    writeASCII("TriangulatedWallUnitTest_ascii.stl");
+    TriangulatedWall ascii;
+    ascii.setSpecies(problem.speciesHandler.getObject(0));
+    ascii.readSTL("TriangulatedWallUnitTest_ascii.stl");
+    writeBinary("TriangulatedWallUnitTest_binary.stl");
+    TriangulatedWall binary;
+    binary.setSpecies(problem.speciesHandler.getObject(0));
+    binary.readSTL("TriangulatedWallUnitTest_binary.stl");
+    if (ascii.getNumberOfTriangles() != 12 || binary.getNumberOfTriangles() != 12)
+        logger(FATAL, "read % triangles from the ASCII and % from the binary STL file instead of 12",
+               ascii.getNumberOfTriangles(), binary.getNumberOfTriangles());
+    compare(problem, ascii, identity, Vec3D(0, 0, 0));
+    compare(problem, binary, identity, Vec3D(0, 0, 0));
+
+    //rotate the mesh by 30 degrees around (1,1,0) and move it
+    const Vec3D axis = Vec3D(1, 1, 0) / std::sqrt(2.0);
+    const Mdouble angle = constants::pi / 6.0;
+    const Vec3D shift(1, 2, 3);
+    mesh.setOrientation(angle * axis);
+    mesh.setPosition(shift);
+    Mdouble s = std::sin(angle), c = 1.0 - std::cos(angle);
+    const Matrix3D rotation = identity + Matrix3D(0, -axis.Z, axis.Y, axis.Z, 0, -axis.X, -axis.Y, axis.X, 0) * s
+                              + Matrix3D::dyadic(axis, axis) * c - identity * (Vec3D::dot(axis, axis) * c);
+    compare(problem, mesh, rotation, shift);
+
+    //a restart keeps the triangles, position and orientation
+    std::stringstream restart;
+    restart.precision(17);
+    mesh.write(restart);
+    std::string type;
+    TriangulatedWall restarted;
+    restart >> type >> restarted;
+    restarted.setSpecies(problem.speciesHandler.getObject(0));
+    if (restarted.getNumberOfTriangles() != 12)
+        logger(FATAL, "the restarted wall has % triangles instead of 12", restarted.getNumberOfTriangles());
+    compare(problem, restarted, rotation, shift);
+    return 0;
+}
@@ -0,0 +1,153 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "DPMBase.h"
+#include "Particles/BaseParticle.h"
+#include "Walls/InfiniteWall.h"
+#include "Walls/IntersectionOfWalls.h"
+#include "Walls/AxisymmetricIntersectionOfWalls.h"
+#include "Walls/Screw.h"
+#include "Walls/Coil.h"
+#include "Species/LinearViscoelasticSpecies.h"
+#include "Logger.h"
+#include <algorithm>
+#include <random>
+
+/*!
+ * \brief Checks that WallHandler::getCandidateWalls returns every wall a particle interacts with.
+ * \details Particles of different sizes are placed at random around a cube, 
+ * an unbounded prism, two axisymmetric rings, a screw, a coil and an infinite 
+ * wall. Every wall for which getDistanceAndNormal detects an interaction has to
+ * be among the candidate walls, which have to be in the order of the 
+ * WallHandler, while most bounded walls have to be filtered out. This is 
+ * checked again after the cube is moved and after a larger particle appears.
+ */
+unsigned int checkCandidateWalls(DPMBase& problem, std::mt19937& generator, Mdouble maxRadius)
+{
+    std::uniform_real_distribution<Mdouble> coordinate(-2.0, 8.0);
+    std::uniform_real_distribution<Mdouble> radius(0.05, maxRadius);
+    BaseParticle& p = *problem.particleHandler.getObject(0);
+    unsigned int numberOfCandidates = 0;
+    for (unsigned int n = 0; n < 20000; n++)
+    {
+        p.setRadius(radius(generator));
+        p.setPosition(Vec3D(coordinate(generator), coordinate(generator), coordinate(generator)));
+        const std::vector<BaseWall*>& candidates = problem.wallHandler.getCandidateWalls(p);
+        numberOfCandidates += candidates.size();
+        for (unsigned int i = 1; i < candidates.size(); i++)
+        {
+            if (candidates[i - 1]->getIndex() >= candidates[i]->getIndex())
+                logger(FATAL, "the candidate walls are not in the order of the WallHandler");
+        }
+        for (BaseWall* wall : problem.wallHandler)
+        {
+            Mdouble distance;
+            Vec3D normal;
+            if (wall->getDistanceAndNormal(p, distance, normal) && std::find(candidates.begin(), candidates.end(), wall) == candidates.end())
+                logger(FATAL, "particle at % with radius % interacts with wall % (%), which is not a candidate",
+                       p.getPosition(), p.getRadius(), wall->getIndex(), wall->getName());
+        }
+    }
+    return numberOfCandidates;
+}
+
+int main(int argc UNUSED, char *argv[] UNUSED)
+{
+    DPMBase problem;
+    LinearViscoelasticSpecies species;
+    species.setDensity(1.0);
+    species.setStiffness(1.0);
+    problem.speciesHandler.copyAndAddObject(species);
+
+    //a cube (the normals point into the wall)
+    IntersectionOfWalls cube;
+    cube.setSpecies(problem.speciesHandler.getObject(0));
+    cube.addObject(Vec3D(1, 0, 0), Vec3D(0, 0, 0));
+    cube.addObject(Vec3D(-1, 0, 0), Vec3D(1, 0, 0));
+    cube.addObject(Vec3D(0, 1, 0), Vec3D(0, 0, 0));
+    cube.addObject(Vec3D(0, -1, 0), Vec3D(0, 1, 0));
+    cube.addObject(Vec3D(0, 0, 1), Vec3D(0, 0, 0));
+    cube.addObject(Vec3D(0, 0, -1), Vec3D(0, 0, 1));
+    IntersectionOfWalls* cubeInHandler = problem.wallHandler.copyAndAddObject(cube);
+
+    //a triangular prism along z, which is unbounded
+    IntersectionOfWalls prism;
+    prism.setSpecies(problem.speciesHandler.getObject(0));
+    prism.createPrism({Vec3D(4, 4, 0), Vec3D(5, 4, 0), Vec3D(4, 5, 0)}, Vec3D(0, 0, 1));
+    problem.wallHandler.copyAndAddObject(prism);
+
+    //rings with 1<r<2 and 0<z<0.5 around a vertical and a tilted axis
+    AxisymmetricIntersectionOfWalls ring;
+    ring.setSpecies(problem.speciesHandler.getObject(0));
+    ring.addObject(Vec3D(1, 0, 0), Vec3D(1, 0, 0));
+    ring.addObject(Vec3D(-1, 0, 0), Vec3D(2, 0, 0));
+    ring.addObject(Vec3D(0, 0, 1), Vec3D(0, 0, 0));
+    ring.addObject(Vec3D(0, 0, -1), Vec3D(0, 0, 0.5));
+    ring.setPosition(Vec3D(5, 1, 5));
+    ring.setOrientation(Vec3D(0, 0, 1));
+    problem.wallHandler.copyAndAddObject(ring);
+    ring.setPosition(Vec3D(2, 5, 2));
+    ring.setOrientation(Vec3D(1, 1, 1) / std::sqrt(3.0));
+    problem.wallHandler.copyAndAddObject(ring);
+
+    Screw screw(Vec3D(6, 6, 0), 3, 1, 2, 0, 0.1);
+    screw.setSpecies(problem.speciesHandler.getObject(0));
+    problem.wallHandler.copyAndAddObject(screw);
+
+    Coil coil(Vec3D(1, 6, 5), 2, 0.8, 3, 0, 0.05);
+    coil.setSpecies(problem.speciesHandler.getObject(0));
+    problem.wallHandler.copyAndAddObject(coil);
+
+    InfiniteWall floor;
+    floor.setSpecies(problem.speciesHandler.getObject(0));
+    floor.set(Vec3D(0, 0, -1), Vec3D(0, 0, -1));
+    problem.wallHandler.copyAndAddObject(floor);
+
+    BaseParticle particle;
+    particle.setSpecies(problem.speciesHandler.getObject(0));
+    particle.setRadius(0.1);
+    problem.particleHandler.copyAndAddObject(particle);
+
+    std::mt19937 generator(42);
+    unsigned int numberOfCandidates = checkCandidateWalls(problem, generator, 0.2);
+    const WallBoundingVolumeHierarchy& hierarchy = problem.wallHandler.getBoundingVolumeHierarchy();
+    if (hierarchy.getNumberOfBoundedWalls() != 5 || hierarchy.getNumberOfNodes() != 9)
+        logger(FATAL, "the hierarchy has % bounded walls and % nodes instead of 5 and 9",
+               hierarchy.getNumberOfBoundedWalls(), hierarchy.getNumberOfNodes());
+    //the prism and the infinite wall are candidates for every particle, the bounded walls rarely
+    if (numberOfCandidates > 2.2 * 20000)
+        logger(FATAL, "% candidate walls for 20000 particles; the bounded walls are not filtered", numberOfCandidates);
+
+    //move the cube to where no particle was near it before
+    cubeInHandler->move(Vec3D(3, 0, 3));
+    problem.wallHandler.updateBoundingVolumes();
+    checkCandidateWalls(problem, generator, 0.2);
+
+    //larger particles rebuild the hierarchy for their interaction radius
+    checkCandidateWalls(problem, generator, 0.6);
+    if (hierarchy.getWallInteractionRadius() < 0.55)
+        logger(FATAL, "the hierarchy was not rebuilt for the larger particles");
+    return 0;
+}
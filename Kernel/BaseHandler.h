@@ -99,10 +99,16 @@ public:
      */
     void removeLastObject();
 
+    /*!
+     * \brief Rearranges the Objects, such that the Object at index order[i] moves to index i.
+     */
+    void reorderObjects(const std::vector<unsigned int>& order);
+
     /*!
      * \brief Empties the whole BaseHandler by removing all Objects and setting all other variables to 0.
+     * \details Virtual, such that #read also resets the variables of derived handlers.
      */
-    void clear();
+    virtual void clear();
 
     /*!
      * \brief Reads Object into the BaseHandler from restart data.
@@ -155,6 +161,16 @@ public:
      */
     void setStorageCapacity(const unsigned int N);
 
+    /*!
+     * \brief Gets the number of bytes used by this BaseHandler and the Objects in it.
+     */
+    virtual std::size_t getMemoryUsage() const;
+
+    /*!
+     * \brief Gets the largest number of bytes returned by getMemoryUsage since the last call to clear.
+     */
+    std::size_t getPeakMemoryUsage() const;
+
     /*!
      * \brief Gets the begin of the const_iterator over all Object in this BaseHandler.
      */
@@ -203,6 +219,11 @@ protected:
      * of these objects.
      */
     std::vector<T*> objects_;    
+
+    /*!
+     * \brief Updates the peak memory usage and returns the given number of bytes.
+     */
+    std::size_t recordMemoryUsage(std::size_t memoryUsage) const;
     
 private:
     /*!
@@ -210,6 +231,11 @@ private:
      */
     unsigned int maxObjects_;
 
+    /*!
+     * \brief The largest number of bytes returned by getMemoryUsage
+     */
+    mutable std::size_t peakMemoryUsage_;
+
     /*!
      * \brief identifier for next object created
      */
@@ -355,6 +381,38 @@ template<class T> void BaseHandler<T>::removeLastObject()
     objects_.pop_back();
 }
 
+/*!
+ * \param[in] order A permutation of the indices 0 to getNumberOfObjects()-1.
+ * \details The Objects are not copied; only the vector of pointers is 
+ *          rearranged, and each Object is told its new index via moveInHandler.
+ *          The ids of the Objects do not change.
+ */
+template<class T> void BaseHandler<T>::reorderObjects(const std::vector<unsigned int>& order)
+{
+    if (order.size() != getNumberOfObjects())
+    {
+        logger(ERROR, "In: void %::reorderObjects, the order has % entries, but there are % objects", getName(), order.size(), getNumberOfObjects());
+        return;
+    }
+    std::vector<T*> objects(objects_.size(), nullptr);
+    std::vector<bool> isMoved(objects_.size(), false);
+    for (unsigned int i = 0; i < order.size(); i++)
+    {
+        if (order[i] >= objects_.size() || isMoved[order[i]])
+        {
+            logger(ERROR, "In: void %::reorderObjects, the order is not a permutation", getName());
+            return;
+        }
+        isMoved[order[i]] = true;
+        objects[i] = objects_[order[i]];
+    }
+    objects_.swap(objects);
+    for (unsigned int i = 0; i < objects_.size(); i++)
+    {
+        objects_[i]->moveInHandler(i);
+    }
+}
+
 ///Delete all objects stored in objects_ and set the maximum number of objects that
 ///have been in this container to 0, and set the Id of the next object that will be added to 0.
 template<class T> void BaseHandler<T>::clear()
@@ -368,6 +426,7 @@ template<class T> void BaseHandler<T>::clear()
     
     nextId_ = 0;
     maxObjects_ = 0;
+    peakMemoryUsage_ = 0;
 }
 
 /// \param[in] is The input stream from which the information is read.
@@ -478,6 +537,41 @@ template<class T> void BaseHandler<T>::setStorageCapacity(const unsigned int N)
     objects_.reserve(N);
 }
 
+/*!
+ * \details The memory usage consists of the vector of pointers and the memory 
+ *          used by each Object, see BaseObject::getMemoryUsage. The size of the 
+ *          handler itself is not counted.
+ * \return The number of bytes used by this BaseHandler.
+ */
+template<class T> std::size_t BaseHandler<T>::getMemoryUsage() const
+{
+    std::size_t memoryUsage = objects_.capacity() * sizeof(T*);
+    for (const T* object : objects_)
+    {
+        memoryUsage += object->getMemoryUsage();
+    }
+    return recordMemoryUsage(memoryUsage);
+}
+
+/*!
+ * \details The peak is only updated when getMemoryUsage is called, e.g. when 
+ *          DPMBase::computeMemoryUsage samples the memory usage.
+ * \return The largest number of bytes returned by getMemoryUsage.
+ */
+template<class T> std::size_t BaseHandler<T>::getPeakMemoryUsage() const
+{
+    return peakMemoryUsage_;
+}
+
+///\param[in] memoryUsage The number of bytes currently used by this BaseHandler.
+///\return The given number of bytes.
+template<class T> std::size_t BaseHandler<T>::recordMemoryUsage(std::size_t memoryUsage) const
+{
+    if (memoryUsage > peakMemoryUsage_)
+        peakMemoryUsage_ = memoryUsage;
+    return memoryUsage;
+}
+
 ///\return A const_iterator pointing to the first Object.
 template<class T> const typename std::vector<T*>::const_iterator BaseHandler<T>::begin() const
 {
@@ -337,6 +337,24 @@ const std::list<BaseInteraction*>& BaseInteractable::getInteractions() const
     return interactions_;
 }
 
+/*!
+ * \return The size of a BaseInteractable plus the memory used by its list of interactions.
+ */
+std::size_t BaseInteractable::getMemoryUsage() const
+{
+    return sizeof(BaseInteractable) + getInteractionListMemoryUsage();
+}
+
+/*!
+ * \details Each node of the std::list stores the pointer to the interaction and 
+ *          the pointers to the previous and next node.
+ * \return The memory used by the list of interactions.
+ */
+std::size_t BaseInteractable::getInteractionListMemoryUsage() const
+{
+    return interactions_.size() * 3 * sizeof(void*);
+}
+
 /*!
  * \details Added a new interactions to the current interactable. 
  * \param[in] I Pointer to the new interaction which is to be added to the list
@@ -579,6 +597,15 @@ void BaseInteractable::applyPrescribedAngularVelocity(double time)
     }
 }
 
+/*!
+ * \return True if any of the prescribed position, velocity, orientation or 
+ *         angular velocity functions has been set.
+ */
+bool BaseInteractable::hasPrescribedMotion() const
+{
+    return prescribedPosition_ || prescribedVelocity_ || prescribedOrientation_ || prescribedAngularVelocity_;
+}
+
 /*!
  * \details This does not first part of verlet integration but for objects with
  *          an infinite mass i.e. there motion is prescribed and not calculated 
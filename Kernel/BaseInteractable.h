@@ -164,6 +164,16 @@ public:
      */
     const std::list<BaseInteraction*>& getInteractions() const;
 
+    /*!
+     * \brief Returns the number of bytes used by this BaseInteractable, including its list of interactions.
+     */
+    std::size_t getMemoryUsage() const override;
+
+    /*!
+     * \brief Returns the number of bytes used by the list of interactions (not by the interactions themselves).
+     */
+    std::size_t getInteractionListMemoryUsage() const;
+
     /*!
      * \brief Adds an interaction to this BaseInteractable.
      */
@@ -258,6 +268,12 @@ public:
      */
     void applyPrescribedAngularVelocity(double time);
 
+    /*!
+     * \brief Returns whether the position, velocity, orientation or angular 
+     *        velocity of this interactable is prescribed.
+     */
+    bool hasPrescribedMotion() const;
+
     /*!
      * \brief Returns the interaction between this object and a given 
      *        BaseParticle
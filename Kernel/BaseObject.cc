@@ -100,6 +100,15 @@ void BaseObject::setId(const unsigned int id)
     id_ = id;
     ///\todo TW: here we should update BaseHandler::nextId_
 }
+/*!
+ * \details Derived classes override this function to add their own size and 
+ *          the memory they allocate.
+ * \return The size of a BaseObject.
+ */
+std::size_t BaseObject::getMemoryUsage() const
+{
+    return sizeof(BaseObject);
+}
 /*!
  * \return index_
  */
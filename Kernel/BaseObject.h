@@ -27,6 +27,7 @@
 #define BASEOBJECT_H
 
 #include <iostream>
+#include <cstddef>
 
 class BaseObject;
 
@@ -87,6 +88,11 @@ public:
      */
     virtual void moveInHandler(const unsigned int index);
 
+    /*!
+     * \brief Returns the number of bytes used by this object, including the memory it allocates.
+     */
+    virtual std::size_t getMemoryUsage() const;
+
     /*!
      * \brief Allows one to assign an index to an object in the handler/container.
      */
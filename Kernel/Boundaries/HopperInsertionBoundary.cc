@@ -183,17 +183,19 @@ BaseParticle* HopperInsertionBoundary::generateParticle(RNG &random)
     P->setRadius(random.getRandomNumber(radMin_, radMax_));
     
     //Define an orthogonal coordinate system this is useful in the hopper, see 
-    //diagram in html documentation for details.
-    static Mdouble s = sin(chuteAngle_);
-    static Mdouble c = cos(chuteAngle_);
-    static Mdouble Ht = tan(hopperAngle_);
-    static Mdouble Hc = cos(hopperAngle_);
-    static Vec3D AB = Vec3D(c, 0.0, s);
-    static Vec3D AC = Vec3D(-s, 0.0, c);
-    static Vec3D AD = Vec3D(0.0, 1.0, 0.0);
+    //diagram in html documentation for details. These are computed for every 
+    //particle from the settings of this boundary, as other boundaries (or 
+    //simulations running in other threads) have other settings.
+    const Mdouble s = sin(chuteAngle_);
+    const Mdouble c = cos(chuteAngle_);
+    const Mdouble Ht = tan(hopperAngle_);
+    const Mdouble Hc = cos(hopperAngle_);
+    const Vec3D AB = Vec3D(c, 0.0, s);
+    const Vec3D AC = Vec3D(-s, 0.0, c);
+    const Vec3D AD = Vec3D(0.0, 1.0, 0.0);
     
     //Point A is located in the centre of the hopper.
-    static Vec3D A = Vec3D(isHopperCentred__ ? 40 : 0.0,    /// Bram: Where does the '40' come from??
+    const Vec3D A = Vec3D(isHopperCentred__ ? 40 : 0.0,    /// Bram: Where does the '40' come from??
             (yMax_ - yMin_) / 2.0,
             s * (-0.5 * (hopperLength_ - hopperExitLength_)) + c * hopperHeight_)
             + AB * 0.5 * hopperLength_
@@ -0,0 +1,108 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "CandidateBatch.h"
+#include "Particles/BaseParticle.h"
+
+///The relative tolerance of the overlap test, see CandidateBatch
+static const Mdouble overlapTolerance = 1.0 + 1e-12;
+
+CandidateBatch::CandidateBatch()
+{
+    size_ = 0;
+}
+
+/*!
+ * \param[in] p The particle that is added.
+ */
+void CandidateBatch::add(BaseParticle* p)
+{
+    if (size_ == particles_.size())
+    {
+        const unsigned int capacity = 2 * size_ + 16;
+        particles_.resize(capacity);
+        x_.resize(capacity);
+        y_.resize(capacity);
+        z_.resize(capacity);
+        radius_.resize(capacity);
+        separation_.resize(capacity);
+        overlaps_.resize(capacity);
+    }
+    particles_[size_] = p;
+    x_[size_] = p->getPosition().X;
+    y_[size_] = p->getPosition().Y;
+    z_[size_] = p->getPosition().Z;
+    radius_[size_] = p->getInteractionRadius();
+    size_++;
+}
+
+/*!
+ * \param[in] p     The particle that is tested against the particles in the batch.
+ * \param[in] begin The index of the first particle in the batch that is tested, 
+ *                  e.g. to test the pairs within a cell only once.
+ * \return The number of particles that might be in contact with p; their 
+ *         indices, in increasing order, are returned by getOverlap.
+ */
+unsigned int CandidateBatch::findOverlaps(const BaseParticle& p, unsigned int begin)
+{
+    if (begin >= size_)
+    {
+        return 0;
+    }
+    const Mdouble px = p.getPosition().X;
+    const Mdouble py = p.getPosition().Y;
+    const Mdouble pz = p.getPosition().Z;
+    const Mdouble pRadius = p.getInteractionRadius();
+    const Mdouble* x = x_.data();
+    const Mdouble* y = y_.data();
+    const Mdouble* z = z_.data();
+    const Mdouble* radius = radius_.data();
+    Mdouble* separation = separation_.data();
+    //no branches and only doubles, such that this loop is vectorised
+    for (unsigned int i = begin; i < size_; i++)
+    {
+        const Mdouble dx = x[i] - px;
+        const Mdouble dy = y[i] - py;
+        const Mdouble dz = z[i] - pz;
+        const Mdouble sumOfRadii = radius[i] + pRadius;
+        separation[i] = dx * dx + dy * dy + dz * dz - sumOfRadii * sumOfRadii * overlapTolerance;
+    }
+    //the indices of the overlapping particles are stored without branches as well
+    unsigned int* overlaps = overlaps_.data();
+    unsigned int numberOfOverlaps = 0;
+    for (unsigned int i = begin; i < size_; i++)
+    {
+        overlaps[numberOfOverlaps] = i;
+        numberOfOverlaps += separation[i] < 0.0;
+    }
+    return numberOfOverlaps;
+}
+
+std::size_t CandidateBatch::getMemoryUsage() const
+{
+    return sizeof(CandidateBatch) + particles_.capacity() * sizeof(BaseParticle*)
+        + (x_.capacity() + y_.capacity() + z_.capacity() + radius_.capacity()) * sizeof(Mdouble)
+        + separation_.capacity() * sizeof(Mdouble) + overlaps_.capacity() * sizeof(unsigned int);
+}
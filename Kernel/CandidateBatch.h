@@ -0,0 +1,140 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef CANDIDATEBATCH_H
+#define CANDIDATEBATCH_H
+
+#include <vector>
+#include "Math/ExtendedMath.h"
+
+class BaseParticle;
+
+/*!
+ * \brief The particles of an HGrid cell, with their positions and interaction 
+ *        radii stored in separate arrays, such that the overlaps with a 
+ *        particle can be tested for all of them in one vectorised loop.
+ * \details Most pairs of particles found by the HGrid are not in contact. 
+ * Instead of calling DPMBase::computeInternalForces for every pair, which 
+ * looks up both particles and computes their distance one pair at a time, the
+ * traversal of a cell adds the particles of the cell to the batch and calls 
+ * findOverlaps. The loop in findOverlaps has no branches and reads contiguous 
+ * arrays, so the compiler evaluates several pairs per instruction. Only the 
+ * pairs that overlap are passed to computeInternalForces, in the same order 
+ * as before, so the results do not change.
+ *
+ * The test is the one of BaseParticle::getInteractionWith (the distance is 
+ * smaller than the sum of the interaction radii), with a tolerance of 1e-12 
+ * such that round-off never discards a pair that would be in contact.
+ */
+class CandidateBatch
+{
+public:
+    /*!
+     * \brief Default constructor; creates an empty batch.
+     */
+    CandidateBatch();
+
+    /*!
+     * \brief Removes all particles from the batch; the memory is kept.
+     */
+    void clear()
+    {
+        size_ = 0;
+    }
+
+    /*!
+     * \brief Adds a particle to the batch.
+     */
+    void add(BaseParticle* p);
+
+    /*!
+     * \brief Returns the number of particles in the batch.
+     */
+    unsigned int getSize() const
+    {
+        return size_;
+    }
+
+    /*!
+     * \brief Returns the i-th particle in the batch.
+     */
+    BaseParticle* getParticle(unsigned int i) const
+    {
+        return particles_[i];
+    }
+
+    /*!
+     * \brief Tests which particles, from the given index on, overlap with p; returns their number.
+     */
+    unsigned int findOverlaps(const BaseParticle& p, unsigned int begin = 0);
+
+    /*!
+     * \brief Returns the particle of the k-th overlap found by the last call to findOverlaps.
+     */
+    BaseParticle* getOverlap(unsigned int k) const
+    {
+        return particles_[overlaps_[k]];
+    }
+
+    /*!
+     * \brief Returns the index in the batch of the k-th overlap found by the last call to findOverlaps.
+     */
+    unsigned int getOverlapIndex(unsigned int k) const
+    {
+        return overlaps_[k];
+    }
+
+    /*!
+     * \brief Returns the number of bytes used by the batch.
+     */
+    std::size_t getMemoryUsage() const;
+
+private:
+    ///The number of particles in the batch; the arrays are larger, to avoid reallocations
+    unsigned int size_;
+
+    ///The particles in the batch
+    std::vector<BaseParticle*> particles_;
+
+    ///The x-coordinates of the particles
+    std::vector<Mdouble> x_;
+
+    ///The y-coordinates of the particles
+    std::vector<Mdouble> y_;
+
+    ///The z-coordinates of the particles
+    std::vector<Mdouble> z_;
+
+    ///The interaction radii of the particles
+    std::vector<Mdouble> radius_;
+
+    ///For each particle, the squared distance to the particle passed to findOverlaps minus the squared sum of their interaction radii; negative if they overlap
+    std::vector<Mdouble> separation_;
+
+    ///The indices of the particles found by findOverlaps
+    std::vector<unsigned int> overlaps_;
+};
+
+#endif
@@ -103,7 +103,8 @@ Chute::Chute(const Chute& other)
         roughBottomType_(other.roughBottomType_),
         maxFailed_(other.maxFailed_), 
         insertionBoundary_(other.insertionBoundary_), 
-        isChutePeriodic_(other.isChutePeriodic_)    
+        isChutePeriodic_(other.isChutePeriodic_),
+        cleanChuteCount_(other.cleanChuteCount_)
 {
     logger(DEBUG,"[Chute::Chute(const Chute& other)] copy constructor finished");     
 }
@@ -115,6 +116,7 @@ void Chute::constructor()
 {
     insertionBoundary_ = nullptr;
     isChutePeriodic_ = false;
+    cleanChuteCount_ = 0;
     setFixedParticleRadius(0.001);
     setRoughBottomType(MONOLAYER_DISORDERED);
     setChuteAngle(0.0);
@@ -409,13 +411,11 @@ void Chute::createBottom()
 void Chute::cleanChute()
 {
     //clean outflow every 100 timesteps
-    static int count = 0, maxcount = 100; // please note: static variables are only initialised once, and their values
-                                          // are stored even after the method returns. I.e., next time the method is 
-                                          // called, the initialisation is ignored and the previously assigned value is used.
-    if (count > maxcount)
+    const int maxcount = 100;
+    if (cleanChuteCount_ > maxcount)
     {
         // reset counter
-        count = 0;
+        cleanChuteCount_ = 0;
         
         // check all particles
         for (unsigned int i = 0; i < particleHandler.getNumberOfObjects();)
@@ -432,7 +432,7 @@ void Chute::cleanChute()
         }
     }
     else
-        count++;
+        cleanChuteCount_++;
 }
 
 /*!
@@ -362,6 +362,10 @@ private:
      * in the Y-direction
      */
     bool isChutePeriodic_;
+    /*!
+     * \brief The number of calls to cleanChute() since the particles outside the chute were last removed
+     */
+    int cleanChuteCount_;
     
 };
 
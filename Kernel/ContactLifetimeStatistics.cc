@@ -0,0 +1,255 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "ContactLifetimeStatistics.h"
+#include "Interactions/BaseInteraction.h"
+#include "Particles/BaseParticle.h"
+#include "Logger.h"
+#include <cmath>
+#include <iomanip>
+#include <fstream>
+#include <algorithm>
+
+///Number of bins of the duration histogram (up to 2^24 time steps)
+static const unsigned int numberOfDurationBins = 24;
+///Number of bins of the overlap histogram (from 1e-6 to 1)
+static const unsigned int numberOfOverlapBins = 24;
+///Number of bins of the impact-velocity histogram (from 1e-6 to 1e2)
+static const unsigned int numberOfImpactVelocityBins = 32;
+///Number of bins per decade of the overlap and impact-velocity histograms
+static const unsigned int binsPerDecade = 4;
+
+ContactLifetimeStatistics::ContactLifetimeStatistics()
+{
+    isEnabled_ = false;
+    requiredStepsPerContact_ = 50;
+    reset();
+}
+
+/*!
+ * \param[in] other The ContactLifetimeStatistics whose settings are copied.
+ */
+ContactLifetimeStatistics::ContactLifetimeStatistics(const ContactLifetimeStatistics& other)
+{
+    isEnabled_ = other.isEnabled_;
+    requiredStepsPerContact_ = other.requiredStepsPerContact_;
+    reset();
+}
+
+void ContactLifetimeStatistics::setEnabled(bool isEnabled)
+{
+    isEnabled_ = isEnabled;
+}
+
+bool ContactLifetimeStatistics::isEnabled() const
+{
+    return isEnabled_;
+}
+
+/*!
+ * \param[in] requiredStepsPerContact The number of time steps per contact below which the contact is not resolved accurately; has to be positive.
+ */
+void ContactLifetimeStatistics::setRequiredStepsPerContact(Mdouble requiredStepsPerContact)
+{
+    if (requiredStepsPerContact <= 0)
+    {
+        logger(ERROR, "ContactLifetimeStatistics::setRequiredStepsPerContact: the number of steps has to be positive, but is %", requiredStepsPerContact);
+    }
+    requiredStepsPerContact_ = requiredStepsPerContact;
+}
+
+Mdouble ContactLifetimeStatistics::getRequiredStepsPerContact() const
+{
+    return requiredStepsPerContact_;
+}
+
+void ContactLifetimeStatistics::reset()
+{
+    numberOfContacts_ = 0;
+    sumDuration_ = 0;
+    maximumRelativeOverlap_ = 0;
+    maximumImpactVelocity_ = 0;
+    durationHistogram_.assign(numberOfDurationBins, 0);
+    overlapHistogram_.assign(numberOfOverlapBins, 0);
+    impactVelocityHistogram_.assign(numberOfImpactVelocityBins, 0);
+}
+
+/*!
+ * \details The duration is the time between the creation of the interaction 
+ * and its last time stamp, plus one time step, as the interaction was active 
+ * during both time steps. The overlap is divided by the radius of the smaller
+ * particle (or of the particle, for particle-wall contacts). Contacts whose 
+ * force has never been computed do not contribute to the impact velocity.
+ * \param[in] C The interaction that is about to be removed from the InteractionHandler.
+ * \param[in] timeStep The time step of the simulation.
+ */
+void ContactLifetimeStatistics::removeContact(const BaseInteraction* C, Mdouble timeStep)
+{
+    numberOfContacts_++;
+
+    Mdouble duration = (C->getTimeStamp() - C->getCreationTime()) / timeStep + 1;
+    sumDuration_ += duration;
+    unsigned int durationBin = duration < 2 ? 0 : static_cast<unsigned int>(std::log2(duration));
+    durationHistogram_[std::min(durationBin, numberOfDurationBins - 1)]++;
+
+    const BaseParticle* P = dynamic_cast<const BaseParticle*>(C->getP());
+    const BaseParticle* I = dynamic_cast<const BaseParticle*>(C->getI());
+    Mdouble radius = P != nullptr ? P->getRadius() : 0;
+    if (I != nullptr && (P == nullptr || I->getRadius() < radius))
+        radius = I->getRadius();
+    if (radius > 0)
+    {
+        Mdouble relativeOverlap = C->getMaximumOverlap() / radius;
+        maximumRelativeOverlap_ = std::max(maximumRelativeOverlap_, relativeOverlap);
+        overlapHistogram_[getLogarithmicBin(relativeOverlap, numberOfOverlapBins)]++;
+    }
+
+    if (C->getImpactVelocity() >= 0)
+    {
+        maximumImpactVelocity_ = std::max(maximumImpactVelocity_, C->getImpactVelocity());
+        impactVelocityHistogram_[getLogarithmicBin(C->getImpactVelocity(), numberOfImpactVelocityBins)]++;
+    }
+}
+
+unsigned int ContactLifetimeStatistics::getNumberOfContacts() const
+{
+    return numberOfContacts_;
+}
+
+const std::vector<unsigned int>& ContactLifetimeStatistics::getDurationHistogram() const
+{
+    return durationHistogram_;
+}
+
+const std::vector<unsigned int>& ContactLifetimeStatistics::getOverlapHistogram() const
+{
+    return overlapHistogram_;
+}
+
+const std::vector<unsigned int>& ContactLifetimeStatistics::getImpactVelocityHistogram() const
+{
+    return impactVelocityHistogram_;
+}
+
+Mdouble ContactLifetimeStatistics::getMeanDuration() const
+{
+    return numberOfContacts_ > 0 ? sumDuration_ / numberOfContacts_ : 0;
+}
+
+Mdouble ContactLifetimeStatistics::getMaximumRelativeOverlap() const
+{
+    return maximumRelativeOverlap_;
+}
+
+Mdouble ContactLifetimeStatistics::getMaximumImpactVelocity() const
+{
+    return maximumImpactVelocity_;
+}
+
+/*!
+ * \param[in] quantile A number in [0,1], e.g. 0.05 for the duration that 5% of the contacts do not exceed.
+ * \return The lower edge of the bin of the duration histogram that contains the quantile, i.e. a power of two.
+ */
+Mdouble ContactLifetimeStatistics::getDurationQuantile(Mdouble quantile) const
+{
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < durationHistogram_.size(); i++)
+    {
+        count += durationHistogram_[i];
+        if (count > 0 && count >= quantile * numberOfContacts_)
+            return std::pow(2.0, i);
+    }
+    return 0;
+}
+
+/*!
+ * \details Short contacts (e.g. grazing collisions) limit the time step, so 
+ * the 5% quantile of the contact duration is compared to the required number
+ * of time steps per contact. If it is more than four times larger, a warning
+ * is printed with the factor by which the time step could be increased.
+ * \param[in] timeStep The time step of the simulation.
+ */
+void ContactLifetimeStatistics::checkTimeStep(Mdouble timeStep) const
+{
+    if (numberOfContacts_ == 0)
+        return;
+    Mdouble shortDuration = getDurationQuantile(0.05);
+    if (shortDuration > 4 * requiredStepsPerContact_)
+    {
+        logger(WARN, "95 percent of the contacts lasted at least % time steps; the time step % could be increased by a factor % "
+               "while still resolving each contact in % time steps", shortDuration, timeStep,
+               shortDuration / requiredStepsPerContact_, requiredStepsPerContact_);
+    }
+}
+
+/*!
+ * \param[in] i The index of a bin of the overlap or impact-velocity histogram.
+ * \return 1e-6 * 10^(i/4); the first bin also contains smaller values, the last bin larger values.
+ */
+Mdouble ContactLifetimeStatistics::getBinLowerEdge(unsigned int i)
+{
+    return 1e-6 * std::pow(10.0, static_cast<Mdouble>(i) / binsPerDecade);
+}
+
+unsigned int ContactLifetimeStatistics::getLogarithmicBin(Mdouble value, unsigned int numberOfBins)
+{
+    if (value <= getBinLowerEdge(1))
+        return 0;
+    unsigned int bin = static_cast<unsigned int>(binsPerDecade * (std::log10(value) + 6));
+    return std::min(bin, numberOfBins - 1);
+}
+
+void ContactLifetimeStatistics::print(std::ostream& os) const
+{
+    os << "contacts ended " << numberOfContacts_
+        << ", mean duration " << getMeanDuration() << " time steps"
+        << ", 5% quantile of the duration >= " << getDurationQuantile(0.05) << " time steps"
+        << ", maximum overlap/radius " << maximumRelativeOverlap_
+        << ", maximum impact velocity " << maximumImpactVelocity_ << std::endl;
+}
+
+/*!
+ * \details The file contains one line per bin: the name of the histogram, the 
+ * lower edge of the bin (in time steps for the duration) and the number of 
+ * contacts in the bin.
+ * \param[in] name The name of the output file, usually problemName.lifetime.
+ */
+void ContactLifetimeStatistics::write(const std::string& name) const
+{
+    std::ofstream file(name.c_str(), std::ofstream::out);
+    if (!file.is_open())
+    {
+        logger(WARN, "ContactLifetimeStatistics::write: could not open %", name);
+        return;
+    }
+    file << "histogram lowerEdge contacts" << std::endl;
+    file << std::setprecision(6);
+    for (unsigned int i = 0; i < durationHistogram_.size(); i++)
+        file << "durationInTimeSteps " << std::pow(2.0, i) << ' ' << durationHistogram_[i] << std::endl;
+    for (unsigned int i = 0; i < overlapHistogram_.size(); i++)
+        file << "overlapOverRadius " << getBinLowerEdge(i) << ' ' << overlapHistogram_[i] << std::endl;
+    for (unsigned int i = 0; i < impactVelocityHistogram_.size(); i++)
+        file << "impactVelocity " << getBinLowerEdge(i) << ' ' << impactVelocityHistogram_[i] << std::endl;
+}
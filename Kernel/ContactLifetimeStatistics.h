@@ -0,0 +1,192 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef CONTACTLIFETIMESTATISTICS_H
+#define CONTACTLIFETIMESTATISTICS_H
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include "GeneralDefine.h"
+class BaseInteraction;
+
+/*!
+ * \brief Gathers histograms of the duration, maximum overlap and impact velocity of the contacts that ended.
+ * \details When an interaction expires, i.e. when it is erased by 
+ * InteractionHandler::eraseOldInteractions because the contact has ended, 
+ * its duration, its maximum overlap relative to the radius of the (smaller) 
+ * particle, and the absolute normal relative velocity at its first force 
+ * computation are added to logarithmic histograms. The maximum overlap and 
+ * the impact velocity are tracked by BaseInteraction itself, so the 
+ * statistics cost O(1) per ended contact and nothing per time step.
+ * 
+ * The histograms show whether the time step is chosen well: a contact should 
+ * be resolved in about getRequiredStepsPerContact (default 50) time steps. If 
+ * even the short contacts take much longer than that, checkTimeStep warns 
+ * that a larger time step could be used.
+ * 
+ * The statistics are disabled by default. They can be enabled through 
+ * setEnabled or the command-line argument -contactLifetimeStatistics 1; then 
+ * DPMBase::solve prints them and writes the histograms to the file 
+ * name.lifetime at the end of the run.
+ */
+class ContactLifetimeStatistics
+{
+public:
+    /*!
+     * \brief Default constructor; the statistics are disabled.
+     */
+    ContactLifetimeStatistics();
+
+    /*!
+     * \brief Copy constructor; copies the settings, but not the histograms.
+     */
+    ContactLifetimeStatistics(const ContactLifetimeStatistics& other);
+
+    /*!
+     * \brief Enables or disables the statistics.
+     */
+    void setEnabled(bool isEnabled);
+
+    /*!
+     * \brief Returns true if the statistics are gathered.
+     */
+    bool isEnabled() const;
+
+    /*!
+     * \brief Sets the number of time steps in which a contact should be resolved.
+     */
+    void setRequiredStepsPerContact(Mdouble requiredStepsPerContact);
+
+    /*!
+     * \brief Returns the number of time steps in which a contact should be resolved.
+     */
+    Mdouble getRequiredStepsPerContact() const;
+
+    /*!
+     * \brief Sets all histograms to zero.
+     */
+    void reset();
+
+    /*!
+     * \brief Adds a contact that has ended, and is about to be erased from the InteractionHandler, to the histograms.
+     */
+    void removeContact(const BaseInteraction* C, Mdouble timeStep);
+
+    /*!
+     * \brief Returns the number of contacts in the histograms.
+     */
+    unsigned int getNumberOfContacts() const;
+
+    /*!
+     * \brief Returns the histogram of the contact durations; bin i counts durations of [2^i,2^(i+1)) time steps.
+     */
+    const std::vector<unsigned int>& getDurationHistogram() const;
+
+    /*!
+     * \brief Returns the histogram of the maximum overlaps relative to the radius; see getBinLowerEdge.
+     */
+    const std::vector<unsigned int>& getOverlapHistogram() const;
+
+    /*!
+     * \brief Returns the histogram of the impact velocities; see getBinLowerEdge.
+     */
+    const std::vector<unsigned int>& getImpactVelocityHistogram() const;
+
+    /*!
+     * \brief Returns the mean contact duration, in time steps.
+     */
+    Mdouble getMeanDuration() const;
+
+    /*!
+     * \brief Returns the largest maximum overlap relative to the radius.
+     */
+    Mdouble getMaximumRelativeOverlap() const;
+
+    /*!
+     * \brief Returns the largest impact velocity.
+     */
+    Mdouble getMaximumImpactVelocity() const;
+
+    /*!
+     * \brief Returns a lower bound of the given quantile of the contact duration, in time steps.
+     */
+    Mdouble getDurationQuantile(Mdouble quantile) const;
+
+    /*!
+     * \brief Warns if the short contacts take many more time steps than required, i.e. if the time step could be increased.
+     */
+    void checkTimeStep(Mdouble timeStep) const;
+
+    /*!
+     * \brief Returns the lower edge of bin i of the overlap and impact-velocity histograms.
+     */
+    static Mdouble getBinLowerEdge(unsigned int i);
+
+    /*!
+     * \brief Prints a summary of the statistics.
+     */
+    void print(std::ostream& os) const;
+
+    /*!
+     * \brief Writes the three histograms to the file name.
+     */
+    void write(const std::string& name) const;
+
+private:
+    /*!
+     * \brief Returns the bin of a positive value in a logarithmic histogram starting at getBinLowerEdge(0).
+     */
+    static unsigned int getLogarithmicBin(Mdouble value, unsigned int numberOfBins);
+
+    ///If false, removeContact is not called
+    bool isEnabled_;
+
+    ///Number of time steps in which a contact should be resolved
+    Mdouble requiredStepsPerContact_;
+
+    ///Number of contacts in the histograms
+    unsigned int numberOfContacts_;
+
+    ///Sum of the durations, in time steps
+    Mdouble sumDuration_;
+
+    ///Largest maximum overlap relative to the radius
+    Mdouble maximumRelativeOverlap_;
+
+    ///Largest impact velocity
+    Mdouble maximumImpactVelocity_;
+
+    ///Number of contacts per duration bin
+    std::vector<unsigned int> durationHistogram_;
+
+    ///Number of contacts per relative overlap bin
+    std::vector<unsigned int> overlapHistogram_;
+
+    ///Number of contacts per impact velocity bin
+    std::vector<unsigned int> impactVelocityHistogram_;
+};
+
+#endif
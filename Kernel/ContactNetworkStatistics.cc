@@ -0,0 +1,256 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "ContactNetworkStatistics.h"
+#include "Interactions/BaseInteraction.h"
+#include "Particles/BaseParticle.h"
+#include "Math/ExtendedMath.h"
+#include "Logger.h"
+#include <cmath>
+#include <iomanip>
+
+ContactNetworkStatistics::ContactNetworkStatistics()
+{
+    isEnabled_ = false;
+    orientationHistogram_.resize(18);
+    e1_ = Vec3D(1, 0, 0);
+    e2_ = Vec3D(0, 0, 1);
+    reset();
+}
+
+/*!
+ * \param[in] other The ContactNetworkStatistics whose settings are copied.
+ */
+ContactNetworkStatistics::ContactNetworkStatistics(const ContactNetworkStatistics& other)
+{
+    isEnabled_ = other.isEnabled_;
+    orientationHistogram_.resize(other.orientationHistogram_.size());
+    e1_ = other.e1_;
+    e2_ = other.e2_;
+    reset();
+}
+
+bool ContactNetworkStatistics::isEnabled() const
+{
+    return isEnabled_;
+}
+
+/*!
+ * \param[in] isEnabled If true, the counters are updated.
+ */
+void ContactNetworkStatistics::setEnabled(bool isEnabled)
+{
+    isEnabled_ = isEnabled;
+    reset();
+}
+
+/*!
+ * \details Since the bins of the existing contacts become invalid, the counters
+ * are reset; call this function before enabling the statistics.
+ * \param[in] numberOfBins The number of bins dividing [0,pi).
+ */
+void ContactNetworkStatistics::setNumberOfBins(unsigned int numberOfBins)
+{
+    if (numberOfBins == 0)
+    {
+        logger(ERROR, "ContactNetworkStatistics::setNumberOfBins: the number of bins has to be positive");
+        return;
+    }
+    if (isEnabled_)
+        logger(WARN, "ContactNetworkStatistics::setNumberOfBins: the statistics have already been enabled; call this function first");
+    orientationHistogram_.resize(numberOfBins);
+    reset();
+}
+
+unsigned int ContactNetworkStatistics::getNumberOfBins() const
+{
+    return orientationHistogram_.size();
+}
+
+/*!
+ * \param[in] e1 The direction of angle 0.
+ * \param[in] e2 The direction of angle pi/2.
+ */
+void ContactNetworkStatistics::setOrientationPlane(Vec3D e1, Vec3D e2)
+{
+    e1.normalize();
+    e2.normalize();
+    e1_ = e1;
+    e2_ = e2;
+}
+
+void ContactNetworkStatistics::reset()
+{
+    numberOfParticleContacts_ = 0;
+    numberOfWallContacts_ = 0;
+    numberOfSlidingContacts_ = 0;
+    for (unsigned int& n : orientationHistogram_)
+        n = 0;
+}
+
+/*!
+ * \details As the sign of the normal is arbitrary, the angle between the 
+ * projection of the normal onto the plane (e1,e2) and e1 is folded into [0,pi).
+ * \param[in] normal The contact normal.
+ * \return The index of the histogram bin.
+ */
+int ContactNetworkStatistics::getOrientationBin(const Vec3D& normal) const
+{
+    Mdouble angle = std::atan2(Vec3D::dot(normal, e2_), Vec3D::dot(normal, e1_));
+    if (angle < 0)
+        angle += constants::pi;
+    unsigned int bin = static_cast<unsigned int>(angle / constants::pi * orientationHistogram_.size());
+    return std::min(bin, static_cast<unsigned int>(orientationHistogram_.size() - 1));
+}
+
+/*!
+ * \param[in] C The interaction that has been added to the InteractionHandler.
+ */
+void ContactNetworkStatistics::addContact(BaseInteraction* C)
+{
+    if (dynamic_cast<BaseParticle*>(C->getI()) != nullptr)
+        numberOfParticleContacts_++;
+    else
+        numberOfWallContacts_++;
+    if (C->isSliding())
+        numberOfSlidingContacts_++;
+    int bin = getOrientationBin(C->getNormal());
+    C->setOrientationBin(bin);
+    orientationHistogram_[bin]++;
+}
+
+/*!
+ * \param[in] C The interaction that is about to be removed from the InteractionHandler.
+ */
+void ContactNetworkStatistics::removeContact(BaseInteraction* C)
+{
+    if (dynamic_cast<BaseParticle*>(C->getI()) != nullptr)
+        numberOfParticleContacts_--;
+    else
+        numberOfWallContacts_--;
+    if (C->isSliding())
+        numberOfSlidingContacts_--;
+    if (C->getOrientationBin() >= 0)
+        orientationHistogram_[C->getOrientationBin()]--;
+    C->setOrientationBin(-1);
+}
+
+/*!
+ * \param[in] isSliding The new sliding state of a contact whose state has changed.
+ */
+void ContactNetworkStatistics::updateSliding(bool isSliding)
+{
+    if (isSliding)
+        numberOfSlidingContacts_++;
+    else
+        numberOfSlidingContacts_--;
+}
+
+/*!
+ * \param[in] C An interaction whose normal has been changed.
+ */
+void ContactNetworkStatistics::updateOrientation(BaseInteraction* C)
+{
+    //contacts that are not counted (yet) have no bin
+    if (C->getOrientationBin() < 0)
+        return;
+    int bin = getOrientationBin(C->getNormal());
+    if (bin != C->getOrientationBin())
+    {
+        orientationHistogram_[C->getOrientationBin()]--;
+        orientationHistogram_[bin]++;
+        C->setOrientationBin(bin);
+    }
+}
+
+unsigned int ContactNetworkStatistics::getNumberOfParticleContacts() const
+{
+    return numberOfParticleContacts_;
+}
+
+unsigned int ContactNetworkStatistics::getNumberOfWallContacts() const
+{
+    return numberOfWallContacts_;
+}
+
+unsigned int ContactNetworkStatistics::getNumberOfSlidingContacts() const
+{
+    return numberOfSlidingContacts_;
+}
+
+/*!
+ * \param[in] numberOfParticles The number of particles in the ParticleHandler.
+ * \return Twice the number of particle-particle contacts per particle.
+ */
+Mdouble ContactNetworkStatistics::getCoordinationNumber(unsigned int numberOfParticles) const
+{
+    if (numberOfParticles == 0)
+        return 0.0;
+    return 2.0 * numberOfParticleContacts_ / numberOfParticles;
+}
+
+Mdouble ContactNetworkStatistics::getSlidingFraction() const
+{
+    unsigned int numberOfContacts = numberOfParticleContacts_ + numberOfWallContacts_;
+    if (numberOfContacts == 0)
+        return 0.0;
+    return static_cast<Mdouble>(numberOfSlidingContacts_) / numberOfContacts;
+}
+
+const std::vector<unsigned int>& ContactNetworkStatistics::getOrientationHistogram() const
+{
+    return orientationHistogram_;
+}
+
+/*!
+ * \details Each line contains the time, the number of particles, the number of 
+ * particle-particle and particle-wall contacts, the coordination number, 
+ * the sliding fraction, and the number of contacts in each orientation bin.
+ * \param[in] name The name of the output file, usually problemName.network.
+ * \param[in] time The current time.
+ * \param[in] numberOfParticles The number of particles in the ParticleHandler.
+ */
+void ContactNetworkStatistics::write(const std::string& name, Mdouble time, unsigned int numberOfParticles)
+{
+    if (!file_.is_open())
+    {
+        file_.open(name.c_str(), std::ofstream::out);
+        if (!file_.is_open())
+        {
+            logger(WARN, "ContactNetworkStatistics::write: could not open %", name);
+            return;
+        }
+        file_ << "time particles particleContacts wallContacts coordinationNumber slidingFraction orientationHistogram(" << orientationHistogram_.size() << " bins in [0,pi))" << std::endl;
+    }
+    file_ << std::setprecision(8) << time
+        << ' ' << numberOfParticles
+        << ' ' << numberOfParticleContacts_
+        << ' ' << numberOfWallContacts_
+        << ' ' << getCoordinationNumber(numberOfParticles)
+        << ' ' << getSlidingFraction();
+    for (unsigned int n : orientationHistogram_)
+        file_ << ' ' << n;
+    file_ << std::endl;
+}
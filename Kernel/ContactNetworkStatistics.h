@@ -0,0 +1,180 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef CONTACTNETWORKSTATISTICS_H
+#define CONTACTNETWORKSTATISTICS_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include "Math/Vector.h"
+class BaseInteraction;
+
+/*!
+ * \brief Keeps track of the number of contacts, the number of sliding contacts
+ * and a histogram of the contact orientations while the simulation runs.
+ * \details The counters are updated incrementally by the InteractionHandler 
+ * when an interaction is created or erased, and by BaseInteraction when the 
+ * sliding state or the normal of a contact changes. Thus, writing the 
+ * coordination number, the sliding fraction and the orientation histogram 
+ * costs O(1) per output step, instead of a loop over all contacts. 
+ * 
+ * The statistics are disabled by default; when disabled, none of the counters 
+ * are updated. They can be enabled through 
+ * InteractionHandler::setContactNetworkStatisticsEnabled, in which case they 
+ * are written to the file name.network whenever the .ene file is written.
+ * 
+ * Every interaction in the handler is counted as a contact; for non-adhesive 
+ * species an interaction only exists while the particles overlap.
+ */
+class ContactNetworkStatistics
+{
+public:
+    /*!
+     * \brief Default constructor; the statistics are disabled and use 18 orientation bins in the xz-plane.
+     */
+    ContactNetworkStatistics();
+    
+    /*!
+     * \brief Copy constructor; copies the settings, but not the counters or the output file.
+     */
+    ContactNetworkStatistics(const ContactNetworkStatistics& other);
+
+    /*!
+     * \brief Returns true if the statistics are updated.
+     */
+    bool isEnabled() const;
+    
+    /*!
+     * \brief Sets the number of bins of the orientation histogram; resets the counters.
+     */
+    void setNumberOfBins(unsigned int numberOfBins);
+
+    /*!
+     * \brief Returns the number of bins of the orientation histogram.
+     */
+    unsigned int getNumberOfBins() const;
+
+    /*!
+     * \brief Sets the plane in which the contact orientation is measured; the angle is measured from e1 towards e2.
+     */
+    void setOrientationPlane(Vec3D e1, Vec3D e2);
+
+    /*!
+     * \brief Sets all counters to zero.
+     */
+    void reset();
+
+    /*!
+     * \brief Counts a new contact (including its sliding state and orientation).
+     */
+    void addContact(BaseInteraction* C);
+
+    /*!
+     * \brief Removes a contact from the counters.
+     */
+    void removeContact(BaseInteraction* C);
+
+    /*!
+     * \brief Updates the number of sliding contacts if a contact starts or stops sliding.
+     */
+    void updateSliding(bool isSliding);
+
+    /*!
+     * \brief Moves a contact to the histogram bin of its current normal.
+     */
+    void updateOrientation(BaseInteraction* C);
+
+    /*!
+     * \brief Returns the number of particle-particle contacts.
+     */
+    unsigned int getNumberOfParticleContacts() const;
+
+    /*!
+     * \brief Returns the number of particle-wall contacts.
+     */
+    unsigned int getNumberOfWallContacts() const;
+
+    /*!
+     * \brief Returns the number of sliding contacts (particle-particle and particle-wall).
+     */
+    unsigned int getNumberOfSlidingContacts() const;
+
+    /*!
+     * \brief Returns the mean number of particle-particle contacts per particle.
+     */
+    Mdouble getCoordinationNumber(unsigned int numberOfParticles) const;
+
+    /*!
+     * \brief Returns the fraction of contacts that are sliding.
+     */
+    Mdouble getSlidingFraction() const;
+
+    /*!
+     * \brief Returns the number of contacts in each orientation bin.
+     */
+    const std::vector<unsigned int>& getOrientationHistogram() const;
+
+    /*!
+     * \brief Writes one line of statistics to the file name (the header is written when the file is opened).
+     */
+    void write(const std::string& name, Mdouble time, unsigned int numberOfParticles);
+
+private:
+    /*!
+     * \brief Enables or disables the statistics; only the InteractionHandler can do this, as it has to recount the existing contacts.
+     */
+    void setEnabled(bool isEnabled);
+
+    /*!
+     * \brief Returns the histogram bin of a normal vector.
+     */
+    int getOrientationBin(const Vec3D& normal) const;
+
+    friend class InteractionHandler;
+
+    ///If false, the counters are not updated
+    bool isEnabled_;
+
+    ///Number of particle-particle contacts
+    unsigned int numberOfParticleContacts_;
+
+    ///Number of particle-wall contacts
+    unsigned int numberOfWallContacts_;
+
+    ///Number of sliding contacts
+    unsigned int numberOfSlidingContacts_;
+
+    ///Number of contacts per orientation bin; the bins divide [0,pi) into equal intervals
+    std::vector<unsigned int> orientationHistogram_;
+
+    ///Unit vectors spanning the plane in which the orientation is measured
+    Vec3D e1_, e2_;
+
+    ///The output file, opened at the first call to write
+    std::ofstream file_;
+};
+
+#endif
@@ -103,6 +103,7 @@ DPMBase::DPMBase(const DPMBase& other)
     time_ = other.time_;
     timeStep_ = other.timeStep_;
     ntimeSteps_ = other.ntimeSteps_;
+    numberOfParticleContacts_ = other.numberOfParticleContacts_;
     timeMax_ = other.timeMax_;
     restartVersion_ = other.restartVersion_; //to read new and old restart data
     restarted_ = other.restarted_; //to see if it was restarted or not
@@ -116,6 +117,16 @@ DPMBase::DPMBase(const DPMBase& other)
             possibleContactList=other.possibleContactList;
 #endif
     random = other.random;
+    profiler.setEnabled(other.profiler.isEnabled());
+    profiler.setHardwareCountersEnabled(other.profiler.getHardwareCountersEnabled());
+    memoryUsage.setEnabled(other.memoryUsage.isEnabled());
+    telemetry.setEnabled(other.telemetry.isEnabled());
+    telemetry.setInterval(other.telemetry.getInterval());
+    particleReordering.setEnabled(other.particleReordering.isEnabled());
+    particleReordering.setCurve(other.particleReordering.getCurve());
+    particleReordering.setInterval(other.particleReordering.getInterval());
+    particleReordering.setCheckInterval(other.particleReordering.getCheckInterval());
+    particleReordering.setMissRateIncrease(other.particleReordering.getMissRateIncrease());
 
     boundaryHandler.setDPMBase(this);
     particleHandler.setDPMBase(this);
@@ -166,6 +177,16 @@ unsigned int DPMBase::getNtimeSteps() const
 {
     return ntimeSteps_;
 }
+/*!
+ * \details The contacts are counted by computeInternalForces, so this is the
+ * number of particle pairs that interacted in the last call to computeAllForces;
+ * the InteractionHandler does not need to be traversed.
+ * \return numberOfParticleContacts_
+ */
+unsigned int DPMBase::getNumberOfParticleContacts() const
+{
+    return numberOfParticleContacts_;
+}
 /*!
  * \param[in] time
  */
@@ -614,10 +635,13 @@ void DPMBase::actionsOnRestart()
 }
 
 /*!
- * \brief no implementation but can be overidden in its derived classes.
+ * \details Updates the grid of the static particles, see 
+ *          ParticleHandler::updateFixedParticleGrid; can be overidden in its 
+ *          derived classes.
  */
 void DPMBase::hGridActionsBeforeTimeStep()
 {
+    particleHandler.updateFixedParticleGrid();
 }
 
 /*!
@@ -739,7 +763,11 @@ void DPMBase::broadPhase(BaseParticle* i)
 {
     for (std::vector<BaseParticle*>::iterator it = particleHandler.begin(); (*it) != i; ++it)
     {
-        computeInternalForces(i, *it);
+        //static particles are found by computeAllForces, see ParticleHandler::getCandidateFixedParticles
+        if (!particleHandler.isInFixedParticleGrid(*it))
+        {
+            computeInternalForces(i, *it);
+        }
     }
 }
 
@@ -798,6 +826,7 @@ void DPMBase::constructor()
     time_ = 0.0;
     timeStep_ = 0.0; // if dt is not user-specified, this is set in actionsBeforeTimeLoop()
     ntimeSteps_ = 0;
+    numberOfParticleContacts_ = 0;
     setSaveCount(20);
     timeMax_ = 1.0;
     
@@ -1431,15 +1460,25 @@ void DPMBase::computeInternalForces(BaseParticle* P1, BaseParticle* P2)
     BaseInteraction* C = PJ->getInteractionWith(PI, getTime(), &interactionHandler);
     if (C != 0)
     {
+        numberOfParticleContacts_++;
         C->computeForce();
 
-        PI->addForce(C->getForce());
-        PJ->addForce(-C->getForce());
-
-        if (getRotation())
+        //the forces on the particles in the grid of static particles are not accumulated, as they are not reset
+        if (!particleHandler.isInFixedParticleGrid(PI))
         {
-            PI->addTorque(C->getTorque() - Vec3D::cross(PI->getPosition() - C->getContactPoint(), C->getForce()));
-            PJ->addTorque(-C->getTorque() + Vec3D::cross(PJ->getPosition() - C->getContactPoint(), C->getForce()));
+            PI->addForce(C->getForce());
+            if (getRotation())
+            {
+                PI->addTorque(C->getTorque() - Vec3D::cross(PI->getPosition() - C->getContactPoint(), C->getForce()));
+            }
+        }
+        if (!particleHandler.isInFixedParticleGrid(PJ))
+        {
+            PJ->addForce(-C->getForce());
+            if (getRotation())
+            {
+                PJ->addTorque(-C->getTorque() + Vec3D::cross(PJ->getPosition() - C->getContactPoint(), C->getForce()));
+            }
         }
     }
 }
@@ -1468,7 +1507,9 @@ void DPMBase::computeForcesDueToWalls(BaseParticle* pI)
     if (pI->getPeriodicFromParticle() != nullptr)
         return;
 
-    for (std::vector<BaseWall*>::iterator it = wallHandler.begin(); it != wallHandler.end(); ++it)
+    //only the walls near the particle are tested, see WallHandler::getCandidateWalls
+    const std::vector<BaseWall*>& walls = wallHandler.getCandidateWalls(*pI);
+    for (std::vector<BaseWall*>::const_iterator it = walls.begin(); it != walls.end(); ++it)
     {
         BaseInteraction* C = (*it)->getInteractionWith(pI, getTime(), &interactionHandler);
 
@@ -1496,7 +1537,11 @@ void DPMBase::integrateBeforeForceComputation()
 {
     for_each(particleHandler.begin(), particleHandler.end(), [this] (BaseParticle* p)
     {
-        p->integrateBeforeForceComputation(getTime(),getTimeStep());
+        //integrating a static particle does not change it
+        if (!particleHandler.isInFixedParticleGrid(p))
+        {
+            p->integrateBeforeForceComputation(getTime(),getTimeStep());
+        }
     });
     for_each(wallHandler.begin(), wallHandler.end(), [this] (BaseWall* w)
     {
@@ -1525,7 +1570,10 @@ void DPMBase::integrateAfterForceComputation()
 {
     for_each(particleHandler.begin(), particleHandler.end(), [this] (BaseParticle* p)
     {
-        p->integrateAfterForceComputation(getTime(),getTimeStep());
+        if (!particleHandler.isInFixedParticleGrid(p))
+        {
+            p->integrateAfterForceComputation(getTime(),getTimeStep());
+        }
     });
     for_each(wallHandler.begin(), wallHandler.end(), [this] (BaseWall* w)
     {
@@ -1585,9 +1633,14 @@ void DPMBase::integrateAfterForceComputation()
  */
 void DPMBase::computeAllForces()
 {
-    ///Reset all forces to zero
+    ///The particle contacts are counted anew by computeInternalForces
+    numberOfParticleContacts_ = 0;
+    
+    ///Reset all forces to zero; the particles in the grid of static particles keep zero force
     for (std::vector<BaseParticle*>::iterator it = particleHandler.begin(); it != particleHandler.end(); ++it)
     {
+        if (particleHandler.isInFixedParticleGrid(*it))
+            continue;
         (*it)->setForce(Vec3D(0.0, 0.0, 0.0));
         (*it)->setTorque(Vec3D(0.0, 0.0, 0.0));
     }
@@ -1600,16 +1653,32 @@ void DPMBase::computeAllForces()
 #ifdef DEBUG_OUTPUT
     std::cerr << "Have all forces set to zero " << std::endl;
 #endif
+
+    ///Update the bounding boxes of the walls that moved since the last force computation
+    wallHandler.updateBoundingVolumes();
     
     ///Now loop over all particles contacts computing force contributions
     
     for (std::vector<BaseParticle*>::iterator it = particleHandler.begin(); it != particleHandler.end(); ++it)
     {
+        ///Static particles are only found as neighbours of the other particles
+        if (particleHandler.isInFixedParticleGrid(*it))
+            continue;
         
         ///Now loop over all other particles looking for contacts
         computeInternalForces(*it);
         //end inner loop over contacts.
         
+        ///Then over the static particles near it, which are not found by computeInternalForces
+        if (!(*it)->isFixed())
+        {
+            const std::vector<BaseParticle*>& fixedParticles = particleHandler.getCandidateFixedParticles(**it);
+            for (std::vector<BaseParticle*>::const_iterator f = fixedParticles.begin(); f != fixedParticles.end(); ++f)
+            {
+                computeInternalForces(*it, *f);
+            }
+        }
+        
         computeExternalForces(*it);
         
     }
@@ -1845,6 +1914,42 @@ void DPMBase::checkSettings()
     }
 }
 
+/*!
+ * \details The memory of the periodic ghost particles is reported separately 
+ *          from the memory of the real particles. Derived classes that own 
+ *          additional data structures (e.g. the HGrid) add these after calling 
+ *          this function.
+ */
+void DPMBase::computeMemoryUsage()
+{
+    std::size_t ghostParticles = particleHandler.getGhostMemoryUsage();
+    memoryUsage.set("particles", particleHandler.getMemoryUsage() - ghostParticles);
+    memoryUsage.set("ghostParticles", ghostParticles);
+    memoryUsage.set("interactions", interactionHandler.getMemoryUsage());
+    memoryUsage.set("walls", wallHandler.getMemoryUsage());
+    memoryUsage.set("species", speciesHandler.getMemoryUsage());
+    memoryUsage.set("boundaries", boundaryHandler.getMemoryUsage());
+}
+
+/*!
+ * \details The number of ghost particles and the memory usage are computed 
+ *          here, so they only cost time when a line is written.
+ */
+void DPMBase::writeTelemetry()
+{
+    unsigned int numberOfGhosts = 0;
+    for (const BaseParticle* particle : particleHandler)
+    {
+        if (particle->getPeriodicFromParticle() != nullptr)
+            numberOfGhosts++;
+    }
+    computeMemoryUsage();
+    memoryUsage.computeTotal();
+    telemetry.write(getName() + ".telemetry", getTime(), getTimeMax(), ntimeSteps_,
+                    particleHandler.getNumberOfObjects() - numberOfGhosts, numberOfGhosts,
+                    interactionHandler.getNumberOfObjects(), memoryUsage.getTotalBytes());
+}
+
 void DPMBase::writeOutputFiles()
 {
     if (fStatFile.saveCurrentTimestep(ntimeSteps_))
@@ -1855,6 +1960,9 @@ void DPMBase::writeOutputFiles()
         if (eneFile.getCounter()==1 || eneFile.getFileType()==FileType::MULTIPLE_FILES || eneFile.getFileType()==FileType::MULTIPLE_FILES_PADDED)
             writeEneHeader(eneFile.getFstream());
         writeEneTimestep(eneFile.getFstream());
+        //the contact-network statistics are written alongside the energies
+        if (interactionHandler.getContactNetworkStatistics().isEnabled())
+            interactionHandler.getContactNetworkStatistics().write(getName() + ".network", getTime(), particleHandler.getNumberOfObjects());
     }
 
     if (dataFile.saveCurrentTimestep(ntimeSteps_))
@@ -1863,6 +1971,9 @@ void DPMBase::writeOutputFiles()
         if ((getRestarted() ||dataFile.getCounter()==1) && dataFile.getFileType()!= FileType::NO_FILE)
             writeXBallsScript();
         outputXBallsData(dataFile.getFstream());
+        //the cumulative timings of the profiler are written whenever the data file is
+        if (profiler.isEnabled())
+            profiler.write(getName() + ".prof", getTime(), ntimeSteps_);
     }
 
 //    if (statFile.saveCurrentTimestep(ntimeSteps_))
@@ -1952,11 +2063,32 @@ void DPMBase::solve()
     actionsBeforeTimeLoop();
     hGridActionsBeforeTimeLoop();
 
+    // the profiler times the initial force computation as part of the time loop
+    profiler.reset();
+    profiler.startTimeLoop();
+    memoryUsage.reset();
+    telemetry.reset(getTime(), ntimeSteps_);
+    particleReordering.reset();
+    interactionHandler.getContactLifetimeStatistics().reset();
+    unsigned int firstTimeStep = ntimeSteps_;
+
     // do a first force computation
-    checkAndDuplicatePeriodicParticles();
-    hGridActionsBeforeTimeStep();
-    computeAllForces();
-    removeDuplicatePeriodicParticles();
+    {
+        SolveProfiler::ScopedTimer timer(profiler, SolvePhase::CHECK_AND_DUPLICATE_PERIODIC_PARTICLES);
+        checkAndDuplicatePeriodicParticles();
+    }
+    {
+        SolveProfiler::ScopedTimer timer(profiler, SolvePhase::HGRID_ACTIONS_BEFORE_TIME_STEP);
+        hGridActionsBeforeTimeStep();
+    }
+    {
+        SolveProfiler::ScopedTimer timer(profiler, SolvePhase::COMPUTE_ALL_FORCES);
+        computeAllForces();
+    }
+    {
+        SolveProfiler::ScopedTimer timer(profiler, SolvePhase::REMOVE_DUPLICATE_PERIODIC_PARTICLES);
+        removeDuplicatePeriodicParticles();
+    }
 
 
 #ifdef DEBUG_OUTPUT
@@ -1966,12 +2098,21 @@ void DPMBase::solve()
     // This is the main loop over advancing time
     while (getTime() < getTimeMax() && continueSolve())
     {
-        writeOutputFiles(); //everything is written at the beginning of the timestep!
+        {
+            SolveProfiler::ScopedTimer timer(profiler, SolvePhase::WRITE_OUTPUT_FILES);
+            writeOutputFiles(); //everything is written at the beginning of the timestep!
+        }
         
         // Loop over all particles doing the time integration step
         hGridActionsBeforeIntegration();
-        integrateBeforeForceComputation();
-        checkInteractionWithBoundaries(); // INSERTION boundaries handled
+        {
+            SolveProfiler::ScopedTimer timer(profiler, SolvePhase::INTEGRATE_BEFORE_FORCE_COMPUTATION);
+            integrateBeforeForceComputation();
+        }
+        {
+            SolveProfiler::ScopedTimer timer(profiler, SolvePhase::CHECK_INTERACTION_WITH_BOUNDARIES);
+            checkInteractionWithBoundaries(); // INSERTION boundaries handled
+        }
         hGridActionsAfterIntegration();
 
         // Compute forces
@@ -1985,32 +2126,78 @@ void DPMBase::solve()
 
         actionsBeforeTimeStep();
 
-        checkAndDuplicatePeriodicParticles();
+        {
+            SolveProfiler::ScopedTimer timer(profiler, SolvePhase::CHECK_AND_DUPLICATE_PERIODIC_PARTICLES);
+            checkAndDuplicatePeriodicParticles();
+        }
 
-        hGridActionsBeforeTimeStep();
+        {
+            SolveProfiler::ScopedTimer timer(profiler, SolvePhase::HGRID_ACTIONS_BEFORE_TIME_STEP);
+            hGridActionsBeforeTimeStep();
+        }
 
-        computeAllForces();
+        {
+            SolveProfiler::ScopedTimer timer(profiler, SolvePhase::COMPUTE_ALL_FORCES);
+            computeAllForces();
+        }
 
-        removeDuplicatePeriodicParticles();
+        //the memory usage is sampled while the ghost particles and the new interactions exist
+        if (memoryUsage.isEnabled() && dataFile.getSaveCount() > 0 && ntimeSteps_ % dataFile.getSaveCount() == 0)
+        {
+            computeMemoryUsage();
+            memoryUsage.computeTotal();
+            logger(INFO, "t=% memory usage: %", getTime(), memoryUsage.toString());
+        }
+        if (telemetry.isDue())
+            writeTelemetry();
+
+        {
+            SolveProfiler::ScopedTimer timer(profiler, SolvePhase::REMOVE_DUPLICATE_PERIODIC_PARTICLES);
+            removeDuplicatePeriodicParticles();
+        }
 
         actionsAfterTimeStep();
 
         // Loop over all particles doing the time integration step
         hGridActionsBeforeIntegration();
-        integrateAfterForceComputation();
+        {
+            SolveProfiler::ScopedTimer timer(profiler, SolvePhase::INTEGRATE_AFTER_FORCE_COMPUTATION);
+            integrateAfterForceComputation();
+        }
 
-        checkInteractionWithBoundaries(); // DELETION boundaries handled
+        {
+            SolveProfiler::ScopedTimer timer(profiler, SolvePhase::CHECK_INTERACTION_WITH_BOUNDARIES);
+            checkInteractionWithBoundaries(); // DELETION boundaries handled
+        }
         hGridActionsAfterIntegration();
 
         //erase interactions that have not been used during the last timestep
-        interactionHandler.eraseOldInteractions(getTime() - getTimeStep() * 0.5);
+        {
+            SolveProfiler::ScopedTimer timer(profiler, SolvePhase::ERASE_OLD_INTERACTIONS);
+            interactionHandler.eraseOldInteractions(getTime() - getTimeStep() * 0.5);
+        }
+
+        //sort the particles along a space-filling curve; there are no ghost particles at this point
+        if (particleReordering.isEnabled() && particleReordering.check(*this))
+        {
+            particleReordering.reorder(particleHandler, interactionHandler, getSystemDimensions());
+        }
 
         time_ += timeStep_;
         ntimeSteps_ ++;
     }
     //force writing of the last time step
     setNextSavedTimeStep(ntimeSteps_);
-    writeOutputFiles();
+    {
+        SolveProfiler::ScopedTimer timer(profiler, SolvePhase::WRITE_OUTPUT_FILES);
+        writeOutputFiles();
+    }
+    profiler.stopTimeLoop(ntimeSteps_ - firstTimeStep);
+    if (telemetry.isEnabled())
+    {
+        writeTelemetry();
+        telemetry.close();
+    }
 
     //end loop over interaction count
     actionsAfterSolve();
@@ -2020,6 +2207,34 @@ void DPMBase::solve()
     finishStatistics();
     
     closeFiles();
+
+    if (profiler.isEnabled())
+    {
+        std::cout << "Wall-clock time per phase of the time loop:" << std::endl;
+        profiler.print(std::cout);
+        if (profiler.getNumberOfCountedThreads() > 0)
+        {
+            std::cout << "Hardware counts per thread and phase of the time loop:" << std::endl;
+            profiler.printCounts(std::cout);
+        }
+    }
+
+    if (interactionHandler.getContactLifetimeStatistics().isEnabled())
+    {
+        const ContactLifetimeStatistics& contactLifetimeStatistics = interactionHandler.getContactLifetimeStatistics();
+        std::cout << "Statistics of the contacts that ended:" << std::endl;
+        contactLifetimeStatistics.print(std::cout);
+        contactLifetimeStatistics.write(getName() + ".lifetime");
+        contactLifetimeStatistics.checkTimeStep(getTimeStep());
+    }
+
+    if (memoryUsage.isEnabled())
+    {
+        computeMemoryUsage();
+        memoryUsage.computeTotal();
+        std::cout << "Memory usage (current and peak):" << std::endl;
+        memoryUsage.print(std::cout);
+    }
 }
 
 /*!
@@ -2163,6 +2378,37 @@ bool DPMBase::readNextArgument(int& i, int argc, char *argv[])
     {
         eneFile.setFileType(static_cast<FileType>(atoi(argv[i + 1])));
     }
+    else if (!strcmp(argv[i], "-profile"))
+    {
+        profiler.setEnabled(atoi(argv[i + 1]));
+    }
+    else if (!strcmp(argv[i], "-profileCounters"))
+    {
+        profiler.setEnabled(true);
+        profiler.setHardwareCountersEnabled(atoi(argv[i + 1]));
+    }
+    else if (!strcmp(argv[i], "-telemetry"))
+    {
+        telemetry.setEnabled(true);
+        telemetry.setInterval(atof(argv[i + 1]));
+    }
+    else if (!strcmp(argv[i], "-contactLifetimeStatistics"))
+    {
+        interactionHandler.getContactLifetimeStatistics().setEnabled(atoi(argv[i + 1]));
+    }
+    else if (!strcmp(argv[i], "-memoryUsage"))
+    {
+        memoryUsage.setEnabled(atoi(argv[i + 1]));
+    }
+    else if (!strcmp(argv[i], "-particleReordering"))
+    {
+        particleReordering.setEnabled(true);
+        particleReordering.setInterval(atoi(argv[i + 1]));
+    }
+    else if (!strcmp(argv[i], "-fixedParticleGrid"))
+    {
+        particleHandler.getFixedParticleGrid().setEnabled(atoi(argv[i + 1]));
+    }
     else if (!strcmp(argv[i], "-auto_number"))
     {
         autoNumber();
@@ -2356,7 +2602,9 @@ bool DPMBase::checkParticleForInteraction(const BaseParticle& p)
     Vec3D normal;
     
     //Check if it has no collision with walls
-    for (std::vector<BaseWall*>::const_iterator it = wallHandler.begin(); it != wallHandler.end(); it++)
+    wallHandler.updateBoundingVolumes();
+    const std::vector<BaseWall*>& walls = wallHandler.getCandidateWalls(p);
+    for (std::vector<BaseWall*>::const_iterator it = walls.begin(); it != walls.end(); it++)
     {
         if ((*it)->getDistanceAndNormal(p, distance, normal))
         {
@@ -48,6 +48,10 @@
 #endif
 //This class defines the random number generator
 #include "Math/RNG.h"
+#include "SolveProfiler.h"
+#include "MemoryUsage.h"
+#include "Telemetry.h"
+#include "ParticleReordering.h"
 
 
 /*!
@@ -107,6 +111,16 @@ public:
      */
     virtual void writeOutputFiles();
 
+    /*!
+     * \brief Stores the number of bytes used by the handlers in #memoryUsage.
+     */
+    virtual void computeMemoryUsage();
+
+    /*!
+     * \brief Writes the current progress of the simulation as one line of the telemetry file name.telemetry.
+     */
+    void writeTelemetry();
+
     /*!
      * \brief The solve function is the work horse of the code with the user input.
      */
@@ -236,6 +250,11 @@ public:
      */
     unsigned int getNtimeSteps() const;
 
+    /*!
+     * \brief Returns the number of particle pairs in contact in the last force computation.
+     */
+    unsigned int getNumberOfParticleContacts() const;
+
     /*!
      * \brief Access function for the time
      */
@@ -790,6 +809,11 @@ private:
      */
     unsigned int ntimeSteps_;
 
+    /*!
+     * \brief Stores the number of particle pairs in contact, counted by computeInternalForces
+     */
+    unsigned int numberOfParticleContacts_;
+
     /*!
      * \brief Stores the simulation time step
      */
@@ -872,6 +896,26 @@ public:
      */
     RNG random;
 
+    /*!
+     * \brief Measures the wall-clock time spent in each stage of solve(); disabled by default.
+     */
+    SolveProfiler profiler;
+
+    /*!
+     * \brief Records the number of bytes used by the handlers (and, in derived classes, the HGrid and statistics); disabled by default.
+     */
+    MemoryUsage memoryUsage;
+
+    /*!
+     * \brief Writes the progress of the simulation (rates, counts, memory, eta) at a wall-clock interval; disabled by default.
+     */
+    Telemetry telemetry;
+
+    /*!
+     * \brief Sorts the particles along a space-filling curve at the end of a time step, to improve memory locality; disabled by default.
+     */
+    ParticleReordering particleReordering;
+
     /*!
      * \brief An object of the class ParticleHandler, contains the pointers to all the particles created.
      */
@@ -0,0 +1,335 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "FixedParticleGrid.h"
+#include "Particles/BaseParticle.h"
+#include <algorithm>
+#include <cmath>
+
+///Returns whether two vectors are exactly equal, i.e. whether a particle has not moved
+static bool isSame(const Vec3D& a, const Vec3D& b)
+{
+    return a.X == b.X && a.Y == b.Y && a.Z == b.Z;
+}
+
+///Returns whether all components of a vector are zero
+static bool isZero(const Vec3D& a)
+{
+    return a.X == 0.0 && a.Y == 0.0 && a.Z == 0.0;
+}
+
+FixedParticleGrid::FixedParticleGrid()
+{
+    isEnabled_ = false;
+    isOutdated_ = true;
+    numberOfBuilds_ = 0;
+    maxInteractionRadius_ = 0.0;
+    cellSize_ = 1.0;
+    nX_ = nY_ = nZ_ = 0;
+}
+
+/*!
+ * \param[in] other The FixedParticleGrid whose settings are copied.
+ */
+FixedParticleGrid::FixedParticleGrid(const FixedParticleGrid& other)
+{
+    isEnabled_ = other.isEnabled_;
+    isOutdated_ = true;
+    numberOfBuilds_ = 0;
+    maxInteractionRadius_ = 0.0;
+    cellSize_ = 1.0;
+    nX_ = nY_ = nZ_ = 0;
+}
+
+/*!
+ * \param[in] isEnabled Whether the static particles are stored in this grid 
+ *                      instead of the contact detection of the other particles.
+ */
+void FixedParticleGrid::setEnabled(bool isEnabled)
+{
+    isEnabled_ = isEnabled;
+    isOutdated_ = true;
+}
+
+/*!
+ * \return Whether the static particles are stored in this grid.
+ */
+bool FixedParticleGrid::isEnabled() const
+{
+    return isEnabled_;
+}
+
+/*!
+ * \details Has to be called if a static particle is deleted, such that the grid
+ * does not point to it anymore.
+ */
+void FixedParticleGrid::setOutdated()
+{
+    isOutdated_ = true;
+}
+
+/*!
+ * \return Whether the grid will be rebuilt by the next call to update.
+ */
+bool FixedParticleGrid::isOutdated() const
+{
+    return isOutdated_;
+}
+
+/*!
+ * \param[in] p The particle that is checked.
+ * \return True if the particle is fixed, does not move (no velocity, angular 
+ *         velocity or prescribed motion) and is not a periodic image, such that 
+ *         integrating it would not change it.
+ */
+bool FixedParticleGrid::isStatic(const BaseParticle* p)
+{
+    return p->isFixed() && p->getPeriodicFromParticle() == nullptr && !p->hasPrescribedMotion()
+        && isZero(p->getVelocity()) && isZero(p->getAngularVelocity());
+}
+
+/*!
+ * \param[in] particles The particles of the ParticleHandler.
+ * \return True if the grid was rebuilt, i.e. if particles were added to or 
+ *         removed from the grid, such that the other contact detection has to 
+ *         be updated as well.
+ * \details Checks that exactly the particles in the grid are static, using 
+ * BaseParticle::isInFixedParticleGrid, and that their positions and interaction
+ * radii are the same as at the time the grid was built. The order of the 
+ * particles is not compared, so reordering the ParticleHandler (see 
+ * ParticleReordering) does not rebuild the grid. This costs one pass over the 
+ * particles, which is cheap compared to the force computation, so update is 
+ * called before every time step.
+ */
+bool FixedParticleGrid::update(const std::vector<BaseParticle*>& particles)
+{
+    if (!isEnabled_)
+        return false;
+    if (!isOutdated_)
+    {
+        //the flag is set for all particles by build and is false for copies, so if the numbers agree, the sets agree
+        unsigned int n = 0;
+        for (const BaseParticle* p : particles)
+        {
+            if (p->isInFixedParticleGrid() != isStatic(p))
+            {
+                isOutdated_ = true;
+                break;
+            }
+            if (p->isInFixedParticleGrid())
+                n++;
+        }
+        if (n != staticParticles_.size())
+            isOutdated_ = true;
+    }
+    if (!isOutdated_)
+    {
+        //the particles in the grid still exist, as removing one of them marks the grid as outdated
+        for (unsigned int i = 0; i < staticParticles_.size(); i++)
+        {
+            if (!isSame(positions_[i], staticParticles_[i]->getPosition()) || radii_[i] != staticParticles_[i]->getInteractionRadius())
+            {
+                isOutdated_ = true;
+                break;
+            }
+        }
+    }
+    if (isOutdated_)
+    {
+        build(particles);
+        return true;
+    }
+    return false;
+}
+
+/*!
+ * \param[in] p The particle for which the static neighbours are needed.
+ * \return The static particles in the cells that overlap with a box of 
+ *         half-width p.getInteractionRadius() plus the largest interaction 
+ *         radius in the grid around p. Only those can interact with p.
+ */
+const std::vector<BaseParticle*>& FixedParticleGrid::getCandidateParticles(const BaseParticle& p)
+{
+    candidates_.clear();
+    if (!isEnabled_ || particles_.empty())
+        return candidates_;
+
+    const Mdouble reach = p.getInteractionRadius() + maxInteractionRadius_;
+    const Vec3D& position = p.getPosition();
+    const Mdouble coordinates[3] = {position.X, position.Y, position.Z};
+    const Mdouble min[3] = {min_.X, min_.Y, min_.Z};
+    const unsigned int n[3] = {nX_, nY_, nZ_};
+    unsigned int lo[3], hi[3];
+    for (unsigned int d = 0; d < 3; d++)
+    {
+        const Mdouble cellLo = std::floor((coordinates[d] - reach - min[d]) / cellSize_);
+        const Mdouble cellHi = std::floor((coordinates[d] + reach - min[d]) / cellSize_);
+        if (cellHi < 0.0 || cellLo >= n[d] || std::isnan(cellLo) || std::isnan(cellHi))
+            return candidates_;
+        lo[d] = cellLo < 0.0 ? 0 : static_cast<unsigned int>(cellLo);
+        hi[d] = cellHi >= n[d] ? n[d] - 1 : static_cast<unsigned int>(cellHi);
+    }
+
+    for (unsigned int k = lo[2]; k <= hi[2]; k++)
+    {
+        for (unsigned int j = lo[1]; j <= hi[1]; j++)
+        {
+            const unsigned int row = nX_ * (j + nY_ * k);
+            candidates_.insert(candidates_.end(), particles_.begin() + cellStart_[row + lo[0]],
+                               particles_.begin() + cellStart_[row + hi[0] + 1]);
+        }
+    }
+    return candidates_;
+}
+
+/*!
+ * \return The number of static particles stored in the grid.
+ */
+unsigned int FixedParticleGrid::getNumberOfParticles() const
+{
+    return particles_.size();
+}
+
+/*!
+ * \return The number of cells of the grid.
+ */
+unsigned int FixedParticleGrid::getNumberOfCells() const
+{
+    return nX_ * nY_ * nZ_;
+}
+
+/*!
+ * \return How often the grid has been built; if the static particles do not 
+ *         change, this is one.
+ */
+unsigned int FixedParticleGrid::getNumberOfBuilds() const
+{
+    return numberOfBuilds_;
+}
+
+/*!
+ * \return The largest interaction radius of the particles in the grid.
+ */
+Mdouble FixedParticleGrid::getMaxInteractionRadius() const
+{
+    return maxInteractionRadius_;
+}
+
+/*!
+ * \return The number of bytes used by the grid, excluding the particles.
+ */
+std::size_t FixedParticleGrid::getMemoryUsage() const
+{
+    return sizeof(FixedParticleGrid) + staticParticles_.capacity() * sizeof(BaseParticle*)
+        + positions_.capacity() * sizeof(Vec3D) + radii_.capacity() * sizeof(Mdouble)
+        + cellStart_.capacity() * sizeof(unsigned int)
+        + (particles_.capacity() + candidates_.capacity()) * sizeof(BaseParticle*);
+}
+
+/*!
+ * \param[in] particles The particles of the ParticleHandler.
+ * \details The grid covers the bounding box of the static particles with cubic
+ * cells of the size of the largest static particle; the cells are enlarged if 
+ * there would be many more cells than particles, e.g. for a sparse frozen bed.
+ * The particles are sorted into the cells by a counting sort, such that the 
+ * particles of a cell are in the order of the ParticleHandler. The force and 
+ * torque on the static particles are reset, as they are not reset every time 
+ * step anymore. Every particle is told whether it is in the grid, see 
+ * BaseParticle::isInFixedParticleGrid.
+ */
+void FixedParticleGrid::build(const std::vector<BaseParticle*>& particles)
+{
+    isOutdated_ = false;
+    numberOfBuilds_++;
+    staticParticles_.clear();
+    positions_.clear();
+    radii_.clear();
+    particles_.clear();
+    cellStart_.clear();
+    maxInteractionRadius_ = 0.0;
+    nX_ = nY_ = nZ_ = 0;
+
+    Vec3D max;
+    for (BaseParticle* p : particles)
+    {
+        p->setInFixedParticleGrid(isStatic(p));
+        if (!isStatic(p))
+            continue;
+        if (staticParticles_.empty())
+        {
+            min_ = p->getPosition();
+            max = p->getPosition();
+        }
+        else
+        {
+            min_ = Vec3D::min(min_, p->getPosition());
+            max = Vec3D::max(max, p->getPosition());
+        }
+        staticParticles_.push_back(p);
+        positions_.push_back(p->getPosition());
+        radii_.push_back(p->getInteractionRadius());
+        maxInteractionRadius_ = std::max(maxInteractionRadius_, p->getInteractionRadius());
+        p->setForce(Vec3D(0.0, 0.0, 0.0));
+        p->setTorque(Vec3D(0.0, 0.0, 0.0));
+    }
+    if (staticParticles_.empty())
+        return;
+
+    const Vec3D extent = max - min_;
+    cellSize_ = 2.0 * maxInteractionRadius_;
+    if (cellSize_ <= 0.0)
+        cellSize_ = std::max(1.0, std::max(extent.X, std::max(extent.Y, extent.Z)));
+    const Mdouble maxNumberOfCells = 4.0 * staticParticles_.size() + 64.0;
+    while ((std::floor(extent.X / cellSize_) + 1.0) * (std::floor(extent.Y / cellSize_) + 1.0)
+           * (std::floor(extent.Z / cellSize_) + 1.0) > maxNumberOfCells)
+    {
+        cellSize_ *= 2.0;
+    }
+    nX_ = static_cast<unsigned int>(std::floor(extent.X / cellSize_)) + 1;
+    nY_ = static_cast<unsigned int>(std::floor(extent.Y / cellSize_)) + 1;
+    nZ_ = static_cast<unsigned int>(std::floor(extent.Z / cellSize_)) + 1;
+
+    std::vector<unsigned int> cells(staticParticles_.size());
+    cellStart_.assign(nX_ * nY_ * nZ_ + 1, 0);
+    for (unsigned int i = 0; i < staticParticles_.size(); i++)
+    {
+        const Vec3D relative = positions_[i] - min_;
+        const unsigned int x = std::min(nX_ - 1, static_cast<unsigned int>(relative.X / cellSize_));
+        const unsigned int y = std::min(nY_ - 1, static_cast<unsigned int>(relative.Y / cellSize_));
+        const unsigned int z = std::min(nZ_ - 1, static_cast<unsigned int>(relative.Z / cellSize_));
+        cells[i] = x + nX_ * (y + nY_ * z);
+        cellStart_[cells[i] + 1]++;
+    }
+    for (unsigned int c = 0; c + 1 < cellStart_.size(); c++)
+    {
+        cellStart_[c + 1] += cellStart_[c];
+    }
+    std::vector<unsigned int> next(cellStart_.begin(), cellStart_.end() - 1);
+    particles_.resize(staticParticles_.size());
+    for (unsigned int i = 0; i < staticParticles_.size(); i++)
+    {
+        particles_[next[cells[i]]++] = staticParticles_[i];
+    }
+}
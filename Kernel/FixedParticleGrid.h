@@ -0,0 +1,170 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef FIXEDPARTICLEGRID_H
+#define FIXEDPARTICLEGRID_H
+
+#include <vector>
+#include "Math/Vector.h"
+
+class BaseParticle;
+
+/*!
+ * \brief A uniform grid of the static particles, used to find the static particles near a mobile particle.
+ * \details Rough bottoms (see ChuteBottom::makeRoughBottom) and frozen beds 
+ * consist of many fixed particles that never move. If the grid is enabled, 
+ * these particles are stored once in this grid instead of being inserted into 
+ * the HGrid every time step; they are neither integrated nor used as the 
+ * origin of a contact search, and the force on them is not accumulated. Each 
+ * mobile particle instead asks the grid for the static particles near it, see 
+ * getCandidateParticles.
+ *
+ * A particle is static if it is fixed, has no prescribed motion, zero velocity 
+ * and zero angular velocity, and is not a periodic image (see isStatic). The 
+ * grid is rebuilt by update() if the set of static particles, or the position 
+ * or interaction radius of one of them, has changed. Until then, a particle 
+ * that was added or became static is treated like all other particles; 
+ * BaseParticle::isInFixedParticleGrid tells which particles are in the grid.
+ */
+class FixedParticleGrid
+{
+public:
+    /*!
+     * \brief Default constructor; creates an empty, disabled grid.
+     */
+    FixedParticleGrid();
+
+    /*!
+     * \brief Copy constructor; copies only the settings, the grid is rebuilt when it is used.
+     */
+    FixedParticleGrid(const FixedParticleGrid& other);
+
+    /*!
+     * \brief Enables or disables the grid; if disabled, static particles are treated like all other particles.
+     */
+    void setEnabled(bool isEnabled);
+
+    /*!
+     * \brief Returns whether the grid is enabled.
+     */
+    bool isEnabled() const;
+
+    /*!
+     * \brief Marks the grid as outdated, such that it is rebuilt by the next call to update.
+     */
+    void setOutdated();
+
+    /*!
+     * \brief Returns whether the grid has to be rebuilt before it can be used.
+     */
+    bool isOutdated() const;
+
+    /*!
+     * \brief Returns whether a particle can be stored in the grid, i.e. whether it never moves.
+     */
+    static bool isStatic(const BaseParticle* p);
+
+    /*!
+     * \brief Rebuilds the grid if the static particles changed; returns true if the grid was rebuilt.
+     */
+    bool update(const std::vector<BaseParticle*>& particles);
+
+    /*!
+     * \brief Returns the static particles that can interact with the given particle.
+     */
+    const std::vector<BaseParticle*>& getCandidateParticles(const BaseParticle& p);
+
+    /*!
+     * \brief Returns the number of particles stored in the grid.
+     */
+    unsigned int getNumberOfParticles() const;
+
+    /*!
+     * \brief Returns the number of cells of the grid.
+     */
+    unsigned int getNumberOfCells() const;
+
+    /*!
+     * \brief Returns how often the grid has been built.
+     */
+    unsigned int getNumberOfBuilds() const;
+
+    /*!
+     * \brief Returns the largest interaction radius of the particles in the grid.
+     */
+    Mdouble getMaxInteractionRadius() const;
+
+    /*!
+     * \brief Returns the number of bytes used by the grid.
+     */
+    std::size_t getMemoryUsage() const;
+
+private:
+    /*!
+     * \brief Sorts the static particles into the cells of the grid.
+     */
+    void build(const std::vector<BaseParticle*>& particles);
+
+    ///Whether the grid is used
+    bool isEnabled_;
+
+    ///Whether the grid has to be rebuilt by the next call to update
+    bool isOutdated_;
+
+    ///The number of times the grid has been built
+    unsigned int numberOfBuilds_;
+
+    ///The static particles when the grid was built, to detect changes of their positions and radii
+    std::vector<BaseParticle*> staticParticles_;
+
+    ///The positions of the static particles when the grid was built
+    std::vector<Vec3D> positions_;
+
+    ///The interaction radii of the static particles when the grid was built
+    std::vector<Mdouble> radii_;
+
+    ///The largest interaction radius of the static particles
+    Mdouble maxInteractionRadius_;
+
+    ///The lower corner of the grid
+    Vec3D min_;
+
+    ///The edge length of the (cubic) cells
+    Mdouble cellSize_;
+
+    ///The number of cells in x, y and z direction
+    unsigned int nX_, nY_, nZ_;
+
+    ///The particles in cell c are particles_[cellStart_[c]] to particles_[cellStart_[c+1]-1]; cells are stored x-fastest
+    std::vector<unsigned int> cellStart_;
+
+    ///The static particles, sorted by cell
+    std::vector<BaseParticle*> particles_;
+
+    ///The result of getCandidateParticles, kept to avoid allocations
+    std::vector<BaseParticle*> candidates_;
+};
+
+#endif
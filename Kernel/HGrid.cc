@@ -26,11 +26,14 @@
 #include "HGrid.h"
 #include "Logger.h"
 #include "Particles/BaseParticle.h"
+#include <limits>
 
 HGrid::HGrid()
 {
     needsRebuilding_ = true;
     numberOfBuckets_ = 10;
+    numberOfHashBuckets_ = 10;
+    numberOfDenseCells_ = 0;
     cellOverSizeRatio_ = 1.0;
     occupiedLevelsMask_ = 0;
     logger(DEBUG, "HGrid::HGrid() finished");
@@ -48,6 +51,8 @@ HGrid::HGrid(unsigned int num_buckets, double cellOverSizeRatio, std::vector<dou
 {
     needsRebuilding_ = false;
     numberOfBuckets_ = num_buckets;
+    numberOfHashBuckets_ = num_buckets;
+    numberOfDenseCells_ = 0;
     cellOverSizeRatio_ = cellOverSizeRatio;
     occupiedLevelsMask_ = 0;
     
@@ -113,8 +118,96 @@ void HGrid::insertParticleToHgrid(BaseParticle *obj)
     }
 }
 
+/*!
+ * \param[in] min                   The lower corner of the domain.
+ * \param[in] max                   The upper corner of the domain.
+ * \param[in] dimensions            The number of dimensions of the grid (2 or 3);
+ *                                  in 2D, only the x and y direction are used.
+ * \param[in] maxNumberOfDenseCells The maximum number of direct-indexed buckets.
+ * \return True if the direct-indexed buckets are used, false if the grid keeps 
+ *         hashing all cells.
+ * \details For each level, the cells covering the domain, padded by one cell on
+ *          each side such that the neighbour cells of all cells in the domain 
+ *          are included, get their own bucket. The buckets of a level are 
+ *          stored in x-fastest order, such that neighbouring cells are close 
+ *          in memory, and no two cells of the domain share a bucket. Cells 
+ *          outside the domain (e.g. particles leaving the domain or ghost 
+ *          particles of periodic boundaries) are still hashed into the 
+ *          numberOfHashBuckets_ buckets stored behind the direct-indexed ones.
+ *          If the domain is not finite or needs more than maxNumberOfDenseCells
+ *          buckets, the grid falls back to hashing all cells.
+ *          This function has to be called before any particle is inserted.
+ */
+bool HGrid::setDenseDomain(const Vec3D& min, const Vec3D& max, unsigned int dimensions, unsigned int maxNumberOfDenseCells)
+{
+    denseDomainMin_ = min;
+    denseDomainMax_ = max;
+    
+    const unsigned int numberOfDirections = (dimensions == 2 ? 2 : 3);
+    bool isBounded = true;
+    for (unsigned int d = 0; d < numberOfDirections; d++)
+    {
+        if (!std::isfinite(min.getComponent(d)) || !std::isfinite(max.getComponent(d)) || min.getComponent(d) >= max.getComponent(d))
+        {
+            logger(VERBOSE, "HGrid: the domain is not bounded in direction %, so all cells are hashed.", d);
+            isBounded = false;
+        }
+    }
+    
+    Mdouble numberOfDenseCells = 0;
+    std::vector<DenseLevel> denseLevels;
+    for (unsigned int l = 0; isBounded && l < cellSizes_.size(); l++)
+    {
+        DenseLevel level;
+        int* cellMin[3] = {&level.minX, &level.minY, &level.minZ};
+        unsigned int* numberOfCells[3] = {&level.nX, &level.nY, &level.nZ};
+        Mdouble numberOfCellsInLevel = 1;
+        for (unsigned int d = 0; d < 3; d++)
+        {
+            if (d < numberOfDirections)
+            {
+                Mdouble first = std::floor(min.getComponent(d) * invCellSizes_[l]) - 1;
+                Mdouble last = std::floor(max.getComponent(d) * invCellSizes_[l]) + 1;
+                //the check on the cell coordinates also catches the number of cells overflowing
+                if (first < std::numeric_limits<int>::min() || last > std::numeric_limits<int>::max())
+                {
+                    numberOfCellsInLevel = std::numeric_limits<Mdouble>::max();
+                    break;
+                }
+                *cellMin[d] = static_cast<int>(first);
+                *numberOfCells[d] = static_cast<unsigned int>(last - first + 1);
+            }
+            else
+            {
+                *cellMin[d] = 0;
+                *numberOfCells[d] = 1;
+            }
+            numberOfCellsInLevel *= *numberOfCells[d];
+        }
+        level.offset = static_cast<unsigned int>(numberOfDenseCells);
+        numberOfDenseCells += numberOfCellsInLevel;
+        if (numberOfDenseCells > maxNumberOfDenseCells)
+        {
+            logger(VERBOSE, "HGrid: the domain needs more than % cells, so all cells are hashed.", maxNumberOfDenseCells);
+            denseLevels.clear();
+            numberOfDenseCells = 0;
+            break;
+        }
+        denseLevels.push_back(level);
+    }
+    
+    denseLevels_ = denseLevels;
+    numberOfDenseCells_ = static_cast<unsigned int>(numberOfDenseCells);
+    numberOfBuckets_ = numberOfDenseCells_ + numberOfHashBuckets_;
+    firstBaseParticleInBucket_.assign(numberOfBuckets_, nullptr);
+    bucketIsChecked_.assign(numberOfBuckets_, false);
+    return numberOfDenseCells_ > 0;
+}
+
 /*!
  * \details Computes a hash from parameters, the result is in range [0, numberOfBuckets_-1].
+ *          If the cell lies in the domain set by setDenseDomain, its 
+ *          direct-indexed bucket is returned instead.
  * \param[in] x The coordinate of the cell in x direction for which the hash must be computed.
  * \param[in] y The coordinate of the cell in y direction for which the hash must be computed.
  * \param[in] z The coordinate of the cell in z direction for which the hash must be computed.
@@ -123,19 +216,34 @@ void HGrid::insertParticleToHgrid(BaseParticle *obj)
  */
 unsigned int HGrid::computeHashBucketIndex(int x, int y, int z, unsigned int l) const
 {
+    if (l < denseLevels_.size())
+    {
+        //negative differences wrap around to large unsigned values, so one comparison per direction suffices
+        const DenseLevel& level = denseLevels_[l];
+        const unsigned int i = static_cast<unsigned int>(x - level.minX);
+        const unsigned int j = static_cast<unsigned int>(y - level.minY);
+        const unsigned int k = static_cast<unsigned int>(z - level.minZ);
+        if (i < level.nX && j < level.nY && k < level.nZ)
+        {
+            return level.offset + i + level.nX * (j + level.nY * k);
+        }
+    }
+    
     const unsigned int h1 = 0x8da6b343u; // Large multiplicative constants;
     const unsigned int h2 = 0xd8163841u; // here arbitrarily chosen primes
     const unsigned int h3 = 0xcb1ab31fu;
     const unsigned int h4 = 0x165667b1u;
     
     unsigned long int n = h1 * x + h2 * y + h3 * z + h4 * l;
-    n = n % numberOfBuckets_;
+    n = n % numberOfHashBuckets_;
     
-    return static_cast<unsigned int>(n);
+    return numberOfDenseCells_ + static_cast<unsigned int>(n);
 }
 
 /*!
  * \details Computes a hash from parameters, the result is in range [0, numberOfBuckets_-1].
+ *          If the cell lies in the domain set by setDenseDomain, its 
+ *          direct-indexed bucket is returned instead.
  * \param[in] x The coordinate of the cell in x direction for which the hash must be computed.
  * \param[in] y The coordinate of the cell in y direction for which the hash must be computed.
  * \param[in] l The level in the HGrid of the cell for which the hash must be computed.
@@ -143,14 +251,25 @@ unsigned int HGrid::computeHashBucketIndex(int x, int y, int z, unsigned int l)
  */
 unsigned int HGrid::computeHashBucketIndex(int x, int y, unsigned int l) const
 {
+    if (l < denseLevels_.size())
+    {
+        const DenseLevel& level = denseLevels_[l];
+        const unsigned int i = static_cast<unsigned int>(x - level.minX);
+        const unsigned int j = static_cast<unsigned int>(y - level.minY);
+        if (i < level.nX && j < level.nY)
+        {
+            return level.offset + i + level.nX * j;
+        }
+    }
+    
     const unsigned int h1 = 0x8da6b343u; // Large multiplicative constants;
     const unsigned int h2 = 0xd8163841u; // here arbitrarily chosen primes
     const unsigned int h4 = 0x165667b1u;
     
     unsigned long int n = h1 * x + h2 * y + h4 * l;
-    n = n % numberOfBuckets_;
+    n = n % numberOfHashBuckets_;
     
-    return static_cast<unsigned int>(n);
+    return numberOfDenseCells_ + static_cast<unsigned int>(n);
 }
 
 /*!
@@ -161,6 +280,73 @@ unsigned int HGrid::getNumberOfBuckets() const
     return numberOfBuckets_;
 }
 
+/*!
+ * \return The number of hashed buckets in this HGrid.
+ */
+unsigned int HGrid::getNumberOfHashBuckets() const
+{
+    return numberOfHashBuckets_;
+}
+
+/*!
+ * \return The number of direct-indexed buckets in this HGrid.
+ */
+unsigned int HGrid::getNumberOfDenseCells() const
+{
+    return numberOfDenseCells_;
+}
+
+/*!
+ * \param[in] i The ordinal number of the bucket.
+ * \return True if the bucket is direct-indexed, such that all particles in it are in the same cell.
+ */
+bool HGrid::isDenseBucket(unsigned int i) const
+{
+    return i < numberOfDenseCells_;
+}
+
+/*!
+ * \param[in] min The lower corner of the domain.
+ * \param[in] max The upper corner of the domain.
+ * \return True if setDenseDomain was called with exactly this domain, whether 
+ *         or not the direct-indexed buckets could be used for it.
+ */
+bool HGrid::hasDenseDomain(const Vec3D& min, const Vec3D& max) const
+{
+    //compared component-wise, as infinite bounds have to compare equal
+    return denseDomainMin_.X == min.X && denseDomainMin_.Y == min.Y && denseDomainMin_.Z == min.Z
+        && denseDomainMax_.X == max.X && denseDomainMax_.Y == max.Y && denseDomainMax_.Z == max.Z;
+}
+
+/*!
+ * \return The number of buckets in this HGrid that contain at least one BaseParticle.
+ */
+unsigned int HGrid::getNumberOfOccupiedBuckets() const
+{
+    unsigned int numberOfOccupiedBuckets = 0;
+    for (const BaseParticle* p : firstBaseParticleInBucket_)
+    {
+        if (p != nullptr)
+        {
+            numberOfOccupiedBuckets++;
+        }
+    }
+    return numberOfOccupiedBuckets;
+}
+
+/*!
+ * \return The number of bytes used by this HGrid, including the bucket arrays 
+ *         and the cell sizes of all levels.
+ */
+std::size_t HGrid::getMemoryUsage() const
+{
+    return sizeof(HGrid)
+        + (cellSizes_.capacity() + invCellSizes_.capacity()) * sizeof(double)
+        + firstBaseParticleInBucket_.capacity() * sizeof(BaseParticle*)
+        + bucketIsChecked_.capacity() / 8
+        + denseLevels_.capacity() * sizeof(DenseLevel);
+}
+
 void HGrid::clearBucketIsChecked()
 {
     for (std::vector<bool>::iterator it = bucketIsChecked_.begin(); it != bucketIsChecked_.end(); ++it)
@@ -292,6 +478,8 @@ void HGrid::info() const
     std::cout << "Current status of hGrid parameters:" << std::endl;
     std::cout << "bool needsRebuilding_=" << needsRebuilding_ << std::endl; 
     std::cout << "unsigned int numberOfBuckets_=" << numberOfBuckets_ << std::endl; 
+    std::cout << "unsigned int numberOfHashBuckets_=" << numberOfHashBuckets_ << std::endl; 
+    std::cout << "unsigned int numberOfDenseCells_=" << numberOfDenseCells_ << std::endl; 
     std::cout << "Mdouble cellOverSizeRatio_=" << cellOverSizeRatio_ << std::endl;
     std::cout << "int occupiedLevelsMask_=" << occupiedLevelsMask_ << std::endl; 
     std::cout << "std::vector<double> cellSizes_[" << cellSizes_.size() << "]="; 
@@ -28,6 +28,7 @@
 
 #include <vector>
 #include "Math/ExtendedMath.h"
+#include "Math/Vector.h"
 
 class BaseParticle;
 
@@ -66,6 +67,12 @@ public:
      */
     void insertParticleToHgrid(BaseParticle *obj);
 
+    /*!
+     * \brief Adds a direct-indexed bucket for every cell of the given domain, 
+     *        so cells inside the domain never share a bucket.
+     */
+    bool setDenseDomain(const Vec3D& min, const Vec3D& max, unsigned int dimensions, unsigned int maxNumberOfDenseCells);
+
     /*!
      * \brief Computes hash bucket index in range [0, NUM_BUCKETS-1] for a 3D domain.
      */
@@ -146,6 +153,36 @@ public:
      */
     unsigned int getNumberOfBuckets() const;
 
+    /*!
+     * \brief Gets the number of hashed buckets, which hold the cells outside the dense domain.
+     */
+    unsigned int getNumberOfHashBuckets() const;
+
+    /*!
+     * \brief Gets the number of direct-indexed buckets, which is zero if the grid only uses hashing.
+     */
+    unsigned int getNumberOfDenseCells() const;
+
+    /*!
+     * \brief Gets whether the given bucket is direct-indexed, i.e. holds the particles of a single cell.
+     */
+    bool isDenseBucket(unsigned int i) const;
+
+    /*!
+     * \brief Gets whether setDenseDomain was called with the given domain.
+     */
+    bool hasDenseDomain(const Vec3D& min, const Vec3D& max) const;
+
+    /*!
+     * \brief Gets the number of buckets that contain at least one BaseParticle.
+     */
+    unsigned int getNumberOfOccupiedBuckets() const;
+
+    /*!
+     * \brief Gets the number of bytes used by this HGrid.
+     */
+    std::size_t getMemoryUsage() const;
+
     /*!
      * \brief Gets the number of levels of this HGrid.
      */
@@ -176,6 +213,40 @@ private:
      *          hash function for the grid.
      */
     unsigned int numberOfBuckets_; 
+    
+    /*!
+     * \brief The number of buckets the hash function maps to; these are stored
+     *        after the numberOfDenseCells_ direct-indexed buckets.
+     */
+    unsigned int numberOfHashBuckets_;
+    
+    /*!
+     * \brief The number of direct-indexed buckets of all levels together.
+     */
+    unsigned int numberOfDenseCells_;
+    
+    /*!
+     * \brief The block of direct-indexed buckets of one level.
+     * \details The cells (x,y,z) with minX <= x < minX+nX etc. are stored in 
+     *          x-fastest order starting at bucket offset, so the neighbouring 
+     *          cells of a cell are close in memory.
+     */
+    struct DenseLevel
+    {
+        int minX, minY, minZ;
+        unsigned int nX, nY, nZ;
+        unsigned int offset;
+    };
+    
+    /*!
+     * \brief The direct-indexed blocks of all levels; empty if the grid only uses hashing.
+     */
+    std::vector<DenseLevel> denseLevels_;
+    
+    /*!
+     * \brief The domain passed to setDenseDomain, whether or not it could be used.
+     */
+    Vec3D denseDomainMin_, denseDomainMax_;
 
     /*!
      * \brief The maximum ratio between the size of the cell and the size of a particle it contains.
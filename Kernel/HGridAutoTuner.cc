@@ -0,0 +1,334 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "HGridAutoTuner.h"
+#include "HGridOptimiser.h"
+#include "MercuryBase.h"
+#include "Particles/BaseParticle.h"
+#include "Logger.h"
+#include <cmath>
+#include <limits>
+
+HGridAutoTuner::HGridAutoTuner()
+{
+    isEnabled_ = false;
+    interval_ = 1000;
+    bucketFactor_ = 1;
+    numberOfLevels_ = 0;
+    forcedNumberOfLevels_ = 0;
+    previousNumberOfLevels_ = 0;
+    referenceCost_ = -1;
+    trialCost_ = -1;
+    numberOfParticles_ = 0;
+    minRadius_ = 0;
+    meanRadius_ = 0;
+    maxRadius_ = 0;
+    resetCounters();
+}
+
+/*!
+ * \param[in] other The HGridAutoTuner whose settings are copied.
+ */
+HGridAutoTuner::HGridAutoTuner(const HGridAutoTuner& other)
+        : HGridAutoTuner()
+{
+    isEnabled_ = other.isEnabled_;
+    interval_ = other.interval_;
+}
+
+/*!
+ * \param[in] isEnabled If true, the HGrid is tuned automatically.
+ */
+void HGridAutoTuner::setEnabled(bool isEnabled)
+{
+    isEnabled_ = isEnabled;
+}
+
+bool HGridAutoTuner::isEnabled() const
+{
+    return isEnabled_;
+}
+
+/*!
+ * \param[in] interval The number of time steps between two checks of the grid.
+ */
+void HGridAutoTuner::setInterval(unsigned int interval)
+{
+    if (interval == 0)
+    {
+        logger(ERROR, "HGridAutoTuner::setInterval: the interval has to be positive");
+        return;
+    }
+    interval_ = interval;
+}
+
+unsigned int HGridAutoTuner::getInterval() const
+{
+    return interval_;
+}
+
+unsigned int HGridAutoTuner::getBucketFactor() const
+{
+    return bucketFactor_;
+}
+
+unsigned int HGridAutoTuner::getNumberOfLevels() const
+{
+    return numberOfLevels_;
+}
+
+void HGridAutoTuner::resetCounters()
+{
+    timeSteps_ = 0;
+    bucketsVisited_ = 0;
+    pairsTested_ = 0;
+    hashCollisions_ = 0;
+}
+
+/*!
+ * \param[in] statistics The statistics whose counters are stored.
+ */
+void HGridAutoTuner::recordCounters(const HGridStatistics& statistics)
+{
+    timeSteps_ = statistics.getNumberOfTimeSteps();
+    bucketsVisited_ = statistics.getNumberOfBucketsVisited();
+    pairsTested_ = statistics.getNumberOfPairsTested();
+    hashCollisions_ = statistics.getNumberOfHashCollisions();
+}
+
+/*!
+ * \param[in] particleHandler The particles.
+ * \return The mean interaction radius, or zero if there are no particles.
+ */
+Mdouble HGridAutoTuner::getMeanInteractionRadius(const ParticleHandler& particleHandler)
+{
+    if (particleHandler.getNumberOfObjects() == 0)
+        return 0;
+    Mdouble sum = 0;
+    for (const BaseParticle* p : particleHandler)
+        sum += p->getInteractionRadius();
+    return sum / particleHandler.getNumberOfObjects();
+}
+
+/*!
+ * \details For a monodisperse mixture (or no particles) a single level is used.
+ * Otherwise, the cell sizes (in units of the particle diameter) are optimised 
+ * by the HGridOptimiser for each number of levels up to hGridMaxLevels (or 
+ * only for the number of levels that is tried), and the distribution with the
+ * lowest expected work is chosen. The cell sizes are then multiplied by the 
+ * cellOverSizeRatio; the largest cell is at least as big as the largest 
+ * particle (times the cellOverSizeRatio).
+ * \param[in] problem The MercuryBase whose particles are used.
+ * \param[out] cellSizes The cell sizes of the levels, in increasing order.
+ */
+void HGridAutoTuner::computeCellSizes(const MercuryBase& problem, std::vector<Mdouble>& cellSizes)
+{
+    const ParticleHandler& particleHandler = problem.particleHandler;
+    Mdouble ratio = problem.getHGridCellOverSizeRatio();
+    cellSizes.clear();
+    if (particleHandler.getNumberOfObjects() < 2
+        || particleHandler.getSmallestParticle()->getInteractionRadius() == particleHandler.getLargestParticle()->getInteractionRadius())
+    {
+        Mdouble maxRadius = particleHandler.getNumberOfObjects() > 0 ? particleHandler.getLargestParticle()->getInteractionRadius() : 0;
+        cellSizes.push_back(nextafter(2.0 * maxRadius * ratio, std::numeric_limits<Mdouble>::max()));
+        numberOfLevels_ = 1;
+        return;
+    }
+
+    Mdouble minRadius = particleHandler.getSmallestParticle()->getInteractionRadius();
+    Mdouble maxRadius = particleHandler.getLargestParticle()->getInteractionRadius();
+    HGridOptimiser optimiser;
+    optimiser.initialise(problem, 100, 0);
+    unsigned int minLevels = forcedNumberOfLevels_ > 0 ? forcedNumberOfLevels_ : 1;
+    unsigned int maxLevels = forcedNumberOfLevels_ > 0 ? forcedNumberOfLevels_ : problem.getHGridMaxLevels();
+    std::vector<double> bestSizes;
+    double bestWork = std::numeric_limits<double>::max();
+    for (unsigned int levels = minLevels; levels <= maxLevels; levels++)
+    {
+        //the sizes contain the lower bound of the first level and the upper bounds of all levels
+        std::vector<double> sizes;
+        if (levels == 1)
+        {
+            sizes.push_back(2.0 * minRadius);
+            sizes.push_back(2.0 * maxRadius);
+        }
+        else
+        {
+            optimiser.getOptimalDistribution(sizes, levels, problem.getHGridMethod(), 0);
+        }
+        double work = optimiser.calculateWork(sizes, problem.getHGridMethod(), 0);
+        logger(VERBOSE, "HGridAutoTuner: expected work for % levels is %", sizes.size() - 1, work);
+        if (work < bestWork && std::isfinite(work))
+        {
+            bestWork = work;
+            bestSizes = sizes;
+        }
+    }
+    if (bestSizes.size() < 2)
+    {
+        bestSizes = {2.0 * minRadius, 2.0 * maxRadius};
+    }
+
+    for (unsigned int i = 1; i + 1 < bestSizes.size(); i++)
+    {
+        cellSizes.push_back(bestSizes[i] * ratio);
+    }
+    cellSizes.push_back(nextafter(2.0 * maxRadius * ratio, std::numeric_limits<Mdouble>::max()));
+    numberOfLevels_ = cellSizes.size();
+}
+
+/*!
+ * \details A new size distribution (or new HGrid parameters) lets the tuner 
+ * choose the number of levels again and measure a new reference cost. A 
+ * rebuild for hash collisions keeps the number of levels, but measures a new
+ * reference cost. A rebuild for the broad-phase cost keeps the state set by check.
+ * \param[in] reason The reason for which the grid is rebuilt.
+ */
+void HGridAutoTuner::prepareRebuild(HGridRebuildReason reason)
+{
+    if (reason == HGridRebuildReason::BROAD_PHASE_COST)
+    {
+        return;
+    }
+    referenceCost_ = -1;
+    trialCost_ = -1;
+    if (reason != HGridRebuildReason::HASH_COLLISIONS)
+    {
+        forcedNumberOfLevels_ = 0;
+    }
+    else
+    {
+        forcedNumberOfLevels_ = numberOfLevels_;
+    }
+}
+
+/*!
+ * \param[in] problem The MercuryBase whose grid has been built.
+ */
+void HGridAutoTuner::recordBuild(const MercuryBase& problem)
+{
+    const ParticleHandler& particleHandler = problem.particleHandler;
+    numberOfParticles_ = particleHandler.getNumberOfObjects();
+    minRadius_ = numberOfParticles_ > 0 ? particleHandler.getSmallestParticle()->getInteractionRadius() : 0;
+    maxRadius_ = numberOfParticles_ > 0 ? particleHandler.getLargestParticle()->getInteractionRadius() : 0;
+    meanRadius_ = getMeanInteractionRadius(particleHandler);
+    recordCounters(problem.getHGridStatistics());
+}
+
+/*!
+ * \details See the description of the class. The function returns 
+ * HGridRebuildReason::NONE until interval time steps have been counted since 
+ * the last check or build; then the size distribution, the fraction of hash 
+ * collisions and the broad-phase cost of the last interval are checked.
+ * \param[in] problem The MercuryBase whose grid is checked.
+ * \return The reason for which the grid should be rebuilt, or HGridRebuildReason::NONE.
+ */
+HGridRebuildReason HGridAutoTuner::check(const MercuryBase& problem)
+{
+    const HGridStatistics& statistics = problem.getHGridStatistics();
+    if (!isEnabled_ || statistics.getNumberOfTimeSteps() < timeSteps_ + interval_)
+    {
+        return HGridRebuildReason::NONE;
+    }
+    Mdouble steps = statistics.getNumberOfTimeSteps() - timeSteps_;
+    Mdouble buckets = statistics.getNumberOfBucketsVisited() - bucketsVisited_;
+    Mdouble pairs = statistics.getNumberOfPairsTested() - pairsTested_;
+    Mdouble collisions = statistics.getNumberOfHashCollisions() - hashCollisions_;
+    recordCounters(statistics);
+
+    const ParticleHandler& particleHandler = problem.particleHandler;
+    unsigned int numberOfParticles = particleHandler.getNumberOfObjects();
+    if (numberOfParticles == 0)
+    {
+        return HGridRebuildReason::NONE;
+    }
+
+    //a relative change of more than 10% in the radii or 20% in the number of particles is considered a new distribution
+    Mdouble minRadius = particleHandler.getSmallestParticle()->getInteractionRadius();
+    Mdouble maxRadius = particleHandler.getLargestParticle()->getInteractionRadius();
+    Mdouble meanRadius = getMeanInteractionRadius(particleHandler);
+    if (std::abs(minRadius - minRadius_) > 0.1 * minRadius_ || std::abs(maxRadius - maxRadius_) > 0.1 * maxRadius_
+        || std::abs(meanRadius - meanRadius_) > 0.1 * meanRadius_
+        || std::abs(static_cast<Mdouble>(numberOfParticles) - numberOfParticles_) > 0.2 * numberOfParticles_)
+    {
+        logger(INFO, "HGridAutoTuner: the size distribution has changed: % particles with radii in [%,%] (mean %), "
+                "was % particles in [%,%] (mean %)", numberOfParticles, minRadius, maxRadius, meanRadius, 
+               numberOfParticles_, minRadius_, maxRadius_, meanRadius_);
+        return HGridRebuildReason::SIZE_DISTRIBUTION_CHANGED;
+    }
+
+    if (pairs > 0)
+    {
+        Mdouble hashCollisionFraction = collisions / pairs;
+        if (hashCollisionFraction > 0.5 && bucketFactor_ < 16)
+        {
+            bucketFactor_ *= 2;
+            logger(INFO, "HGridAutoTuner: % of the tested pairs were hash collisions; using % buckets per particle", 
+                   hashCollisionFraction, bucketFactor_);
+            return HGridRebuildReason::HASH_COLLISIONS;
+        }
+        if (hashCollisionFraction < 0.05 && bucketFactor_ > 1)
+        {
+            bucketFactor_ /= 2;
+            logger(INFO, "HGridAutoTuner: only % of the tested pairs were hash collisions; using % buckets per particle", 
+                   hashCollisionFraction, bucketFactor_);
+            return HGridRebuildReason::HASH_COLLISIONS;
+        }
+    }
+
+    Mdouble cost = (buckets + pairs) / (steps * numberOfParticles);
+    if (trialCost_ >= 0)
+    {
+        //a different number of levels has been tried for one interval
+        if (cost >= trialCost_)
+        {
+            logger(INFO, "HGridAutoTuner: % levels did not reduce the broad-phase cost (% instead of %); using % levels again", 
+                   numberOfLevels_, cost, trialCost_, previousNumberOfLevels_);
+            forcedNumberOfLevels_ = previousNumberOfLevels_;
+            referenceCost_ = trialCost_;
+            trialCost_ = -1;
+            return HGridRebuildReason::BROAD_PHASE_COST;
+        }
+        logger(INFO, "HGridAutoTuner: % levels reduced the broad-phase cost from % to %", numberOfLevels_, trialCost_, cost);
+        referenceCost_ = cost;
+        trialCost_ = -1;
+        return HGridRebuildReason::NONE;
+    }
+    if (referenceCost_ < 0)
+    {
+        referenceCost_ = cost;
+        return HGridRebuildReason::NONE;
+    }
+    if (cost > 1.5 * referenceCost_ && problem.getHGridMaxLevels() > 1 && minRadius < maxRadius)
+    {
+        previousNumberOfLevels_ = numberOfLevels_;
+        forcedNumberOfLevels_ = numberOfLevels_ < problem.getHGridMaxLevels() ? numberOfLevels_ + 1 : numberOfLevels_ - 1;
+        trialCost_ = cost;
+        logger(INFO, "HGridAutoTuner: the broad-phase cost has grown from % to % per particle and time step; trying % levels",
+               referenceCost_, cost, forcedNumberOfLevels_);
+        return HGridRebuildReason::BROAD_PHASE_COST;
+    }
+    return HGridRebuildReason::NONE;
+}
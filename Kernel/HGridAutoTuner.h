@@ -0,0 +1,172 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef HGRIDAUTOTUNER_H
+#define HGRIDAUTOTUNER_H
+
+#include <vector>
+#include "GeneralDefine.h"
+#include "HGridStatistics.h"
+
+class MercuryBase;
+class ParticleHandler;
+
+/*!
+ * \brief Chooses the cell sizes and the number of buckets of the HGrid while the simulation runs.
+ * \details When enabled (via MercuryBase::setHGridAutoTune or the command-line 
+ * argument -hGridAutoTune 1), MercuryBase::hGridRebuild asks the tuner for the
+ * cell sizes: for each number of levels up to hGridMaxLevels, the HGridOptimiser 
+ * computes the cell sizes with the lowest expected work for the current 
+ * particle size distribution, and the number of levels with the lowest work is
+ * used. The distribution set by setHGridDistribution is then ignored.
+ * 
+ * Every interval time steps, MercuryBase::hGridActionsBeforeTimeStep calls 
+ * check, which uses the counters of the HGridStatistics (the tuner enables them) 
+ * to decide whether the grid should be rebuilt:
+ *  - if the number of particles, the smallest, the mean or the largest 
+ *    interaction radius has changed significantly since the grid was built 
+ *    (e.g. by insertion, deletion or breakage), the cell sizes are optimised again;
+ *  - if more than half of the tested particle pairs are hash collisions, the 
+ *    number of buckets is doubled (up to 16 buckets per particle); if less than 
+ *    5% are, it is halved again;
+ *  - if the measured broad-phase cost (buckets visited plus pairs tested per 
+ *    particle and time step) has grown by more than 50% since the first interval
+ *    after the grid was built, one more (or one less) level is tried for one 
+ *    interval; if that does not reduce the cost, the previous number of levels is restored.
+ */
+class HGridAutoTuner
+{
+public:
+    /*!
+     * \brief Default constructor; the tuner is disabled and checks the grid every 1000 time steps.
+     */
+    HGridAutoTuner();
+
+    /*!
+     * \brief Copy constructor; copies the settings, but not the state of the tuning.
+     */
+    HGridAutoTuner(const HGridAutoTuner& other);
+
+    /*!
+     * \brief Enables or disables the tuner.
+     */
+    void setEnabled(bool isEnabled);
+
+    /*!
+     * \brief Returns true if the HGrid is tuned automatically.
+     */
+    bool isEnabled() const;
+
+    /*!
+     * \brief Sets the number of time steps between two checks of the grid.
+     */
+    void setInterval(unsigned int interval);
+
+    /*!
+     * \brief Returns the number of time steps between two checks of the grid.
+     */
+    unsigned int getInterval() const;
+
+    /*!
+     * \brief Returns the number of buckets per particle the HGrid is built with.
+     */
+    unsigned int getBucketFactor() const;
+
+    /*!
+     * \brief Returns the number of levels chosen when the grid was last built.
+     */
+    unsigned int getNumberOfLevels() const;
+
+    /*!
+     * \brief Forgets the counters of the last check; called when the HGridStatistics are reset.
+     */
+    void resetCounters();
+
+    /*!
+     * \brief Computes the cell sizes of the levels of the HGrid for the current particles.
+     */
+    void computeCellSizes(const MercuryBase& problem, std::vector<Mdouble>& cellSizes);
+
+    /*!
+     * \brief Prepares the tuner for a rebuild of the grid for the given reason.
+     */
+    void prepareRebuild(HGridRebuildReason reason);
+
+    /*!
+     * \brief Stores the particle size distribution and the counters at the time the grid was built.
+     */
+    void recordBuild(const MercuryBase& problem);
+
+    /*!
+     * \brief Returns the reason for which the grid should be rebuilt, or HGridRebuildReason::NONE.
+     */
+    HGridRebuildReason check(const MercuryBase& problem);
+
+private:
+    /*!
+     * \brief Returns the mean interaction radius of the particles.
+     */
+    static Mdouble getMeanInteractionRadius(const ParticleHandler& particleHandler);
+
+    /*!
+     * \brief Stores the counters of the HGridStatistics, such that the next check uses the counts since now.
+     */
+    void recordCounters(const HGridStatistics& statistics);
+
+    ///If false, the grid is built as set by the user
+    bool isEnabled_;
+
+    ///Number of time steps between two checks
+    unsigned int interval_;
+
+    ///Number of buckets per particle
+    unsigned int bucketFactor_;
+
+    ///Number of levels of the grid at the last build
+    unsigned int numberOfLevels_;
+
+    ///If nonzero, the number of levels the next grid is built with; otherwise the number of levels with the lowest expected work is used
+    unsigned int forcedNumberOfLevels_;
+
+    ///Number of levels before the current trial
+    unsigned int previousNumberOfLevels_;
+
+    ///Broad-phase cost in the first interval after the grid was built; negative if not measured yet
+    Mdouble referenceCost_;
+
+    ///Broad-phase cost before the current trial of another number of levels; negative if there is no trial
+    Mdouble trialCost_;
+
+    ///The number of particles when the grid was built
+    unsigned int numberOfParticles_;
+
+    ///The smallest, mean and largest interaction radius when the grid was built
+    Mdouble minRadius_, meanRadius_, maxRadius_;
+
+    ///The counters of the HGridStatistics at the last check
+    unsigned long timeSteps_, bucketsVisited_, pairsTested_, hashCollisions_;
+};
+
+#endif
@@ -161,10 +161,14 @@ unsigned int HGridOptimiser::radius2Cell(double r)
     return y;
 }
 
+/*!
+ * \details The upper bound rMax_ is included, as it is the upper bound of the 
+ *          largest cell size used by getOptimalDistribution.
+ */
 unsigned int HGridOptimiser::radius2IntCell(double r)
 {
-    if(r < rMin_ || r >= rMax_)
-        throw;
+    if(r < rMin_ || r > rMax_)
+        logger(ERROR, "The radius % is not in the range [%,%]", r, rMin_, rMax_);
     unsigned int y = static_cast<unsigned int> (floor(numCells_ * (r - rMin_) / (rMax_ - rMin_) + 0.5));
     return y;
 }
@@ -0,0 +1,239 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "HGridStatistics.h"
+#include "Logger.h"
+#include <iomanip>
+#include <algorithm>
+
+HGridStatistics::HGridStatistics()
+{
+    isEnabled_ = false;
+    reset();
+}
+
+/*!
+ * \param[in] other The HGridStatistics whose settings are copied.
+ */
+HGridStatistics::HGridStatistics(const HGridStatistics& other)
+{
+    isEnabled_ = other.isEnabled_;
+    reset();
+}
+
+/*!
+ * \param[in] isEnabled If true, the traversal counters are updated.
+ */
+void HGridStatistics::setEnabled(bool isEnabled)
+{
+    isEnabled_ = isEnabled;
+}
+
+bool HGridStatistics::isEnabled() const
+{
+    return isEnabled_;
+}
+
+void HGridStatistics::reset()
+{
+    total_ = {0, 0, 0, 0, 0};
+    atLastWrite_ = total_;
+    for (unsigned int& n : rebuilds_)
+        n = 0;
+    if (file_.is_open())
+        file_.close();
+}
+
+/*!
+ * \param[in] reason The reason for which the grid is rebuilt.
+ */
+void HGridStatistics::addRebuild(HGridRebuildReason reason)
+{
+    rebuilds_[static_cast<unsigned int>(reason)]++;
+}
+
+unsigned long HGridStatistics::getNumberOfTimeSteps() const
+{
+    return total_.timeSteps;
+}
+
+unsigned long HGridStatistics::getNumberOfBucketsVisited() const
+{
+    return total_.bucketsVisited;
+}
+
+unsigned long HGridStatistics::getNumberOfPairsTested() const
+{
+    return total_.pairsTested;
+}
+
+unsigned long HGridStatistics::getNumberOfHashCollisions() const
+{
+    return total_.hashCollisions;
+}
+
+unsigned long HGridStatistics::getNumberOfParticleInsertions() const
+{
+    return total_.particleInsertions;
+}
+
+/*!
+ * \param[in] reason The reason for which the grid was rebuilt.
+ */
+unsigned int HGridStatistics::getNumberOfRebuilds(HGridRebuildReason reason) const
+{
+    return rebuilds_[static_cast<unsigned int>(reason)];
+}
+
+unsigned int HGridStatistics::getNumberOfRebuilds() const
+{
+    unsigned int sum = 0;
+    for (unsigned int n : rebuilds_)
+        sum += n;
+    return sum;
+}
+
+/*!
+ * \param[in] reason The rebuild reason.
+ * \return The name of the reason; "none" for HGridRebuildReason::NONE.
+ */
+std::string HGridStatistics::getName(HGridRebuildReason reason)
+{
+    switch (reason)
+    {
+        case HGridRebuildReason::NO_GRID:
+            return "noGrid";
+        case HGridRebuildReason::PARAMETERS_CHANGED:
+            return "parametersChanged";
+        case HGridRebuildReason::REQUESTED_BY_GRID:
+            return "requestedByGrid";
+        case HGridRebuildReason::NUMBER_OF_BUCKETS:
+            return "numberOfBuckets";
+        case HGridRebuildReason::MAXIMUM_CELL_SIZE:
+            return "maximumCellSize";
+        case HGridRebuildReason::SIZE_DISTRIBUTION_CHANGED:
+            return "sizeDistributionChanged";
+        case HGridRebuildReason::HASH_COLLISIONS:
+            return "hashCollisions";
+        case HGridRebuildReason::BROAD_PHASE_COST:
+            return "broadPhaseCost";
+        default:
+            return "none";
+    }
+}
+
+/*!
+ * \details The bucket, pair and insertion counters are given per time step of the 
+ * interval since the last call; the number of rebuilds is cumulative. The 
+ * last columns contain the number of particles in each level of the grid.
+ * \param[in] name The name of the output file.
+ * \param[in] time The current time.
+ * \param[in] numberOfContacts The current number of particle-particle contacts.
+ * \param[in] numberOfOccupiedBuckets The number of buckets that contain at least one particle.
+ * \param[in] numberOfBuckets The number of buckets of the grid.
+ * \param[in] particlesPerLevel The number of particles in each level of the grid.
+ */
+void HGridStatistics::write(const std::string& name, Mdouble time, unsigned int numberOfContacts, unsigned int numberOfOccupiedBuckets,
+                            unsigned int numberOfBuckets, const std::vector<unsigned int>& particlesPerLevel)
+{
+    if (!file_.is_open())
+    {
+        file_.open(name.c_str(), std::ofstream::out);
+        if (!file_.is_open())
+        {
+            logger(WARN, "HGridStatistics::write: could not open %", name);
+            return;
+        }
+        file_ << "time timeSteps bucketsPerTimeStep pairsTestedPerTimeStep hashCollisionFraction contacts pairsTestedPerContact"
+            " insertionsPerTimeStep rebuilds occupiedBuckets buckets particlesPerLevel" << std::endl;
+    }
+    Mdouble steps = total_.timeSteps - atLastWrite_.timeSteps;
+    Mdouble pairs = total_.pairsTested - atLastWrite_.pairsTested;
+    Mdouble collisions = total_.hashCollisions - atLastWrite_.hashCollisions;
+    Mdouble pairsPerStep = steps > 0 ? pairs / steps : 0.0;
+    file_ << std::setprecision(8) << time
+        << ' ' << total_.timeSteps - atLastWrite_.timeSteps
+        << ' ' << (steps > 0 ? (total_.bucketsVisited - atLastWrite_.bucketsVisited) / steps : 0.0)
+        << ' ' << pairsPerStep
+        << ' ' << (pairs > 0 ? collisions / pairs : 0.0)
+        << ' ' << numberOfContacts
+        << ' ' << (numberOfContacts > 0 ? pairsPerStep / numberOfContacts : 0.0)
+        << ' ' << (steps > 0 ? (total_.particleInsertions - atLastWrite_.particleInsertions) / steps : 0.0)
+        << ' ' << getNumberOfRebuilds()
+        << ' ' << numberOfOccupiedBuckets
+        << ' ' << numberOfBuckets;
+    for (unsigned int n : particlesPerLevel)
+        file_ << ' ' << n;
+    file_ << std::endl;
+    atLastWrite_ = total_;
+}
+
+/*!
+ * \param[in,out] os The stream the counters are printed to.
+ * \param[in] numberOfContacts The current number of particle-particle contacts.
+ * \param[in] numberOfOccupiedBuckets The number of buckets that contain at least one particle.
+ * \param[in] numberOfBuckets The number of buckets of the grid.
+ * \param[in] particlesPerLevel The number of particles in each level of the grid.
+ */
+void HGridStatistics::print(std::ostream& os, unsigned int numberOfContacts, unsigned int numberOfOccupiedBuckets,
+                            unsigned int numberOfBuckets, const std::vector<unsigned int>& particlesPerLevel) const
+{
+    os << "HGrid statistics:" << std::endl;
+    os << "rebuilds " << getNumberOfRebuilds();
+    for (unsigned int i = 1; i < static_cast<unsigned int>(HGridRebuildReason::NUMBER_OF_REASONS); i++)
+        os << ' ' << getName(static_cast<HGridRebuildReason>(i)) << ' ' << rebuilds_[i];
+    os << std::endl;
+    os << "occupiedBuckets " << numberOfOccupiedBuckets << " of " << numberOfBuckets << std::endl;
+    os << "particlesPerLevel";
+    for (unsigned int n : particlesPerLevel)
+        os << ' ' << n;
+    os << std::endl;
+    if (!isEnabled_)
+    {
+        os << "traversal counters are disabled" << std::endl;
+        return;
+    }
+
+    Mdouble steps = std::max(total_.timeSteps, 1ul);
+    Mdouble pairsPerStep = total_.pairsTested / steps;
+    Mdouble hashCollisionFraction = total_.pairsTested > 0 ? static_cast<Mdouble>(total_.hashCollisions) / total_.pairsTested : 0.0;
+    os << "timeSteps " << total_.timeSteps << std::endl;
+    os << "bucketsPerTimeStep " << total_.bucketsVisited / steps << std::endl;
+    os << "pairsTestedPerTimeStep " << pairsPerStep << std::endl;
+    os << "hashCollisionFraction " << hashCollisionFraction << std::endl;
+    os << "contacts " << numberOfContacts << std::endl;
+    if (numberOfContacts > 0)
+        os << "pairsTestedPerContact " << pairsPerStep / numberOfContacts << std::endl;
+    os << "insertionsPerTimeStep " << total_.particleInsertions / steps << std::endl;
+
+    //hints on mistuned parameters
+    if (hashCollisionFraction > 0.25)
+        os << "Hint: many pairs are rejected due to hash collisions; the number of buckets may be too small" << std::endl;
+    if (numberOfContacts > 0 && (1.0 - hashCollisionFraction) * pairsPerStep > 20.0 * numberOfContacts)
+        os << "Hint: many pairs in the same cell are tested per contact; the cellOverSizeRatio may be too large, or hGridMaxLevels too small" << std::endl;
+    //the first build of the grid is not counted
+    if (getNumberOfRebuilds() - getNumberOfRebuilds(HGridRebuildReason::NO_GRID) > 0.01 * steps)
+        os << "Hint: the grid is rebuilt in more than 1% of the time steps" << std::endl;
+}
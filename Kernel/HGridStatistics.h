@@ -0,0 +1,221 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef HGRIDSTATISTICS_H
+#define HGRIDSTATISTICS_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include "GeneralDefine.h"
+
+/*!
+ * \brief The reasons for which the HGrid is rebuilt.
+ * \details The first five are the reasons given by 
+ * MercuryBase::hGridNeedsRebuilding; the last three are only given when the 
+ * HGrid is tuned automatically (see MercuryBase::setHGridAutoTune).
+ */
+enum class HGridRebuildReason : unsigned int
+{
+    NONE,
+    NO_GRID,
+    PARAMETERS_CHANGED,
+    REQUESTED_BY_GRID,
+    NUMBER_OF_BUCKETS,
+    MAXIMUM_CELL_SIZE,
+    SIZE_DISTRIBUTION_CHANGED,
+    HASH_COLLISIONS,
+    BROAD_PHASE_COST,
+    NUMBER_OF_REASONS
+};
+
+/*!
+ * \brief Counts the work done by the HGrid broad phase while the simulation runs.
+ * \details Mercury2D and Mercury3D add, for each bucket they traverse in 
+ * hGridFindOneSidedContacts, the number of particle pairs tested and the 
+ * number of those pairs that were rejected because the particles only share 
+ * the bucket due to a hash collision, not the cell, and the number of particles
+ * they insert in a bucket when updating the grid. MercuryBase counts the time
+ * steps and the rebuilds of the grid, sorted by the reason given by 
+ * hGridNeedsRebuilding. 
+ * 
+ * The traversal counters are disabled by default; then adding a bucket only 
+ * checks a flag. The rebuilds are always counted. When enabled (via 
+ * MercuryBase::getHGridStatistics().setEnabled or the command-line argument 
+ * -hGridStatistics 1), MercuryBase writes the counters of the last output 
+ * interval, together with the number of contacts and the occupancy of each 
+ * level, to the file name.hgrid every saveCount time steps. 
+ * 
+ * A large number of pairs tested per contact indicates that the cells are too
+ * large (cellOverSizeRatio too large, or too few levels for a polydisperse 
+ * mixture); a large fraction of hash collisions indicates that there are too 
+ * few buckets.
+ */
+class HGridStatistics
+{
+public:
+    /*!
+     * \brief Default constructor; the traversal counters are disabled.
+     */
+    HGridStatistics();
+
+    /*!
+     * \brief Copy constructor; copies the settings, but not the counters or the output file.
+     */
+    HGridStatistics(const HGridStatistics& other);
+
+    /*!
+     * \brief Enables or disables the traversal counters.
+     */
+    void setEnabled(bool isEnabled);
+
+    /*!
+     * \brief Returns true if the traversal counters are updated.
+     */
+    bool isEnabled() const;
+
+    /*!
+     * \brief Sets all counters to zero and closes the output file.
+     */
+    void reset();
+
+    /*!
+     * \brief Counts a time step.
+     */
+    void addTimeStep()
+    {
+        if (isEnabled_)
+            total_.timeSteps++;
+    }
+
+    /*!
+     * \brief Counts a traversed bucket, the particle pairs tested in it and the pairs rejected due to a hash collision.
+     */
+    void addBucket(unsigned int pairsTested, unsigned int hashCollisions)
+    {
+        if (isEnabled_)
+        {
+            total_.bucketsVisited++;
+            total_.pairsTested += pairsTested;
+            total_.hashCollisions += hashCollisions;
+        }
+    }
+
+    /*!
+     * \brief Counts a particle inserted in a bucket, either when the grid is 
+     *        updated or when the particle changed cell.
+     */
+    void addParticleInsertion()
+    {
+        if (isEnabled_)
+            total_.particleInsertions++;
+    }
+    /*!
+     * \brief Counts a rebuild of the HGrid.
+     */
+    void addRebuild(HGridRebuildReason reason);
+
+    /*!
+     * \brief Returns the number of time steps counted.
+     */
+    unsigned long getNumberOfTimeSteps() const;
+
+    /*!
+     * \brief Returns the number of buckets traversed.
+     */
+    unsigned long getNumberOfBucketsVisited() const;
+
+    /*!
+     * \brief Returns the number of particle pairs tested, including the pairs rejected due to hash collisions.
+     */
+    unsigned long getNumberOfPairsTested() const;
+
+    /*!
+     * \brief Returns the number of particle pairs rejected because the particles are in different cells that hash to the same bucket.
+     */
+    unsigned long getNumberOfHashCollisions() const;
+
+    /*!
+     * \brief Returns the number of particles inserted in a bucket.
+     */
+    unsigned long getNumberOfParticleInsertions() const;
+    /*!
+     * \brief Returns the number of rebuilds of the HGrid for the given reason.
+     */
+    unsigned int getNumberOfRebuilds(HGridRebuildReason reason) const;
+
+    /*!
+     * \brief Returns the total number of rebuilds of the HGrid.
+     */
+    unsigned int getNumberOfRebuilds() const;
+
+    /*!
+     * \brief Returns the name of a rebuild reason, as it is used in the output.
+     */
+    static std::string getName(HGridRebuildReason reason);
+
+    /*!
+     * \brief Writes the counters since the last call as one line to the file name (the header is written when the file is opened).
+     */
+    void write(const std::string& name, Mdouble time, unsigned int numberOfContacts, unsigned int numberOfOccupiedBuckets, 
+               unsigned int numberOfBuckets, const std::vector<unsigned int>& particlesPerLevel);
+
+    /*!
+     * \brief Prints the cumulative counters, the occupancy of the grid and hints on the HGrid parameters.
+     */
+    void print(std::ostream& os, unsigned int numberOfContacts, unsigned int numberOfOccupiedBuckets, 
+               unsigned int numberOfBuckets, const std::vector<unsigned int>& particlesPerLevel) const;
+
+private:
+    /*!
+     * \brief The traversal counters; stored twice, to compute the values of an output interval.
+     */
+    struct Counters
+    {
+        unsigned long timeSteps;
+        unsigned long bucketsVisited;
+        unsigned long pairsTested;
+        unsigned long hashCollisions;
+        unsigned long particleInsertions;
+    };
+
+    ///If false, the traversal counters are not updated
+    bool isEnabled_;
+
+    ///The counters since the last reset
+    Counters total_;
+
+    ///The counters at the last call to write
+    Counters atLastWrite_;
+
+    ///Number of rebuilds of the HGrid per reason
+    unsigned int rebuilds_[static_cast<unsigned int>(HGridRebuildReason::NUMBER_OF_REASONS)];
+
+    ///The output file, opened at the first call to write
+    std::ofstream file_;
+};
+
+#endif
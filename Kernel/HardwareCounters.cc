@@ -0,0 +1,191 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "HardwareCounters.h"
+#include "Logger.h"
+#include <cstring>
+#include <cerrno>
+#include <mutex>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+static const unsigned int numberOfCounters = static_cast<unsigned int>(HardwareCounter::NUMBER_OF_COUNTERS);
+
+HardwareCounters::HardwareCounters()
+{
+    for (int& fileDescriptor : fileDescriptors_)
+        fileDescriptor = -1;
+    groupLeader_ = -1;
+    numberOfOpenCounters_ = 0;
+}
+
+HardwareCounters::~HardwareCounters()
+{
+    close();
+}
+
+/*!
+ * \details The first counter that can be opened becomes the group leader; the 
+ * other counters are added to its group. If opening a counter fails, the 
+ * reason is logged at VERBOSE level and the counter is skipped.
+ * \return True if at least one counter could be opened.
+ */
+bool HardwareCounters::open()
+{
+    close();
+#ifdef __linux__
+    const uint64_t cache = PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+    const uint32_t types[] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE};
+    const uint64_t configs[] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_L1D | cache,
+                                PERF_COUNT_HW_CACHE_LL | cache, PERF_COUNT_HW_BRANCH_MISSES};
+    for (unsigned int i = 0; i < numberOfCounters; i++)
+    {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = types[i];
+        attributes.config = configs[i];
+        attributes.disabled = (groupLeader_ == -1);
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID;
+        //pid 0 and cpu -1: count the calling thread on any cpu
+        int fileDescriptor = static_cast<int>(syscall(__NR_perf_event_open, &attributes, 0, -1, groupLeader_, 0));
+        if (fileDescriptor == -1)
+        {
+            logger(VERBOSE, "HardwareCounters::open: % is not available (%)", getName(static_cast<HardwareCounter>(i)), std::strerror(errno));
+            continue;
+        }
+        fileDescriptors_[i] = fileDescriptor;
+        numberOfOpenCounters_++;
+        if (groupLeader_ == -1)
+            groupLeader_ = fileDescriptor;
+    }
+    if (groupLeader_ != -1)
+    {
+        ioctl(groupLeader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(groupLeader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+    return isOpen();
+}
+
+void HardwareCounters::close()
+{
+    for (int& fileDescriptor : fileDescriptors_)
+    {
+#ifdef __linux__
+        if (fileDescriptor != -1)
+            ::close(fileDescriptor);
+#endif
+        fileDescriptor = -1;
+    }
+    groupLeader_ = -1;
+    numberOfOpenCounters_ = 0;
+}
+
+bool HardwareCounters::isOpen() const
+{
+    return numberOfOpenCounters_ > 0;
+}
+
+bool HardwareCounters::isAvailable(HardwareCounter counter) const
+{
+    return fileDescriptors_[static_cast<unsigned int>(counter)] != -1;
+}
+
+/*!
+ * \details All counters of the group are read with a single system call. 
+ * \param[out] values Array of length HardwareCounter::NUMBER_OF_COUNTERS, 
+ *             filled with the number of events counted since the counters were opened.
+ */
+void HardwareCounters::read(uint64_t values[]) const
+{
+    for (unsigned int i = 0; i < numberOfCounters; i++)
+        values[i] = 0;
+#ifdef __linux__
+    if (groupLeader_ == -1)
+        return;
+    //the group is read as {number of counters, {value, id} per counter}, in the order in which the counters were opened
+    uint64_t buffer[1 + 2 * numberOfCounters];
+    if (::read(groupLeader_, buffer, sizeof(buffer)) <= 0)
+        return;
+    unsigned int j = 0;
+    for (unsigned int i = 0; i < numberOfCounters && j < buffer[0]; i++)
+    {
+        if (fileDescriptors_[i] != -1)
+        {
+            values[i] = buffer[1 + 2 * j];
+            j++;
+        }
+    }
+#endif
+}
+
+std::string HardwareCounters::getName(HardwareCounter counter)
+{
+    switch (counter)
+    {
+        case HardwareCounter::CYCLES:
+            return "cycles";
+        case HardwareCounter::INSTRUCTIONS:
+            return "instructions";
+        case HardwareCounter::L1D_MISSES:
+            return "L1dMisses";
+        case HardwareCounter::LLC_MISSES:
+            return "LLCMisses";
+        case HardwareCounter::BRANCH_MISSES:
+            return "branchMisses";
+        default:
+            return "unknown";
+    }
+}
+
+/*!
+ * \details If no counter can be opened, a warning is printed once per program
+ * run and the counters of that thread read as zero.
+ * \return The counters of the calling thread.
+ */
+HardwareCounters& HardwareCounters::getThreadCounters()
+{
+    static std::once_flag warning;
+    thread_local HardwareCounters counters;
+    thread_local bool isOpened = false;
+    if (!isOpened)
+    {
+        isOpened = true;
+        if (!counters.open())
+        {
+            std::call_once(warning, []() {
+                logger(WARN, "Hardware performance counters are not available (perf_event_open failed); only wall-clock times are measured");
+            });
+        }
+    }
+    return counters;
+}
@@ -0,0 +1,127 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef HARDWARECOUNTERS_H
+#define HARDWARECOUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+/*!
+ * \brief The hardware events that are counted by the HardwareCounters.
+ */
+enum class HardwareCounter : unsigned int
+{
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_MISSES,
+    LLC_MISSES,
+    BRANCH_MISSES,
+    NUMBER_OF_COUNTERS
+};
+
+/*!
+ * \brief Reads the hardware performance counters of the calling thread, using the Linux perf_event_open interface.
+ * \details The counters are opened as one group, such that they are always 
+ * scheduled together, and only count events in user space. A counter that 
+ * cannot be opened (e.g. because the processor or virtual machine does not 
+ * support it, or because /proc/sys/kernel/perf_event_paranoid forbids it) is 
+ * skipped and reads as zero; if no counter can be opened, or if the code is 
+ * not compiled on Linux, isOpen returns false and read returns zeros.
+ * 
+ * The counters only count the events of the thread that opened them, so each 
+ * thread has to use its own HardwareCounters object; getThreadCounters returns 
+ * the object of the calling thread.
+ */
+class HardwareCounters
+{
+public:
+    /*!
+     * \brief Default constructor; the counters are not opened yet.
+     */
+    HardwareCounters();
+
+    /*!
+     * \brief Destructor; closes the counters.
+     */
+    ~HardwareCounters();
+
+    /*!
+     * \brief The counters are bound to a thread and cannot be copied.
+     */
+    HardwareCounters(const HardwareCounters& other) = delete;
+
+    /*!
+     * \brief The counters are bound to a thread and cannot be copied.
+     */
+    HardwareCounters& operator=(const HardwareCounters& other) = delete;
+
+    /*!
+     * \brief Opens the counters for the calling thread; returns true if at least one counter could be opened.
+     */
+    bool open();
+
+    /*!
+     * \brief Closes all counters.
+     */
+    void close();
+
+    /*!
+     * \brief Returns true if at least one counter is open.
+     */
+    bool isOpen() const;
+
+    /*!
+     * \brief Returns true if the given counter is open.
+     */
+    bool isAvailable(HardwareCounter counter) const;
+
+    /*!
+     * \brief Reads the current values of all counters; counters that are not available are set to zero.
+     */
+    void read(uint64_t values[]) const;
+
+    /*!
+     * \brief Returns the name of a counter, as it is used in the output.
+     */
+    static std::string getName(HardwareCounter counter);
+
+    /*!
+     * \brief Returns the counters of the calling thread, which are opened at the first call.
+     */
+    static HardwareCounters& getThreadCounters();
+
+private:
+    ///The file descriptor of each counter, or -1 if the counter is not open
+    int fileDescriptors_[static_cast<unsigned int>(HardwareCounter::NUMBER_OF_COUNTERS)];
+
+    ///The file descriptor of the group leader, through which all counters are read at once
+    int groupLeader_;
+
+    ///The number of open counters
+    unsigned int numberOfOpenCounters_;
+};
+
+#endif
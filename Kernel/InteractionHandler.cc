@@ -47,8 +47,9 @@ InteractionHandler::InteractionHandler()
  *          by default interactions are not copied.
  * \todo Please check if interactions indeed don't need to be copied.
  */
-InteractionHandler::InteractionHandler(const InteractionHandler& IH UNUSED)
-: BaseHandler<BaseInteraction>()
+InteractionHandler::InteractionHandler(const InteractionHandler& IH)
+: BaseHandler<BaseInteraction>(), contactNetworkStatistics_(IH.contactNetworkStatistics_),
+  contactLifetimeStatistics_(IH.contactLifetimeStatistics_)
 {
     //By default interactions are not copied.
     logger(DEBUG, "InteractionHandler::InteractionHandler(const "
@@ -64,6 +65,7 @@ InteractionHandler InteractionHandler::operator =(const InteractionHandler& rhs)
     if (this != &rhs)
     {
         clear();
+        contactLifetimeStatistics_.reset();
     }
     logger(DEBUG, "InteractionHandler::operator =(const InteractionHandler& rhs) finished.");
     return *this;
@@ -74,6 +76,17 @@ InteractionHandler::~InteractionHandler()
     logger(DEBUG, "InteractionHandler::~InteractionHandler() finished");
 }
 
+/*!
+ * \details The interactions are deleted without being removed one by one, so the
+ *          contact network statistics, which count the existing interactions, are
+ *          reset; otherwise they would be counted twice after reading a restart file.
+ */
+void InteractionHandler::clear()
+{
+    contactNetworkStatistics_.reset();
+    BaseHandler<BaseInteraction>::clear();
+}
+
 /*!
  * \param[in] P A pointer to the BaseInteraction (or derived class) that has to be added.
  */
@@ -83,6 +96,18 @@ void InteractionHandler::addObject(BaseInteraction* I)
     BaseHandler<BaseInteraction>::addObject(I);
     //set the particleHandler pointer
     I->setHandler(this);
+    if (contactNetworkStatistics_.isEnabled())
+        contactNetworkStatistics_.addContact(I);
+}
+
+/*!
+ * \param[in] id The index of the BaseInteraction that has to be removed.
+ */
+void InteractionHandler::removeObject(unsigned const int id)
+{
+    if (contactNetworkStatistics_.isEnabled() && id < getNumberOfObjects())
+        contactNetworkStatistics_.removeContact(getObject(id));
+    BaseHandler<BaseInteraction>::removeObject(id);
 }
 
 /*!
@@ -186,7 +211,7 @@ void InteractionHandler::removeObjectKeepingPeriodics(unsigned const int id)
                     else
                     {
                         //std::cout << "Not switching" << std::endl;
-                        BaseHandler<BaseInteraction>::removeObject(id);
+                        removeObject(id);
                         return;
                     }
                 }
@@ -199,7 +224,7 @@ void InteractionHandler::removeObjectKeepingPeriodics(unsigned const int id)
             }
         }
     }
-    BaseHandler<BaseInteraction>::removeObject(id);
+    removeObject(id);
 }
 
 /*!
@@ -207,6 +232,11 @@ void InteractionHandler::removeObjectKeepingPeriodics(unsigned const int id)
  * that an interaction object has been called. Thus, one can see that an 
  * interaction has ended by comparing the time stamp with the last value of DPMBase::time_.
  * This function erases all interactions that have ended. 
+ * 
+ * These are the only removals that are passed to ContactLifetimeStatistics: 
+ * the interactions of ghost particles that are removed or transferred to the 
+ * real particles in DPMBase::removeDuplicatePeriodicParticles are not ended 
+ * contacts, and there are no ghost particles left when this function is called.
  * \param[in] lastTimeStep the last used value of DPMBase::time_.
  */
 void InteractionHandler::eraseOldInteractions(Mdouble lastTimeStep)
@@ -220,12 +250,47 @@ void InteractionHandler::eraseOldInteractions(Mdouble lastTimeStep)
     {
         if (getObject(id)->getTimeStamp() < lastTimeStep)
         {
+            if (contactLifetimeStatistics_.isEnabled() && getDPMBase() != nullptr)
+                contactLifetimeStatistics_.removeContact(getObject(id), getDPMBase()->getTimeStep());
             removeObject(id);
             --id;
         }
     }
 }
 
+/*!
+ * \details The statistics are updated incrementally, so the existing 
+ * interactions are counted once when the statistics are enabled.
+ * \param[in] isEnabled If true, the statistics are updated.
+ */
+void InteractionHandler::setContactNetworkStatisticsEnabled(bool isEnabled)
+{
+    contactNetworkStatistics_.setEnabled(isEnabled);
+    if (isEnabled)
+        for (BaseInteraction* i : *this)
+            contactNetworkStatistics_.addContact(i);
+}
+
+ContactNetworkStatistics& InteractionHandler::getContactNetworkStatistics()
+{
+    return contactNetworkStatistics_;
+}
+
+const ContactNetworkStatistics& InteractionHandler::getContactNetworkStatistics() const
+{
+    return contactNetworkStatistics_;
+}
+
+ContactLifetimeStatistics& InteractionHandler::getContactLifetimeStatistics()
+{
+    return contactLifetimeStatistics_;
+}
+
+const ContactLifetimeStatistics& InteractionHandler::getContactLifetimeStatistics() const
+{
+    return contactLifetimeStatistics_;
+}
+
 /*!
  * \return the string InteractionHandler
  */
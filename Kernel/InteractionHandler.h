@@ -26,6 +26,8 @@
 #define INTERACTIONHANDLER_H
 #include "BaseHandler.h"
 #include "Interactions/BaseInteraction.h"
+#include "ContactNetworkStatistics.h"
+#include "ContactLifetimeStatistics.h"
 class SpeciesHandler;
 
 /*!
@@ -61,6 +63,16 @@ public:
      */
     void addObject(BaseInteraction* I);
 
+    /*!
+     * \brief Removes an Interaction from the InteractionHandler.
+     */
+    void removeObject(unsigned const int id);
+
+    /*!
+     * \brief Empties the InteractionHandler by removing all Interactions, and resets the contact network statistics.
+     */
+    void clear() override;
+
     /*!
      * \brief Reads an Interaction into the InteractionHandler from restart data.
      */
@@ -97,6 +109,42 @@ public:
      * \brief Returns the name of the object
      */
     std::string getName() const;
+
+    /*!
+     * \brief Enables or disables the incremental contact-network statistics; when enabling, the existing contacts are counted.
+     */
+    void setContactNetworkStatisticsEnabled(bool isEnabled);
+
+    /*!
+     * \brief Returns the contact-network statistics (coordination number, sliding fraction, orientation histogram).
+     */
+    ContactNetworkStatistics& getContactNetworkStatistics();
+
+    /*!
+     * \brief Returns the contact-network statistics (coordination number, sliding fraction, orientation histogram).
+     */
+    const ContactNetworkStatistics& getContactNetworkStatistics() const;
+
+    /*!
+     * \brief Returns the histograms of contact duration, overlap and impact velocity of the removed interactions.
+     */
+    ContactLifetimeStatistics& getContactLifetimeStatistics();
+
+    /*!
+     * \brief Returns the histograms of contact duration, overlap and impact velocity of the removed interactions.
+     */
+    const ContactLifetimeStatistics& getContactLifetimeStatistics() const;
+
+private:
+    /*!
+     * \brief Counts contacts, sliding contacts and contact orientations as interactions are added and removed.
+     */
+    ContactNetworkStatistics contactNetworkStatistics_;
+
+    /*!
+     * \brief Gathers the duration, maximum overlap and impact velocity of the interactions as they are removed.
+     */
+    ContactLifetimeStatistics contactLifetimeStatistics_;
 };
 #endif
 
@@ -31,6 +31,7 @@
 #include "DPMBase.h"
 #include<iomanip>
 #include<fstream>
+#include<limits>
 
 /*!
  * \details This is the constructor which creates a new interactions between two 
@@ -52,6 +53,13 @@ BaseInteraction::BaseInteraction(BaseInteractable* P, BaseInteractable* I, Mdoub
     overlap_ = 0;
     timeStamp_ = timeStamp;
     species_ = 0;
+    handler_ = nullptr;
+    isSliding_ = false;
+    orientationBin_ = -1;
+    creationTime_ = timeStamp;
+    maximumOverlap_ = 0;
+    impactVelocity_ = -1;
+    wallContactParameter_ = std::numeric_limits<Mdouble>::quiet_NaN();
     force_.setZero();
     torque_.setZero();
 #ifdef DEBUG_CONSTRUCTOR
@@ -74,6 +82,13 @@ BaseInteraction::BaseInteraction(const BaseInteraction &p)
     torque_ = p.torque_;
     species_ = p.species_;
     timeStamp_ = p.timeStamp_;
+    handler_ = nullptr;
+    isSliding_ = p.isSliding_;
+    orientationBin_ = -1;
+    creationTime_ = p.creationTime_;
+    maximumOverlap_ = p.maximumOverlap_;
+    impactVelocity_ = p.impactVelocity_;
+    wallContactParameter_ = p.wallContactParameter_;
 }
 
 /*!
@@ -137,6 +152,78 @@ std::string BaseInteraction::getName() const
 void BaseInteraction::setNormal(Vec3D normal)
 {
     normal_ = normal;
+    if (handler_ != nullptr && handler_->getContactNetworkStatistics().isEnabled())
+        handler_->getContactNetworkStatistics().updateOrientation(this);
+}
+
+/*!
+ * \details Called by the friction force models every time the tangential force
+ * is computed. If the state changes, the number of sliding contacts in the 
+ * ContactNetworkStatistics of the handler is updated.
+ * \param[in] isSliding true if the tangential force is at the Coulomb limit.
+ */
+void BaseInteraction::setSliding(bool isSliding)
+{
+    if (isSliding == isSliding_)
+        return;
+    isSliding_ = isSliding;
+    if (handler_ != nullptr && handler_->getContactNetworkStatistics().isEnabled())
+        handler_->getContactNetworkStatistics().updateSliding(isSliding);
+}
+
+/*!
+ * \return true if the tangential force is at the Coulomb limit.
+ */
+bool BaseInteraction::isSliding() const
+{
+    return isSliding_;
+}
+
+/*!
+ * \param[in] orientationBin the bin of the orientation histogram, or -1.
+ */
+void BaseInteraction::setOrientationBin(int orientationBin)
+{
+    orientationBin_ = orientationBin;
+}
+
+/*!
+ * \return the bin of the orientation histogram, or -1.
+ */
+int BaseInteraction::getOrientationBin() const
+{
+    return orientationBin_;
+}
+
+Mdouble BaseInteraction::getCreationTime() const
+{
+    return creationTime_;
+}
+
+Mdouble BaseInteraction::getMaximumOverlap() const
+{
+    return maximumOverlap_;
+}
+
+Mdouble BaseInteraction::getImpactVelocity() const
+{
+    return impactVelocity_;
+}
+
+/*!
+ * \param[in] wallContactParameter The parameter of the contact point, e.g. the helix parameter q of a Screw or Coil.
+ */
+void BaseInteraction::setWallContactParameter(Mdouble wallContactParameter)
+{
+    wallContactParameter_ = wallContactParameter;
+}
+
+/*!
+ * \return The parameter of the contact point at the last time step, or NaN if it has not been set.
+ */
+Mdouble BaseInteraction::getWallContactParameter() const
+{
+    return wallContactParameter_;
 }
 
 /*!
@@ -150,12 +237,14 @@ void BaseInteraction::setDistance(Mdouble distance)
 
 /*!
  * \details set the overlap between the two interactable object involved in the 
- *          interactions.
+ *          interactions; also updates the maximum overlap of the interaction.
  * \param[in] overlap   Mdouble which is the overlap to set.
  */
 void BaseInteraction::setOverlap(Mdouble overlap)
 {
     overlap_ = overlap;
+    if (overlap > maximumOverlap_)
+        maximumOverlap_ = overlap;
 }
 
 /*
@@ -587,7 +676,8 @@ void BaseInteraction::setRelativeVelocity(Vec3D relativeVelocity)
 }
 
 /*!
- * \details set the norm (length) of the normal relative velocity.
+ * \details set the norm (length) of the normal relative velocity. The first 
+ *          value set is stored as the impact velocity of the interaction.
  * \param[in] normalRelativeVelocity    Mdouble containing the normal (length)
  *                                      of the normal velocity between the 
  *                                      interactable objects.
@@ -595,6 +685,9 @@ void BaseInteraction::setRelativeVelocity(Vec3D relativeVelocity)
 void BaseInteraction::setNormalRelativeVelocity(Mdouble normalRelativeVelocity)
 {
     normalRelativeVelocity_=normalRelativeVelocity;
+    //the velocity at the first force computation is the impact velocity
+    if (impactVelocity_ < 0)
+        impactVelocity_ = std::abs(normalRelativeVelocity);
 }
 
 /*!
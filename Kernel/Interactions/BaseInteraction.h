@@ -168,6 +168,51 @@ public:
      */
     Mdouble getOverlap() const;
 
+    /*!
+     * \brief Sets whether the tangential force is at the Coulomb limit; updates the contact-network statistics if the state changes.
+     */
+    void setSliding(bool isSliding);
+
+    /*!
+     * \brief Returns true if the tangential force is at the Coulomb limit.
+     */
+    bool isSliding() const;
+
+    /*!
+     * \brief Sets the orientation bin in which this interaction is counted by the ContactNetworkStatistics (-1 if not counted).
+     */
+    void setOrientationBin(int orientationBin);
+
+    /*!
+     * \brief Returns the orientation bin in which this interaction is counted by the ContactNetworkStatistics (-1 if not counted).
+     */
+    int getOrientationBin() const;
+
+    /*!
+     * \brief Returns the time at which the interaction was created.
+     */
+    Mdouble getCreationTime() const;
+
+    /*!
+     * \brief Returns the largest overlap since the interaction was created.
+     */
+    Mdouble getMaximumOverlap() const;
+
+    /*!
+     * \brief Returns the absolute normal relative velocity at the first force computation (-1 if the force has not been computed yet).
+     */
+    Mdouble getImpactVelocity() const;
+
+    /*!
+     * \brief Sets the parameter of the contact point on a curved wall, which is used as initial guess at the next time step.
+     */
+    void setWallContactParameter(Mdouble wallContactParameter);
+
+    /*!
+     * \brief Returns the parameter of the contact point on a curved wall at the last time step (NaN if it has not been set).
+     */
+    Mdouble getWallContactParameter() const;
+
     /*!
      * \brief Removes this interaction from its interaction hander.
      */
@@ -392,6 +437,36 @@ private:
      */
     Mdouble overlap_;
 
+    /*!
+     * True if the tangential force is at the Coulomb limit.
+     */
+    bool isSliding_;
+
+    /*!
+     * The bin of the orientation histogram in ContactNetworkStatistics in which this interaction is counted; -1 if not counted.
+     */
+    int orientationBin_;
+
+    /*!
+     * The time at which the interaction was created; used by ContactLifetimeStatistics.
+     */
+    Mdouble creationTime_;
+
+    /*!
+     * The largest overlap since the interaction was created; used by ContactLifetimeStatistics.
+     */
+    Mdouble maximumOverlap_;
+
+    /*!
+     * The absolute normal relative velocity at the first force computation, or -1 if it has not been computed yet; used by ContactLifetimeStatistics.
+     */
+    Mdouble impactVelocity_;
+
+    /*!
+     * The parameter of the contact point on a curved wall, e.g. the helix parameter of a Screw or Coil, or NaN if it has not been set.
+     */
+    Mdouble wallContactParameter_;
+
     /*!
      * Pointer to the species of the interaction could be a mixed species or a species.
      */
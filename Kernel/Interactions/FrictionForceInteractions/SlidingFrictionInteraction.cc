@@ -87,7 +87,11 @@ void SlidingFrictionInteraction::read(std::istream& is)
 void SlidingFrictionInteraction::computeFrictionForce()
 {
     //If tangential forces are absent
-    if (getAbsoluteNormalForce() == 0.0) return;
+    if (getAbsoluteNormalForce() == 0.0)
+    {
+        setSliding(false);
+        return;
+    }
 
     const SlidingFrictionSpecies* species = getSpecies();//dynamic_cast
     
@@ -117,9 +121,11 @@ void SlidingFrictionInteraction::computeFrictionForce()
             {
                 //if sticking (|ft|<=mu*|fn|), apply the force
                 addForce(tangentialForce_);
+                setSliding(false);
             }
             else
             {
+                setSliding(true);
                 //if sliding, resize the tangential force such that |ft|=mu*|fn|
                 tangentialForce_ *= species->getSlidingFrictionCoefficient() * getAbsoluteNormalForce() / std::sqrt(tangentialForceSquared);
                 addForce(tangentialForce_);
@@ -135,9 +141,15 @@ void SlidingFrictionInteraction::computeFrictionForce()
 //            }
             Mdouble tangentialRelativeVelocitySquared = tangentialRelativeVelocity.getLengthSquared();
             if (tangentialRelativeVelocitySquared * mathsFunc::square(species->getSlidingDissipation()) <= mathsFunc::square(species->getSlidingFrictionCoefficientStatic() * getAbsoluteNormalForce()))
+            {
                 tangentialForce_=-species->getSlidingDissipation() * tangentialRelativeVelocity;
+                setSliding(false);
+            }
             else //if sliding, set force to Coulomb limit
+            {
                 tangentialForce_=-(species->getSlidingFrictionCoefficient() * getAbsoluteNormalForce() / std::sqrt(tangentialRelativeVelocitySquared)) * tangentialRelativeVelocity;
+                setSliding(true);
+            }
 
             addForce(tangentialForce_);
         }
@@ -132,6 +132,11 @@ public:
     ///\brief Returns the name of the Interaction.
     std::string getName() const final;
 
+    /*!
+     * \brief Returns the number of bytes used by this Interaction, including the history parameters of the contact.
+     */
+    std::size_t getMemoryUsage() const final;
+
     ///\brief Returns the elastic energy stored in the Interaction.
     Mdouble getElasticEnergy() const final;
 
@@ -234,6 +239,17 @@ std::string Interaction<NormalForceInteraction, FrictionForceInteraction, Adhesi
     return NormalForceInteraction::getBaseName() + FrictionForceInteraction::getBaseName() + AdhesiveForceInteraction::getBaseName() + "Interaction";
 }
 
+/*!
+ * \details The history parameters (e.g. the sliding spring) are members of the
+ * force interactions, so they are included in the size of the Interaction.
+ * \return The size of this Interaction.
+ */
+template<class NormalForceInteraction, class FrictionForceInteraction, class AdhesiveForceInteraction>
+std::size_t Interaction<NormalForceInteraction, FrictionForceInteraction, AdhesiveForceInteraction>::getMemoryUsage() const
+{
+    return sizeof(Interaction<NormalForceInteraction, FrictionForceInteraction, AdhesiveForceInteraction>);
+}
+
 /*!
  * \details Called by ??? to integrate time-dependent parameters of the 
  * contact force, such as the SlidingFrictionInteraction::slidingSpring_
@@ -252,6 +252,48 @@ Matrix3D& Matrix3D::operator /=(const Mdouble a)
     return *this;
 }
 
+/*!
+ * \details Adds a scalar multiple of a given matrix to its own; equivalent to
+ * *this += A * a, but the elements are updated in place
+ * \param[in] A     3D matrix to be added
+ * \param[in] a     scalar factor
+ * \return (reference to) resulting (this) matrix
+ */
+Matrix3D& Matrix3D::addScaled(const Matrix3D& A, const Mdouble a)
+{
+    XX += A.XX * a;
+    XY += A.XY * a;
+    XZ += A.XZ * a;
+    YX += A.YX * a;
+    YY += A.YY * a;
+    YZ += A.YZ * a;
+    ZX += A.ZX * a;
+    ZY += A.ZY * a;
+    ZZ += A.ZZ * a;
+    return *this;
+}
+
+/*!
+ * \details Adds the cross product of a vector with each column of a matrix to its own;
+ * equivalent to *this += cross(a, B), but the elements are updated in place
+ * \param[in] a     vector
+ * \param[in] B     matrix
+ * \return (reference to) resulting (this) matrix
+ */
+Matrix3D& Matrix3D::addCross(const Vec3D& a, const Matrix3D& B)
+{
+    XX += a.Y * B.ZX - a.Z * B.YX;
+    XY += a.Y * B.ZY - a.Z * B.YY;
+    XZ += a.Y * B.ZZ - a.Z * B.YZ;
+    YX += a.Z * B.XX - a.X * B.ZX;
+    YY += a.Z * B.XY - a.X * B.ZY;
+    YZ += a.Z * B.XZ - a.X * B.ZZ;
+    ZX += a.X * B.YX - a.Y * B.XX;
+    ZY += a.X * B.YY - a.Y * B.XY;
+    ZZ += a.X * B.YZ - a.Y * B.XZ;
+    return *this;
+}
+
 /*!
  * \details Squares all the elements in given matrix
  * \param[in] A     Matrix to be pointwise squared
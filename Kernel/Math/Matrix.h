@@ -125,6 +125,16 @@ public:
      * \brief Scalar division
      */
     Matrix3D& operator/=(const Mdouble a);
+
+    /*!
+     * \brief Adds a scaled matrix, \f$ this += a A \f$, without creating a temporary
+     */
+    Matrix3D& addScaled(const Matrix3D& A, const Mdouble a);
+
+    /*!
+     * \brief Adds the 'special' cross product, \f$ this += cross(a,B) \f$, without creating a temporary
+     */
+    Matrix3D& addCross(const Vec3D& a, const Matrix3D& B);
     
     /*!
      * \brief Calculates the pointwise square 
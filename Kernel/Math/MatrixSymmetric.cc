@@ -227,6 +227,24 @@ MatrixSymmetric3D& MatrixSymmetric3D::operator/=(const Mdouble a)
     return *this;
 }
 
+/*!
+ * \details Adds a scalar multiple of a given matrix; equivalent to *this += A * a,
+ * but the elements are updated in place
+ * \param[in] A     the matrix to be added
+ * \param[in] a     the scalar factor
+ * \return (reference to) this matrix, which is the result of the addition
+ */
+MatrixSymmetric3D& MatrixSymmetric3D::addScaled(const MatrixSymmetric3D& A, const Mdouble a)
+{
+    XX += A.XX * a;
+    XY += A.XY * a;
+    XZ += A.XZ * a;
+    YY += A.YY * a;
+    YZ += A.YZ * a;
+    ZZ += A.ZZ * a;
+    return *this;
+}
+
 /*!
  * \details Pointwise squares the matrix, i.e. takes the square of each element.
  * NB: is a STATIC function!
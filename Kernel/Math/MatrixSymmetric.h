@@ -126,6 +126,11 @@ public:
      */
     MatrixSymmetric3D& operator/=(const Mdouble a);
 
+    /*!
+     * \brief Adds a scaled matrix, \f$ this += a A \f$, without creating a temporary
+     */
+    MatrixSymmetric3D& addScaled(const MatrixSymmetric3D& A, const Mdouble a);
+
     /*!
      * \brief Calculates the pointwise square 
      */
@@ -140,9 +140,9 @@ Mdouble RNG::getRandomNumberFromLaggedFibonacciGenerator(Mdouble min, Mdouble ma
 Mdouble RNG::test()
 {
     //This are the fixed parameters that define the test
-    static unsigned int num_of_tests = 100000;
-    static Mdouble max_num = 100.0;
-    static unsigned int num_of_bins = 10;
+    const unsigned int num_of_tests = 100000;
+    const Mdouble max_num = 100.0;
+    const unsigned int num_of_bins = 10;
     
     //This is the generated random_number
     Mdouble rn;
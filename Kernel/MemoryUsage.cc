@@ -0,0 +1,164 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "MemoryUsage.h"
+#include <iomanip>
+#include <sstream>
+
+MemoryUsage::MemoryUsage()
+{
+    isEnabled_ = false;
+    reset();
+}
+
+MemoryUsage::MemoryUsage(const MemoryUsage& other)
+{
+    isEnabled_ = other.isEnabled_;
+    reset();
+}
+
+void MemoryUsage::setEnabled(bool isEnabled)
+{
+    isEnabled_ = isEnabled;
+}
+
+bool MemoryUsage::isEnabled() const
+{
+    return isEnabled_;
+}
+
+void MemoryUsage::reset()
+{
+    components_.clear();
+    peakTotalBytes_ = 0;
+}
+
+/*!
+ * \param[in] component The name of the component, e.g. "particles".
+ * \param[in] bytes     The number of bytes the component currently uses.
+ */
+void MemoryUsage::set(const std::string& component, std::size_t bytes)
+{
+    for (Component& c : components_)
+    {
+        if (c.name == component)
+        {
+            c.bytes = bytes;
+            if (bytes > c.peakBytes)
+                c.peakBytes = bytes;
+            return;
+        }
+    }
+    components_.push_back({component, bytes, bytes});
+}
+
+std::size_t MemoryUsage::getBytes(const std::string& component) const
+{
+    const Component* c = find(component);
+    return c == nullptr ? 0 : c->bytes;
+}
+
+std::size_t MemoryUsage::getPeakBytes(const std::string& component) const
+{
+    const Component* c = find(component);
+    return c == nullptr ? 0 : c->peakBytes;
+}
+
+std::size_t MemoryUsage::getTotalBytes() const
+{
+    std::size_t totalBytes = 0;
+    for (const Component& c : components_)
+        totalBytes += c.bytes;
+    return totalBytes;
+}
+
+/*!
+ * \details The peak of the total is not the sum of the peaks of the 
+ * components, since the components do not necessarily peak at the same time.
+ */
+std::size_t MemoryUsage::getPeakTotalBytes() const
+{
+    return peakTotalBytes_;
+}
+
+void MemoryUsage::computeTotal()
+{
+    std::size_t totalBytes = getTotalBytes();
+    if (totalBytes > peakTotalBytes_)
+        peakTotalBytes_ = totalBytes;
+}
+
+std::string MemoryUsage::toString() const
+{
+    std::stringstream ss;
+    ss << "total " << toString(getTotalBytes()) << " (";
+    for (unsigned int i = 0; i < components_.size(); i++)
+    {
+        if (i > 0)
+            ss << ", ";
+        ss << components_[i].name << ' ' << toString(components_[i].bytes);
+    }
+    ss << ')';
+    return ss.str();
+}
+
+void MemoryUsage::print(std::ostream& os) const
+{
+    os << std::left << std::setw(16) << "component" << std::right << std::setw(12) << "current" << std::setw(12) << "peak" << '\n';
+    for (const Component& c : components_)
+    {
+        os << std::left << std::setw(16) << c.name << std::right << std::setw(12) << toString(c.bytes) << std::setw(12) << toString(c.peakBytes) << '\n';
+    }
+    os << std::left << std::setw(16) << "total" << std::right << std::setw(12) << toString(getTotalBytes()) << std::setw(12) << toString(peakTotalBytes_) << std::endl;
+}
+
+/*!
+ * \param[in] bytes A number of bytes.
+ * \return The number of bytes with three significant digits and a unit (B, kB, MB or GB; 1kB = 1024B).
+ */
+std::string MemoryUsage::toString(std::size_t bytes)
+{
+    const char* units[] = {"B", "kB", "MB", "GB"};
+    double value = bytes;
+    unsigned int unit = 0;
+    while (value >= 1024.0 && unit < 3)
+    {
+        value /= 1024.0;
+        unit++;
+    }
+    std::stringstream ss;
+    ss << std::setprecision(3) << value << units[unit];
+    return ss.str();
+}
+
+const MemoryUsage::Component* MemoryUsage::find(const std::string& component) const
+{
+    for (const Component& c : components_)
+    {
+        if (c.name == component)
+            return &c;
+    }
+    return nullptr;
+}
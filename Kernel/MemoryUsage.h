@@ -0,0 +1,149 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef MEMORYUSAGE_H
+#define MEMORYUSAGE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <iostream>
+
+/*!
+ * \brief Keeps track of the number of bytes used by the components of a simulation.
+ * \details Each component (e.g. "particles", "interactions", "hgrid") is 
+ * identified by its name; set stores the current number of bytes of a component 
+ * and updates its peak. The values are computed by DPMBase::computeMemoryUsage, 
+ * which derived classes extend with their own data structures (e.g. the HGrid 
+ * in MercuryBase, the coarse-graining grid in StatisticsVector).
+ * 
+ * The memory accounting is disabled by default. When enabled (via setEnabled or
+ * the command-line argument -memoryUsage 1), solve logs the current memory usage 
+ * every saveCount time steps and prints the current and peak usage per 
+ * component at the end of the run. 
+ * 
+ * The numbers are estimates based on sizeof and the capacity of the containers;
+ * the overhead of the memory allocator is not included.
+ */
+class MemoryUsage
+{
+public:
+    /*!
+     * \brief Default constructor; the memory accounting is disabled.
+     */
+    MemoryUsage();
+
+    /*!
+     * \brief Copy constructor; copies the settings, but not the recorded values.
+     */
+    MemoryUsage(const MemoryUsage& other);
+
+    /*!
+     * \brief Enables or disables the memory accounting.
+     */
+    void setEnabled(bool isEnabled);
+
+    /*!
+     * \brief Returns true if the memory usage is computed during solve.
+     */
+    bool isEnabled() const;
+
+    /*!
+     * \brief Removes all recorded values; called at the start of solve.
+     */
+    void reset();
+
+    /*!
+     * \brief Sets the current number of bytes used by a component and updates its peak.
+     */
+    void set(const std::string& component, std::size_t bytes);
+
+    /*!
+     * \brief Returns the current number of bytes used by a component (0 if the component is unknown).
+     */
+    std::size_t getBytes(const std::string& component) const;
+
+    /*!
+     * \brief Returns the largest number of bytes used by a component (0 if the component is unknown).
+     */
+    std::size_t getPeakBytes(const std::string& component) const;
+
+    /*!
+     * \brief Returns the current number of bytes used by all components.
+     */
+    std::size_t getTotalBytes() const;
+
+    /*!
+     * \brief Returns the largest total number of bytes recorded by computeTotal.
+     */
+    std::size_t getPeakTotalBytes() const;
+
+    /*!
+     * \brief Updates the peak of the total memory usage; called after all components have been set.
+     */
+    void computeTotal();
+
+    /*!
+     * \brief Returns the current memory usage as a single line, e.g. "total 1.2MB (particles 800kB, ...)".
+     */
+    std::string toString() const;
+
+    /*!
+     * \brief Prints a table of the current and peak memory usage per component.
+     */
+    void print(std::ostream& os) const;
+
+    /*!
+     * \brief Returns a number of bytes in a human readable form, e.g. "1.5MB".
+     */
+    static std::string toString(std::size_t bytes);
+
+private:
+    /*!
+     * \brief The recorded memory usage of one component.
+     */
+    struct Component
+    {
+        std::string name;
+        std::size_t bytes;
+        std::size_t peakBytes;
+    };
+
+    /*!
+     * \brief Returns the component with the given name, or nullptr if it has not been set.
+     */
+    const Component* find(const std::string& component) const;
+
+    ///If false, solve does not compute the memory usage
+    bool isEnabled_;
+
+    ///The components, in the order in which they were first set
+    std::vector<Component> components_;
+
+    ///The largest total number of bytes
+    std::size_t peakTotalBytes_;
+};
+
+#endif
@@ -27,6 +27,7 @@
 #define MERCURY2D_H
 
 #include "MercuryBase.h"
+#include "CandidateBatch.h"
 #include <iostream>
 
 /*!
@@ -62,10 +63,15 @@ protected:
     virtual void hGridFindContactsWithinTargetCell(int x, int y, unsigned int l);
 
     /*!
-     * \brief Finds contacts between given BaseParticle and the BaseParticle in the target cell.
+     * \brief Gathers the BaseParticle in the target cell that may be in contact with given BaseParticle.
      */
     virtual void hGridFindContactsWithTargetCell(int x, int y, unsigned int l, BaseParticle* obj);
 
+    /*!
+     * \brief Computes the forces between given BaseParticle and the gathered candidates that overlap with it.
+     */
+    void hGridComputeCandidateForces(BaseParticle* obj);
+
     /*!
      * \brief Finds contacts with the BaseParticle; avoids multiple checks.
      */
@@ -102,5 +108,11 @@ protected:
      */
     void InsertObjAgainstGrid(BaseParticle *obj);
 #endif    
+
+private:
+    /*!
+     * \brief The particles gathered from the traversed cells, whose overlaps are tested in one vectorised loop.
+     */
+    CandidateBatch hGridCandidates_;
 };
 #endif
@@ -81,24 +81,63 @@ void Mercury3D::hGridFindContactsWithinTargetCell(int x, int y, int z, unsigned
         return;
     }
     
-    BaseParticle* p1 = hgrid->getFirstBaseParticleInBucket(bucket);
-    while (p1 != nullptr)
+    //a bucket with less than two particles has no pairs to test
+    BaseParticle* first = hgrid->getFirstBaseParticleInBucket(bucket);
+    if (first == nullptr || first->getHGridNextObject() == nullptr)
     {
-        BaseParticle* p2 = p1->getHGridNextObject();
-        while (p2 != nullptr)
+        hgrid->setBucketIsChecked(bucket);
+        getHGridStatistics().addBucket(0, 0);
+        return;
+    }
+    
+    //gather the particles of the bucket, such that their overlaps are tested in one vectorised loop
+    const bool denseBucket = hgrid->isDenseBucket(bucket);
+    hGridCandidates_.clear();
+    for (BaseParticle* p = first; p != nullptr; p = p->getHGridNextObject())
+    {
+        hGridCandidates_.add(p);
+    }
+    const unsigned int n = hGridCandidates_.getSize();
+    unsigned int pairsTested = n * (n - 1) / 2;
+    unsigned int hashCollisions = 0;
+    
+    for (unsigned int i = 0; i + 1 < n; i++)
+    {
+        BaseParticle* p1 = hGridCandidates_.getParticle(i);
+        const unsigned int numberOfOverlaps = hGridCandidates_.findOverlaps(*p1, i + 1);
+        for (unsigned int k = 0; k < numberOfOverlaps; k++)
         {
+            BaseParticle* p2 = hGridCandidates_.getOverlap(k);
             ///\bug{TW: This check is not necessary, I believe. This is the most-expensive function in most codes (the two checks in this function slows down granular jet by 15%) and the selftests are not affected.}
             ///\bug{DK: I do think this is necessary, for example: If two cells hash to the same bucket and a particle in one of these cells check for collisions with the other cell. Then due to the hashing collision it also gets all particles in it's own cell and thus generating false collisions.}
-            //Check if the BaseParticle* p1 and BaseParticle* p2 are really in the same cell (i.e. no hashing error has occurred)
-            if ((p1->getHGridX() == p2->getHGridX()) && (p1->getHGridY() == p2->getHGridY()) && (p1->getHGridZ() == p2->getHGridZ()) && (p1->getHGridLevel() == p2->getHGridLevel()))
+            //Check if the BaseParticle* p1 and BaseParticle* p2 are really in the same cell (i.e. no hashing error has occurred);
+            //otherwise, the pair would be found again from the cell of p2. A direct-indexed bucket only contains the particles of one cell
+            if (denseBucket || ((p1->getHGridX() == p2->getHGridX()) && (p1->getHGridY() == p2->getHGridY()) && (p1->getHGridZ() == p2->getHGridZ()) && (p1->getHGridLevel() == p2->getHGridLevel())))
             {
                 computeInternalForces(p1, p2);
             }
-            p2 = p2->getHGridNextObject();
         }
-        p1 = p1->getHGridNextObject();
     }
+    
+    //the pairs rejected due to a hash collision are only counted if they are needed for the statistics
+    if (!denseBucket && getHGridStatistics().isEnabled())
+    {
+        for (unsigned int i = 0; i < n; i++)
+        {
+            const BaseParticle* p1 = hGridCandidates_.getParticle(i);
+            for (unsigned int j = i + 1; j < n; j++)
+            {
+                const BaseParticle* p2 = hGridCandidates_.getParticle(j);
+                if (!((p1->getHGridX() == p2->getHGridX()) && (p1->getHGridY() == p2->getHGridY()) && (p1->getHGridZ() == p2->getHGridZ()) && (p1->getHGridLevel() == p2->getHGridLevel())))
+                {
+                    hashCollisions++;
+                }
+            }
+        }
+    }
+    hGridCandidates_.clear();
     hgrid->setBucketIsChecked(bucket);
+    getHGridStatistics().addBucket(pairsTested, hashCollisions);
 }
 
 /*!
@@ -107,10 +146,10 @@ void Mercury3D::hGridFindContactsWithinTargetCell(int x, int y, int z, unsigned
  * \param[in] z     The coordinate of the target cell in z direction.
  * \param[in] l     The level in the HGrid of the target cell.
  * \param[in] obj   A pointer to the BaseParticle for which we want to have interactions.
- * \details Computes all collisions between given BaseParticle and particles in 
+ * \details Gathers the possible collision partners of given BaseParticle in 
  * cell (x,y,z,l). This is done by first checking if the BaseParticle is indeed from
- * another cell, then for all BaseParticle in the target cell it is checked what
- * the forces between that BaseParticle and given BaseParticle are.
+ * another cell, then all BaseParticle in the target cell are added to the candidates,
+ * for which hGridComputeCandidateForces computes the forces of the overlapping pairs.
  */
 void Mercury3D::hGridFindContactsWithTargetCell(int x, int y, int z, unsigned int l, BaseParticle *obj)
 {
@@ -126,18 +165,42 @@ void Mercury3D::hGridFindContactsWithTargetCell(int x, int y, int z, unsigned in
     // Calculate the bucket
     unsigned int bucket = hgrid->computeHashBucketIndex(x, y, z, l);
 
-    // Loop through all objects in the bucket to find nearby objects
-    BaseParticle* p = hgrid->getFirstBaseParticleInBucket(bucket);
-    while (p != nullptr)
+    // Gather the objects in the target cell, such that their overlaps with obj are tested in one vectorised loop
+    unsigned int pairsTested = 0;
+    unsigned int hashCollisions = 0;
+    const bool denseBucket = hgrid->isDenseBucket(bucket);
+    for (BaseParticle* p = hgrid->getFirstBaseParticleInBucket(bucket); p != nullptr; p = p->getHGridNextObject())
     {
+        pairsTested++;
         ///\bug{TW: This check is not necessary, I believe. This is the most-expensive function in most codes (the two checks in this function slows down granular jet by 15%) and the selftests are not affected. DK: I do think this is neccesary, for example: If two cells hash to the same bucket and a particle in one of these cells check for collisions with the other cell. Then due to the hashingcollision it also gets all particles in it's own cell and thus generating false collisions.}
         //Check if the BaseParticle *p really is in the target cell (i.e. no hashing error has occurred)
-        if ((p->getHGridX() == x) && (p->getHGridY() == y) && (p->getHGridZ() == z) && (p->getHGridLevel() == l))
+        if (denseBucket || ((p->getHGridX() == x) && (p->getHGridY() == y) && (p->getHGridZ() == z) && (p->getHGridLevel() == l)))
         {
-            computeInternalForces(obj, p);
+            hGridCandidates_.add(p);
         }
-        p = p->getHGridNextObject();
+        else
+        {
+            hashCollisions++;
+        }
+    }
+    getHGridStatistics().addBucket(pairsTested, hashCollisions);
+}
+
+/*!
+ * \param[in] obj   A pointer to the BaseParticle for which the candidates have been gathered.
+ * \details Tests the candidates gathered by hGridFindContactsWithTargetCell for
+ * overlap with the given BaseParticle in one vectorised loop, and computes the
+ * forces of the overlapping pairs only, in the order in which the candidates were
+ * gathered. Afterwards, the list of candidates is empty again.
+ */
+void Mercury3D::hGridComputeCandidateForces(BaseParticle* obj)
+{
+    const unsigned int numberOfOverlaps = hGridCandidates_.findOverlaps(*obj);
+    for (unsigned int k = 0; k < numberOfOverlaps; k++)
+    {
+        computeInternalForces(obj, hGridCandidates_.getOverlap(k));
     }
+    hGridCandidates_.clear();
 }
 
 /*!
@@ -238,6 +301,8 @@ void Mercury3D::hGridFindOneSidedContacts(BaseParticle* obj)
                     int y = obj->getHGridY();
                     int z = obj->getHGridZ();
                     
+                    //the candidates of the coarser levels are processed first, to keep the order in which the forces are computed
+                    hGridComputeCandidateForces(obj);
                     hGridFindContactsWithinTargetCell(x, y, z, level);
                     hGridFindContactsWithTargetCell(x + 1, y - 1, z, level, obj);
                     hGridFindContactsWithTargetCell(x + 1, y, z, level, obj);
@@ -278,11 +343,16 @@ void Mercury3D::hGridFindOneSidedContacts(BaseParticle* obj)
             break;
         }
     }
+    hGridComputeCandidateForces(obj);
 }
 
 /*!
  * \param[in] obj   A pointer to the BaseParticle that must be updated.
  * \details         Updates the HGrid positions (x, y and z) of the given BaseParticle.
+ *                  If the HGrid is updated incrementally, the particle is only
+ *                  moved to another bucket if it has changed cell; otherwise, 
+ *                  it is inserted in the bucket of its cell, which assumes the
+ *                  buckets have been cleared.
  */
 void Mercury3D::hGridUpdateParticle(BaseParticle* obj)
 {
@@ -322,6 +392,17 @@ void Mercury3D::hGridUpdateParticle(BaseParticle* obj)
             InsertObjAgainstGrid(obj);
         }
 #else
+        if (getHGridIncrementalUpdate())
+        {
+            //the particle keeps its place in the bucket as long as it stays in the same cell
+            if (obj->getHGridX() == x && obj->getHGridY() == y && obj->getHGridZ() == z)
+            {
+                return;
+            }
+            hGridRemoveParticle(obj);
+        }
+        getHGridStatistics().addParticleInsertion();
+        
         unsigned int bucket = hGrid->computeHashBucketIndex(x, y, z, l);
 
         obj->setHGridNextObject(hGrid->getFirstBaseParticleInBucket(bucket));
@@ -342,10 +423,16 @@ void Mercury3D::hGridUpdateParticle(BaseParticle* obj)
 
 /*!
  * \param[in] obj   A pointer to the BaseParticle that needs to be removed.
- * \details         Removes the given BaseParticle from the HGrid.
+ * \details         Removes the given BaseParticle from the HGrid. If the SortAndSweep is
+ *                  used instead, the particle is removed from it.
  */
 void Mercury3D::hGridRemoveParticle(BaseParticle *obj)
 {
+    if (getBroadPhase() == BroadPhase::SORT_AND_SWEEP)
+    {
+        getSortAndSweep().removeParticle(obj);
+        return;
+    }
     HGrid* hGrid=getHGrid();
     if (hGrid)
     {
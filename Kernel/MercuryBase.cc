@@ -25,6 +25,7 @@
 
 #include <limits>
 #include <string.h>
+#include <sstream>
 
 #include "MercuryBase.h"
 #include "Math/Helpers.h"
@@ -56,9 +57,11 @@ MercuryBase::~MercuryBase()
  *          anything else happens.
  */
 MercuryBase::MercuryBase(const MercuryBase& mercuryBase)
+        : hGridAutoTuner_(mercuryBase.hGridAutoTuner_)
 {
     grid = nullptr;
     gridNeedsUpdate_ = true;
+    stepsBeforeUpdate_ = 0;
     
     hGridMethod_ = mercuryBase.hGridMethod_;
     hGridDistribution_ = mercuryBase.hGridDistribution_;
@@ -67,8 +70,12 @@ MercuryBase::MercuryBase(const MercuryBase& mercuryBase)
     totalCurrentMaxRelativeDisplacement_ = mercuryBase.totalCurrentMaxRelativeDisplacement_;
     
     updateEachTimeStep_ = mercuryBase.updateEachTimeStep_;
+    hGridIncrementalUpdate_ = mercuryBase.hGridIncrementalUpdate_;
     hGridMaxLevels_ = mercuryBase.hGridMaxLevels_;
     hGridCellOverSizeRatio_ = mercuryBase.hGridCellOverSizeRatio_;
+    hGridDenseCells_ = mercuryBase.hGridDenseCells_;
+    hGridStatistics_.setEnabled(mercuryBase.hGridStatistics_.isEnabled());
+    broadPhase_ = mercuryBase.broadPhase_;
     
     logger(DEBUG, "HGRID_base(HGrid_base& other) constructor finished.");
 }
@@ -81,26 +88,34 @@ void MercuryBase::constructor()
 {
     grid = nullptr;
     gridNeedsUpdate_ = true;
+    stepsBeforeUpdate_ = 0;
     hGridMaxLevels_ = 3;
     hGridCellOverSizeRatio_ = 1.0;
+    hGridDenseCells_ = false;
     updateEachTimeStep_ = true;
+    hGridIncrementalUpdate_ = false;
     hGridDistribution_ = EXPONENTIAL;
     hGridMethod_ = TOPDOWN;
+    broadPhase_ = BroadPhase::HGRID;
 }
 
 /*!
  * \details Performs all actions that need to be done before the time loop. At the
- *          moment, this means nothing.
+ *          moment, this means resetting the HGrid statistics.
  */
 void MercuryBase::hGridActionsBeforeTimeLoop()
 {
+    hGridStatistics_.reset();
+    hGridAutoTuner_.resetCounters();
 }
 
 /*!
  * \param[in,out] is The input stream from which the MercuryBase must be read.
  * \details This function reads first the properties that are DPMBase related from
  *          the given input stream, after that it reads the hGridMaxLevels_ and 
- *          the hGridCellOverSizeRatio_ from the input stream.
+ *          the hGridCellOverSizeRatio_ from the input stream. If the line also 
+ *          contains the broad phase, it is set; otherwise, the broad phase is 
+ *          not changed.
  */
 void MercuryBase::read(std::istream& is)
 {
@@ -114,6 +129,11 @@ void MercuryBase::read(std::istream& is)
     line >> dummy >> dummy
             >> dummy >> hGridMaxLevels_
             >> dummy >> hGridCellOverSizeRatio_;
+    if (line >> dummy && !dummy.compare("broadPhase"))
+    {
+        line >> dummy;
+        setBroadPhase(!dummy.compare("SORT_AND_SWEEP") ? BroadPhase::SORT_AND_SWEEP : BroadPhase::HGRID);
+    }
 }
 
 /*!
@@ -128,6 +148,8 @@ void MercuryBase::read(std::istream& is)
  * \details Function that writes this MercuryBase to an output stream, for example
  *          a restart file. First writes the domain information, then the walls,
  *          followed by the boundaries and particles, and finally the HGrid information.
+ *          The broad phase is only written if it is not the default (the HGrid), 
+ *          such that restart files of HGrid simulations do not change.
  */
 void MercuryBase::write(std::ostream& os, bool writeAllParticles) const
 {
@@ -136,14 +158,19 @@ void MercuryBase::write(std::ostream& os, bool writeAllParticles) const
     {
         os << "NUM_BUCKETS " << grid->getNumberOfBuckets() << " "
                 << "hGridMaxLevels " << getHGridMaxLevels() << " "
-                << "cellOverSizeRatio " << getHGridCellOverSizeRatio() << std::endl;
+                << "cellOverSizeRatio " << getHGridCellOverSizeRatio();
     }
     else
     {
         os << "NUM_BUCKETS " << 0.0 << " "
                 << "hGridMaxLevels " << getHGridMaxLevels() << " "
-                << "cellOverSizeRatio " << getHGridCellOverSizeRatio() << std::endl;
+                << "cellOverSizeRatio " << getHGridCellOverSizeRatio();
+    }
+    if (broadPhase_ == BroadPhase::SORT_AND_SWEEP)
+    {
+        os << " broadPhase SORT_AND_SWEEP";
     }
+    os << std::endl;
 }
 
 /*!
@@ -182,6 +209,30 @@ bool MercuryBase::getHGridUpdateEachTimeStep() const
     return updateEachTimeStep_;
 }
 
+/*!
+ * \details In the default (non-CONTACT_LIST_HGRID) build, all buckets are 
+ *          cleared and all particles are inserted again whenever the grid is
+ *          updated. If the update is incremental, the buckets are kept and 
+ *          a particle is only moved to another bucket if its cell changed, so
+ *          the cost of an update scales with the number of particles that 
+ *          changed cell. The order in which the particles of a bucket are 
+ *          traversed, and thus the order in which forces are summed, differs
+ *          between the two modes.
+ * \param[in] incrementalUpdate If true, the HGrid is updated incrementally.
+ */
+void MercuryBase::setHGridIncrementalUpdate(bool incrementalUpdate)
+{
+    hGridIncrementalUpdate_ = incrementalUpdate;
+}
+
+/*!
+ * \return True if the HGrid is updated incrementally.
+ */
+bool MercuryBase::getHGridIncrementalUpdate() const
+{
+    return hGridIncrementalUpdate_;
+}
+
 /*!
  * \details Rebuild the HGrid with the current data. First compute the cell sizes
  *          of the new HGrid, then delete the old HGrid and build the new HGrid. 
@@ -196,6 +247,8 @@ bool MercuryBase::getHGridUpdateEachTimeStep() const
  *          to the distribution. USER just takes the cell sizes given by the user.
  *          OLDHGRID computes the smallest cell size and then makes the cells of
  *          each subsequent level twice as big.
+ *          If hGridDenseCells_ is set, the cells inside the domain get 
+ *          direct-indexed buckets, see HGrid::setDenseDomain.
  */
 void
 MercuryBase::hGridRebuild()
@@ -205,7 +258,12 @@ MercuryBase::hGridRebuild()
 
     Mdouble minParticleInteractionRadius = getHGridTargetMinInteractionRadius();
     Mdouble maxParticleInteractionRadius = getHGridTargetMaxInteractionRadius();
-    if(minParticleInteractionRadius == 0.0 || minParticleInteractionRadius == maxParticleInteractionRadius)
+    if(hGridAutoTuner_.isEnabled())
+    {
+        //the tuner ignores the hGridDistribution and chooses the number of levels itself
+        hGridAutoTuner_.computeCellSizes(*this, cellSizes);
+    }
+    else if(minParticleInteractionRadius == 0.0 || minParticleInteractionRadius == maxParticleInteractionRadius)
     {
         //this case is executed if the particleHandler is empty (minParticleInteractionRadius == 0)
         //or if the particle distribution is monodispersed. 
@@ -280,15 +338,33 @@ MercuryBase::hGridRebuild()
     }
 
     grid = new HGrid(getHGridTargetNumberOfBuckets(), getHGridCellOverSizeRatio(), cellSizes);
+    if (hGridDenseCells_)
+    {
+        grid->setDenseDomain(Vec3D(getXMin(), getYMin(), getZMin()), Vec3D(getXMax(), getYMax(), getZMax()),
+                             getSystemDimensions(), getHGridMaxNumberOfDenseCells());
+    }
 
+    //the particles still point to their neighbours in the buckets of the old grid
+    for (BaseParticle* p : particleHandler)
+    {
+        p->setHGridNextObject(nullptr);
+        p->setHGridPrevObject(nullptr);
+    }
     for(std::vector<BaseParticle*>::iterator it = particleHandler.begin(); it != particleHandler.end(); ++it)
     {
+        //static particles are stored in the grid of the ParticleHandler instead
+        if (particleHandler.isInFixedParticleGrid(*it))
+            continue;
         hGridInsertParticle(*it);
         //\todo{This is really ugly fix to force the particle to update}
         (*it)->setHGridX(9999);
         hGridUpdateParticle(*it);
     }
     gridNeedsUpdate_ = false;
+    if(hGridAutoTuner_.isEnabled())
+    {
+        hGridAutoTuner_.recordBuild(*this);
+    }
 }
 
 /*!
@@ -296,7 +372,11 @@ MercuryBase::hGridRebuild()
  */
 void MercuryBase::hGridInsertParticle(BaseParticle *obj)
 {
-    if (grid != nullptr)
+    if (broadPhase_ == BroadPhase::SORT_AND_SWEEP)
+    {
+        sortAndSweep_.insertParticle(obj);
+    }
+    else if (grid != nullptr)
     {
         grid->insertParticleToHgrid(obj);
     }
@@ -313,25 +393,76 @@ void MercuryBase::broadPhase(BaseParticle *i UNUSED)
  */
 void MercuryBase::broadPhase(BaseParticle *i)
 {
-    hGridFindOneSidedContacts(i);
+    if (broadPhase_ == BroadPhase::SORT_AND_SWEEP)
+    {
+        if (sortAndSweep_.needsUpdate())
+        {
+            sortAndSweep_.update(particleHandler, getSystemDimensions());
+        }
+        const std::vector<BaseParticle*>& candidates = sortAndSweep_.getOneSidedCandidates(*i);
+        for (std::vector<BaseParticle*>::const_iterator it = candidates.begin(); it != candidates.end(); ++it)
+        {
+            computeInternalForces(i, *it);
+        }
+    }
+    else
+    {
+        hGridFindOneSidedContacts(i);
+    }
 }
 #endif
 
 /*!
  * \details The actions that are done before each time step, it rebuilds the HGrid
  *          if necessary, otherwise it computes which cell each particle is in.
+ *          If the SortAndSweep is used instead, it is brought up to date.
  */
 void MercuryBase::hGridActionsBeforeTimeStep()
 {
-    ///\todo IFCD Look up if stepsBeforeUpdate is actually used.
-    static int stepsBeforeUpdate = 0;
-    if (hGridNeedsRebuilding())
+    if (broadPhase_ == BroadPhase::SORT_AND_SWEEP)
     {
+        if (particleHandler.updateFixedParticleGrid())
+        {
+            sortAndSweep_.setNeedsRebuilding();
+        }
+        sortAndSweep_.update(particleHandler, getSystemDimensions());
+        return;
+    }
+    
+    ///\todo IFCD Look up if stepsBeforeUpdate_ is actually used.
+    hGridStatistics_.addTimeStep();
+    //if particles entered or left the grid of static particles, they have to leave or enter the HGrid
+    if (particleHandler.updateFixedParticleGrid())
+    {
+        gridNeedsUpdate_ = true;
+    }
+    HGridRebuildReason reason = getHGridRebuildReason();
+    if (reason == HGridRebuildReason::NONE)
+    {
+        reason = hGridAutoTuner_.check(*this);
+    }
+    if (reason != HGridRebuildReason::NONE)
+    {
+        hGridStatistics_.addRebuild(reason);
         //std::cout<<"HGrid needs rebuilding for void HGRID_base::hGridActionsBeforeTimeStep()"<<std::endl;
+        if (hGridAutoTuner_.isEnabled())
+        {
+            hGridAutoTuner_.prepareRebuild(reason);
+        }
         hGridRebuild();
+        if (hGridAutoTuner_.isEnabled())
+        {
+            std::stringstream cellSizes;
+            for (Mdouble cellSize : grid->getCellSizes())
+            {
+                cellSizes << ' ' << cellSize;
+            }
+            logger(INFO, "HGrid rebuilt at t=% because of %: % levels, % buckets, cell sizes%", getTime(), 
+                   HGridStatistics::getName(reason), grid->getNumberOfLevels(), grid->getNumberOfBuckets(), cellSizes.str());
+        }
         ///\todo TW: I believe the following two steps should be in hGridRebuild
         totalCurrentMaxRelativeDisplacement_ = 0;
-        stepsBeforeUpdate = 0;
+        stepsBeforeUpdate_ = 0;
     }
     else
     {
@@ -341,18 +472,24 @@ void MercuryBase::hGridActionsBeforeTimeStep()
         if (getHGridUpdateEachTimeStep() || getHGridTotalCurrentMaxRelativeDisplacement() >= getHGridCellOverSizeRatio() - 1)
         {
 #ifndef CONTACT_LIST_HGRID
-            getHGrid()->clearFirstBaseParticleInBucket();
+            if (!getHGridIncrementalUpdate())
+            {
+                getHGrid()->clearFirstBaseParticleInBucket();
+            }
 #endif
             totalCurrentMaxRelativeDisplacement_ = 0;
             for (std::vector<BaseParticle*>::iterator it = particleHandler.begin(); it != particleHandler.end(); ++it)
             {
-                hGridUpdateParticle(*it);
+                if (!particleHandler.isInFixedParticleGrid(*it))
+                {
+                    hGridUpdateParticle(*it);
+                }
             }
-            stepsBeforeUpdate = 0;
+            stepsBeforeUpdate_ = 0;
         }
         else
         {
-            stepsBeforeUpdate++;
+            stepsBeforeUpdate_++;
         }
     }
     
@@ -366,6 +503,10 @@ void MercuryBase::hGridActionsBeforeTimeStep()
  */
 void MercuryBase::hGridUpdateMove(BaseParticle* iP, Mdouble move)
 {
+    if (grid == nullptr)
+    {
+        return;
+    }
     Mdouble currentRelativeDisplacement = move / (getHGrid()->getCellSize(iP->getHGridLevel()));
     if (currentRelativeDisplacement > currentMaxRelativeDisplacement_)
     {
@@ -381,6 +522,7 @@ void MercuryBase::hGridActionsBeforeIntegration()
 void MercuryBase::hGridActionsAfterIntegration()
 {
     totalCurrentMaxRelativeDisplacement_ += 2.0 * currentMaxRelativeDisplacement_;
+    sortAndSweep_.setOutdated();
 }
 
 /*!
@@ -426,6 +568,26 @@ bool MercuryBase::readNextArgument(int& i, int argc, char *argv[])
     {
         setHGridCellOverSizeRatio(atof(argv[i + 1]));
     }
+    else if (!strcmp(argv[i], "-hGridStatistics"))
+    {
+        hGridStatistics_.setEnabled(atoi(argv[i + 1]));
+    }
+    else if (!strcmp(argv[i], "-hGridAutoTune"))
+    {
+        setHGridAutoTune(atoi(argv[i + 1]));
+    }
+    else if (!strcmp(argv[i], "-hGridIncrementalUpdate"))
+    {
+        setHGridIncrementalUpdate(atoi(argv[i + 1]));
+    }
+    else if (!strcmp(argv[i], "-hGridDenseCells"))
+    {
+        setHGridDenseCells(atoi(argv[i + 1]));
+    }
+    else if (!strcmp(argv[i], "-sortAndSweep"))
+    {
+        setBroadPhase(atoi(argv[i + 1]) ? BroadPhase::SORT_AND_SWEEP : BroadPhase::HGRID);
+    }
     else
     {
         return DPMBase::readNextArgument(i, argc, argv); //if argv[i] is not found, check the commands in MD
@@ -494,6 +656,122 @@ void MercuryBase::setHGridCellOverSizeRatio(Mdouble hGridCellOverSizeRatio)
     }
 }
 
+/*!
+ * \details If enabled, the HGrid is rebuilt before the next time step with 
+ *          the cell sizes chosen by the HGridAutoTuner, and the HGridStatistics
+ *          are enabled, as the tuner uses their counters.
+ * \param[in] autoTune If true, the cell sizes and the number of buckets of the 
+ *                     HGrid are tuned automatically.
+ */
+void MercuryBase::setHGridAutoTune(bool autoTune)
+{
+    if (autoTune != hGridAutoTuner_.isEnabled())
+    {
+        gridNeedsUpdate_ = true;
+        hGridAutoTuner_.setEnabled(autoTune);
+    }
+    if (autoTune)
+    {
+        hGridStatistics_.setEnabled(true);
+    }
+}
+
+/*!
+ * \return True if the cell sizes and the number of buckets of the HGrid are tuned automatically.
+ */
+bool MercuryBase::getHGridAutoTune() const
+{
+    return hGridAutoTuner_.isEnabled();
+}
+
+/*!
+ * \param[in] interval The number of time steps between two checks of the automatically tuned HGrid.
+ */
+void MercuryBase::setHGridAutoTuneInterval(unsigned int interval)
+{
+    hGridAutoTuner_.setInterval(interval);
+}
+
+/*!
+ * \return The number of time steps between two checks of the automatically tuned HGrid.
+ */
+unsigned int MercuryBase::getHGridAutoTuneInterval() const
+{
+    return hGridAutoTuner_.getInterval();
+}
+
+/*!
+ * \details Direct-indexed buckets are only used if the domain is finite in all
+ *          directions and needs at most getHGridMaxNumberOfDenseCells() cells;
+ *          otherwise, the HGrid falls back to hashing all cells. Particles 
+ *          outside the domain are hashed in either case. Changing the domain 
+ *          causes the HGrid to be rebuilt.
+ * \param[in] denseCells If true, the cells inside the domain get 
+ *                       direct-indexed buckets, so neighbouring cells are 
+ *                       adjacent in memory and no hash collisions occur.
+ */
+void MercuryBase::setHGridDenseCells(bool denseCells)
+{
+    if (hGridDenseCells_ != denseCells)
+    {
+        gridNeedsUpdate_ = true;
+        hGridDenseCells_ = denseCells;
+    }
+}
+
+/*!
+ * \return True if the cells inside the domain get direct-indexed buckets instead of being hashed.
+ */
+bool MercuryBase::getHGridDenseCells() const
+{
+    return hGridDenseCells_;
+}
+
+/*!
+ * \details The HGrid is deleted if the SortAndSweep is chosen and rebuilt 
+ *          before the next time step if the HGrid is chosen again.
+ * \param[in] broadPhase Whether the HGrid or the SortAndSweep is used to find 
+ *                       possible contacts between particles.
+ */
+void MercuryBase::setBroadPhase(BroadPhase broadPhase)
+{
+    if (broadPhase_ != broadPhase)
+    {
+        broadPhase_ = broadPhase;
+        gridNeedsUpdate_ = true;
+        sortAndSweep_.setNeedsRebuilding();
+        if (broadPhase_ == BroadPhase::SORT_AND_SWEEP && grid != nullptr)
+        {
+            delete grid;
+            grid = nullptr;
+        }
+    }
+}
+
+/*!
+ * \return Whether the HGrid or the SortAndSweep is used to find possible contacts between particles.
+ */
+BroadPhase MercuryBase::getBroadPhase() const
+{
+    return broadPhase_;
+}
+
+/*!
+ * \return A reference to the SortAndSweep of this MercuryBase.
+ */
+SortAndSweep& MercuryBase::getSortAndSweep()
+{
+    return sortAndSweep_;
+}
+
+/*!
+ * \return A const reference to the SortAndSweep of this MercuryBase.
+ */
+const SortAndSweep& MercuryBase::getSortAndSweep() const
+{
+    return sortAndSweep_;
+}
+
 /*!
  * \param[in] hGridMaxLevels The maximum number of levels that will be used in the HGrid.
  */
@@ -518,37 +796,51 @@ unsigned int MercuryBase::getHGridMaxLevels() const
  * \return A boolean which indicates if the HGrid needs to be rebuilt.
  */
 bool MercuryBase::hGridNeedsRebuilding()
+{
+    return getHGridRebuildReason() != HGridRebuildReason::NONE;
+}
+
+/*!
+ * \return The first reason found for which the HGrid needs to be rebuilt, or 
+ *         HGridRebuildReason::NONE if the current grid can be used.
+ */
+HGridRebuildReason MercuryBase::getHGridRebuildReason()
 {
     if (grid == nullptr)
     {
         logger(VERBOSE, "HGrid needs updating, because there is no grid.");
-        return true;
+        return HGridRebuildReason::NO_GRID;
     }
     else if (gridNeedsUpdate_)
     {
         logger(VERBOSE, "HGrid needs updating, because some of its initialisation parameters have changed.");
-        return true;
+        return HGridRebuildReason::PARAMETERS_CHANGED;
     }
     else if (grid->getNeedsRebuilding())
     {
         logger(VERBOSE, "HGrid needs updating, because said so by the grid itself");
-        return true;
+        return HGridRebuildReason::REQUESTED_BY_GRID;
+    }
+    else if (hGridDenseCells_ && !grid->hasDenseDomain(Vec3D(getXMin(), getYMin(), getZMin()), Vec3D(getXMax(), getYMax(), getZMax())))
+    {
+        logger(VERBOSE, "HGrid needs updating, because the domain of the direct-indexed cells has changed.");
+        return HGridRebuildReason::PARAMETERS_CHANGED;
     }
-    else if (getHGrid()->getNumberOfBuckets() > 10 * getHGridTargetNumberOfBuckets() || 10 * getHGrid()->getNumberOfBuckets() < getHGridTargetNumberOfBuckets())
+    else if (getHGrid()->getNumberOfHashBuckets() > 10 * getHGridTargetNumberOfBuckets() || 10 * getHGrid()->getNumberOfHashBuckets() < getHGridTargetNumberOfBuckets())
     {
-        logger(VERBOSE, "HGrid needs updating, because of number of buckets, current = %, target = %.", grid->getNumberOfBuckets(), particleHandler.getNumberOfObjects());
-        return true;
+        logger(VERBOSE, "HGrid needs updating, because of number of buckets, current = %, target = %.", grid->getNumberOfHashBuckets(), particleHandler.getNumberOfObjects());
+        return HGridRebuildReason::NUMBER_OF_BUCKETS;
     }
     else if (particleHandler.getLargestParticle() != nullptr && 2.0 * particleHandler.getLargestParticle()->getInteractionRadius() > getHGrid()->getCellSizes().back() * grid->getCellOverSizeRatio())
     {
         logger(VERBOSE, "HGrid needs updating, because of maximum cell size, current = %, required = %.", grid->getCellSizes().back() * hGridCellOverSizeRatio_, particleHandler.getLargestParticle()->getInteractionRadius());
-        return true;
+        return HGridRebuildReason::MAXIMUM_CELL_SIZE;
     }
     else
     {
         //std::cout<<"HGrid does not need updating, because of number of buckets, current="<<grid->NUM_BUCKETS<<" target="<<particleHandler.getNumberOfObjects()<<std::endl;
         //std::cout<<"HGrid does not need updating, because of maximum cell size, current="<<grid->cellSizes_.back()*grid->cellOverSizeRatio_<<" required="<<2.0*particleHandler.getLargestParticle()->getInteractionRadius()<<std::endl;
-        return false;
+        return HGridRebuildReason::NONE;
     }
 }
 
@@ -560,7 +852,8 @@ unsigned int MercuryBase::getHGridTargetNumberOfBuckets() const
     unsigned int nParticles = particleHandler.getNumberOfObjects();
     if (nParticles > 10)
     {
-        return nParticles;
+        //the tuner increases the number of buckets if there are many hash collisions
+        return nParticles * hGridAutoTuner_.getBucketFactor();
     }
     else
     {
@@ -568,6 +861,17 @@ unsigned int MercuryBase::getHGridTargetNumberOfBuckets() const
     }
 }
 
+/*!
+ * \details The direct-indexed buckets are cleared every time step, so their 
+ *          number is limited to a multiple of the number of hashed buckets, 
+ *          but at least 2^16.
+ * \return The maximum number of direct-indexed buckets of the HGrid.
+ */
+unsigned int MercuryBase::getHGridMaxNumberOfDenseCells() const
+{
+    return std::max(8 * getHGridTargetNumberOfBuckets(), 1u << 16);
+}
+
 /*!
  * \return The interaction radius of the smallest particle multiplied by the maximum
  *         ratio between the cell size and particle size.
@@ -612,7 +916,9 @@ bool MercuryBase::checkParticleForInteraction(const BaseParticle& p)
     Vec3D normal;
 
     //Check if it has no collision with walls
-    for (std::vector<BaseWall*>::const_iterator it = wallHandler.begin(); it != wallHandler.end(); it++)
+    wallHandler.updateBoundingVolumes();
+    const std::vector<BaseWall*>& walls = wallHandler.getCandidateWalls(p);
+    for (std::vector<BaseWall*>::const_iterator it = walls.begin(); it != walls.end(); it++)
     {
         if ((*it)->getDistanceAndNormal(p, distance, normal))
         {
@@ -626,15 +932,38 @@ bool MercuryBase::checkParticleForInteraction(const BaseParticle& p)
     }
     
     //Check if it has no collision with other particles
-    if (hGridHasParticleContacts(&p))
+    if (broadPhase_ == BroadPhase::SORT_AND_SWEEP)
+    {
+        if (sortAndSweep_.needsUpdate())
+        {
+            sortAndSweep_.update(particleHandler, getSystemDimensions());
+        }
+        const std::vector<BaseParticle*>& candidates = sortAndSweep_.getCandidateParticles(p);
+        for (std::vector<BaseParticle*>::const_iterator it = candidates.begin(); it != candidates.end(); ++it)
+        {
+            if (areInContact(&p, *it))
+            {
+                logger(VERBOSE, "Collision with particle %.", **it);
+                return false;
+            }
+        }
+    }
+    else if (hGridHasParticleContacts(&p))
     {
         logger(VERBOSE, "Collision with particle.");
         return false;
     }
-    else
+    //and the static particles, which are not in the HGrid
+    const std::vector<BaseParticle*>& fixedParticles = particleHandler.getCandidateFixedParticles(p);
+    for (std::vector<BaseParticle*>::const_iterator it = fixedParticles.begin(); it != fixedParticles.end(); ++it)
     {
-        logger(VERBOSE, "No collision with particles.");
+        if (Vec3D::getDistanceSquared(p.getPosition(), (*it)->getPosition()) < mathsFunc::square(p.getInteractionRadius() + (*it)->getInteractionRadius()))
+        {
+            logger(VERBOSE, "Collision with static particle %.", **it);
+            return false;
+        }
     }
+    logger(VERBOSE, "No collision with particles.");
     return true;
 }
 
@@ -642,19 +971,76 @@ bool MercuryBase::checkParticleForInteraction(const BaseParticle& p)
 void MercuryBase::hGridInfo() const
 {
     std::cout << "Status of hGrid parameters:" << std::endl;
+    std::cout << "BroadPhase broadPhase_=" << (broadPhase_ == BroadPhase::SORT_AND_SWEEP ? "SORT_AND_SWEEP" : "HGRID") << std::endl;
     std::cout << "HGridMethod hGridMethod_=" << hGridMethod_ << std::endl; 
     std::cout << "HGridDistribution hGridDistribution_=" << hGridDistribution_ << std::endl; 
     std::cout << "Mdouble currentMaxRelativeDisplacement_=" << currentMaxRelativeDisplacement_ << std::endl; 
     std::cout << "Mdouble totalCurrentMaxRelativeDisplacement_=" << totalCurrentMaxRelativeDisplacement_ << std::endl; 
     std::cout << "bool gridNeedsUpdate_=" << gridNeedsUpdate_ << std::endl; 
     std::cout << "bool updateEachTimeStep_=" << updateEachTimeStep_ << std::endl; 
+    std::cout << "bool hGridIncrementalUpdate_=" << hGridIncrementalUpdate_ << std::endl; 
     std::cout << "unsigned int hGridMaxLevels_=" << hGridMaxLevels_ << std::endl; 
     std::cout << "Mdouble hGridCellOverSizeRatio_=" << hGridCellOverSizeRatio_ << std::endl; 
     if (grid != nullptr) 
     {
         grid->info();
+        hGridStatistics_.print(std::cout, getNumberOfParticleContacts(), grid->getNumberOfOccupiedBuckets(),
+                               grid->getNumberOfBuckets(), getHGridParticlesPerLevel());
     } else
     {
         std::cout << "hGrid does not exist yet" << std::endl;    
     }
 }
+
+/*!
+ * \return A reference to the HGridStatistics of this MercuryBase.
+ */
+HGridStatistics& MercuryBase::getHGridStatistics()
+{
+    return hGridStatistics_;
+}
+
+/*!
+ * \return A const reference to the HGridStatistics of this MercuryBase.
+ */
+const HGridStatistics& MercuryBase::getHGridStatistics() const
+{
+    return hGridStatistics_;
+}
+
+/*!
+ * \details The HGrid statistics are written every saveCount time steps of the 
+ *          data file, like the timings of the profiler.
+ */
+void MercuryBase::writeOutputFiles()
+{
+    DPMBase::writeOutputFiles();
+    if (hGridStatistics_.isEnabled() && grid != nullptr && dataFile.getSaveCount() > 0 && getNtimeSteps() % dataFile.getSaveCount() == 0)
+    {
+        hGridStatistics_.write(getName() + ".hgrid", getTime(), getNumberOfParticleContacts(), grid->getNumberOfOccupiedBuckets(),
+                               grid->getNumberOfBuckets(), getHGridParticlesPerLevel());
+    }
+}
+
+void MercuryBase::computeMemoryUsage()
+{
+    DPMBase::computeMemoryUsage();
+    memoryUsage.set("hgrid", grid != nullptr ? grid->getMemoryUsage() : 0);
+    memoryUsage.set("sortAndSweep", sortAndSweep_.getMemoryUsage());
+}
+
+/*!
+ * \return A vector containing the number of particles in each level of the HGrid.
+ */
+std::vector<unsigned int> MercuryBase::getHGridParticlesPerLevel() const
+{
+    std::vector<unsigned int> particlesPerLevel(grid != nullptr ? grid->getNumberOfLevels() : 0, 0);
+    for (const BaseParticle* p : particleHandler)
+    {
+        if (p->getHGridLevel() < particlesPerLevel.size())
+        {
+            particlesPerLevel[p->getHGridLevel()]++;
+        }
+    }
+    return particlesPerLevel;
+}
@@ -32,6 +32,9 @@
 
 #include "DPMBase.h"
 #include "HGrid.h"
+#include "HGridStatistics.h"
+#include "HGridAutoTuner.h"
+#include "SortAndSweep.h"
 #include "Logger.h"
 
 /*!
@@ -65,6 +68,19 @@ enum HGridDistribution
     OLDHGRID, LINEAR, EXPONENTIAL, USER
 };
 
+/*!
+ * \brief   Enum class that indicates which broad phase is used to find the 
+ *          pairs of particles that might be in contact.
+ * \details HGRID sorts the particles into the cells of the HGrid; this is the 
+ *          default and works well for most systems. SORT_AND_SWEEP sorts the 
+ *          particles along the longest axis of the system (see SortAndSweep), 
+ *          which can be faster for long and thin systems like chutes.
+ */
+enum class BroadPhase : unsigned int
+{
+    HGRID, SORT_AND_SWEEP
+};
+
 /*!
  * \brief This is the base class for both Mercury2D and Mercury3D. Note the 
  *        actually abstract grid is defined in the class Grid defined below.
@@ -136,6 +152,16 @@ public:
      */
     bool getHGridUpdateEachTimeStep() const override;
 
+    /*!
+     * \brief Sets whether the HGrid is updated incrementally, i.e. only particles that changed cell are moved to another bucket.
+     */
+    void setHGridIncrementalUpdate(bool incrementalUpdate);
+
+    /*!
+     * \brief Gets whether the HGrid is updated incrementally.
+     */
+    bool getHGridIncrementalUpdate() const;
+
     /*!
      * \brief Sets the maximum number of levels of the HGrid in this MercuryBase.
      */
@@ -176,16 +202,76 @@ public:
      */
     void setHGridCellOverSizeRatio(Mdouble cellOverSizeRatio);
 
+    /*!
+     * \brief Sets whether the cell sizes and the number of buckets of the HGrid are tuned automatically.
+     */
+    void setHGridAutoTune(bool autoTune);
+
+    /*!
+     * \brief Gets whether the cell sizes and the number of buckets of the HGrid are tuned automatically.
+     */
+    bool getHGridAutoTune() const;
+
+    /*!
+     * \brief Sets the number of time steps between two checks of the automatically tuned HGrid.
+     */
+    void setHGridAutoTuneInterval(unsigned int interval);
+
+    /*!
+     * \brief Gets the number of time steps between two checks of the automatically tuned HGrid.
+     */
+    unsigned int getHGridAutoTuneInterval() const;
+
+    /*!
+     * \brief Sets whether the cells inside the domain get direct-indexed buckets instead of being hashed.
+     */
+    void setHGridDenseCells(bool denseCells);
+
+    /*!
+     * \brief Gets whether the cells inside the domain get direct-indexed buckets instead of being hashed.
+     */
+    bool getHGridDenseCells() const;
+
+    /*!
+     * \brief Sets whether the HGrid or the SortAndSweep is used to find possible contacts between particles.
+     */
+    void setBroadPhase(BroadPhase broadPhase);
+
+    /*!
+     * \brief Gets whether the HGrid or the SortAndSweep is used to find possible contacts between particles.
+     */
+    BroadPhase getBroadPhase() const;
+
+    /*!
+     * \brief Returns the SortAndSweep, which is used if the broad phase is BroadPhase::SORT_AND_SWEEP.
+     */
+    SortAndSweep& getSortAndSweep();
+
+    /*!
+     * \brief Returns the SortAndSweep, const version.
+     */
+    const SortAndSweep& getSortAndSweep() const;
+
     /*!
      * \brief Gets if the HGrid needs rebuilding before anything else happens.
      */
     bool hGridNeedsRebuilding();
+
+    /*!
+     * \brief Returns the reason for which the HGrid needs rebuilding, or HGridRebuildReason::NONE.
+     */
+    HGridRebuildReason getHGridRebuildReason();
     
     /*!
      * \brief Gets the desired number of buckets, which is the maximum of the number of particles and 10.
      */
     virtual unsigned int getHGridTargetNumberOfBuckets() const;
     
+    /*!
+     * \brief Gets the maximum number of direct-indexed buckets; if the domain needs more, all cells are hashed.
+     */
+    virtual unsigned int getHGridMaxNumberOfDenseCells() const;
+    
     /*!
      * \brief Gets the desired size of the smallest cells of the HGrid.
      */
@@ -249,7 +335,8 @@ protected:
     void hGridActionsBeforeIntegration() override;
 
     /*!
-     * \brief Sets the totalCurrentMaxRelativeDisplacement_ as 2*currentMaxRelativeDisplacement_.
+     * \brief Sets the totalCurrentMaxRelativeDisplacement_ as 2*currentMaxRelativeDisplacement_,
+     *        and marks the SortAndSweep as outdated.
      */
     void hGridActionsAfterIntegration() override;
     
@@ -273,8 +360,34 @@ public:
      * \brief Writes the info of the HGrid to the screen in a nice format.
      */
     void hGridInfo() const;
-    
+
+    /*!
+     * \brief Returns the counters of the HGrid traversal and rebuilds.
+     */
+    HGridStatistics& getHGridStatistics();
+
+    /*!
+     * \brief Returns the counters of the HGrid traversal and rebuilds, const version.
+     */
+    const HGridStatistics& getHGridStatistics() const;
+
+    /*!
+     * \brief Writes the output files of DPMBase and, if enabled, the HGrid statistics.
+     */
+    void writeOutputFiles() override;
+
+    /*!
+     * \brief Stores the number of bytes used by the handlers and the HGrid in #memoryUsage.
+     */
+    void computeMemoryUsage() override;
+
 private:
+    /*!
+     * \brief Returns the number of particles in each level of the HGrid.
+     */
+    std::vector<unsigned int> getHGridParticlesPerLevel() const;
+
+
     /*!
      * \brief A pointer to the HGrid associated with this MercuryBase.
      */
@@ -320,12 +433,24 @@ private:
      */
     bool gridNeedsUpdate_;
     
+    /*!
+     * \brief The number of time steps since the particles were last updated in the HGrid.
+     */
+    int stepsBeforeUpdate_;
+    
     /*!
      * \brief Boolean which indicates whether or not the cell in which a 
      *        particle is must be updated every timestep.
      */
     bool updateEachTimeStep_;
     
+    /*!
+     * \brief Boolean which indicates whether the buckets are kept between 
+     *        updates of the grid, such that only the particles that changed 
+     *        cell are moved to another bucket.
+     */
+    bool hGridIncrementalUpdate_;
+    
     /*!
      * \brief   Unsigned integer that indicates the maximum number of levels of 
      *          the HGrid.
@@ -347,6 +472,37 @@ private:
      *          Currently, the default is set to 1.
      */
     Mdouble hGridCellOverSizeRatio_;
+
+    /*!
+     * \brief Boolean which indicates whether the cells inside the domain 
+     *        (getXMin() to getZMax()) get direct-indexed buckets instead of 
+     *        being hashed.
+     */
+    bool hGridDenseCells_;
+
+    /*!
+     * \brief Counts the buckets and particle pairs traversed by 
+     *        hGridFindOneSidedContacts and the rebuilds of the HGrid.
+     */
+    HGridStatistics hGridStatistics_;
+
+    /*!
+     * \brief Chooses the cell sizes and the number of buckets of the HGrid, 
+     *        if the HGrid is tuned automatically.
+     */
+    HGridAutoTuner hGridAutoTuner_;
+
+    /*!
+     * \brief Whether the HGrid or the SortAndSweep is used to find possible 
+     *        contacts between particles; the default is BroadPhase::HGRID.
+     */
+    BroadPhase broadPhase_;
+
+    /*!
+     * \brief The particles sorted along one axis, used if broadPhase_ is 
+     *        BroadPhase::SORT_AND_SWEEP; the HGrid is not built in that case.
+     */
+    SortAndSweep sortAndSweep_;
 };
 
 #endif
@@ -50,7 +50,7 @@ ParticleHandler::ParticleHandler()
  *          computes the smallest and largest particle in this handler.
  */
 ParticleHandler::ParticleHandler(const ParticleHandler& PH)
-    : BaseHandler<BaseParticle>() 
+    : BaseHandler<BaseParticle>(), fixedParticleGrid_(PH.fixedParticleGrid_)
 {
     clear();
     setDPMBase(PH.getDPMBase());
@@ -78,6 +78,7 @@ ParticleHandler ParticleHandler::operator =(const ParticleHandler& rhs)
         clear();
         largestParticle_ = nullptr;
         smallestParticle_ = nullptr;
+        fixedParticleGrid_.setEnabled(rhs.fixedParticleGrid_.isEnabled());
         copyContentsFromOtherHandler(rhs);
         if (objects_.size() != 0)
         {
@@ -153,6 +154,10 @@ void ParticleHandler::removeObject(unsigned const int id)
     getDPMBase()->getPossibleContactList().remove_ParticlePosibleContacts(getObject(id));
 #endif
     getDPMBase()->hGridRemoveParticle(getObject(id));
+    if (isInFixedParticleGrid(getObject(id)))
+    {
+        fixedParticleGrid_.setOutdated();
+    }
     BaseHandler<BaseParticle>::removeObject(id);
 }
 
@@ -166,6 +171,10 @@ void ParticleHandler::removeLastObject()
     getDPMBase()->getPossibleContactList().remove_ParticlePosibleContacts(getLastObject());
 #endif
     getDPMBase()->hGridRemoveParticle(getLastObject());
+    if (isInFixedParticleGrid(getLastObject()))
+    {
+        fixedParticleGrid_.setOutdated();
+    }
     BaseHandler<BaseParticle>::removeLastObject();
 }
 
@@ -389,6 +398,7 @@ void ParticleHandler::clear()
 {
     smallestParticle_ = nullptr;
     largestParticle_ = nullptr;
+    fixedParticleGrid_.setOutdated();
     BaseHandler<BaseParticle>::clear();
 }
 
@@ -552,3 +562,82 @@ std::string ParticleHandler::getName() const
 {
     return "ParticleHandler";
 }
+
+/*!
+ * \details Ghost particles are the copies created by the periodic boundaries; 
+ *          they are included in getMemoryUsage as well.
+ * \return The number of bytes used by the ghost particles.
+ */
+std::size_t ParticleHandler::getGhostMemoryUsage() const
+{
+    std::size_t memoryUsage = 0;
+    for (const BaseParticle* particle : objects_)
+    {
+        if (particle->getPeriodicFromParticle() != nullptr)
+            memoryUsage += particle->getMemoryUsage();
+    }
+    return memoryUsage;
+}
+
+/*!
+ * \return The memory used by the particles (see BaseHandler::getMemoryUsage) 
+ *         plus the memory used by the grid of the static particles.
+ */
+std::size_t ParticleHandler::getMemoryUsage() const
+{
+    return BaseHandler<BaseParticle>::getMemoryUsage() + fixedParticleGrid_.getMemoryUsage();
+}
+
+/*!
+ * \return True if the grid was rebuilt, i.e. if particles entered or left the 
+ *         grid, such that the HGrid has to be rebuilt as well.
+ * \details Called before each time step, see DPMBase::hGridActionsBeforeTimeStep.
+ */
+bool ParticleHandler::updateFixedParticleGrid()
+{
+    return fixedParticleGrid_.update(objects_);
+}
+
+/*!
+ * \param[in] p The BaseParticle for which the static neighbours are needed.
+ * \return The static particles that can interact with p; empty if the grid is disabled.
+ * \details If a static particle was deleted since the last update, the grid is 
+ *          rebuilt first, such that it does not point to deleted particles.
+ */
+const std::vector<BaseParticle*>& ParticleHandler::getCandidateFixedParticles(const BaseParticle& p)
+{
+    if (fixedParticleGrid_.isOutdated())
+    {
+        fixedParticleGrid_.update(objects_);
+    }
+    return fixedParticleGrid_.getCandidateParticles(p);
+}
+
+/*!
+ * \param[in] p The BaseParticle that is checked.
+ * \return True if the grid is enabled and p was stored in it when it was last 
+ *         built. Such particles are neither integrated nor inserted in the HGrid, 
+ *         and the forces on them are not computed. A particle that was added or 
+ *         became static since then is not in the grid yet, so it is still treated 
+ *         like all other particles.
+ */
+bool ParticleHandler::isInFixedParticleGrid(const BaseParticle* p) const
+{
+    return fixedParticleGrid_.isEnabled() && p->isInFixedParticleGrid();
+}
+
+/*!
+ * \return A reference to the grid of the static particles.
+ */
+FixedParticleGrid& ParticleHandler::getFixedParticleGrid()
+{
+    return fixedParticleGrid_;
+}
+
+/*!
+ * \return A const reference to the grid of the static particles.
+ */
+const FixedParticleGrid& ParticleHandler::getFixedParticleGrid() const
+{
+    return fixedParticleGrid_;
+}
@@ -29,6 +29,7 @@
 
 #include "BaseHandler.h"
 #include "Particles/BaseParticle.h"
+#include "FixedParticleGrid.h"
 
 class SpeciesHandler;
 class BaseSpecies;
@@ -168,6 +169,41 @@ public:
      */    
     std::string getName() const;
 
+    /*!
+     *  \brief Gets the number of bytes used by the periodic ghost particles in this ParticleHandler.
+     */
+    std::size_t getGhostMemoryUsage() const;
+
+    /*!
+     *  \brief Gets the number of bytes used by the particles and the grid of the static particles.
+     */
+    std::size_t getMemoryUsage() const override;
+
+    /*!
+     * \brief Rebuilds the grid of the static particles if they changed; returns true if it was rebuilt.
+     */
+    bool updateFixedParticleGrid();
+
+    /*!
+     * \brief Returns the static particles near a BaseParticle, see FixedParticleGrid::getCandidateParticles.
+     */
+    const std::vector<BaseParticle*>& getCandidateFixedParticles(const BaseParticle& p);
+
+    /*!
+     * \brief Returns whether a BaseParticle is handled by the grid of the static particles instead of the other contact detection.
+     */
+    bool isInFixedParticleGrid(const BaseParticle* p) const;
+
+    /*!
+     * \brief Returns the grid of the static particles, e.g. to enable it.
+     */
+    FixedParticleGrid& getFixedParticleGrid();
+
+    /*!
+     * \brief Returns the grid of the static particles.
+     */
+    const FixedParticleGrid& getFixedParticleGrid() const;
+
 private:
     /*!
      * \brief A pointer to the largest BaseParticle (by interactionRadius) in this ParticleHandler
@@ -183,6 +219,11 @@ private:
      * \brief A pointer to the smallest BaseParticle (by interactionRadius) in this ParticleHandler
      */
     BaseParticle* smallestParticle_;
+
+    /*!
+     * \brief The grid in which the static particles, e.g. of a rough bottom, are stored if it is enabled.
+     */
+    FixedParticleGrid fixedParticleGrid_;
 };
 
 #endif
@@ -0,0 +1,371 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "ParticleReordering.h"
+#include "DPMBase.h"
+#include "Particles/BaseParticle.h"
+#include "Interactions/BaseInteraction.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <numeric>
+
+///Two particles whose indices differ by more than this are counted as a miss by getContactLocalityMissRate;
+///64 particles of a few hundred bytes each about fill a 32kB L1 data cache
+static const unsigned int localityWindow = 64;
+
+///Lower bound of the baseline miss rate, such that a perfectly ordered system is not sorted again at the first far contact
+static const Mdouble minimumMissRate = 0.01;
+
+///Returns the number of bits per direction of the keys computed by ParticleReordering::computeKey
+static unsigned int getNumberOfBits(unsigned int dimensions)
+{
+    return dimensions >= 3 ? 21 : (dimensions == 2 ? 31 : 32);
+}
+
+ParticleReordering::ParticleReordering()
+{
+    isEnabled_ = false;
+    curve_ = SpaceFillingCurve::HILBERT;
+    interval_ = 0;
+    checkInterval_ = 50;
+    missRateIncrease_ = 0.25;
+    reset();
+}
+
+/*!
+ * \param[in] other The ParticleReordering whose settings are copied.
+ */
+ParticleReordering::ParticleReordering(const ParticleReordering& other)
+{
+    isEnabled_ = other.isEnabled_;
+    curve_ = other.curve_;
+    interval_ = other.interval_;
+    checkInterval_ = other.checkInterval_;
+    missRateIncrease_ = other.missRateIncrease_;
+    reset();
+}
+
+void ParticleReordering::setEnabled(bool isEnabled)
+{
+    isEnabled_ = isEnabled;
+}
+
+bool ParticleReordering::isEnabled() const
+{
+    return isEnabled_;
+}
+
+void ParticleReordering::setCurve(SpaceFillingCurve curve)
+{
+    curve_ = curve;
+}
+
+SpaceFillingCurve ParticleReordering::getCurve() const
+{
+    return curve_;
+}
+
+/*!
+ * \param[in] interval The number of time steps between two reorderings, or 
+ *                     zero to reorder when the measured miss rate has grown.
+ */
+void ParticleReordering::setInterval(unsigned int interval)
+{
+    interval_ = interval;
+}
+
+unsigned int ParticleReordering::getInterval() const
+{
+    return interval_;
+}
+
+void ParticleReordering::setCheckInterval(unsigned int checkInterval)
+{
+    if (checkInterval == 0)
+    {
+        logger(WARN, "ParticleReordering::setCheckInterval: the check interval has to be positive, it is set to 1");
+        checkInterval = 1;
+    }
+    checkInterval_ = checkInterval;
+}
+
+unsigned int ParticleReordering::getCheckInterval() const
+{
+    return checkInterval_;
+}
+
+void ParticleReordering::setMissRateIncrease(Mdouble missRateIncrease)
+{
+    missRateIncrease_ = missRateIncrease;
+}
+
+Mdouble ParticleReordering::getMissRateIncrease() const
+{
+    return missRateIncrease_;
+}
+
+void ParticleReordering::reset()
+{
+    numberOfReorders_ = 0;
+    stepsSinceReorder_ = 0;
+    missRate_ = 0.0;
+    baselineMissRate_ = -1.0;
+    lastMisses_ = 0;
+    lastTimeStep_ = 0;
+}
+
+/*!
+ * \param[in] problem The simulation whose particles are sorted.
+ * \return True if the particles have not been sorted since the last reset, if 
+ *         the interval has passed, or, for an automatic interval, if the miss 
+ *         rate has grown by more than getMissRateIncrease since the last 
+ *         reordering.
+ */
+bool ParticleReordering::check(const DPMBase& problem)
+{
+    stepsSinceReorder_++;
+    bool isDue;
+    if (numberOfReorders_ == 0)
+    {
+        //the initial order of the particles is arbitrary
+        isDue = true;
+    }
+    else if (interval_ > 0)
+    {
+        isDue = stepsSinceReorder_ >= interval_;
+    }
+    else if (stepsSinceReorder_ % checkInterval_ != 0)
+    {
+        isDue = false;
+    }
+    else
+    {
+        missRate_ = measureMissRate(problem);
+        if (baselineMissRate_ < 0.0)
+        {
+            baselineMissRate_ = missRate_;
+            return false;
+        }
+        isDue = missRate_ > (1.0 + missRateIncrease_) * std::max(baselineMissRate_, minimumMissRate);
+    }
+    if (isDue && interval_ == 0)
+    {
+        //the next measurement only counts the misses after the reordering
+        measureMissRate(problem);
+    }
+    return isDue;
+}
+
+/*!
+ * \param[in,out] particleHandler    The particles that are sorted.
+ * \param[in,out] interactionHandler The interactions that are sorted.
+ * \param[in] dimensions             The number of dimensions of the system; 
+ *                                   in 2D, the curve only runs through x and y.
+ * \details The bounding box of the particles is divided into 2^21 (2D: 2^31) 
+ *          cubic cells per direction, and the particles are sorted by the 
+ *          position of their cell along the curve; particles in the same cell 
+ *          keep their order. Should not be called while there are periodic 
+ *          ghost particles, as the interactions with ghosts are resolved by 
+ *          index, see InteractionHandler::removeObjectKeepingPeriodics.
+ */
+void ParticleReordering::reorder(ParticleHandler& particleHandler, InteractionHandler& interactionHandler, unsigned int dimensions)
+{
+    numberOfReorders_++;
+    stepsSinceReorder_ = 0;
+    baselineMissRate_ = -1.0;
+    const unsigned int numberOfParticles = particleHandler.getNumberOfObjects();
+    if (numberOfParticles < 2)
+        return;
+
+    Vec3D min = particleHandler.getObject(0)->getPosition();
+    Vec3D max = min;
+    for (const BaseParticle* p : particleHandler)
+    {
+        min = Vec3D::min(min, p->getPosition());
+        max = Vec3D::max(max, p->getPosition());
+    }
+    const Vec3D extent = max - min;
+    const Mdouble largestExtent = std::max(extent.X, std::max(dimensions >= 2 ? extent.Y : 0.0, dimensions >= 3 ? extent.Z : 0.0));
+    const Mdouble largestCell = std::ldexp(1.0, getNumberOfBits(dimensions)) - 1.0;
+    const Mdouble scale = largestExtent > 0.0 ? largestCell / largestExtent : 0.0;
+
+    std::vector<std::pair<uint64_t, unsigned int> > keys(numberOfParticles);
+    for (unsigned int i = 0; i < numberOfParticles; i++)
+    {
+        const Vec3D cell = (particleHandler.getObject(i)->getPosition() - min) * scale;
+        keys[i].first = computeKey(curve_, static_cast<unsigned int>(std::min(cell.X, largestCell)),
+                                   static_cast<unsigned int>(std::min(cell.Y, largestCell)),
+                                   static_cast<unsigned int>(std::min(cell.Z, largestCell)), dimensions);
+        keys[i].second = i;
+    }
+    std::sort(keys.begin(), keys.end());
+    std::vector<unsigned int> order(numberOfParticles);
+    for (unsigned int i = 0; i < numberOfParticles; i++)
+    {
+        order[i] = keys[i].second;
+    }
+    particleHandler.reorderObjects(order);
+
+    order.resize(interactionHandler.getNumberOfObjects());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&interactionHandler] (unsigned int a, unsigned int b)
+    {
+        return interactionHandler.getObject(a)->getP()->getIndex() < interactionHandler.getObject(b)->getP()->getIndex();
+    });
+    interactionHandler.reorderObjects(order);
+}
+
+unsigned int ParticleReordering::getNumberOfReorders() const
+{
+    return numberOfReorders_;
+}
+
+Mdouble ParticleReordering::getMissRate() const
+{
+    return missRate_;
+}
+
+Mdouble ParticleReordering::getBaselineMissRate() const
+{
+    return baselineMissRate_;
+}
+
+/*!
+ * \param[in] curve      The space-filling curve.
+ * \param[in] x          The cell index in x direction.
+ * \param[in] y          The cell index in y direction (ignored in 1D).
+ * \param[in] z          The cell index in z direction (ignored in 1D and 2D).
+ * \param[in] dimensions The number of dimensions of the grid.
+ * \return The index of the cell along the curve. The Morton key interleaves the
+ *         bits of the cell indices; the Hilbert key is computed with Skilling's
+ *         transform (J. Skilling, Programming the Hilbert curve, AIP Conf. 
+ *         Proc. 707, 2004), such that consecutive cells along the curve are
+ *         always neighbours.
+ */
+uint64_t ParticleReordering::computeKey(SpaceFillingCurve curve, unsigned int x, unsigned int y, unsigned int z, unsigned int dimensions)
+{
+    const unsigned int n = std::max(1u, std::min(3u, dimensions));
+    const unsigned int bits = getNumberOfBits(n);
+    const unsigned int mask = bits == 32 ? ~0u : (1u << bits) - 1u;
+    unsigned int X[3] = {x & mask, y & mask, z & mask};
+
+    if (curve == SpaceFillingCurve::HILBERT && n > 1)
+    {
+        //undo the excess work of the inverse transform
+        const unsigned int M = 1u << (bits - 1);
+        for (unsigned int Q = M; Q > 1; Q >>= 1)
+        {
+            const unsigned int P = Q - 1;
+            for (unsigned int i = 0; i < n; i++)
+            {
+                if (X[i] & Q)
+                {
+                    X[0] ^= P;
+                }
+                else
+                {
+                    const unsigned int t = (X[0] ^ X[i]) & P;
+                    X[0] ^= t;
+                    X[i] ^= t;
+                }
+            }
+        }
+        //Gray encode
+        for (unsigned int i = 1; i < n; i++)
+        {
+            X[i] ^= X[i - 1];
+        }
+        unsigned int t = 0;
+        for (unsigned int Q = M; Q > 1; Q >>= 1)
+        {
+            if (X[n - 1] & Q)
+            {
+                t ^= Q - 1;
+            }
+        }
+        for (unsigned int i = 0; i < n; i++)
+        {
+            X[i] ^= t;
+        }
+    }
+
+    uint64_t key = 0;
+    for (int bit = bits - 1; bit >= 0; bit--)
+    {
+        for (unsigned int i = 0; i < n; i++)
+        {
+            key = (key << 1) | ((X[i] >> bit) & 1u);
+        }
+    }
+    return key;
+}
+
+/*!
+ * \param[in] interactionHandler The interactions of a simulation.
+ * \return The fraction of the interactions between two particles for which the
+ *         indices of the particles differ by more than 64. This estimates how
+ *         often the force loop has to fetch a particle that is not in the 
+ *         cache anymore, if the hardware counters are not available.
+ */
+Mdouble ParticleReordering::getContactLocalityMissRate(const InteractionHandler& interactionHandler)
+{
+    unsigned int numberOfContacts = 0;
+    unsigned int numberOfMisses = 0;
+    for (const BaseInteraction* interaction : interactionHandler)
+    {
+        const BaseParticle* P = dynamic_cast<const BaseParticle*>(interaction->getP());
+        const BaseParticle* I = dynamic_cast<const BaseParticle*>(interaction->getI());
+        if (P == nullptr || I == nullptr)
+            continue;
+        numberOfContacts++;
+        if (std::max(P->getIndex(), I->getIndex()) - std::min(P->getIndex(), I->getIndex()) > localityWindow)
+            numberOfMisses++;
+    }
+    return numberOfContacts == 0 ? 0.0 : static_cast<Mdouble>(numberOfMisses) / numberOfContacts;
+}
+
+/*!
+ * \param[in] problem The simulation whose particles are sorted.
+ * \return The number of L1 data cache misses in computeAllForces per particle 
+ *         and time step since the last measurement, if the profiler reads the
+ *         hardware counters; otherwise getContactLocalityMissRate.
+ */
+Mdouble ParticleReordering::measureMissRate(const DPMBase& problem)
+{
+    const unsigned int numberOfTimeSteps = problem.getNtimeSteps() - lastTimeStep_;
+    lastTimeStep_ = problem.getNtimeSteps();
+    if (problem.profiler.isEnabled() && problem.profiler.getHardwareCountersEnabled())
+    {
+        const uint64_t misses = problem.profiler.getCount(SolvePhase::COMPUTE_ALL_FORCES, HardwareCounter::L1D_MISSES);
+        const uint64_t newMisses = misses - lastMisses_;
+        lastMisses_ = misses;
+        if (misses > 0 && numberOfTimeSteps > 0 && problem.particleHandler.getNumberOfObjects() > 0)
+        {
+            return static_cast<Mdouble>(newMisses) / numberOfTimeSteps / problem.particleHandler.getNumberOfObjects();
+        }
+    }
+    return getContactLocalityMissRate(problem.interactionHandler);
+}
@@ -0,0 +1,212 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef PARTICLEREORDERING_H
+#define PARTICLEREORDERING_H
+
+#include <cstdint>
+#include "GeneralDefine.h"
+
+class DPMBase;
+class ParticleHandler;
+class InteractionHandler;
+
+/*!
+ * \brief The space-filling curves along which ParticleReordering sorts the particles.
+ */
+enum class SpaceFillingCurve : unsigned int
+{
+    MORTON,
+    HILBERT
+};
+
+/*!
+ * \brief Periodically sorts the particles (and their interactions) along a space-filling curve, to improve memory locality.
+ * \details Particles are removed by swapping the last particle into the hole 
+ * (see BaseHandler::removeObject) and inserted at the end, so after a while the
+ * order of the ParticleHandler has nothing to do with the positions of the 
+ * particles, and the force loop visits the neighbours of a particle in random 
+ * order. reorder sorts the particles along a Morton (z-order) or Hilbert curve
+ * through the bounding box of the particles, such that particles that are 
+ * close in space are close in the handler; the interactions are then sorted by
+ * the index of their first particle. The indices are updated through 
+ * BaseObject::moveInHandler; the ids and the particles themselves (and thus 
+ * all pointers to them, e.g. in the HGrid) do not change.
+ * 
+ * The reordering is disabled by default; it is enabled via setEnabled or the 
+ * command-line argument -particleReordering interval. Solve calls check at the
+ * end of each time step. The particles are sorted at the first check and then
+ * either every interval time steps, or, if the interval is zero, whenever the
+ * measured miss rate has grown by more than getMissRateIncrease compared to 
+ * the miss rate measured after the last reordering. The miss rate is measured
+ * every getCheckInterval time steps: if the profiler reads the hardware 
+ * counters (see SolveProfiler::setHardwareCountersEnabled), it is the number 
+ * of L1 data cache misses per particle and time step in computeAllForces; 
+ * otherwise, it is estimated by getContactLocalityMissRate.
+ */
+class ParticleReordering
+{
+public:
+    /*!
+     * \brief Default constructor; the reordering is disabled and uses the Hilbert curve with an automatic interval.
+     */
+    ParticleReordering();
+
+    /*!
+     * \brief Copy constructor; copies the settings, but not the measurements.
+     */
+    ParticleReordering(const ParticleReordering& other);
+
+    /*!
+     * \brief Enables or disables the reordering.
+     */
+    void setEnabled(bool isEnabled);
+
+    /*!
+     * \brief Returns true if solve reorders the particles.
+     */
+    bool isEnabled() const;
+
+    /*!
+     * \brief Sets the space-filling curve along which the particles are sorted.
+     */
+    void setCurve(SpaceFillingCurve curve);
+
+    /*!
+     * \brief Returns the space-filling curve along which the particles are sorted.
+     */
+    SpaceFillingCurve getCurve() const;
+
+    /*!
+     * \brief Sets the number of time steps between two reorderings; zero chooses the interval from the measured miss rate.
+     */
+    void setInterval(unsigned int interval);
+
+    /*!
+     * \brief Returns the number of time steps between two reorderings, or zero if it is chosen automatically.
+     */
+    unsigned int getInterval() const;
+
+    /*!
+     * \brief Sets the number of time steps between two measurements of the miss rate (for an automatic interval).
+     */
+    void setCheckInterval(unsigned int checkInterval);
+
+    /*!
+     * \brief Returns the number of time steps between two measurements of the miss rate.
+     */
+    unsigned int getCheckInterval() const;
+
+    /*!
+     * \brief Sets the relative increase of the miss rate (e.g. 0.25 for 25 percent) at which the particles are sorted again.
+     */
+    void setMissRateIncrease(Mdouble missRateIncrease);
+
+    /*!
+     * \brief Returns the relative increase of the miss rate at which the particles are sorted again.
+     */
+    Mdouble getMissRateIncrease() const;
+
+    /*!
+     * \brief Forgets the measurements, such that the particles are sorted at the next check; called at the start of solve.
+     */
+    void reset();
+
+    /*!
+     * \brief Returns true if the particles should be sorted now; called once per time step.
+     */
+    bool check(const DPMBase& problem);
+
+    /*!
+     * \brief Sorts the particles along the space-filling curve, and the interactions by the index of their first particle.
+     */
+    void reorder(ParticleHandler& particleHandler, InteractionHandler& interactionHandler, unsigned int dimensions);
+
+    /*!
+     * \brief Returns the number of times the particles have been sorted since the last reset.
+     */
+    unsigned int getNumberOfReorders() const;
+
+    /*!
+     * \brief Returns the last measured miss rate.
+     */
+    Mdouble getMissRate() const;
+
+    /*!
+     * \brief Returns the miss rate measured after the last reordering, or a negative number if it has not been measured yet.
+     */
+    Mdouble getBaselineMissRate() const;
+
+    /*!
+     * \brief Returns the position of a cell along a space-filling curve through a grid of 2^21 (2D: 2^31) cells per direction.
+     */
+    static uint64_t computeKey(SpaceFillingCurve curve, unsigned int x, unsigned int y, unsigned int z, unsigned int dimensions);
+
+    /*!
+     * \brief Returns the fraction of particle-particle interactions whose particles are far apart in the ParticleHandler.
+     */
+    static Mdouble getContactLocalityMissRate(const InteractionHandler& interactionHandler);
+
+private:
+    /*!
+     * \brief Measures the miss rate since the last measurement.
+     */
+    Mdouble measureMissRate(const DPMBase& problem);
+
+    ///If false, solve does not reorder the particles
+    bool isEnabled_;
+
+    ///The curve along which the particles are sorted
+    SpaceFillingCurve curve_;
+
+    ///The number of time steps between two reorderings, or zero for an automatic interval
+    unsigned int interval_;
+
+    ///The number of time steps between two measurements of the miss rate
+    unsigned int checkInterval_;
+
+    ///The relative increase of the miss rate at which the particles are sorted again
+    Mdouble missRateIncrease_;
+
+    ///The number of times the particles have been sorted since the last reset
+    unsigned int numberOfReorders_;
+
+    ///The number of time steps since the particles were last sorted
+    unsigned int stepsSinceReorder_;
+
+    ///The last measured miss rate
+    Mdouble missRate_;
+
+    ///The miss rate measured after the last reordering, or -1 if not measured yet
+    Mdouble baselineMissRate_;
+
+    ///The number of L1 data cache misses in computeAllForces at the last measurement
+    uint64_t lastMisses_;
+
+    ///The number of time steps at the last measurement
+    unsigned int lastTimeStep_;
+};
+
+#endif
@@ -50,6 +50,7 @@ BaseParticle::BaseParticle()
 #endif
     HGridNextObject_ = nullptr;
     HGridPrevObject_ = nullptr;
+    isInFixedParticleGrid_ = false;
     HGridLevel_ = 99999;
     HGridX_ = 99999;
     HGridY_ = 99999;
@@ -79,6 +80,7 @@ BaseParticle::BaseParticle(const BaseParticle &p)
     
     HGridNextObject_ = nullptr;
     HGridPrevObject_ = nullptr;
+    isInFixedParticleGrid_ = false;
     HGridX_ = 99999;
     HGridY_ = 99999;
     HGridZ_ = 99999;
@@ -196,6 +198,14 @@ std::string BaseParticle::getName() const
     return "BaseParticle";
 }
 
+/*!
+ * \return The size of this BaseParticle plus the memory used by its list of interactions.
+ */
+std::size_t BaseParticle::getMemoryUsage() const
+{
+    return sizeof(BaseParticle) + getInteractionListMemoryUsage();
+}
+
 /*!
  * \details Particle read function. Has an std::istream as argument, from which 
  *          it extracts the radius_, invMass_ and invInertia_, respectively. 
@@ -287,6 +297,15 @@ BaseParticle* BaseParticle::getHGridPrevObject() const
     return HGridPrevObject_;
 }
 
+/*!
+ * \details A copy of a particle is not in the grid until the grid is rebuilt.
+ * \return whether the particle is stored in the FixedParticleGrid
+ */
+bool BaseParticle::isInFixedParticleGrid() const
+{
+    return isInFixedParticleGrid_;
+}
+
 #ifdef CONTACT_LIST_HGRID
 /*!
  * \details 
@@ -555,6 +574,15 @@ void BaseParticle::setHGridPrevObject(BaseParticle* p)
     HGridPrevObject_ = p;
 }
 
+/*!
+ * \details Set by FixedParticleGrid whenever it is built
+ * \param[in] isInFixedParticleGrid whether the particle is stored in the grid
+ */
+void BaseParticle::setInFixedParticleGrid(bool isInFixedParticleGrid)
+{
+    isInFixedParticleGrid_ = isInFixedParticleGrid;
+}
+
 /*!
  * \details 
  */
@@ -113,6 +113,11 @@ public:
      */
     virtual std::string getName() const;
 
+    /*!
+     * \brief Returns the number of bytes used by this BaseParticle, including its list of interactions.
+     */
+    std::size_t getMemoryUsage() const override;
+
     /*!
      * \brief Adds particle's HGrid level and cell coordinates to an ostream
      */
@@ -133,6 +138,11 @@ public:
      */
     BaseParticle* getHGridPrevObject() const;
 
+    /*!
+     * \brief Returns whether the particle is stored in the FixedParticleGrid of its handler
+     */
+    bool isInFixedParticleGrid() const;
+
 #ifdef CONTACT_LIST_HGRID
 
     /*!
@@ -269,6 +279,11 @@ public:
      */
     void setHGridPrevObject(BaseParticle* p);
 
+    /*!
+     * \brief Sets whether the particle is stored in the FixedParticleGrid of its handler; only used by FixedParticleGrid.
+     */
+    void setInFixedParticleGrid(bool isInFixedParticleGrid);
+
 #ifdef CONTACT_LIST_HGRID
     /*!
      * \brief 
@@ -388,6 +403,7 @@ private:
     unsigned int HGridLevel_; ///Grid level for the object
     BaseParticle* HGridNextObject_; ///Pointer to the next Particle in the same HGrid cell
     BaseParticle* HGridPrevObject_; ///Pointer to the previous Particle in the same HGrid cell
+    bool isInFixedParticleGrid_; ///Whether the particle was stored in the FixedParticleGrid when it was last built
 
     ///Particle attributes
     Mdouble mass_; ///Particle mass_ \todo{TW: why do we need to store mass and inertia; can we take it out?}
@@ -0,0 +1,290 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "SolveProfiler.h"
+#include "Logger.h"
+#include <iomanip>
+#include <algorithm>
+
+SolveProfiler::SolveProfiler()
+{
+    isEnabled_ = false;
+    hardwareCountersEnabled_ = false;
+    reset();
+}
+
+SolveProfiler::SolveProfiler(const SolveProfiler& other)
+{
+    isEnabled_ = other.isEnabled_;
+    hardwareCountersEnabled_ = other.hardwareCountersEnabled_;
+    reset();
+}
+
+void SolveProfiler::setEnabled(bool isEnabled)
+{
+    isEnabled_ = isEnabled;
+}
+
+bool SolveProfiler::isEnabled() const
+{
+    return isEnabled_;
+}
+
+/*!
+ * \details The counters are only read if the profiler itself is enabled as well.
+ * \param[in] hardwareCountersEnabled If true, the counters are read at the start and end of each timed phase.
+ */
+void SolveProfiler::setHardwareCountersEnabled(bool hardwareCountersEnabled)
+{
+    hardwareCountersEnabled_ = hardwareCountersEnabled;
+}
+
+bool SolveProfiler::getHardwareCountersEnabled() const
+{
+    return hardwareCountersEnabled_;
+}
+
+void SolveProfiler::reset()
+{
+    for (std::chrono::steady_clock::duration& time : times_)
+        time = std::chrono::steady_clock::duration::zero();
+    timeLoopStart_ = std::chrono::steady_clock::now();
+    timeLoopTime_ = std::chrono::steady_clock::duration::zero();
+    numberOfTimeSteps_ = 0;
+    if (file_.is_open())
+        file_.close();
+    std::lock_guard<std::mutex> lock(threadCountsMutex_);
+    threadCounts_.clear();
+}
+
+void SolveProfiler::startTimeLoop()
+{
+    timeLoopStart_ = std::chrono::steady_clock::now();
+}
+
+/*!
+ * \details Also closes the output file.
+ * \param[in] numberOfTimeSteps The number of time steps done in the time loop, used to print the time per time step.
+ */
+void SolveProfiler::stopTimeLoop(unsigned int numberOfTimeSteps)
+{
+    timeLoopTime_ = std::chrono::steady_clock::now() - timeLoopStart_;
+    numberOfTimeSteps_ = numberOfTimeSteps;
+    if (file_.is_open())
+        file_.close();
+}
+
+Mdouble SolveProfiler::getTime(SolvePhase phase) const
+{
+    return std::chrono::duration<Mdouble>(times_[static_cast<unsigned int>(phase)]).count();
+}
+
+Mdouble SolveProfiler::getTimeLoopTime() const
+{
+    return std::chrono::duration<Mdouble>(timeLoopTime_).count();
+}
+
+unsigned int SolveProfiler::getNumberOfTimeSteps() const
+{
+    return numberOfTimeSteps_;
+}
+
+/*!
+ * \param[in] phase The phase the counts are added to.
+ * \param[in] counters The hardware counters of the calling thread.
+ * \param[in] startCounts The values of the counters at the start of the phase.
+ */
+void SolveProfiler::addCounts(SolvePhase phase, const HardwareCounters& counters, const uint64_t startCounts[])
+{
+    uint64_t counts[static_cast<unsigned int>(HardwareCounter::NUMBER_OF_COUNTERS)];
+    counters.read(counts);
+    std::thread::id thread = std::this_thread::get_id();
+    std::lock_guard<std::mutex> lock(threadCountsMutex_);
+    auto threadCounts = std::find_if(threadCounts_.begin(), threadCounts_.end(),
+                                     [thread](const ThreadCounts& t) { return t.thread == thread; });
+    if (threadCounts == threadCounts_.end())
+    {
+        threadCounts_.push_back(ThreadCounts());
+        threadCounts = threadCounts_.end() - 1;
+        threadCounts->thread = thread;
+        for (auto& phaseCounts : threadCounts->counts)
+            for (uint64_t& count : phaseCounts)
+                count = 0;
+    }
+    for (unsigned int i = 0; i < static_cast<unsigned int>(HardwareCounter::NUMBER_OF_COUNTERS); i++)
+        threadCounts->counts[static_cast<unsigned int>(phase)][i] += counts[i] - startCounts[i];
+}
+
+uint64_t SolveProfiler::getCount(SolvePhase phase, HardwareCounter counter) const
+{
+    std::lock_guard<std::mutex> lock(threadCountsMutex_);
+    uint64_t count = 0;
+    for (const ThreadCounts& t : threadCounts_)
+        count += t.counts[static_cast<unsigned int>(phase)][static_cast<unsigned int>(counter)];
+    return count;
+}
+
+unsigned int SolveProfiler::getNumberOfCountedThreads() const
+{
+    std::lock_guard<std::mutex> lock(threadCountsMutex_);
+    return threadCounts_.size();
+}
+
+std::string SolveProfiler::getName(SolvePhase phase)
+{
+    switch (phase)
+    {
+        case SolvePhase::WRITE_OUTPUT_FILES:
+            return "writeOutputFiles";
+        case SolvePhase::INTEGRATE_BEFORE_FORCE_COMPUTATION:
+            return "integrateBeforeForceComputation";
+        case SolvePhase::CHECK_INTERACTION_WITH_BOUNDARIES:
+            return "checkInteractionWithBoundaries";
+        case SolvePhase::CHECK_AND_DUPLICATE_PERIODIC_PARTICLES:
+            return "checkAndDuplicatePeriodicParticles";
+        case SolvePhase::HGRID_ACTIONS_BEFORE_TIME_STEP:
+            return "hGridActionsBeforeTimeStep";
+        case SolvePhase::COMPUTE_ALL_FORCES:
+            return "computeAllForces";
+        case SolvePhase::REMOVE_DUPLICATE_PERIODIC_PARTICLES:
+            return "removeDuplicatePeriodicParticles";
+        case SolvePhase::INTEGRATE_AFTER_FORCE_COMPUTATION:
+            return "integrateAfterForceComputation";
+        case SolvePhase::ERASE_OLD_INTERACTIONS:
+            return "eraseOldInteractions";
+        default:
+            return "other";
+    }
+}
+
+/*!
+ * \details Each line contains the simulation time, the number of time steps, 
+ * the wall-clock time since the start of the time loop and the cumulative 
+ * wall-clock time of each phase, all in seconds. Thus, the cost of the 
+ * interval between two saves is the difference of two lines.
+ * \param[in] name The name of the output file.
+ * \param[in] time The simulation time.
+ * \param[in] numberOfTimeSteps The number of time steps done so far.
+ */
+void SolveProfiler::write(const std::string& name, Mdouble time, unsigned int numberOfTimeSteps)
+{
+    if (!file_.is_open())
+    {
+        file_.open(name.c_str(), std::ofstream::out);
+        if (!file_.is_open())
+        {
+            logger(WARN, "SolveProfiler::write: could not open %", name);
+            return;
+        }
+        file_ << "time timeSteps wallTime";
+        for (unsigned int i = 0; i < static_cast<unsigned int>(SolvePhase::NUMBER_OF_PHASES); i++)
+            file_ << ' ' << getName(static_cast<SolvePhase>(i));
+        file_ << std::endl;
+    }
+    file_ << std::setprecision(8) << time
+        << ' ' << numberOfTimeSteps
+        << ' ' << std::chrono::duration<Mdouble>(std::chrono::steady_clock::now() - timeLoopStart_).count();
+    for (unsigned int i = 0; i < static_cast<unsigned int>(SolvePhase::NUMBER_OF_PHASES); i++)
+        file_ << ' ' << getTime(static_cast<SolvePhase>(i));
+    file_ << std::endl;
+}
+
+/*!
+ * \details For each phase, the table contains the total wall-clock time, the 
+ * percentage of the time loop and the mean time per time step. The time of 
+ * the time loop not assigned to any phase is listed as "other".
+ */
+void SolveProfiler::print(std::ostream& os) const
+{
+    std::ios_base::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    Mdouble total = getTimeLoopTime();
+    Mdouble steps = std::max(numberOfTimeSteps_, 1u);
+    Mdouble other = total;
+    os << std::left << std::setw(36) << "phase" << std::right
+        << std::setw(12) << "time(s)" << std::setw(8) << "%" << std::setw(14) << "us/timestep" << std::endl;
+    os << std::fixed;
+    for (unsigned int i = 0; i <= static_cast<unsigned int>(SolvePhase::NUMBER_OF_PHASES); i++)
+    {
+        Mdouble time;
+        if (i < static_cast<unsigned int>(SolvePhase::NUMBER_OF_PHASES))
+        {
+            time = getTime(static_cast<SolvePhase>(i));
+            other -= time;
+        }
+        else
+        {
+            time = std::max(other, Mdouble(0));
+        }
+        os << std::left << std::setw(36) << getName(static_cast<SolvePhase>(i)) << std::right
+            << std::setprecision(4) << std::setw(12) << time
+            << std::setprecision(1) << std::setw(8) << (total > 0 ? 100.0 * time / total : 0.0)
+            << std::setprecision(3) << std::setw(14) << 1e6 * time / steps << std::endl;
+    }
+    os << std::left << std::setw(36) << "total" << std::right
+        << std::setprecision(4) << std::setw(12) << total
+        << std::setprecision(1) << std::setw(8) << 100.0
+        << std::setprecision(3) << std::setw(14) << 1e6 * total / steps << std::endl;
+    os.flags(flags);
+    os.precision(precision);
+}
+
+/*!
+ * \details For each thread and phase, the table contains the number of events 
+ * of each counter and the number of instructions per cycle (IPC). A low IPC 
+ * together with many cache misses indicates that a phase is limited by memory 
+ * accesses; a high IPC that it is limited by computation. Phases without 
+ * events are omitted.
+ */
+void SolveProfiler::printCounts(std::ostream& os) const
+{
+    const unsigned int numberOfCounters = static_cast<unsigned int>(HardwareCounter::NUMBER_OF_COUNTERS);
+    std::ios_base::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    std::lock_guard<std::mutex> lock(threadCountsMutex_);
+    for (const ThreadCounts& t : threadCounts_)
+    {
+        os << "thread " << t.thread << ":" << std::endl;
+        os << std::left << std::setw(36) << "phase" << std::right;
+        for (unsigned int j = 0; j < numberOfCounters; j++)
+            os << std::setw(15) << HardwareCounters::getName(static_cast<HardwareCounter>(j));
+        os << std::setw(8) << "IPC" << std::endl;
+        for (unsigned int i = 0; i < static_cast<unsigned int>(SolvePhase::NUMBER_OF_PHASES); i++)
+        {
+            const uint64_t* counts = t.counts[i];
+            if (std::all_of(counts, counts + numberOfCounters, [](uint64_t count) { return count == 0; }))
+                continue;
+            os << std::left << std::setw(36) << getName(static_cast<SolvePhase>(i)) << std::right;
+            for (unsigned int j = 0; j < numberOfCounters; j++)
+                os << std::setw(15) << counts[j];
+            uint64_t cycles = counts[static_cast<unsigned int>(HardwareCounter::CYCLES)];
+            uint64_t instructions = counts[static_cast<unsigned int>(HardwareCounter::INSTRUCTIONS)];
+            os << std::fixed << std::setprecision(2) << std::setw(8)
+                << (cycles > 0 ? static_cast<Mdouble>(instructions) / cycles : 0.0) << std::endl;
+        }
+    }
+    os.flags(flags);
+    os.precision(precision);
+}
@@ -0,0 +1,274 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#ifndef SOLVEPROFILER_H
+#define SOLVEPROFILER_H
+
+#include <chrono>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "GeneralDefine.h"
+#include "HardwareCounters.h"
+
+/*!
+ * \brief The stages of the time loop in DPMBase::solve that are timed by the SolveProfiler.
+ */
+enum class SolvePhase : unsigned int
+{
+    WRITE_OUTPUT_FILES,
+    INTEGRATE_BEFORE_FORCE_COMPUTATION,
+    CHECK_INTERACTION_WITH_BOUNDARIES,
+    CHECK_AND_DUPLICATE_PERIODIC_PARTICLES,
+    HGRID_ACTIONS_BEFORE_TIME_STEP,
+    COMPUTE_ALL_FORCES,
+    REMOVE_DUPLICATE_PERIODIC_PARTICLES,
+    INTEGRATE_AFTER_FORCE_COMPUTATION,
+    ERASE_OLD_INTERACTIONS,
+    NUMBER_OF_PHASES
+};
+
+/*!
+ * \brief Measures the wall-clock time spent in each stage of DPMBase::solve.
+ * \details Each stage of the time loop is wrapped in a SolveProfiler::ScopedTimer, 
+ * which adds the elapsed time (measured with std::chrono::steady_clock) to the 
+ * total of its SolvePhase. The time spent in the rest of the loop (e.g. 
+ * actionsBeforeTimeStep, the remaining hGrid actions) is reported as "other".
+ * 
+ * The profiler is disabled by default; then a ScopedTimer only checks a flag 
+ * and does not read the clock. When enabled (via setEnabled or the command-line
+ * argument -profile 1), solve writes the cumulative times to the file 
+ * name.prof whenever the data file is written (including the last time step)
+ * and prints a breakdown table at the end of the run.
+ * 
+ * Optionally (via setHardwareCountersEnabled or -profileCounters 1), the 
+ * ScopedTimers also read the hardware performance counters (cycles, 
+ * instructions, cache and branch misses, see HardwareCounters) of the calling 
+ * thread, such that one can see whether a stage is limited by memory accesses 
+ * or by computation. The counts are stored per thread and phase. If the 
+ * counters are not available, only the wall-clock times are measured.
+ */
+class SolveProfiler
+{
+public:
+    /*!
+     * \brief Adds the wall-clock time between its construction and destruction to a phase of the profiler.
+     */
+    class ScopedTimer
+    {
+    public:
+        /*!
+         * \brief Starts the timer, if the profiler is enabled.
+         */
+        ScopedTimer(SolveProfiler& profiler, SolvePhase phase)
+                : profiler_(profiler.isEnabled_ ? &profiler : nullptr), phase_(phase), counters_(nullptr)
+        {
+            if (profiler_ != nullptr)
+            {
+                if (profiler_->hardwareCountersEnabled_ && HardwareCounters::getThreadCounters().isOpen())
+                {
+                    counters_ = &HardwareCounters::getThreadCounters();
+                    counters_->read(startCounts_);
+                }
+                start_ = std::chrono::steady_clock::now();
+            }
+        }
+
+        /*!
+         * \brief Stops the timer and adds the elapsed time to the phase.
+         */
+        ~ScopedTimer()
+        {
+            if (profiler_ != nullptr)
+            {
+                profiler_->add(phase_, std::chrono::steady_clock::now() - start_);
+                if (counters_ != nullptr)
+                    profiler_->addCounts(phase_, *counters_, startCounts_);
+            }
+        }
+
+    private:
+        ///The profiler the time is added to, or nullptr if the profiler is disabled
+        SolveProfiler* profiler_;
+
+        ///The phase that is timed
+        SolvePhase phase_;
+
+        ///The time at which the timer was started
+        std::chrono::steady_clock::time_point start_;
+
+        ///The hardware counters of the calling thread, or nullptr if they are not measured
+        HardwareCounters* counters_;
+
+        ///The values of the hardware counters at the start of the timer
+        uint64_t startCounts_[static_cast<unsigned int>(HardwareCounter::NUMBER_OF_COUNTERS)];
+    };
+
+    /*!
+     * \brief Default constructor; the profiler is disabled.
+     */
+    SolveProfiler();
+
+    /*!
+     * \brief Copy constructor; copies the settings, but not the timings or the output file.
+     */
+    SolveProfiler(const SolveProfiler& other);
+
+    /*!
+     * \brief Enables or disables the profiler.
+     */
+    void setEnabled(bool isEnabled);
+
+    /*!
+     * \brief Returns true if the profiler measures the phases of solve.
+     */
+    bool isEnabled() const;
+
+    /*!
+     * \brief Enables or disables reading the hardware performance counters in the timed phases.
+     */
+    void setHardwareCountersEnabled(bool hardwareCountersEnabled);
+
+    /*!
+     * \brief Returns true if the hardware performance counters are read in the timed phases.
+     */
+    bool getHardwareCountersEnabled() const;
+
+    /*!
+     * \brief Sets all timings to zero and closes the output file; called at the start of solve.
+     */
+    void reset();
+
+    /*!
+     * \brief Starts measuring the total time of the time loop.
+     */
+    void startTimeLoop();
+
+    /*!
+     * \brief Stops measuring the total time of the time loop and closes the output file.
+     */
+    void stopTimeLoop(unsigned int numberOfTimeSteps);
+
+    /*!
+     * \brief Returns the total wall-clock time (in seconds) spent in a phase.
+     */
+    Mdouble getTime(SolvePhase phase) const;
+
+    /*!
+     * \brief Returns the wall-clock time (in seconds) of the time loop, including the parts not assigned to a phase.
+     */
+    Mdouble getTimeLoopTime() const;
+
+    /*!
+     * \brief Returns the number of time steps done in the time loop.
+     */
+    unsigned int getNumberOfTimeSteps() const;
+
+    /*!
+     * \brief Returns the name of a phase, as it is used in the output.
+     */
+    static std::string getName(SolvePhase phase);
+
+    /*!
+     * \brief Returns the number of events of a hardware counter in a phase, summed over all threads.
+     */
+    uint64_t getCount(SolvePhase phase, HardwareCounter counter) const;
+
+    /*!
+     * \brief Returns the number of threads for which hardware counts have been recorded.
+     */
+    unsigned int getNumberOfCountedThreads() const;
+
+    /*!
+     * \brief Writes the cumulative timings as one line to the file name (the header is written when the file is opened).
+     */
+    void write(const std::string& name, Mdouble time, unsigned int numberOfTimeSteps);
+
+    /*!
+     * \brief Prints a table of the time spent per phase.
+     */
+    void print(std::ostream& os) const;
+
+    /*!
+     * \brief Prints a table of the hardware counts per thread and phase.
+     */
+    void printCounts(std::ostream& os) const;
+
+private:
+    /*!
+     * \brief Adds a time interval to a phase.
+     */
+    void add(SolvePhase phase, std::chrono::steady_clock::duration duration)
+    {
+        times_[static_cast<unsigned int>(phase)] += duration;
+    }
+
+    /*!
+     * \brief Adds the hardware counts since startCounts to a phase of the calling thread.
+     */
+    void addCounts(SolvePhase phase, const HardwareCounters& counters, const uint64_t startCounts[]);
+
+    /*!
+     * \brief The hardware counts of one thread.
+     */
+    struct ThreadCounts
+    {
+        ///The thread in which the counts were measured
+        std::thread::id thread;
+        ///Number of events per phase and counter
+        uint64_t counts[static_cast<unsigned int>(SolvePhase::NUMBER_OF_PHASES)][static_cast<unsigned int>(HardwareCounter::NUMBER_OF_COUNTERS)];
+    };
+
+    ///If false, the ScopedTimers do not read the clock
+    bool isEnabled_;
+
+    ///Time spent in each phase
+    std::chrono::steady_clock::duration times_[static_cast<unsigned int>(SolvePhase::NUMBER_OF_PHASES)];
+
+    ///Time at which the time loop (or the current part of it) was started
+    std::chrono::steady_clock::time_point timeLoopStart_;
+
+    ///Time spent in the time loop
+    std::chrono::steady_clock::duration timeLoopTime_;
+
+    ///Number of time steps done in the time loop
+    unsigned int numberOfTimeSteps_;
+
+    ///The output file, opened at the first call to write
+    std::ofstream file_;
+
+    ///If true, the ScopedTimers also read the hardware counters
+    bool hardwareCountersEnabled_;
+
+    ///Hardware counts of each thread that ran a ScopedTimer
+    std::vector<ThreadCounts> threadCounts_;
+
+    ///Protects threadCounts_ against concurrent timers
+    mutable std::mutex threadCountsMutex_;
+};
+
+#endif
@@ -0,0 +1,395 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "SortAndSweep.h"
+#include "ParticleHandler.h"
+#include "Particles/BaseParticle.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+///The rank of a particle that is not in the sorted list
+static const unsigned int NOT_SORTED = std::numeric_limits<unsigned int>::max();
+
+SortAndSweep::SortAndSweep()
+{
+    numberOfInsertedParticles_ = 0;
+    isOutdated_ = true;
+    needsRebuilding_ = true;
+    axis_ = 0;
+    maxInteractionRadius_ = 0.0;
+    numberOfRebuilds_ = 0;
+    numberOfSwaps_ = 0;
+}
+
+/*!
+ * \param[in] other The SortAndSweep that is copied; as it stores pointers to 
+ *                  the particles of another ParticleHandler, nothing is copied.
+ */
+SortAndSweep::SortAndSweep(const SortAndSweep& other UNUSED)
+{
+    numberOfInsertedParticles_ = 0;
+    isOutdated_ = true;
+    needsRebuilding_ = true;
+    axis_ = 0;
+    maxInteractionRadius_ = 0.0;
+    numberOfRebuilds_ = 0;
+    numberOfSwaps_ = 0;
+}
+
+/*!
+ * \param[in] p The particle that has just been added to the ParticleHandler.
+ */
+void SortAndSweep::insertParticle(BaseParticle* p)
+{
+    pending_.push_back(p);
+    numberOfInsertedParticles_++;
+    if (p->getIndex() < rank_.size())
+    {
+        rank_[p->getIndex()] = NOT_SORTED;
+    }
+    isOutdated_ = true;
+}
+
+/*!
+ * \param[in] p The particle that is about to be removed from the ParticleHandler.
+ * \details The entry of the particle is marked as removed. As the 
+ *          ParticleHandler moves its last particle into the place of the 
+ *          removed one, the rank of the last particle is moved as well.
+ */
+void SortAndSweep::removeParticle(BaseParticle* p)
+{
+    if (numberOfInsertedParticles_ > 0)
+    {
+        numberOfInsertedParticles_--;
+    }
+    unsigned int rank = getRank(p);
+    if (rank < entries_.size())
+    {
+        entries_[rank].particle = nullptr;
+    }
+    else
+    {
+        std::vector<BaseParticle*>::iterator it = std::find(pending_.begin(), pending_.end(), p);
+        if (it != pending_.end())
+        {
+            *it = pending_.back();
+            pending_.pop_back();
+        }
+        else
+        {
+            //the ranks are outdated, e.g. because the ParticleHandler was reordered
+            for (Entry& entry : entries_)
+            {
+                if (entry.particle == p)
+                {
+                    entry.particle = nullptr;
+                }
+            }
+        }
+    }
+    
+    if (p->getHandler() != nullptr && p->getHandler()->getNumberOfObjects() > 0)
+    {
+        unsigned int index = p->getIndex();
+        unsigned int lastIndex = p->getHandler()->getNumberOfObjects() - 1;
+        if (lastIndex < rank_.size())
+        {
+            if (index < rank_.size())
+            {
+                rank_[index] = rank_[lastIndex];
+            }
+            rank_.resize(lastIndex);
+        }
+    }
+}
+
+void SortAndSweep::setOutdated()
+{
+    isOutdated_ = true;
+}
+
+void SortAndSweep::setNeedsRebuilding()
+{
+    needsRebuilding_ = true;
+}
+
+/*!
+ * \return True if particles have moved, been inserted or the list has to be sorted from scratch.
+ */
+bool SortAndSweep::needsUpdate() const
+{
+    return isOutdated_ || needsRebuilding_ || !pending_.empty();
+}
+
+/*!
+ * \param[in] particleHandler The ParticleHandler whose particles are in the list.
+ * \param[in] dimensions      The number of dimensions of the system; the axis
+ *                            is chosen from the first dimensions axes.
+ * \details The entries are updated with the new positions and sorted by an 
+ *          insertion sort, which only moves the particles that overtook 
+ *          another particle along the axis. Then the inserted particles are 
+ *          merged in and the removed ones dropped.
+ */
+void SortAndSweep::update(const ParticleHandler& particleHandler, unsigned int dimensions)
+{
+    if (needsRebuilding_ || numberOfInsertedParticles_ != particleHandler.getNumberOfObjects())
+    {
+        rebuild(particleHandler, dimensions);
+        return;
+    }
+    
+    //update the entries and drop the removed particles
+    unsigned int n = 0;
+    maxInteractionRadius_ = 0.0;
+    for (Entry& entry : entries_)
+    {
+        if (entry.particle != nullptr)
+        {
+            setEntry(entries_[n], entry.particle);
+            maxInteractionRadius_ = std::max(maxInteractionRadius_, entries_[n].radius);
+            n++;
+        }
+    }
+    entries_.resize(n);
+    
+    //insertion sort; the list is almost sorted, as the particles moved little
+    numberOfSwaps_ = 0;
+    for (unsigned int i = 1; i < entries_.size(); i++)
+    {
+        if (entries_[i - 1].lower > entries_[i].lower)
+        {
+            Entry entry = entries_[i];
+            unsigned int j = i;
+            do
+            {
+                entries_[j] = entries_[j - 1];
+                j--;
+                numberOfSwaps_++;
+            } while (j > 0 && entries_[j - 1].lower > entry.lower);
+            entries_[j] = entry;
+        }
+    }
+    
+    //merge in the inserted particles
+    if (!pending_.empty())
+    {
+        unsigned int numberOfSorted = entries_.size();
+        for (BaseParticle* p : pending_)
+        {
+            if (!particleHandler.isInFixedParticleGrid(p))
+            {
+                entries_.push_back(Entry());
+                setEntry(entries_.back(), p);
+                maxInteractionRadius_ = std::max(maxInteractionRadius_, entries_.back().radius);
+            }
+        }
+        pending_.clear();
+        auto isLower = [] (const Entry& a, const Entry& b) {return a.lower < b.lower;};
+        std::sort(entries_.begin() + numberOfSorted, entries_.end(), isLower);
+        std::inplace_merge(entries_.begin(), entries_.begin() + numberOfSorted, entries_.end(), isLower);
+    }
+    
+    rank_.assign(particleHandler.getNumberOfObjects(), NOT_SORTED);
+    for (unsigned int i = 0; i < entries_.size(); i++)
+    {
+        rank_[entries_[i].particle->getIndex()] = i;
+    }
+    isOutdated_ = false;
+}
+
+/*!
+ * \param[in] particleHandler The ParticleHandler whose particles are sorted.
+ * \param[in] dimensions      The number of dimensions of the system.
+ * \details The axis is the longest side of the bounding box of the particles, 
+ *          such that the intervals of as few particles as possible overlap.
+ */
+void SortAndSweep::rebuild(const ParticleHandler& particleHandler, unsigned int dimensions)
+{
+    entries_.clear();
+    pending_.clear();
+    maxInteractionRadius_ = 0.0;
+    Vec3D min(std::numeric_limits<Mdouble>::max(), std::numeric_limits<Mdouble>::max(), std::numeric_limits<Mdouble>::max());
+    Vec3D max = -min;
+    for (BaseParticle* p : particleHandler)
+    {
+        if (!particleHandler.isInFixedParticleGrid(p))
+        {
+            min = Vec3D::min(min, p->getPosition());
+            max = Vec3D::max(max, p->getPosition());
+            entries_.push_back(Entry());
+            entries_.back().particle = p;
+        }
+    }
+    
+    axis_ = 0;
+    for (unsigned int axis = 1; axis < std::min(dimensions, 3u); axis++)
+    {
+        if (max.getComponent(axis) - min.getComponent(axis) > max.getComponent(axis_) - min.getComponent(axis_))
+        {
+            axis_ = axis;
+        }
+    }
+    
+    for (Entry& entry : entries_)
+    {
+        setEntry(entry, entry.particle);
+        maxInteractionRadius_ = std::max(maxInteractionRadius_, entry.radius);
+    }
+    std::sort(entries_.begin(), entries_.end(), [] (const Entry& a, const Entry& b) {return a.lower < b.lower;});
+    
+    rank_.assign(particleHandler.getNumberOfObjects(), NOT_SORTED);
+    for (unsigned int i = 0; i < entries_.size(); i++)
+    {
+        rank_[entries_[i].particle->getIndex()] = i;
+    }
+    numberOfInsertedParticles_ = particleHandler.getNumberOfObjects();
+    numberOfSwaps_ = 0;
+    numberOfRebuilds_++;
+    needsRebuilding_ = false;
+    isOutdated_ = false;
+    logger(VERBOSE, "SortAndSweep: sorted % particles along axis %", entries_.size(), axis_);
+}
+
+/*!
+ * \param[out] entry The entry that is set.
+ * \param[in]  p     The particle of the entry.
+ */
+void SortAndSweep::setEntry(Entry& entry, BaseParticle* p) const
+{
+    entry.particle = p;
+    entry.position = p->getPosition();
+    entry.radius = p->getInteractionRadius();
+    entry.lower = entry.position.getComponent(axis_) - entry.radius;
+}
+
+/*!
+ * \param[in] p The particle whose rank is requested.
+ * \return The position of the particle in entries_, or entries_.size() if the 
+ *         particle is not in the list, e.g. because it has been inserted since
+ *         the last update.
+ */
+unsigned int SortAndSweep::getRank(const BaseParticle* p) const
+{
+    unsigned int index = p->getIndex();
+    if (index < rank_.size() && rank_[index] < entries_.size() && entries_[rank_[index]].particle == p)
+    {
+        return rank_[index];
+    }
+    return entries_.size();
+}
+
+/*!
+ * \param[in] entry    The entry that is compared.
+ * \param[in] position The position of the particle.
+ * \param[in] radius   The interaction radius of the particle.
+ * \return True if the bounding boxes overlap in the two directions perpendicular to the axis.
+ */
+bool SortAndSweep::overlapsPerpendicular(const Entry& entry, const Vec3D& position, Mdouble radius) const
+{
+    Mdouble distance = entry.radius + radius;
+    return (axis_ == 0 || std::abs(entry.position.X - position.X) <= distance)
+        && (axis_ == 1 || std::abs(entry.position.Y - position.Y) <= distance)
+        && (axis_ == 2 || std::abs(entry.position.Z - position.Z) <= distance);
+}
+
+/*!
+ * \param[in] p A particle in the list.
+ * \return The particles after p in the list whose bounding boxes overlap with 
+ *         the one of p, such that each pair is found only once. The list has 
+ *         to be up to date; if p is not in the list, no particles are returned.
+ */
+const std::vector<BaseParticle*>& SortAndSweep::getOneSidedCandidates(const BaseParticle& p)
+{
+    candidates_.clear();
+    unsigned int rank = getRank(&p);
+    if (rank >= entries_.size())
+    {
+        logger(WARN, "SortAndSweep::getOneSidedCandidates: particle % is not in the sorted list", p.getId());
+        return candidates_;
+    }
+    const Entry& entry = entries_[rank];
+    Mdouble upper = entry.position.getComponent(axis_) + entry.radius;
+    for (unsigned int j = rank + 1; j < entries_.size() && entries_[j].lower <= upper; j++)
+    {
+        if (entries_[j].particle != nullptr && overlapsPerpendicular(entries_[j], entry.position, entry.radius))
+        {
+            candidates_.push_back(entries_[j].particle);
+        }
+    }
+    return candidates_;
+}
+
+/*!
+ * \param[in] p A particle, which does not have to be in the list.
+ * \return The particles in the list, other than p, whose bounding boxes overlap
+ *         with the one of p. The lower ends of the candidates lie between 
+ *         x-r-2R and x+r, with x the position of p along the axis, r its 
+ *         interaction radius and R the largest interaction radius in the list;
+ *         this range is found by bisection.
+ */
+const std::vector<BaseParticle*>& SortAndSweep::getCandidateParticles(const BaseParticle& p)
+{
+    candidates_.clear();
+    Mdouble x = p.getPosition().getComponent(axis_);
+    Mdouble radius = p.getInteractionRadius();
+    std::vector<Entry>::const_iterator it = std::lower_bound(entries_.begin(), entries_.end(), x - radius - 2.0 * maxInteractionRadius_,
+                                                             [] (const Entry& a, Mdouble lower) {return a.lower < lower;});
+    for (; it != entries_.end() && it->lower <= x + radius; ++it)
+    {
+        if (it->particle != nullptr && it->particle != &p && overlapsPerpendicular(*it, p.getPosition(), radius))
+        {
+            candidates_.push_back(it->particle);
+        }
+    }
+    return candidates_;
+}
+
+unsigned int SortAndSweep::getAxis() const
+{
+    return axis_;
+}
+
+unsigned int SortAndSweep::getNumberOfParticles() const
+{
+    return entries_.size();
+}
+
+unsigned int SortAndSweep::getNumberOfRebuilds() const
+{
+    return numberOfRebuilds_;
+}
+
+unsigned int SortAndSweep::getNumberOfSwaps() const
+{
+    return numberOfSwaps_;
+}
+
+std::size_t SortAndSweep::getMemoryUsage() const
+{
+    return sizeof(SortAndSweep) + entries_.capacity() * sizeof(Entry) + rank_.capacity() * sizeof(unsigned int)
+        + (pending_.capacity() + candidates_.capacity()) * sizeof(BaseParticle*);
+}
@@ -0,0 +1,202 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef SORTANDSWEEP_H
+#define SORTANDSWEEP_H
+
+#include <vector>
+#include "Math/Vector.h"
+
+class BaseParticle;
+class ParticleHandler;
+
+/*!
+ * \brief A broad phase that sorts the particles along one axis and sweeps over the sorted list to find pairs.
+ * \details The particles are sorted by the lower end of their interaction 
+ * interval along the longest axis of their bounding box. Two particles can only
+ * interact if their intervals overlap, so the partners of a particle that come
+ * after it in the list are found by sweeping forward until the lower end of 
+ * the next particle is beyond the upper end of the particle; the other axes are
+ * only used to discard pairs whose bounding boxes do not overlap.
+ *
+ * For long and thin domains, like chutes, the particles hardly change order 
+ * between two time steps, so the list is kept sorted by an insertion sort, 
+ * which takes linear time for an almost sorted list. New particles, e.g. 
+ * periodic images, are sorted separately and merged into the list; removed 
+ * particles are marked and compacted away at the next update. The list is only
+ * sorted from scratch (and the axis chosen anew) if the particles in the grid 
+ * of static particles change or the list got out of sync with the 
+ * ParticleHandler.
+ *
+ * Particles in the grid of static particles of the ParticleHandler are not 
+ * stored, as they are found by the mobile particles through that grid.
+ */
+class SortAndSweep
+{
+public:
+    /*!
+     * \brief Default constructor; creates an empty list.
+     */
+    SortAndSweep();
+
+    /*!
+     * \brief Copy constructor; the list is not copied, but rebuilt when it is used.
+     */
+    SortAndSweep(const SortAndSweep& other);
+
+    /*!
+     * \brief Adds a particle that was just added to the ParticleHandler; it is sorted in by the next update.
+     */
+    void insertParticle(BaseParticle* p);
+
+    /*!
+     * \brief Removes a particle that is about to be removed from the ParticleHandler.
+     */
+    void removeParticle(BaseParticle* p);
+
+    /*!
+     * \brief Marks the positions as outdated, e.g. after the particles moved.
+     */
+    void setOutdated();
+
+    /*!
+     * \brief Forces the list to be sorted from scratch by the next update.
+     */
+    void setNeedsRebuilding();
+
+    /*!
+     * \brief Returns whether the list has to be updated before it can be used.
+     */
+    bool needsUpdate() const;
+
+    /*!
+     * \brief Brings the list up to date with the positions of the particles in the ParticleHandler.
+     */
+    void update(const ParticleHandler& particleHandler, unsigned int dimensions);
+
+    /*!
+     * \brief Returns the particles after the given particle in the list whose bounding boxes overlap with it.
+     */
+    const std::vector<BaseParticle*>& getOneSidedCandidates(const BaseParticle& p);
+
+    /*!
+     * \brief Returns all particles in the list whose bounding boxes overlap with the given particle.
+     */
+    const std::vector<BaseParticle*>& getCandidateParticles(const BaseParticle& p);
+
+    /*!
+     * \brief Returns the axis along which the particles are sorted (0, 1 or 2 for x, y or z).
+     */
+    unsigned int getAxis() const;
+
+    /*!
+     * \brief Returns the number of particles in the list.
+     */
+    unsigned int getNumberOfParticles() const;
+
+    /*!
+     * \brief Returns how often the list has been sorted from scratch.
+     */
+    unsigned int getNumberOfRebuilds() const;
+
+    /*!
+     * \brief Returns the number of swaps of the insertion sort at the last update.
+     */
+    unsigned int getNumberOfSwaps() const;
+
+    /*!
+     * \brief Returns the number of bytes used by the list.
+     */
+    std::size_t getMemoryUsage() const;
+
+private:
+    ///An entry of the sorted list; the position and radius are copied to keep the sweep in contiguous memory
+    struct Entry
+    {
+        ///The lower end of the interaction interval along the axis, by which the list is sorted
+        Mdouble lower;
+        ///The interaction radius of the particle
+        Mdouble radius;
+        ///The position of the particle
+        Vec3D position;
+        ///The particle, or nullptr if it has been removed since the last update
+        BaseParticle* particle;
+    };
+
+    /*!
+     * \brief Sets the position, radius and lower end of an entry from its particle.
+     */
+    void setEntry(Entry& entry, BaseParticle* p) const;
+
+    /*!
+     * \brief Sorts all particles of the ParticleHandler from scratch and chooses the axis.
+     */
+    void rebuild(const ParticleHandler& particleHandler, unsigned int dimensions);
+
+    /*!
+     * \brief Returns the position of the particle in the list, or entries_.size() if it is not in the list.
+     */
+    unsigned int getRank(const BaseParticle* p) const;
+
+    /*!
+     * \brief Returns whether the bounding boxes of an entry and a particle overlap in the directions other than the axis.
+     */
+    bool overlapsPerpendicular(const Entry& entry, const Vec3D& position, Mdouble radius) const;
+
+    ///The sorted list
+    std::vector<Entry> entries_;
+
+    ///The position of each particle in entries_, indexed by the index of the particle in the ParticleHandler
+    std::vector<unsigned int> rank_;
+
+    ///The particles inserted since the last update
+    std::vector<BaseParticle*> pending_;
+
+    ///The number of particles inserted minus the number removed, to detect if the list got out of sync with the ParticleHandler
+    unsigned int numberOfInsertedParticles_;
+
+    ///Whether the positions have changed since the last update
+    bool isOutdated_;
+
+    ///Whether the list has to be sorted from scratch
+    bool needsRebuilding_;
+
+    ///The axis along which the particles are sorted
+    unsigned int axis_;
+
+    ///The largest interaction radius of the particles in the list
+    Mdouble maxInteractionRadius_;
+
+    ///The number of times the list has been sorted from scratch
+    unsigned int numberOfRebuilds_;
+
+    ///The number of swaps of the insertion sort at the last update
+    unsigned int numberOfSwaps_;
+
+    ///The result of getOneSidedCandidates and getCandidateParticles, kept to avoid allocations
+    std::vector<BaseParticle*> candidates_;
+};
+
+#endif
@@ -67,6 +67,11 @@ public:
     ///\brief Returns the name of the MixedSpecies as it is used in the restart file. 
     std::string getName() const;
 
+    /*!
+     * \brief Returns the number of bytes used by this MixedSpecies.
+     */
+    std::size_t getMemoryUsage() const final;
+
     /*!
      * \brief When a contact between two particles is determined, an Interaction 
      * object is created, as the type of Interaction depends on the MixedSpecies type.
@@ -192,6 +197,15 @@ std::string MixedSpecies<NormalForceSpecies, FrictionForceSpecies, AdhesiveForce
         + AdhesiveForceSpecies::getBaseName() + "MixedSpecies";
 }
 
+/*!
+ * \return The size of this MixedSpecies.
+ */
+template<class NormalForceSpecies, class FrictionForceSpecies, class AdhesiveForceSpecies>
+std::size_t MixedSpecies<NormalForceSpecies, FrictionForceSpecies, AdhesiveForceSpecies>::getMemoryUsage() const
+{
+    return sizeof(MixedSpecies<NormalForceSpecies, FrictionForceSpecies, AdhesiveForceSpecies>);
+}
+
 /*!
  * \details The input parameters of this function are directly passed into the constructor for the new interaction.
  * See Interaction for details.
@@ -167,6 +167,11 @@ public:
     ///\brief Returns the name of the Species as it is used in the restart file. 
     std::string getName() const final;
 
+    /*!
+     * \brief Returns the number of bytes used by this Species.
+     */
+    std::size_t getMemoryUsage() const final;
+
     /*!
      * \brief When a contact between two particles is determined, an Interaction 
      * object is created, as the type of Interaction depends on the Species type.
@@ -288,6 +293,15 @@ std::string Species<NormalForceSpecies, FrictionForceSpecies, AdhesiveForceSpeci
         + AdhesiveForceSpecies::getBaseName() + "Species";
 }
 
+/*!
+ * \return The size of this Species.
+ */
+template<class NormalForceSpecies, class FrictionForceSpecies, class AdhesiveForceSpecies>
+std::size_t Species<NormalForceSpecies, FrictionForceSpecies, AdhesiveForceSpecies>::getMemoryUsage() const
+{
+    return sizeof(Species<NormalForceSpecies, FrictionForceSpecies, AdhesiveForceSpecies>);
+}
+
 /*!
  * \details The input parameters of this function are directly passed into the constructor for the new interaction.
  * See Interaction for details.
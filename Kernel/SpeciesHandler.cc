@@ -621,6 +621,25 @@ std::string SpeciesHandler::getName() const
     return "SpeciesHandler";
 }
 
+/*!
+ * \return The number of bytes used by the species, the mixed species and the 
+ *         vectors of pointers to them.
+ */
+std::size_t SpeciesHandler::getMemoryUsage() const
+{
+    std::size_t memoryUsage = objects_.capacity() * sizeof(ParticleSpecies*)
+        + mixedObjects_.capacity() * sizeof(BaseSpecies*);
+    for (const ParticleSpecies* species : objects_)
+    {
+        memoryUsage += species->getMemoryUsage();
+    }
+    for (const BaseSpecies* mixedSpecies : mixedObjects_)
+    {
+        memoryUsage += mixedSpecies->getMemoryUsage();
+    }
+    return recordMemoryUsage(memoryUsage);
+}
+
 /*!
  * \return The boolean which says whether or not AnuglarDOFs must be used in this handler.
  */
@@ -85,6 +85,9 @@ public:
     /// \brief Returns the name of the handler, namely the string "SpeciesHandler".
     std::string getName() const;
 
+    /// \brief Gets the number of bytes used by the species and mixed species.
+    std::size_t getMemoryUsage() const override;
+
     /// \brief Check if angular DOF have to be used
     bool useAngularDOFs();
 
@@ -53,6 +53,7 @@ public:
     StatisticsPoint()
     {
         this->Position.setZero();
+        RadialPosition = 0;
         mirrorParticle = -1;
         //~ this->set_zero(); 
     }
@@ -179,6 +180,19 @@ public:
     void setPosition(Vec3D new_)
     {
         this->Position = new_;
+        this->RadialPosition = sqrt(new_.X * new_.X + new_.Y * new_.Y);
+    }
+    ///sets #Position from cylindrical coordinates (r,theta,z); #RadialPosition is taken from the radial axis, not recomputed from the Cartesian position
+    void setCylindricalPosition(Vec3D new_)
+    {
+        this->Position = new_.getFromCylindricalCoordinates();
+        this->RadialPosition = new_.X;
+    }
+    ///copies #Position and #RadialPosition of another point
+    void copyPosition(const StatisticsPoint& other)
+    {
+        this->Position = other.Position;
+        this->RadialPosition = other.RadialPosition;
     }
     ///returns #Position
     Vec3D getPosition() const
@@ -236,6 +250,15 @@ public:
     ///averaged along a plane
     Mdouble CG_function_1D(const Vec3D &PI);
 
+    ///Returns the value of the course graining function phi(P,PI) averaged
+    ///about the cylinder axis (and, for StatType R, along z), for PI given
+    ///in reduced coordinates (radius RI, height ZI)
+    Mdouble CG_function_cylindrical(Mdouble RI, Mdouble ZI);
+
+    ///Returns the value of the course graining function phi(P,PI) averaged
+    ///about the cylinder axis, for PI given in Cartesian coordinates
+    Mdouble CG_function_cylindrical(const Vec3D &PI);
+
     ///gradient of phi 
     ///\todo{Only implemented for Gaussian}
     Vec3D CG_gradient(const Vec3D &P, const Mdouble phi);
@@ -256,6 +279,10 @@ public:
     ///averaged along a plane
     Mdouble CG_integral_1D(Vec3D &P1, Vec3D &P2, Vec3D &P1_P2_normal, Mdouble P1_P2_distance, Mdouble& rpsi_scalar);
 
+    ///Returns the value of the coarse graining integral \f$ \psi(P,PI,PJ) = \int_0^1 \phi(P - PI + s PJ) ds \f$
+    ///averaged about the cylinder axis
+    Mdouble CG_integral_cylindrical(Vec3D &P1, Vec3D &P2, Vec3D& rpsi);
+
     ///Outputs statistical variables in human-readable format
     std::string print() const;
     ///Outputs root of statistical variables in human-readable format
@@ -314,10 +341,12 @@ public:
     int mirrorParticle;
 
 private:
-    ///Pointer to StatisticsVector (to obtain global parameters)
-    static StatisticsVector<T>* gb;
+    ///Pointer to StatisticsVector (to obtain global parameters); thread-local, so each thread evaluating statistics can point to its own StatisticsVector
+    static thread_local StatisticsVector<T>* gb;
     ///Position at which evaluation occurs
     Vec3D Position;
+    ///Distance of #Position from the z-axis, used by the azimuthally averaged StatTypes
+    Mdouble RadialPosition;
     
 };
 #endif
@@ -30,6 +30,9 @@
 #include "Math/MatrixSymmetric.h"
 #include <string.h>
 #include <fstream>
+#include <future>
+#include <limits>
+#include <typeinfo>
 #include <math.h>
 #include "Species/LinearViscoelasticSpecies.h"
 /*!
@@ -94,6 +97,11 @@ public:
      * \brief Advanced constructor that accepts arguments from the command line
      */
     StatisticsVector(int argc, char *argv[]);
+
+    /*!
+     * \brief Destructor; waits for and deletes the worker StatisticsVectors used for parallel evaluation
+     */
+    ~StatisticsVector();
     /*!
      * \brief 
      */
@@ -111,6 +119,16 @@ public:
 
     void writeOutputFiles();
 
+    /*!
+     * \brief Stores the number of bytes used by the handlers and the coarse-graining grids in #memoryUsage.
+     */
+    void computeMemoryUsage();
+
+    /*!
+     * \brief Returns the number of bytes used by the coarse-graining grids of all resolutions, the recorded contacts and the workers.
+     */
+    std::size_t getStatisticsMemoryUsage() const;
+
     /*!
      * \brief 
      */
@@ -320,6 +338,21 @@ public:
      */
     void setCGWidth2(Mdouble new_);
 
+    /*!
+     * \brief Adds a further coarse-graining resolution (width and grid size) that is evaluated in the same pass over the data as the primary one
+     * \details The particle and contact loops are shared; the resolution gets its own stat file, named like the primary one with the suffix .1, .2, ...
+     * Has to be called before the statistics are initialised.
+     */
+    void addCGResolution(Mdouble w, int nx_, int ny_, int nz_);
+
+    /*!
+     * \brief Returns the number of coarse-graining resolutions, including the primary one
+     */
+    unsigned int getNumberOfCGResolutions()
+    {
+        return resolutions_.size() + 1;
+    }
+
     /*!
      * \brief 
      */
@@ -646,6 +679,11 @@ public:
      */
     void processStatistics(bool usethese);
 
+    /*!
+     * \brief Processes the gathered statistics of the currently active coarse-graining resolution, see #processStatistics
+     */
+    void processCGResolution(bool usethese);
+
     /*!
      * \brief Finish all statistics (i.e. write out final data)
      */
@@ -666,6 +704,21 @@ public:
      */
     void evaluate_particle_statistics(std::vector<BaseParticle*>::iterator P, int wp = 0);
 
+    /*!
+     * \brief Calculates statistics for a single Particle for all coarse-graining resolutions
+     */
+    void evaluate_particle_statistics_all_resolutions(std::vector<BaseParticle*>::iterator P);
+
+    /*!
+     * \brief Calls #evaluate_force_statistics for all coarse-graining resolutions
+     */
+    void evaluate_force_statistics_all_resolutions();
+
+    /*!
+     * \brief Calls #evaluate_wall_force_statistics for all coarse-graining resolutions
+     */
+    void evaluate_wall_force_statistics_all_resolutions(Vec3D P);
+
     /*!
      * \brief 
      */
@@ -801,6 +854,16 @@ public:
      */
     Mdouble setInfinitelyLongDistance();
 
+    /*!
+     * \brief Returns the distance from P1 along -P1_P2_normal to the cylinder of radius xmaxStat+5w about the z-axis
+     */
+    Mdouble getCylinderExitDistance();
+
+    /*!
+     * \brief For cylindrical StatTypes, sets unset r- and theta-ranges of the grid to [0,rmax] and [-pi,pi], with rmax the largest radius in the domain
+     */
+    void setCylindricalStatDomain();
+
     void set_Polynomial(std::vector<Mdouble> new_coefficients, unsigned int new_dim)
     {
         CGPolynomial.set_polynomial(new_coefficients, new_dim);
@@ -862,6 +925,23 @@ public:
         return nTimeAverageReset;
     }
     
+    /*!
+     * \brief Sets the number of threads used to evaluate the time steps of a time-averaging window concurrently (default 1, i.e. sequential evaluation)
+     * \details Only used by StatisticsVector<T> itself; classes derived from it are always evaluated sequentially.
+     */
+    void setNumberOfThreads(unsigned int numberOfThreads)
+    {
+        numberOfThreads_ = std::max(numberOfThreads, 1u);
+    }
+    
+    /*!
+     * \brief Returns the number of threads used to evaluate time steps concurrently
+     */
+    unsigned int getNumberOfThreads() const
+    {
+        return numberOfThreads_;
+    }
+    
     /*!
      * \brief 
      */
@@ -1018,6 +1098,11 @@ protected:
      */
     int nTimeAverage;
 
+    /*!
+     * \brief True until the first time average has been written; each additional resolution keeps its own copy in CGResolution
+     */
+    bool isFirstTimeAverage_;
+
     //Coarse graining variables
     /*!
      * \brief coarse graining type (Gaussian, Heaviside, Polynomial)
@@ -1210,6 +1295,127 @@ protected:
     unsigned int stepSize_;///
 
     std::vector<Vec3D> positions_;
+
+    /*!
+     * \brief Stores the grid, width and accumulated fields of an additional coarse-graining resolution
+     * \details While a resolution is evaluated, its values are swapped with the corresponding member variables of the StatisticsVector, see #swapCGResolution
+     */
+    struct CGResolution
+    {
+        int nx, ny, nz;
+        int nxMirrored, nyMirrored, nzMirrored;
+        Mdouble w2, cutoff, cutoff2;
+        Mdouble tminStat;
+        std::vector<StatisticsPoint<T> > Points, dx, dy, dz;
+        std::vector<StatisticsPoint<T> > timeAverage, timeVariance, dxTimeAverage, dyTimeAverage, dzTimeAverage;
+        int nTimeAverage;
+        bool isFirstTimeAverage;
+        ///output stream of the resolution; only swapped in when writing
+        std::fstream statFile;
+    };
+
+    /*!
+     * \brief Additional coarse-graining resolutions evaluated in the same pass as the primary one
+     */
+    std::vector<CGResolution> resolutions_;
+
+    /*!
+     * \brief Exchanges the grid, width and fields of a resolution with the active ones (the output stream is not exchanged)
+     */
+    void swapCGResolution(CGResolution& r);
+
+    /*!
+     * \brief Writes and resets the time average if #nTimeAverageReset time steps have been averaged
+     */
+    void resetTimeAverageIfComplete();
+
+    /*!
+     * \brief Stores the arguments of one call to #gatherContactStatistics, such that the contact can be evaluated later by a worker
+     */
+    struct ContactRecord
+    {
+        unsigned int index1;
+        int index2;
+        Vec3D Contact;
+        Mdouble delta, ctheta, fdotn, fdott;
+        Vec3D normal, tangential;
+    };
+
+    /*!
+     * \brief True if the statistics are evaluated by worker threads (see #setNumberOfThreads)
+     * \details The workers are copies of StatisticsVector<T>, so they would not use the functions overridden by a
+     * derived class (e.g. its inclusion criteria); derived classes therefore fall back to sequential evaluation.
+     */
+    bool useParallelStatistics()
+    {
+        if (numberOfThreads_ > 1 && typeid(*this) != typeid(StatisticsVector<T>))
+        {
+            logger(WARN, "StatisticsVector: % threads were requested, but % is derived from StatisticsVector, "
+                   "so its statistics are evaluated sequentially", numberOfThreads_, typeid(*this).name());
+            numberOfThreads_ = 1;
+        }
+        return numberOfThreads_ > 1 && getDoTimeAverage();
+    }
+
+    /*!
+     * \brief Creates one worker StatisticsVector per thread, with the same grid and settings as this one
+     */
+    void createWorkers();
+
+    /*!
+     * \brief Copies the current time step (particles and recorded contacts) into the next free worker and evaluates it in a separate thread
+     */
+    void dispatchTimeStep(Mdouble particleTime);
+
+    /*!
+     * \brief Evaluates one time step on a worker: particle statistics at particleTime, then the recorded contacts at contactTime
+     */
+    void evaluateTimeStep(Mdouble particleTime, Mdouble contactTime);
+
+    /*!
+     * \brief Waits for all workers, adds their time-averaged sums to this StatisticsVector and writes completed averages
+     */
+    void reduceParallelStatistics();
+
+    /*!
+     * \brief Adds the time-averaged sums of another StatisticsVector to this one and zeroes them in the other
+     */
+    void addTimeAverage(StatisticsVector<T>& other);
+
+    /*!
+     * \brief Number of threads used to evaluate time steps concurrently; 1 means sequential evaluation
+     */
+    unsigned int numberOfThreads_;
+
+    /*!
+     * \brief If true, #gatherContactStatistics stores its arguments in #contactRecords_ instead of evaluating them
+     */
+    bool isRecordingContacts_;
+
+    /*!
+     * \brief Contacts of the current time step that still have to be evaluated
+     */
+    std::vector<ContactRecord> contactRecords_;
+
+    /*!
+     * \brief Worker StatisticsVectors; each evaluates one time step at a time and sums the results over the time-averaging window
+     */
+    std::vector<StatisticsVector<T>*> workers_;
+
+    /*!
+     * \brief The time step each worker is currently evaluating
+     */
+    std::vector<std::future<void> > pendingTimeSteps_;
+
+    /*!
+     * \brief Index of the worker that receives the next time step
+     */
+    unsigned int nextWorker_;
+
+    /*!
+     * \brief Number of time steps dispatched to the workers since the last reduction
+     */
+    int nDispatchedTimeSteps_;
 };
 
 #include "StatisticsPoint.hcc"
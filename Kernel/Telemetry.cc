@@ -0,0 +1,172 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Telemetry.h"
+#include "Logger.h"
+#include <algorithm>
+#include <iomanip>
+
+Telemetry::Telemetry()
+{
+    isEnabled_ = false;
+    interval_ = 10;
+    reset(0, 0);
+}
+
+Telemetry::Telemetry(const Telemetry& other)
+{
+    isEnabled_ = other.isEnabled_;
+    interval_ = other.interval_;
+    reset(0, 0);
+}
+
+void Telemetry::setEnabled(bool isEnabled)
+{
+    isEnabled_ = isEnabled;
+}
+
+bool Telemetry::isEnabled() const
+{
+    return isEnabled_;
+}
+
+/*!
+ * \param[in] interval The wall-clock time between two lines, in seconds; has to be positive.
+ */
+void Telemetry::setInterval(Mdouble interval)
+{
+    if (interval <= 0)
+    {
+        logger(ERROR, "Telemetry::setInterval: the interval has to be positive, but is %", interval);
+    }
+    interval_ = interval;
+}
+
+Mdouble Telemetry::getInterval() const
+{
+    return interval_;
+}
+
+/*!
+ * \param[in] time The simulated time at the start of the time loop.
+ * \param[in] numberOfTimeSteps The number of time steps at the start of the time loop.
+ */
+void Telemetry::reset(Mdouble time, unsigned int numberOfTimeSteps)
+{
+    start_ = std::chrono::steady_clock::now();
+    lastCheck_ = start_;
+    lastWrite_ = start_;
+    stepsSinceCheck_ = 0;
+    stepsPerCheck_ = 1;
+    secondsPerStep_ = 0;
+    lastWriteTime_ = time;
+    lastWriteTimeSteps_ = numberOfTimeSteps;
+    close();
+}
+
+/*!
+ * \details If the interval has not passed yet, the number of time steps until 
+ * the next check is set to half the number of time steps that fit in the 
+ * remainder of the interval, based on the time per step measured since the 
+ * last check (but at most twice the number of steps since the last check). Thus, the clock is read a few times per interval, and a line is 
+ * written at most a few time steps late.
+ */
+bool Telemetry::checkClock()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    Mdouble stepsSinceCheck = stepsSinceCheck_;
+    secondsPerStep_ = std::chrono::duration<Mdouble>(now - lastCheck_).count() / stepsSinceCheck;
+    lastCheck_ = now;
+    stepsSinceCheck_ = 0;
+    Mdouble remaining = interval_ - std::chrono::duration<Mdouble>(now - lastWrite_).count();
+    if (remaining <= 0)
+    {
+        stepsPerCheck_ = 1;
+        return true;
+    }
+    //the number of steps between checks at most doubles, as the first time steps can be unrepresentative
+    Mdouble steps = secondsPerStep_ > 0 ? 0.5 * remaining / secondsPerStep_ : 1;
+    stepsPerCheck_ = static_cast<unsigned int>(std::max(std::min(steps, 2 * stepsSinceCheck), 1.0));
+    return false;
+}
+
+/*!
+ * \details The rates and the eta are based on the interval since the previous
+ * line, such that they follow changes in the cost per time step. The eta is 
+ * the wall-clock time needed to reach timeMax at the current rate of simulated 
+ * time per wall-clock time.
+ * \param[in] name The name of the output file.
+ * \param[in] time The simulated time.
+ * \param[in] timeMax The final time of the simulation.
+ * \param[in] numberOfTimeSteps The number of time steps done so far.
+ * \param[in] numberOfParticles The number of real particles.
+ * \param[in] numberOfGhosts The number of periodic ghost particles.
+ * \param[in] numberOfContacts The number of interactions.
+ * \param[in] memoryBytes The memory used by the simulation, see MemoryUsage.
+ */
+void Telemetry::write(const std::string& name, Mdouble time, Mdouble timeMax, unsigned int numberOfTimeSteps,
+                      unsigned int numberOfParticles, unsigned int numberOfGhosts, unsigned int numberOfContacts,
+                      std::size_t memoryBytes)
+{
+    if (!file_.is_open())
+    {
+        file_.open(name.c_str(), std::ofstream::out);
+        if (!file_.is_open())
+        {
+            logger(WARN, "Telemetry::write: could not open %", name);
+            return;
+        }
+    }
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    Mdouble wallTime = std::chrono::duration<Mdouble>(now - start_).count();
+    Mdouble intervalTime = std::chrono::duration<Mdouble>(now - lastWrite_).count();
+    Mdouble stepsPerSecond = intervalTime > 0 ? (numberOfTimeSteps - lastWriteTimeSteps_) / intervalTime : 0;
+    Mdouble timePerSecond = intervalTime > 0 ? (time - lastWriteTime_) / intervalTime : 0;
+    Mdouble eta = timePerSecond > 0 ? std::max(timeMax - time, Mdouble(0)) / timePerSecond : 0;
+    file_ << std::setprecision(8)
+        << "{\"time\":" << time
+        << ",\"timeMax\":" << timeMax
+        << ",\"timeSteps\":" << numberOfTimeSteps
+        << ",\"wallTime\":" << wallTime
+        << ",\"stepsPerSecond\":" << stepsPerSecond
+        << ",\"particleStepsPerSecond\":" << stepsPerSecond * numberOfParticles
+        << ",\"particles\":" << numberOfParticles
+        << ",\"ghosts\":" << numberOfGhosts
+        << ",\"contacts\":" << numberOfContacts
+        << ",\"memoryBytes\":" << memoryBytes
+        << ",\"eta\":" << eta
+        << "}" << std::endl;
+    lastWrite_ = now;
+    lastWriteTime_ = time;
+    lastWriteTimeSteps_ = numberOfTimeSteps;
+    if (secondsPerStep_ > 0)
+        stepsPerCheck_ = static_cast<unsigned int>(std::max(std::min(0.5 * interval_ / secondsPerStep_, 1e6), 1.0));
+}
+
+void Telemetry::close()
+{
+    if (file_.is_open())
+        file_.close();
+}
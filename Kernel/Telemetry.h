@@ -0,0 +1,154 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <fstream>
+#include "GeneralDefine.h"
+
+/*!
+ * \brief Writes the progress of a simulation as one JSON object per line, at a fixed wall-clock interval.
+ * \details Each line of the file name.telemetry contains the simulated time, 
+ * the wall-clock time since the start of the time loop, the number of time 
+ * steps and particle updates per second during the last interval, the number 
+ * of particles, ghost particles and contacts, the memory usage and an estimate 
+ * of the remaining wall-clock time (eta), e.g.
+ * \code
+ * {"time":0.5,"timeMax":10,"timeSteps":1000,"wallTime":10.01,"stepsPerSecond":99.9,"particleStepsPerSecond":99900,"particles":1000,"ghosts":50,"contacts":2500,"memoryBytes":1200000,"eta":190.2}
+ * \endcode
+ * The file is meant to be read by batch schedulers and monitoring scripts.
+ * 
+ * The telemetry is disabled by default; it is enabled via setEnabled or the 
+ * command-line argument -telemetry interval. Since the output is triggered by
+ * the wall clock, the clock is not read every time step: isDue counts down a 
+ * number of time steps that is estimated from the measured time per step, 
+ * such that, between two lines, the overhead is a decrement and a comparison
+ * per time step.
+ */
+class Telemetry
+{
+public:
+    /*!
+     * \brief Default constructor; the telemetry is disabled and the interval is 10 seconds.
+     */
+    Telemetry();
+
+    /*!
+     * \brief Copy constructor; copies the settings, but not the state of the output.
+     */
+    Telemetry(const Telemetry& other);
+
+    /*!
+     * \brief Enables or disables the telemetry.
+     */
+    void setEnabled(bool isEnabled);
+
+    /*!
+     * \brief Returns true if solve writes the telemetry file.
+     */
+    bool isEnabled() const;
+
+    /*!
+     * \brief Sets the wall-clock time (in seconds) between two lines of the telemetry file.
+     */
+    void setInterval(Mdouble interval);
+
+    /*!
+     * \brief Returns the wall-clock time (in seconds) between two lines of the telemetry file.
+     */
+    Mdouble getInterval() const;
+
+    /*!
+     * \brief Starts the wall clock and closes the output file; called at the start of the time loop.
+     */
+    void reset(Mdouble time, unsigned int numberOfTimeSteps);
+
+    /*!
+     * \brief Returns true if the interval has passed since the last line was written; called once per time step.
+     */
+    bool isDue()
+    {
+        if (!isEnabled_ || ++stepsSinceCheck_ < stepsPerCheck_)
+            return false;
+        return checkClock();
+    }
+
+    /*!
+     * \brief Writes one line to the file name (which is opened at the first call).
+     */
+    void write(const std::string& name, Mdouble time, Mdouble timeMax, unsigned int numberOfTimeSteps,
+               unsigned int numberOfParticles, unsigned int numberOfGhosts, unsigned int numberOfContacts,
+               std::size_t memoryBytes);
+
+    /*!
+     * \brief Closes the output file; called at the end of the time loop.
+     */
+    void close();
+
+private:
+    /*!
+     * \brief Reads the clock, returns true if the interval has passed and otherwise estimates when to check again.
+     */
+    bool checkClock();
+
+    ///If false, isDue always returns false
+    bool isEnabled_;
+
+    ///Wall-clock time between two lines
+    Mdouble interval_;
+
+    ///Wall-clock time at the start of the time loop
+    std::chrono::steady_clock::time_point start_;
+
+    ///Wall-clock time at which the clock was last read by checkClock
+    std::chrono::steady_clock::time_point lastCheck_;
+
+    ///Wall-clock time at which the last line was written (or the time loop started)
+    std::chrono::steady_clock::time_point lastWrite_;
+
+    ///Number of time steps since the clock was last read
+    unsigned int stepsSinceCheck_;
+
+    ///Number of time steps after which the clock is read again
+    unsigned int stepsPerCheck_;
+
+    ///Measured wall-clock time per time step
+    Mdouble secondsPerStep_;
+
+    ///Simulated time at the last line
+    Mdouble lastWriteTime_;
+
+    ///Number of time steps at the last line
+    unsigned int lastWriteTimeSteps_;
+
+    ///The output file, opened at the first call to write
+    std::ofstream file_;
+};
+
+#endif
@@ -0,0 +1,306 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "WallBoundingVolumeHierarchy.h"
+#include "Walls/BaseWall.h"
+#include <algorithm>
+#include <limits>
+
+///The value of leaves_ for unbounded walls
+static const unsigned int unboundedLeaf = std::numeric_limits<unsigned int>::max();
+
+///Returns whether two vectors are exactly equal, i.e. whether a wall has not moved
+static bool isSame(const Vec3D& a, const Vec3D& b)
+{
+    return a.X == b.X && a.Y == b.Y && a.Z == b.Z;
+}
+
+WallBoundingVolumeHierarchy::WallBoundingVolumeHierarchy()
+{
+    isEnabled_ = true;
+    isOutdated_ = true;
+    wallInteractionRadius_ = 0.0;
+}
+
+/*!
+ * \param[in] other The WallBoundingVolumeHierarchy whose settings are copied.
+ */
+WallBoundingVolumeHierarchy::WallBoundingVolumeHierarchy(const WallBoundingVolumeHierarchy& other)
+{
+    isEnabled_ = other.isEnabled_;
+    isOutdated_ = true;
+    wallInteractionRadius_ = 0.0;
+}
+
+/*!
+ * \param[in] isEnabled Whether the hierarchy is used to find the walls near a particle.
+ */
+void WallBoundingVolumeHierarchy::setEnabled(bool isEnabled)
+{
+    isEnabled_ = isEnabled;
+    isOutdated_ = true;
+}
+
+/*!
+ * \return Whether the hierarchy is used to find the walls near a particle.
+ */
+bool WallBoundingVolumeHierarchy::isEnabled() const
+{
+    return isEnabled_;
+}
+
+/*!
+ * \details Has to be called if the shape of a wall in the WallHandler changes 
+ * other than by moving it, e.g. by IntersectionOfWalls::addObject.
+ */
+void WallBoundingVolumeHierarchy::setOutdated()
+{
+    isOutdated_ = true;
+}
+
+/*!
+ * \param[in] walls The walls of the WallHandler.
+ * \details Rebuilds the hierarchy if it is outdated or if walls were added or 
+ * removed. Otherwise, the positions and orientations of the bounded walls are 
+ * compared to those at which their boxes were computed; for the walls that 
+ * moved, the boxes are recomputed and the tree is refitted. This is cheap 
+ * compared to testing the particles against the walls, so update is called 
+ * before every force computation.
+ */
+void WallBoundingVolumeHierarchy::update(const std::vector<BaseWall*>& walls)
+{
+    if (!isEnabled_)
+        return;
+    if (isOutdated_ || walls != walls_)
+    {
+        build(walls);
+        return;
+    }
+    for (unsigned int i = 0; i < walls.size(); i++)
+    {
+        if (leaves_[i] == unboundedLeaf)
+            continue;
+        const BaseWall* wall = walls[i];
+        if (isSame(wall->getPosition(), positions_[i]) && isSame(wall->getOrientation(), orientations_[i]))
+            continue;
+        positions_[i] = wall->getPosition();
+        orientations_[i] = wall->getOrientation();
+        if (!wall->getBoundingBox(wallInteractionRadius_, minima_[i], maxima_[i]))
+        {
+            //the wall became unbounded, which changes the structure of the tree
+            build(walls);
+            return;
+        }
+        Node& leaf = nodes_[leaves_[i]];
+        leaf.min = minima_[i];
+        leaf.max = maxima_[i];
+        refitAncestors(leaves_[i]);
+    }
+}
+
+/*!
+ * \param[in] walls The walls of the WallHandler.
+ * \param[in] position The position of the particle.
+ * \param[in] wallInteractionRadius The wall interaction radius of the particle.
+ * \return The walls whose boxes contain the position and all unbounded walls, 
+ * in the order in which they are stored in the WallHandler, such that forces 
+ * are added in the same order as without the hierarchy. If the hierarchy is 
+ * disabled or there are no bounded walls, this is walls itself.
+ * \details If the wall interaction radius is larger than the one for which the
+ * boxes were computed, the hierarchy is rebuilt for the larger radius first.
+ */
+const std::vector<BaseWall*>& WallBoundingVolumeHierarchy::getCandidateWalls(const std::vector<BaseWall*>& walls, const Vec3D& position, Mdouble wallInteractionRadius)
+{
+    if (!isEnabled_)
+        return walls;
+    if (isOutdated_ || walls != walls_ || wallInteractionRadius > wallInteractionRadius_)
+    {
+        wallInteractionRadius_ = std::max(wallInteractionRadius_, wallInteractionRadius);
+        build(walls);
+    }
+    if (nodes_.empty())
+        return walls;
+
+    candidateIndices_.clear();
+    stack_.clear();
+    stack_.push_back(0);
+    while (!stack_.empty())
+    {
+        const Node& node = nodes_[stack_.back()];
+        stack_.pop_back();
+        if (position.X < node.min.X || position.X > node.max.X || position.Y < node.min.Y || position.Y > node.max.Y
+            || position.Z < node.min.Z || position.Z > node.max.Z)
+            continue;
+        if (node.right == 0)
+        {
+            candidateIndices_.push_back(node.left);
+        }
+        else
+        {
+            stack_.push_back(node.right);
+            stack_.push_back(node.left);
+        }
+    }
+    candidateIndices_.insert(candidateIndices_.end(), unboundedWalls_.begin(), unboundedWalls_.end());
+    std::sort(candidateIndices_.begin(), candidateIndices_.end());
+
+    candidates_.clear();
+    for (unsigned int i : candidateIndices_)
+        candidates_.push_back(walls[i]);
+    return candidates_;
+}
+
+/*!
+ * \param[in] walls The walls of the WallHandler.
+ */
+void WallBoundingVolumeHierarchy::build(const std::vector<BaseWall*>& walls)
+{
+    walls_ = walls;
+    positions_.resize(walls.size());
+    orientations_.resize(walls.size());
+    minima_.resize(walls.size());
+    maxima_.resize(walls.size());
+    leaves_.assign(walls.size(), unboundedLeaf);
+    unboundedWalls_.clear();
+    nodes_.clear();
+    isOutdated_ = false;
+
+    std::vector<unsigned int> boundedWalls;
+    for (unsigned int i = 0; i < walls.size(); i++)
+    {
+        positions_[i] = walls[i]->getPosition();
+        orientations_[i] = walls[i]->getOrientation();
+        if (walls[i]->getBoundingBox(wallInteractionRadius_, minima_[i], maxima_[i]))
+            boundedWalls.push_back(i);
+        else
+            unboundedWalls_.push_back(i);
+    }
+    if (!boundedWalls.empty())
+    {
+        nodes_.reserve(2 * boundedWalls.size() - 1);
+        buildNode(boundedWalls.begin(), boundedWalls.end(), 0);
+    }
+}
+
+/*!
+ * \param[in] begin The first of the indices of the bounded walls in this subtree.
+ * \param[in] end The end of the indices of the bounded walls in this subtree.
+ * \param[in] parent The index of the parent node.
+ * \return The index of the new node.
+ * \details The walls are split at the median of the centres of their boxes, in
+ * the direction in which the centres are spread most.
+ */
+unsigned int WallBoundingVolumeHierarchy::buildNode(std::vector<unsigned int>::iterator begin, std::vector<unsigned int>::iterator end, unsigned int parent)
+{
+    unsigned int index = nodes_.size();
+    nodes_.push_back(Node());
+    nodes_[index].parent = parent;
+    if (end - begin == 1)
+    {
+        nodes_[index].min = minima_[*begin];
+        nodes_[index].max = maxima_[*begin];
+        nodes_[index].left = *begin;
+        nodes_[index].right = 0;
+        leaves_[*begin] = index;
+        return index;
+    }
+
+    Vec3D centreMin = minima_[*begin] + maxima_[*begin];
+    Vec3D centreMax = centreMin;
+    for (std::vector<unsigned int>::iterator it = begin; it != end; ++it)
+    {
+        Vec3D centre = minima_[*it] + maxima_[*it];
+        centreMin = Vec3D(std::min(centreMin.X, centre.X), std::min(centreMin.Y, centre.Y), std::min(centreMin.Z, centre.Z));
+        centreMax = Vec3D(std::max(centreMax.X, centre.X), std::max(centreMax.Y, centre.Y), std::max(centreMax.Z, centre.Z));
+    }
+    Vec3D spread = centreMax - centreMin;
+    unsigned int direction = (spread.X >= spread.Y && spread.X >= spread.Z) ? 0 : (spread.Y >= spread.Z ? 1 : 2);
+    std::vector<unsigned int>::iterator middle = begin + (end - begin) / 2;
+    std::nth_element(begin, middle, end, [this, direction](unsigned int a, unsigned int b)
+    {
+        return (minima_[a] + maxima_[a]).getComponent(direction) < (minima_[b] + maxima_[b]).getComponent(direction);
+    });
+
+    unsigned int left = buildNode(begin, middle, index);
+    unsigned int right = buildNode(middle, end, index);
+    nodes_[index].left = left;
+    nodes_[index].right = right;
+    const Node& l = nodes_[left];
+    const Node& r = nodes_[right];
+    nodes_[index].min = Vec3D(std::min(l.min.X, r.min.X), std::min(l.min.Y, r.min.Y), std::min(l.min.Z, r.min.Z));
+    nodes_[index].max = Vec3D(std::max(l.max.X, r.max.X), std::max(l.max.Y, r.max.Y), std::max(l.max.Z, r.max.Z));
+    return index;
+}
+
+/*!
+ * \param[in] node The index of the node whose box changed.
+ */
+void WallBoundingVolumeHierarchy::refitAncestors(unsigned int node)
+{
+    while (node != 0)
+    {
+        node = nodes_[node].parent;
+        const Node& l = nodes_[nodes_[node].left];
+        const Node& r = nodes_[nodes_[node].right];
+        nodes_[node].min = Vec3D(std::min(l.min.X, r.min.X), std::min(l.min.Y, r.min.Y), std::min(l.min.Z, r.min.Z));
+        nodes_[node].max = Vec3D(std::max(l.max.X, r.max.X), std::max(l.max.Y, r.max.Y), std::max(l.max.Z, r.max.Z));
+    }
+}
+
+/*!
+ * \return The number of walls that are stored in the tree.
+ */
+unsigned int WallBoundingVolumeHierarchy::getNumberOfBoundedWalls() const
+{
+    return walls_.size() - unboundedWalls_.size();
+}
+
+/*!
+ * \return The number of nodes of the tree.
+ */
+unsigned int WallBoundingVolumeHierarchy::getNumberOfNodes() const
+{
+    return nodes_.size();
+}
+
+/*!
+ * \return The largest wall interaction radius seen so far, for which the boxes are computed.
+ */
+Mdouble WallBoundingVolumeHierarchy::getWallInteractionRadius() const
+{
+    return wallInteractionRadius_;
+}
+
+/*!
+ * \return The number of bytes used by the vectors of the hierarchy.
+ */
+std::size_t WallBoundingVolumeHierarchy::getMemoryUsage() const
+{
+    return sizeof(WallBoundingVolumeHierarchy)
+           + (walls_.capacity() + candidates_.capacity()) * sizeof(BaseWall*)
+           + (positions_.capacity() + orientations_.capacity() + minima_.capacity() + maxima_.capacity()) * sizeof(Vec3D)
+           + (leaves_.capacity() + unboundedWalls_.capacity() + candidateIndices_.capacity() + stack_.capacity()) * sizeof(unsigned int)
+           + nodes_.capacity() * sizeof(Node);
+}
@@ -0,0 +1,173 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef WALLBOUNDINGVOLUMEHIERARCHY_H
+#define WALLBOUNDINGVOLUMEHIERARCHY_H
+
+#include <vector>
+#include "Math/Vector.h"
+
+class BaseWall;
+
+/*!
+ * \brief A bounding volume hierarchy of the bounded walls, used to find the walls near a particle.
+ * \details Each wall that returns a box from BaseWall::getBoundingBox is stored
+ * in a leaf of a binary tree of axis-aligned boxes; unbounded walls, like 
+ * InfiniteWall, are tested against every particle. The boxes are computed for 
+ * the largest wall interaction radius seen so far, so a particle can only 
+ * interact with a bounded wall if its position is inside the wall's box.
+ * 
+ * The hierarchy is kept up to date by update(): it is rebuilt if walls were 
+ * added or removed, if the shape of a wall changed (see setOutdated) or if a 
+ * particle with a larger wall interaction radius is found; if walls only moved,
+ * the boxes of the moved walls are recomputed and their ancestors refitted.
+ */
+class WallBoundingVolumeHierarchy
+{
+public:
+    /*!
+     * \brief Default constructor; creates an empty, enabled hierarchy.
+     */
+    WallBoundingVolumeHierarchy();
+
+    /*!
+     * \brief Copy constructor; copies only the settings, the hierarchy is rebuilt when it is used.
+     */
+    WallBoundingVolumeHierarchy(const WallBoundingVolumeHierarchy& other);
+
+    /*!
+     * \brief Enables or disables the hierarchy; if disabled, every particle is tested against every wall.
+     */
+    void setEnabled(bool isEnabled);
+
+    /*!
+     * \brief Returns whether the hierarchy is enabled.
+     */
+    bool isEnabled() const;
+
+    /*!
+     * \brief Marks the hierarchy as outdated, such that it is rebuilt by the next call to update.
+     */
+    void setOutdated();
+
+    /*!
+     * \brief Rebuilds the hierarchy if the walls changed, or refits the boxes of the walls that moved.
+     */
+    void update(const std::vector<BaseWall*>& walls);
+
+    /*!
+     * \brief Returns the walls a particle at the given position can interact with, in the order of the WallHandler.
+     */
+    const std::vector<BaseWall*>& getCandidateWalls(const std::vector<BaseWall*>& walls, const Vec3D& position, Mdouble wallInteractionRadius);
+
+    /*!
+     * \brief Returns the number of walls stored in the hierarchy, i.e. the number of bounded walls.
+     */
+    unsigned int getNumberOfBoundedWalls() const;
+
+    /*!
+     * \brief Returns the number of nodes of the hierarchy.
+     */
+    unsigned int getNumberOfNodes() const;
+
+    /*!
+     * \brief Returns the wall interaction radius for which the boxes are computed.
+     */
+    Mdouble getWallInteractionRadius() const;
+
+    /*!
+     * \brief Returns the number of bytes used by the hierarchy.
+     */
+    std::size_t getMemoryUsage() const;
+
+private:
+    /*!
+     * \brief A node of the hierarchy; a leaf stores one wall, other nodes have two children.
+     */
+    struct Node
+    {
+        ///The lower corner of the box containing the boxes of all walls below this node
+        Vec3D min;
+        ///The upper corner of the box containing the boxes of all walls below this node
+        Vec3D max;
+        ///The index of the parent node; the root is its own parent
+        unsigned int parent;
+        ///The indices of the children, or, for a leaf, the index of the wall in the WallHandler (left) and right==0
+        unsigned int left, right;
+    };
+
+    /*!
+     * \brief Recomputes the boxes of all walls for the current wall interaction radius and rebuilds the tree.
+     */
+    void build(const std::vector<BaseWall*>& walls);
+
+    /*!
+     * \brief Builds the subtree of the bounded walls in [begin,end) and returns the index of its root.
+     */
+    unsigned int buildNode(std::vector<unsigned int>::iterator begin, std::vector<unsigned int>::iterator end, unsigned int parent);
+
+    /*!
+     * \brief Recomputes the boxes of the ancestors of a node.
+     */
+    void refitAncestors(unsigned int node);
+
+    ///Whether the hierarchy is used
+    bool isEnabled_;
+
+    ///Whether the hierarchy has to be rebuilt by the next call to update
+    bool isOutdated_;
+
+    ///The wall interaction radius for which the boxes are computed
+    Mdouble wallInteractionRadius_;
+
+    ///The walls for which the hierarchy was built, to detect walls that are added or removed
+    std::vector<BaseWall*> walls_;
+
+    ///The position and orientation of each wall when its box was computed, to detect walls that moved
+    std::vector<Vec3D> positions_, orientations_;
+
+    ///The boxes of the walls; only those of bounded walls are meaningful
+    std::vector<Vec3D> minima_, maxima_;
+
+    ///For each wall, the index of its leaf, or the largest unsigned int if it is unbounded
+    std::vector<unsigned int> leaves_;
+
+    ///The indices of the unbounded walls in the WallHandler, in increasing order
+    std::vector<unsigned int> unboundedWalls_;
+
+    ///The nodes of the tree; the root is nodes_[0]
+    std::vector<Node> nodes_;
+
+    ///The result of getCandidateWalls, kept to avoid allocations
+    std::vector<BaseWall*> candidates_;
+
+    ///The indices of the walls found by getCandidateWalls, kept to avoid allocations
+    std::vector<unsigned int> candidateIndices_;
+
+    ///The stack used to traverse the tree, kept to avoid allocations
+    std::vector<unsigned int> stack_;
+};
+
+#endif
@@ -34,6 +34,8 @@
 #include "Walls/InfiniteWallWithHole.h"
 #include "Walls/Screw.h"
 #include "Walls/Coil.h"
+#include "Walls/TriangulatedWall.h"
+#include "Particles/BaseParticle.h"
 
 /*!
  * Constructor of the WallHandler class. It creates and empty WallHandler.
@@ -51,6 +53,7 @@ WallHandler::WallHandler()
  *          to 0 or nullptr.
  */
 WallHandler::WallHandler(const WallHandler &WH)
+    : BaseHandler<BaseWall>(), boundingVolumes_(WH.boundingVolumes_)
 {
     clear();
     setDPMBase(WH.getDPMBase());
@@ -71,6 +74,7 @@ WallHandler WallHandler::operator =(const WallHandler& rhs)
         clear();
         setDPMBase(rhs.getDPMBase());
         copyContentsFromOtherHandler(rhs);
+        boundingVolumes_.setEnabled(rhs.boundingVolumes_.isEnabled());
     }
 #ifdef DEBUG_CONSTRUCTOR
     logger(DEBUG, "WallHandler::operator = (const WallHandler& rhs) finished");
@@ -102,6 +106,8 @@ void WallHandler::addObject(BaseWall* W)
     BaseHandler<BaseWall>::addObject(W);
     //set the particleHandler pointer
     W->setHandler(this);
+    //a new wall may reuse the address of a removed one, so the hierarchy is rebuilt
+    boundingVolumes_.setOutdated();
 }
 
 /*!
@@ -153,6 +159,12 @@ void WallHandler::readObject(std::istream& is)
         is >> coil;
         copyAndAddObject(coil);
     }
+    else if (type == "TriangulatedWall")
+    {
+        TriangulatedWall triangulatedWall;
+        is >> triangulatedWall;
+        copyAndAddObject(triangulatedWall);
+    }
     //for backward compatibility (before svnversion ~2360)
     else if (type == "numFiniteWalls")
     {
@@ -210,3 +222,51 @@ std::string WallHandler::getName() const
 {
     return "WallHandler";
 }
+
+/*!
+ * \param[in] p The BaseParticle for which the walls are needed.
+ * \return The walls p can interact with, in the order in which they are stored in this handler.
+ * \details Only the walls returned by this function have to be tested for an 
+ * interaction with p; see WallBoundingVolumeHierarchy::getCandidateWalls.
+ */
+const std::vector<BaseWall*>& WallHandler::getCandidateWalls(const BaseParticle& p)
+{
+    return boundingVolumes_.getCandidateWalls(objects_, p.getPosition(), p.getWallInteractionRadius());
+}
+
+/*!
+ * \details Called before the wall interactions are computed, such that the 
+ * boxes of walls that moved, e.g. in BaseInteractable::integrateBeforeForceComputation
+ * or DPMBase::actionsBeforeTimeStep, are updated.
+ */
+void WallHandler::updateBoundingVolumes()
+{
+    boundingVolumes_.update(objects_);
+}
+
+void WallHandler::setBoundingVolumesOutdated()
+{
+    boundingVolumes_.setOutdated();
+}
+
+/*!
+ * \return A reference to the bounding volume hierarchy of the walls.
+ */
+WallBoundingVolumeHierarchy& WallHandler::getBoundingVolumeHierarchy()
+{
+    return boundingVolumes_;
+}
+
+/*!
+ * \return The memory used by the walls (see BaseHandler::getMemoryUsage) plus 
+ *         the memory used by the bounding volume hierarchy.
+ */
+std::size_t WallHandler::getMemoryUsage() const
+{
+    std::size_t memoryUsage = objects_.capacity() * sizeof(BaseWall*) + boundingVolumes_.getMemoryUsage();
+    for (const BaseWall* wall : objects_)
+    {
+        memoryUsage += wall->getMemoryUsage();
+    }
+    return recordMemoryUsage(memoryUsage);
+}
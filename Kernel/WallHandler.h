@@ -29,6 +29,7 @@
 
 #include "BaseHandler.h"
 #include "Walls/BaseWall.h"
+#include "WallBoundingVolumeHierarchy.h"
 
 class BaseWall;
 
@@ -37,7 +38,9 @@ class BaseWall;
  * \brief Container to store all BaseWall
  * 
  * \details The WallHandler is a container to store all BaseWall. 
- * It is implemented by a vector of pointers to BaseWall.
+ * It is implemented by a vector of pointers to BaseWall. To find the walls 
+ * near a particle, the bounded walls are also stored in a 
+ * WallBoundingVolumeHierarchy, see getCandidateWalls.
  */
 class WallHandler : public BaseHandler<BaseWall>
 {
@@ -82,6 +85,36 @@ public:
      */
     std::string getName() const;
 
+    /*!
+     * \brief Returns the walls a BaseParticle can interact with, i.e. all unbounded walls and the bounded walls near it.
+     */
+    const std::vector<BaseWall*>& getCandidateWalls(const BaseParticle& p);
+
+    /*!
+     * \brief Updates the bounding volume hierarchy for walls that moved, were added or removed.
+     */
+    void updateBoundingVolumes();
+
+    /*!
+     * \brief Forces the bounding volume hierarchy to be rebuilt; to be called if the shape of a wall changes.
+     */
+    void setBoundingVolumesOutdated();
+
+    /*!
+     * \brief Returns the bounding volume hierarchy of the walls, e.g. to disable it.
+     */
+    WallBoundingVolumeHierarchy& getBoundingVolumeHierarchy();
+
+    /*!
+     * \brief Returns the number of bytes used by the walls and the bounding volume hierarchy.
+     */
+    std::size_t getMemoryUsage() const override;
+
+private:
+    /*!
+     * \brief The bounding volume hierarchy of the bounded walls.
+     */
+    WallBoundingVolumeHierarchy boundingVolumes_;
 };
 
 #endif
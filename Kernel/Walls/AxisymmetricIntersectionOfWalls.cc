@@ -74,6 +74,8 @@ AxisymmetricIntersectionOfWalls* AxisymmetricIntersectionOfWalls::copy() const
  * and tangential direction is interpreted as the x and z coordinate. With the 
  * particle shifted into the XZ plane, the distance and normal is computed, as 
  * if the AxisymmetricIntersectionOfWalls would be a simple IntersectionOfWalls.
+ * This evaluates the packed walls in the (r,z) frame, and rejects positions 
+ * outside the interaction box in that frame, e.g. in the hole of a ring.
  * Finally, the object and the normal is rotated back to the original position.
  * 
  * See also AxisymmetricIntersectionOfWalls for details.
@@ -108,6 +110,51 @@ bool AxisymmetricIntersectionOfWalls::getDistanceAndNormal(const BaseParticle& p
     }
 }
 
+/*!
+ * \param[in] wallInteractionRadius The largest wall interaction radius of the particles.
+ * \param[out] min The lower corner of the box.
+ * \param[out] max The upper corner of the box.
+ * \return False if the region in which particles interact with this wall is unbounded.
+ * \details The interaction region is first bounded in axisymmetric coordinates,
+ * i.e. in the XZ plane with non-negative X (the distance r to the axis). The 
+ * region in real coordinates is contained in the union of the circles of 
+ * radius rMax around the axis positions between zMin and zMax, whose extent in
+ * direction k is rMax*sqrt(1-orientation_k^2).
+ */
+bool AxisymmetricIntersectionOfWalls::getBoundingBox(Mdouble wallInteractionRadius, Vec3D& min, Vec3D& max) const
+{
+    //restrict the region to the half plane y=0, x>=0
+    std::vector<Vec3D> normals;
+    std::vector<Mdouble> offsets;
+    getPositionConstraints(normals, offsets);
+    Vec3D transformedMin, transformedMax;
+    if (!getBoundingBoxOfInteractionRegion(wallInteractionRadius, normals, offsets, transformedMin, transformedMax))
+        return false;
+    const Vec3D& axis = getOrientation();
+    const Mdouble rMax = std::max(transformedMax.X, 0.0);
+    const Vec3D radialExtent = rMax * Vec3D(std::sqrt(std::max(1.0 - axis.X * axis.X, 0.0)),
+                                            std::sqrt(std::max(1.0 - axis.Y * axis.Y, 0.0)),
+                                            std::sqrt(std::max(1.0 - axis.Z * axis.Z, 0.0)));
+    const Vec3D a = getPosition() + transformedMin.Z * axis;
+    const Vec3D b = getPosition() + transformedMax.Z * axis;
+    min = Vec3D(std::min(a.X, b.X), std::min(a.Y, b.Y), std::min(a.Z, b.Z)) - radialExtent;
+    max = Vec3D(std::max(a.X, b.X), std::max(a.Y, b.Y), std::max(a.Z, b.Z)) + radialExtent;
+    return true;
+}
+
+/*!
+ * \param[out] normals The normals of the constraints normal*x>=offset.
+ * \param[out] offsets The offsets of the constraints.
+ * \details The axisymmetric coordinates (r,0,z) of a position lie in the half 
+ * plane y=0, x>=0, in which the interaction region of a ring or a closed 
+ * container is bounded, although it is unbounded in y as an IntersectionOfWalls.
+ */
+void AxisymmetricIntersectionOfWalls::getPositionConstraints(std::vector<Vec3D>& normals, std::vector<Mdouble>& offsets) const
+{
+    normals.insert(normals.end(), {Vec3D(0.0, 1.0, 0.0), Vec3D(0.0, -1.0, 0.0), Vec3D(1.0, 0.0, 0.0)});
+    offsets.insert(offsets.end(), {0.0, 0.0, 0.0});
+}
+
 /*!
  * \param[in] is The input stream from which the AxisymmetricIntersectionOfWalls
  * is read, usually a restart file.
@@ -134,6 +181,14 @@ std::string AxisymmetricIntersectionOfWalls::getName() const
     return "AxisymmetricIntersectionOfWalls";
 }
 
+/*!
+ * \return The size of this AxisymmetricIntersectionOfWalls plus the memory used by its walls and its list of interactions.
+ */
+std::size_t AxisymmetricIntersectionOfWalls::getMemoryUsage() const
+{
+    return IntersectionOfWalls::getMemoryUsage() - sizeof(IntersectionOfWalls) + sizeof(AxisymmetricIntersectionOfWalls);
+}
+
 
 /*!
  * \param[in] p Pointer to the BaseParticle which we want to check the interaction for.
@@ -74,6 +74,11 @@ public:
      */
     bool getDistanceAndNormal(const BaseParticle& P, Mdouble& distance, Vec3D& normal_return) const final;
 
+    /*!
+     * \brief Computes a box that contains all positions at which a particle can interact with this wall, if it is bounded.
+     */
+    bool getBoundingBox(Mdouble wallInteractionRadius, Vec3D& min, Vec3D& max) const final;
+
     /*!
      * \brief reads wall
      */
@@ -89,11 +94,22 @@ public:
      */
     std::string getName() const final;
 
+    /*!
+     * \brief Returns the number of bytes used by this AxisymmetricIntersectionOfWalls, including its walls.
+     */
+    std::size_t getMemoryUsage() const override;
+
     /*!
      * \brief Get the interaction between this AxisymmetricIntersectionOfWalls
      * and a given BaseParticle at a given time.
      */
     BaseInteraction* getInteractionWith(BaseParticle* P, Mdouble timeStamp, InteractionHandler* interactionHandler) final;
+
+protected:
+    /*!
+     * \brief Restricts the positions in axisymmetric coordinates to the half plane y=0, x>=0.
+     */
+    void getPositionConstraints(std::vector<Vec3D>& normals, std::vector<Mdouble>& offsets) const final;
 };
 
 
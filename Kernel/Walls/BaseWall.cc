@@ -70,6 +70,15 @@ void BaseWall::write(std::ostream& os) const
     BaseInteractable::write(os);
 }
 
+/*!
+ * \details Walls are unbounded unless a derived class overrides this function.
+ * \return False, as the wall is unbounded.
+ */
+bool BaseWall::getBoundingBox(Mdouble wallInteractionRadius UNUSED, Vec3D& min UNUSED, Vec3D& max UNUSED) const
+{
+    return false;
+}
+
 /*!
  * \param[in] handler A pointer to the BaseHandler that handles this wall.
  */
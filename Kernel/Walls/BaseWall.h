@@ -87,6 +87,16 @@ public:
      */
     virtual bool getDistanceAndNormal(const BaseParticle& P, Mdouble& distance, Vec3D& normal_return) const = 0;
 
+    /*!
+     * \brief Computes a box that contains all positions at which a BaseParticle can interact with this wall.
+     * \details The WallHandler uses these boxes to test each particle only against the walls near it.
+     * \param[in] wallInteractionRadius The largest wall interaction radius of the particles.
+     * \param[out] min The lower corner of the box.
+     * \param[out] max The upper corner of the box.
+     * \return False if the wall is unbounded; the default, as such walls have to be tested against every particle.
+     */
+    virtual bool getBoundingBox(Mdouble wallInteractionRadius, Vec3D& min, Vec3D& max) const;
+
     /*!
      * \brief A function which sets the WallHandler for this BaseWall.
      */
@@ -25,7 +25,16 @@
 
 #include "Coil.h"
 #include "InteractionHandler.h"
+#include "WallHandler.h"
 #include "Particles/BaseParticle.h"
+#include "HelixParameterTable.h"
+#include <limits>
+
+/*!
+ * \details The Newton iteration normally converges in a handful of steps; the
+ * bound only guards against the rare cases in which it oscillates.
+ */
+static const unsigned int maximumNumberOfNewtonIterations = 50;
 
 /*!
  * \details Default constructor, make a Coil which is centered in the origin, has
@@ -41,6 +50,8 @@ Coil::Coil()
     omega_ = 1.0;
     offset_ = 0.0;
     thickness_ = 0.0;
+    useTabulatedInitialGuess_ = false;
+    numberOfUnconvergedNewtonIterations_ = 0;
     logger(DEBUG, "Coil() constructor finished");              
 }
 
@@ -56,6 +67,8 @@ Coil::Coil(const Coil& other) : BaseWall(other)
     omega_ = other.omega_;
     offset_ = other.offset_;
     thickness_ = other.thickness_;
+    useTabulatedInitialGuess_ = other.useTabulatedInitialGuess_;
+    numberOfUnconvergedNewtonIterations_ = 0;
     logger(DEBUG, "Coil(const Coil&) copy constructor finished");
 }
 
@@ -78,6 +91,8 @@ Coil::Coil(Vec3D start, Mdouble l, Mdouble r, Mdouble n, Mdouble omega, Mdouble
     omega_ = omega;
     thickness_ = thickness;
     offset_ = 0.0;
+    useTabulatedInitialGuess_ = false;
+    numberOfUnconvergedNewtonIterations_ = 0;
     logger(DEBUG, "Coil(params) constructor with parameters finished.");             
 }
 
@@ -107,6 +122,30 @@ void Coil::set(Vec3D start, Mdouble length, Mdouble radius, Mdouble numberOfReve
     omega_ = omega;
     thickness_ = thickness;
     offset_ = 0.0;
+    //the shape changed, so the bounding box of this wall has to be recomputed
+    if (getHandler() != nullptr)
+        getHandler()->setBoundingVolumesOutdated();
+}
+
+/*!
+ * \param[in] useTabulatedInitialGuess If true, the Newton iteration for a particle
+ * that was not in contact with this Coil at the last time step starts from the 
+ * guess interpolated from HelixParameterTable::getCoilTable(), instead of the 
+ * minimum of the periodic term.
+ * \details The iteration stops at the same tolerance, so only the number of
+ * iterations changes. This setting is not written to the restart file.
+ */
+void Coil::setUseTabulatedInitialGuess(bool useTabulatedInitialGuess)
+{
+    useTabulatedInitialGuess_ = useTabulatedInitialGuess;
+}
+
+/*!
+ * \return True if the Newton iteration starts from a tabulated guess.
+ */
+bool Coil::getUseTabulatedInitialGuess() const
+{
+    return useTabulatedInitialGuess_;
 }
 
 /*!
@@ -126,18 +165,34 @@ Coil* Coil::copy() const
  * a given BaseParticle and this Coil. If there is a collision, this
  * function also computes the distance between the BaseParticle and Coil
  * and the normal of the IntersectionOfWalls at the intersection point. 
- * \todo Make this function readable and explain the steps in the details.
+ * As no initial guess is given, the Newton iteration starts at the minimum of 
+ * the periodic term, or at the tabulated guess if that is switched on.
  */
 bool Coil::getDistanceAndNormal(const BaseParticle& p, Mdouble& distance, Vec3D& normal_return) const
 {
-    Mdouble Rsqr = pow(p.getPosition().X - start_.X, 2) + pow(p.getPosition().Y - start_.Y, 2);
-    if (Rsqr > pow(r_ + p.getWallInteractionRadius() + thickness_, 2) || Rsqr < pow(r_ - p.getWallInteractionRadius() - thickness_, 2) || p.getPosition().Z > l_ + start_.Z + p.getWallInteractionRadius() + thickness_ || p.getPosition().Z < start_.Z - p.getWallInteractionRadius() - thickness_)
+    if (!isInBoundingCylinder(p))
     {
-        //std::cout<<"Particle is out of first bound checking"<<std::endl;
-        //std::cout<<"Rule 1: "<<pow(r-P.getRadius()-thickness_,2)<<"<"<<Rsqr<<"<"<<pow(r+P.getRadius()+thickness_,2)<<std::endl;
-        //std::cout<<"Rule 2: "<<Start.Z-P.getRadius()-thickness_<<"<"<<P.getPosition().Z<<"<"<<L+Start.Z+P.getRadius()+thickness_<<std::endl;
         return false;
     }
+    Mdouble q = std::numeric_limits<Mdouble>::quiet_NaN();
+    return getDistanceNormalAndParameter(p, distance, normal_return, q);
+}
+
+/*!
+ * \param[in] p BaseParticle we want to calculate the distance and whether it collided of.
+ * \param[out] distance The distance of the BaseParticle to this Coil.
+ * \param[out] normal_return If there was a collision, the normal vector to this Coil will be placed here.
+ * \param[in,out] q On input, an initial guess for the helix parameter of the contact
+ * point, e.g. the one of the last time step, or NaN if there is none; on output, 
+ * the helix parameter found by Newton's method (before it is clamped to the ends 
+ * of the Coil), if the particle is close enough to the Coil to compute it.
+ * \return A boolean which says whether or not there was a collision.
+ * \pre isInBoundingCylinder(p) is true; the caller does this cheap test first.
+ * \todo Make this function readable and explain the steps in the details.
+ */
+bool Coil::getDistanceNormalAndParameter(const BaseParticle& p, Mdouble& distance, Vec3D& normal_return, Mdouble& q) const
+{
+    Mdouble Rsqr = pow(p.getPosition().X - start_.X, 2) + pow(p.getPosition().Y - start_.Y, 2);
     Mdouble R = sqrt(Rsqr);
     Mdouble alpha = atan2(p.getPosition().Y - start_.Y, p.getPosition().X - start_.X);
     Mdouble dz = p.getPosition().Z - start_.Z;
@@ -151,38 +206,60 @@ bool Coil::getDistanceAndNormal(const BaseParticle& p, Mdouble& distance, Vec3D&
     //Distance^2=R^2+r^2-2*R*r*cos(alpha-2*Pi*(offset+N*q))+(dz-q*L)^2
     //For this we use the Euler algoritm
     
-    Mdouble q; //Current guess
-    Mdouble dd; //Derivative at current guess
-    Mdouble ddd; //Second derivative at current guess
     Mdouble q0 = dz / l_; //Minimum of the parabolic part
             
-    //The initial guess will be in the maximum of the cos closest to the minimum of the parabolic part
+    //The default initial guess will be in the maximum of the cos closest to the minimum of the parabolic part
     //Minima of the cos are at
     //alpha-2*Pi*(offset+N*q)=2*k*Pi (k=integer)
     //q=alpha/(2*Pi*N)-k/N-offset/N (k=integer)
     
     Mdouble k = round(alpha / 2.0 / constants::pi - (offset_ + n_ * q0));
-    q = alpha / (2 * constants::pi * n_) - k / n_ - offset_ / n_;
+    Mdouble qValley = alpha / (2 * constants::pi * n_) - k / n_ - offset_ / n_;
     
-    //Now apply Newton's method
-    do
+    //The given initial guess is only used if it lies in the same valley of the cos (this also rejects NaN)
+    bool isDefaultGuess = !(fabs(q - qValley) < 0.5 / n_);
+    if (isDefaultGuess)
     {
-        dd = -4.0 * R * r_ * constants::pi * n_ * sin(alpha - 2.0 * constants::pi * (n_ * q + offset_)) - 2.0 * l_ * (dz - q * l_);
-        ddd = 8.0 * R * r_ * constants::sqr_pi * n_ * n_ * cos(alpha - 2.0 * constants::pi * (n_ * q + offset_)) + 2.0 * l_ * l_;
-        q -= dd / ddd;
-    } while (fabs(dd / ddd) > 1e-14);
+        q = qValley;
+        if (useTabulatedInitialGuess_)
+        {
+            //see HelixParameterTable for the scaling with the pitch s
+            const Mdouble s = l_ / (2.0 * constants::pi * n_);
+            const Mdouble phase = HelixParameterTable::getCoilTable().getPhase(2.0 * R * r_ / (s * s), (dz - qValley * l_) / s);
+            if (!std::isnan(phase))
+            {
+                q += phase / (2.0 * constants::pi * n_);
+                isDefaultGuess = false;
+            }
+        }
+    }
+    
+    //Now apply Newton's method; the result of the given guess is only accepted if it is a minimum in the same valley
+    //as the default guess, which contains only one minimum; otherwise, the iteration is restarted from the default guess
+    bool isConverged;
+    const bool isMinimum = applyNewtonMethod(q, R, alpha, dz, isConverged);
+    if (!isDefaultGuess && !(isMinimum && fabs(q - qValley) < 0.5 / n_))
+    {
+        q = qValley;
+        applyNewtonMethod(q, R, alpha, dz, isConverged);
+    }
+    if (!isConverged)
+    {
+        warnNewtonMethodNotConverged();
+    }
     
     //Check if the location is actually on the coil, otherwise a point collision with the end of the coil calculated
-    if (q < 0) //Left boundary of the coil
+    Mdouble qContact = q;
+    if (qContact < 0) //Left boundary of the coil
     {
-        q = 0;
+        qContact = 0;
     }
-    else if (q > 1) //right boundary of the coil
+    else if (qContact > 1) //right boundary of the coil
     {
-        q = 1;
+        qContact = 1;
     }
     
-    Mdouble distanceSquared = R * R + r_ * r_ - 2 * R * r_ * cos(alpha - 2 * constants::pi * (offset_ + n_ * q)) + pow(dz - q * l_, 2);
+    Mdouble distanceSquared = R * R + r_ * r_ - 2 * R * r_ * cos(alpha - 2 * constants::pi * (offset_ + n_ * qContact)) + pow(dz - qContact * l_, 2);
     //If distance is too large there is no contact
     if (distanceSquared >= (p.getWallInteractionRadius() + thickness_) * (p.getWallInteractionRadius() + thickness_))
     {
@@ -192,14 +269,70 @@ bool Coil::getDistanceAndNormal(const BaseParticle& p, Mdouble& distance, Vec3D&
     
     Vec3D ContactPoint;
     distance = sqrt(distanceSquared) - thickness_;
-    ContactPoint.X = start_.X + r_ * cos(2.0 * constants::pi * (offset_ + n_ * q));
-    ContactPoint.Y = start_.Y + r_ * sin(2.0 * constants::pi * (offset_ + n_ * q));
-    ContactPoint.Z = start_.Z + q * l_;
+    ContactPoint.X = start_.X + r_ * cos(2.0 * constants::pi * (offset_ + n_ * qContact));
+    ContactPoint.Y = start_.Y + r_ * sin(2.0 * constants::pi * (offset_ + n_ * qContact));
+    ContactPoint.Z = start_.Z + qContact * l_;
     normal_return = ContactPoint - p.getPosition();
     normal_return /= normal_return.getLength();
     return true;
 }
 
+/*!
+ * \param[in,out] q The initial guess of the helix parameter, which is replaced by the minimum found.
+ * \param[in] R The distance of the particle from the axis of the Coil.
+ * \param[in] alpha The polar angle of the particle around the axis of the Coil.
+ * \param[in] dz The height of the particle above the start of the Coil.
+ * \param[out] isConverged True if the last Newton step was smaller than 1e-14,
+ * false if the maximum number of iterations was reached first.
+ * \return True if the iteration converged and the second derivative is positive,
+ * i.e. a minimum was found; false if it ended in a maximum or did not converge.
+ */
+bool Coil::applyNewtonMethod(Mdouble& q, Mdouble R, Mdouble alpha, Mdouble dz, bool& isConverged) const
+{
+    Mdouble dd; //Derivative at current guess
+    Mdouble ddd; //Second derivative at current guess
+    unsigned int iteration = 0;
+    do
+    {
+        dd = -4.0 * R * r_ * constants::pi * n_ * sin(alpha - 2.0 * constants::pi * (n_ * q + offset_)) - 2.0 * l_ * (dz - q * l_);
+        ddd = 8.0 * R * r_ * constants::sqr_pi * n_ * n_ * cos(alpha - 2.0 * constants::pi * (n_ * q + offset_)) + 2.0 * l_ * l_;
+        q -= dd / ddd;
+    } while (fabs(dd / ddd) > 1e-14 && ++iteration < maximumNumberOfNewtonIterations);
+    isConverged = fabs(dd / ddd) <= 1e-14;
+    return isConverged && ddd > 0;
+}
+
+/*!
+ * \param[in] p The BaseParticle that is checked.
+ * \return True if the BaseParticle is within its wall interaction radius plus the
+ * thickness of the hollow cylinder around the axis of the Coil.
+ */
+bool Coil::isInBoundingCylinder(const BaseParticle& p) const
+{
+    const Mdouble Rsqr = pow(p.getPosition().X - start_.X, 2) + pow(p.getPosition().Y - start_.Y, 2);
+    return !(Rsqr > pow(r_ + p.getWallInteractionRadius() + thickness_, 2) || Rsqr < pow(r_ - p.getWallInteractionRadius() - thickness_, 2) || p.getPosition().Z > l_ + start_.Z + p.getWallInteractionRadius() + thickness_ || p.getPosition().Z < start_.Z - p.getWallInteractionRadius() - thickness_);
+}
+
+/*!
+ * \details The unconverged helix parameter is still used, as it is usually close
+ * to the contact point; to keep the output readable when this happens at every
+ * time step, only the 1st, 10th, 100th, ... occurrence for this Coil is reported.
+ */
+void Coil::warnNewtonMethodNotConverged() const
+{
+    ++numberOfUnconvergedNewtonIterations_;
+    unsigned int count = numberOfUnconvergedNewtonIterations_;
+    while (count % 10 == 0)
+    {
+        count /= 10;
+    }
+    if (count == 1)
+    {
+        logger(WARN, "Coil %: the Newton iteration for the contact point did not converge in % iterations (% times so far)",
+               getIndex(), maximumNumberOfNewtonIterations, numberOfUnconvergedNewtonIterations_);
+    }
+}
+
 /*!
  * \param[in] p Pointer to the BaseParticle which we want to check the interaction for.
  * \param[in] timeStamp The time at which we want to look at the interaction.
@@ -211,9 +344,18 @@ BaseInteraction* Coil::getInteractionWith(BaseParticle* p, Mdouble timeStamp, In
 {
     Mdouble distance;
     Vec3D normal;
-    if (getDistanceAndNormal(*p,distance,normal))
+    //the cheap bounding test comes first, so distant particles do not pay for the interaction lookup
+    if (!isInBoundingCylinder(*p))
     {
-        BaseInteraction* c = interactionHandler->getInteraction(p, this, timeStamp);
+        return nullptr;
+    }
+    //the helix parameter of the last time step is the initial guess of the Newton iteration
+    BaseInteraction* c = interactionHandler->getExistingInteraction(p, this);
+    Mdouble q = (c == nullptr) ? std::numeric_limits<Mdouble>::quiet_NaN() : c->getWallContactParameter();
+    if (getDistanceNormalAndParameter(*p, distance, normal, q))
+    {
+        c = interactionHandler->getInteraction(p, this, timeStamp);
+        c->setWallContactParameter(q);
         c->setNormal(-normal);
         c->setDistance(distance);
         c->setOverlap(p->getRadius() - distance);
@@ -227,6 +369,21 @@ BaseInteraction* Coil::getInteractionWith(BaseParticle* p, Mdouble timeStamp, In
     }
 }
 
+/*!
+ * \param[in] wallInteractionRadius The largest wall interaction radius of the particles.
+ * \param[out] min The lower corner of the box.
+ * \param[out] max The upper corner of the box.
+ * \return True, as a Coil is bounded by the cylinder of radius r_ and length l_ around its axis.
+ * \details The box does not depend on the rotation of the Coil, so it only changes with start_.
+ */
+bool Coil::getBoundingBox(Mdouble wallInteractionRadius, Vec3D& min, Vec3D& max) const
+{
+    const Mdouble margin = wallInteractionRadius + thickness_;
+    min = Vec3D(start_.X - r_ - margin, start_.Y - r_ - margin, start_.Z + std::min(l_, 0.0) - margin);
+    max = Vec3D(start_.X + r_ + margin, start_.Y + r_ + margin, start_.Z + std::max(l_, 0.0) + margin);
+    return true;
+}
+
 /*!
  * \param[in] dt The time for which the Screw has to be turned.
  */
@@ -286,3 +443,11 @@ std::string Coil::getName() const
 {
     return "Coil";
 }
+
+/*!
+ * \return The size of this Coil plus the memory used by its list of interactions.
+ */
+std::size_t Coil::getMemoryUsage() const
+{
+    return sizeof(Coil) + getInteractionListMemoryUsage();
+}
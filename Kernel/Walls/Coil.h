@@ -65,6 +65,16 @@ public:
      */
     void set(Vec3D Start, Mdouble length, Mdouble radius, Mdouble numberOfRevelations, Mdouble omega, Mdouble thickness);
 
+    /*!
+     * \brief Sets whether the Newton iteration for the contact point starts from a tabulated guess.
+     */
+    void setUseTabulatedInitialGuess(bool useTabulatedInitialGuess);
+
+    /*!
+     * \brief Returns whether the Newton iteration for the contact point starts from a tabulated guess.
+     */
+    bool getUseTabulatedInitialGuess() const;
+
     /*!
      * \brief Copy this Coil and return a pointer to the copy, useful for polymorphism.
      */    
@@ -75,6 +85,11 @@ public:
      */   
     bool getDistanceAndNormal(const BaseParticle& P, Mdouble& distance, Vec3D& normal_return) const override;
 
+    /*!
+     * \brief Computes a box that contains all positions at which a particle can interact with this Coil.
+     */
+    bool getBoundingBox(Mdouble wallInteractionRadius, Vec3D& min, Vec3D& max) const override;
+
     /*!
      * \brief Get the interaction between this Coil and given BaseParticle at a given time.
      */    
@@ -108,6 +123,32 @@ public:
     */
     std::string getName() const override;
 
+    /*!
+     * \brief Returns the number of bytes used by this Coil.
+     */
+    std::size_t getMemoryUsage() const override;
+
+private:
+    /*!
+     * \brief Computes the distance and normal like getDistanceAndNormal, starting the Newton iteration from the given helix parameter.
+     */
+    bool getDistanceNormalAndParameter(const BaseParticle& p, Mdouble& distance, Vec3D& normal_return, Mdouble& q) const;
+
+    /*!
+     * \brief Minimises the distance to the particle over the helix parameter q with a bounded number of Newton steps.
+     */
+    bool applyNewtonMethod(Mdouble& q, Mdouble R, Mdouble alpha, Mdouble dz, bool& isConverged) const;
+
+    /*!
+     * \brief Returns whether the particle lies in the hollow cylinder around the Coil, i.e. whether it can touch this Coil at all.
+     */
+    bool isInBoundingCylinder(const BaseParticle& p) const;
+
+    /*!
+     * \brief Counts a Newton iteration that did not converge, and warns at the 1st, 10th, 100th, ... occurrence.
+     */
+    void warnNewtonMethodNotConverged() const;
+
 private:
     /*!
      * \brief The centre of the lower end of the Coil.
@@ -143,6 +184,16 @@ private:
      * The thickness of the "spiral" of the Coil.
      */
     Mdouble thickness_;
+    
+    /*!
+     * If true, the Newton iteration starts from the guess of HelixParameterTable::getCoilTable() when there is no contact at the last time step.
+     */
+    bool useTabulatedInitialGuess_;
+
+    /*!
+     * \brief The number of contact computations in which the Newton iteration did not converge; only used to limit the number of warnings.
+     */
+    mutable unsigned int numberOfUnconvergedNewtonIterations_;
 };
 
 #endif
@@ -114,6 +114,14 @@ std::string CylindricalWall::getName() const
     return "CylindricalWall";
 }
 
+/*!
+ * \return The size of this CylindricalWall plus the memory used by its list of interactions.
+ */
+std::size_t CylindricalWall::getMemoryUsage() const
+{
+    return sizeof(CylindricalWall) + getInteractionListMemoryUsage();
+}
+
 ///access function for radius
 double CylindricalWall::getRadius() const
 {
@@ -90,6 +90,11 @@ public:
     * \brief Returns the name of the object
     */
     virtual std::string getName() const;
+
+    /*!
+     * \brief Returns the number of bytes used by this CylindricalWall.
+     */
+    std::size_t getMemoryUsage() const override;
     
    /*!
     * \brief access function for radius
@@ -0,0 +1,147 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "HelixParameterTable.h"
+#include "Math/ExtendedMath.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/*!
+ * \details Two neighbouring nodes whose phases differ by more than this value lie
+ * in different valleys of the periodic term, so interpolating between them would
+ * not give a useful guess.
+ */
+static const Mdouble maximumPhaseJumpInCell = 0.5;
+
+/*!
+ * \param[in] shape The function to tabulate, i.e. the one of a Screw or of a Coil.
+ * \param[in] numberOfBins The number of cells of the table in each direction.
+ * \details The phases at the nodes are computed with the same Newton iteration
+ * the walls use without a table, such that the table leads to the same minimum.
+ */
+HelixParameterTable::HelixParameterTable(Shape shape, unsigned int numberOfBins)
+{
+    shape_ = shape;
+    numberOfBins_ = std::max(numberOfBins, 1u);
+    maximumBeta_ = (shape_ == Shape::SCREW) ? 0.5 * constants::pi : constants::pi;
+    phases_.resize((numberOfBins_ + 1) * (numberOfBins_ + 1));
+    for (unsigned int i = 0; i <= numberOfBins_; i++)
+    {
+        //the last column represents kappa=infinity, where the periodic term pins the minimum to theta=0
+        const Mdouble x = static_cast<Mdouble>(i) / numberOfBins_;
+        for (unsigned int j = 0; j <= numberOfBins_; j++)
+        {
+            const Mdouble beta = maximumBeta_ * (2.0 * j / numberOfBins_ - 1.0);
+            phases_[i * (numberOfBins_ + 1) + j] = (i == numberOfBins_) ? 0.0 : computePhase(x / (1.0 - x), beta);
+        }
+    }
+}
+
+/*!
+ * \param[in] kappa The ratio of the periodic and the parabolic term, must be non-negative.
+ * \param[in] beta The position of the minimum of the parabolic term; it is clamped to the range of the table.
+ * \return The phase theta of the minimum, interpolated from the table, or NaN if
+ * the minimum jumps between two valleys inside the cell of the table.
+ */
+Mdouble HelixParameterTable::getPhase(Mdouble kappa, Mdouble beta) const
+{
+    const Mdouble x = kappa / (1.0 + kappa) * numberOfBins_;
+    const Mdouble b = (std::min(std::max(beta, -maximumBeta_), maximumBeta_) + maximumBeta_) / (2.0 * maximumBeta_) * numberOfBins_;
+    const unsigned int i = std::min(static_cast<unsigned int>(x), numberOfBins_ - 1);
+    const unsigned int j = std::min(static_cast<unsigned int>(b), numberOfBins_ - 1);
+    const Mdouble tx = x - i;
+    const Mdouble tb = b - j;
+    
+    const Mdouble p00 = phases_[i * (numberOfBins_ + 1) + j];
+    const Mdouble p01 = phases_[i * (numberOfBins_ + 1) + j + 1];
+    const Mdouble p10 = phases_[(i + 1) * (numberOfBins_ + 1) + j];
+    const Mdouble p11 = phases_[(i + 1) * (numberOfBins_ + 1) + j + 1];
+    const Mdouble minimum = std::min(std::min(p00, p01), std::min(p10, p11));
+    const Mdouble maximum = std::max(std::max(p00, p01), std::max(p10, p11));
+    //the comparison is false if one of the nodes did not converge (NaN)
+    if (!(maximum - minimum <= maximumPhaseJumpInCell))
+    {
+        return std::numeric_limits<Mdouble>::quiet_NaN();
+    }
+    return (1.0 - tx) * ((1.0 - tb) * p00 + tb * p01) + tx * ((1.0 - tb) * p10 + tb * p11);
+}
+
+/*!
+ * \return The largest value of |beta| covered by the table: pi/2 for a Screw and pi for a Coil.
+ */
+Mdouble HelixParameterTable::getMaximumBeta() const
+{
+    return maximumBeta_;
+}
+
+/*!
+ * \return A table with 64 cells in each direction, which is computed at the first call.
+ */
+const HelixParameterTable& HelixParameterTable::getScrewTable()
+{
+    static const HelixParameterTable table(Shape::SCREW, 64);
+    return table;
+}
+
+/*!
+ * \return A table with 64 cells in each direction, which is computed at the first call.
+ */
+const HelixParameterTable& HelixParameterTable::getCoilTable()
+{
+    static const HelixParameterTable table(Shape::COIL, 64);
+    return table;
+}
+
+/*!
+ * \param[in] kappa The ratio of the periodic and the parabolic term.
+ * \param[in] beta The position of the minimum of the parabolic term.
+ * \return The phase theta of the minimum, or NaN if the iteration did not converge.
+ */
+Mdouble HelixParameterTable::computePhase(Mdouble kappa, Mdouble beta) const
+{
+    Mdouble theta = 0.0;
+    for (unsigned int iteration = 0; iteration < 100; iteration++)
+    {
+        Mdouble dd; //Derivative at current guess
+        Mdouble ddd; //Second derivative at current guess
+        if (shape_ == Shape::SCREW)
+        {
+            dd = kappa * std::sin(2.0 * theta) - 2.0 * (beta - theta);
+            ddd = 2.0 * kappa * std::cos(2.0 * theta) + 2.0;
+        }
+        else
+        {
+            dd = kappa * std::sin(theta) - 2.0 * (beta - theta);
+            ddd = kappa * std::cos(theta) + 2.0;
+        }
+        theta -= dd / ddd;
+        if (std::fabs(dd / ddd) <= 1e-14)
+        {
+            return theta;
+        }
+    }
+    return std::numeric_limits<Mdouble>::quiet_NaN();
+}
@@ -0,0 +1,113 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef HELIXPARAMETERTABLE_H
+#define HELIXPARAMETERTABLE_H
+
+#include <vector>
+#include "GeneralDefine.h"
+
+/*!
+ * \brief A table of initial guesses for the Newton iteration with which a Screw 
+ * or Coil finds the point of its helix closest to a particle.
+ * \details Both walls minimise the squared distance over the helix parameter q,
+ * starting from the minimum q_c of the periodic term closest to the minimum of
+ * the parabolic term. In the phase theta=2*pi*n*(q-q_c) and after dividing by 
+ * the square of the pitch s=l/(2*pi*n), the function to minimise only depends 
+ * on two numbers, kappa and beta:
+ * - Screw: f(theta)=kappa*sin^2(theta)+(beta-theta)^2, with |beta|<=pi/2,
+ * - Coil:  f(theta)=-kappa*cos(theta)+(beta-theta)^2, with |beta|<=pi.
+ * 
+ * The table stores the minimum theta found by the Newton iteration starting at
+ * theta=0 on a regular grid in kappa/(1+kappa) and beta, and interpolates 
+ * bilinearly between the nodes. Where the minimum jumps between two valleys of 
+ * the periodic term inside a cell of the table, no guess is returned, such that 
+ * the wall falls back to its usual initial guess. As the table is 
+ * dimensionless, one table per shape serves all walls.
+ */
+class HelixParameterTable
+{
+public:
+    /*!
+     * \brief The two functions that can be tabulated.
+     */
+    enum class Shape : unsigned int
+    {
+        SCREW, COIL
+    };
+    
+    /*!
+     * \brief Constructor; computes the table for the given shape.
+     */
+    HelixParameterTable(Shape shape, unsigned int numberOfBins);
+    
+    /*!
+     * \brief Returns the interpolated phase of the minimum, or NaN if the table has no reliable guess.
+     */
+    Mdouble getPhase(Mdouble kappa, Mdouble beta) const;
+    
+    /*!
+     * \brief Returns the largest value of |beta|, i.e. half the period of the periodic term.
+     */
+    Mdouble getMaximumBeta() const;
+    
+    /*!
+     * \brief Returns the table shared by all Screw walls.
+     */
+    static const HelixParameterTable& getScrewTable();
+    
+    /*!
+     * \brief Returns the table shared by all Coil walls.
+     */
+    static const HelixParameterTable& getCoilTable();
+
+private:
+    /*!
+     * \brief Minimises f by Newton's method starting at theta=0.
+     */
+    Mdouble computePhase(Mdouble kappa, Mdouble beta) const;
+    
+    /*!
+     * \brief The function that is tabulated.
+     */
+    Shape shape_;
+    
+    /*!
+     * \brief The number of cells in each direction of the table.
+     */
+    unsigned int numberOfBins_;
+    
+    /*!
+     * \brief The largest value of |beta|.
+     */
+    Mdouble maximumBeta_;
+    
+    /*!
+     * \brief The phases at the (numberOfBins_+1)^2 nodes, with beta running fastest.
+     */
+    std::vector<Mdouble> phases_;
+};
+
+#endif
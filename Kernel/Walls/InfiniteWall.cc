@@ -176,6 +176,14 @@ std::string InfiniteWall::getName() const
     return "InfiniteWall";
 }
 
+/*!
+ * \return The size of this InfiniteWall plus the memory used by its list of interactions.
+ */
+std::size_t InfiniteWall::getMemoryUsage() const
+{
+    return sizeof(InfiniteWall) + getInteractionListMemoryUsage();
+}
+
 /*!
  * \return The 3D vector that represents the normal to the wall.
  */
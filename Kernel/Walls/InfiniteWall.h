@@ -122,6 +122,11 @@ public:
      */
     std::string getName() const override;
 
+    /*!
+     * \brief Returns the number of bytes used by this InfiniteWall.
+     */
+    std::size_t getMemoryUsage() const override;
+
     /*!
      * \brief Access function for normal.
      */
@@ -211,6 +211,14 @@ std::string InfiniteWallWithHole::getName() const
     return "InfiniteWallWithHole";
 }
 
+/*!
+ * \return The size of this InfiniteWallWithHole plus the memory used by its list of interactions.
+ */
+std::size_t InfiniteWallWithHole::getMemoryUsage() const
+{
+    return sizeof(InfiniteWallWithHole) + getInteractionListMemoryUsage();
+}
+
 ///access function for normal
 Vec3D InfiniteWallWithHole::getNormal()
 {
@@ -124,6 +124,11 @@ public:
      * \brief Returns the name of the object
      */
     virtual std::string getName() const;
+
+    /*!
+     * \brief Returns the number of bytes used by this InfiniteWallWithHole.
+     */
+    std::size_t getMemoryUsage() const override;
     
     /*!
      * \brief access function for normal
@@ -25,10 +25,14 @@
 
 #include "IntersectionOfWalls.h"
 #include "InteractionHandler.h"
+#include "WallHandler.h"
 #include "Particles/BaseParticle.h"
+#include <algorithm>
 
 IntersectionOfWalls::IntersectionOfWalls()
 {
+    interactionBoxRadius_ = -1.0;
+    hasInteractionBox_ = false;
     logger(DEBUG, "IntersectionOfWalls() constructed.");
 }
 
@@ -42,6 +46,14 @@ IntersectionOfWalls::IntersectionOfWalls(const IntersectionOfWalls& other)
     A_ = other.A_;
     AB_ = other.AB_;
     C_ = other.C_;
+    normalX_ = other.normalX_;
+    normalY_ = other.normalY_;
+    normalZ_ = other.normalZ_;
+    pointX_ = other.pointX_;
+    pointY_ = other.pointY_;
+    pointZ_ = other.pointZ_;
+    interactionBoxRadius_ = -1.0;
+    hasInteractionBox_ = false;
     logger(DEBUG, "IntersectionOfWalls(IntersectionOfWalls&) constructed.");
 }
 
@@ -77,6 +89,17 @@ void IntersectionOfWalls::clear()
     A_.clear();
     AB_.clear();
     C_.clear();
+    normalX_.clear();
+    normalY_.clear();
+    normalZ_.clear();
+    pointX_.clear();
+    pointY_.clear();
+    pointZ_.clear();
+    interactionBoxRadius_ = -1.0;
+    hasInteractionBox_ = false;
+    //the shape changed, so the bounding box of this wall has to be recomputed
+    if (getHandler() != nullptr)
+        getHandler()->setBoundingVolumesOutdated();
 }
 
 /*!
@@ -85,7 +108,8 @@ void IntersectionOfWalls::clear()
  * \details Adds a wall to the set of finite walls, given an outward unit normal
  *  vector s.t. normal*x=normal*point for all x of the wallObject. First make the 
  * InfiniteWall, then compute all intersections, which are then stored in A_, AB_
- * and C_.
+ * and C_. The normal and point of the new wall are also appended to the packed
+ * arrays, and the interaction box has to be recomputed.
  */
 void IntersectionOfWalls::addObject(Vec3D normal, Vec3D point)
 {
@@ -95,6 +119,14 @@ void IntersectionOfWalls::addObject(Vec3D normal, Vec3D point)
     std::size_t n = wallObjects_.size();
     wallObjects_.resize(n + 1);
     wallObjects_[n].set(normal, point);
+    normalX_.push_back(wallObjects_[n].getNormal().X);
+    normalY_.push_back(wallObjects_[n].getNormal().Y);
+    normalZ_.push_back(wallObjects_[n].getNormal().Z);
+    pointX_.push_back(wallObjects_[n].getPosition().X);
+    pointY_.push_back(wallObjects_[n].getPosition().Y);
+    pointZ_.push_back(wallObjects_[n].getPosition().Z);
+    interactionBoxRadius_ = -1.0;
+    hasInteractionBox_ = false;
 
     // AB[n*(n-1)/2+m] is the direction of the intersecting line between walls m and n, m<n
     // A[n*(n-1)/2+m] is a point on the intersecting line between walls m and n, m<n
@@ -145,6 +177,10 @@ void IntersectionOfWalls::addObject(Vec3D normal, Vec3D point)
         }
     }
 
+    //the shape changed, so the bounding box of this wall has to be recomputed
+    if (getHandler() != nullptr)
+        getHandler()->setBoundingVolumesOutdated();
+
     logger(VERBOSE, "%", *this);
     for (InfiniteWall w : wallObjects_)
         logger(VERBOSE, "wallObject %, %", w.getNormal(), w.getPosition());
@@ -268,6 +304,19 @@ bool IntersectionOfWalls::getDistanceAndNormal(const BaseParticle& p, Mdouble& d
  */
 bool IntersectionOfWalls::getDistanceAndNormal(const Vec3D& position, Mdouble wallInteractionRadius, Mdouble &distance, Vec3D &normal_return) const
 {
+    //A position outside the bounding box of the interaction region does not interact with this wall;
+    //the box is computed for the largest radius seen so far, as the region grows with the radius
+    if (wallInteractionRadius > interactionBoxRadius_)
+    {
+        updateInteractionBox(std::max(wallInteractionRadius, 1.25 * interactionBoxRadius_));
+    }
+    if (hasInteractionBox_ && (position.X < interactionBoxMin_.X || position.X > interactionBoxMax_.X
+                               || position.Y < interactionBoxMin_.Y || position.Y > interactionBoxMax_.Y
+                               || position.Z < interactionBoxMin_.Z || position.Z > interactionBoxMax_.Z))
+    {
+        return false;
+    }
+
     distance = -1e20;
     Mdouble distance2 = -1e20;
     Mdouble distance3 = -1e20;
@@ -276,50 +325,69 @@ bool IntersectionOfWalls::getDistanceAndNormal(const Vec3D& position, Mdouble wa
     unsigned int id2=0;
     unsigned int id3=0;
 
-    //The object has to touch each wall  each wall (distanceCurrent) and keep the minimum distance (distance) and wall index (id)
-    for (unsigned int i = 0; i < wallObjects_.size(); i++)
+    //The distances to the walls are computed in blocks; within a block, they are computed from the packed arrays
+    //in a loop without branches, which the compiler vectorises. The arithmetic is the same as in InfiniteWall::getDistance.
+    const unsigned int numberOfWalls = normalX_.size();
+    const unsigned int blockSize = 16;
+    Mdouble distances[blockSize];
+    for (unsigned int begin = 0; begin < numberOfWalls; begin += blockSize)
     {
-        // Calculate distance to each wall (distanceCurrent);
-        distanceCurrent = wallObjects_[i].getDistance(position);
-        // The object has to touch each wall (distanceCurrent >= wallInteractionRadius), otherwise return false (i.e. no contact)
-        // This means that for each InfiniteWall in wallObjects_, the particle is either "inside"
-        // the wall or touching it. If not, there is no interaction.
-        if (distanceCurrent >= wallInteractionRadius)
-            return false;
-        // Find out which of the InfiniteWalls is interacting with the particle.
-        // Keep the minimum distance (distance) and wall index (id)
-        // and store up to two walls (id2, id3) and their distances (distance2, distance3),
-        // if the possible contact point is near the intersection between id and id2 (and id3)
-        if (distanceCurrent > distance)
+        const unsigned int end = std::min(begin + blockSize, numberOfWalls);
+        const Mdouble* nx = normalX_.data() + begin;
+        const Mdouble* ny = normalY_.data() + begin;
+        const Mdouble* nz = normalZ_.data() + begin;
+        const Mdouble* px = pointX_.data() + begin;
+        const Mdouble* py = pointY_.data() + begin;
+        const Mdouble* pz = pointZ_.data() + begin;
+        for (unsigned int j = 0; j < end - begin; j++)
+        {
+            distances[j] = (px[j] - position.X) * nx[j] + (py[j] - position.Y) * ny[j] + (pz[j] - position.Z) * nz[j];
+        }
+
+        //The object has to touch each wall  each wall (distanceCurrent) and keep the minimum distance (distance) and wall index (id)
+        for (unsigned int i = begin; i < end; i++)
         {
-            if (distance > -wallInteractionRadius)
+            distanceCurrent = distances[i - begin];
+            // The object has to touch each wall (distanceCurrent >= wallInteractionRadius), otherwise return false (i.e. no contact)
+            // This means that for each InfiniteWall in wallObjects_, the particle is either "inside"
+            // the wall or touching it. If not, there is no interaction.
+            if (distanceCurrent >= wallInteractionRadius)
+                return false;
+            // Find out which of the InfiniteWalls is interacting with the particle.
+            // Keep the minimum distance (distance) and wall index (id)
+            // and store up to two walls (id2, id3) and their distances (distance2, distance3),
+            // if the possible contact point is near the intersection between id and id2 (and id3)
+            if (distanceCurrent > distance)
+            {
+                if (distance > -wallInteractionRadius)
+                {
+                    if (distance2 > -wallInteractionRadius)
+                    {
+                        distance3 = distance;
+                        id3 = id;
+                    }
+                    else
+                    {
+                        distance2 = distance;
+                        id2 = id;
+                    }
+                }
+                distance = distanceCurrent;
+                id = i;
+            }
+            else if (distanceCurrent > -wallInteractionRadius)
             {
                 if (distance2 > -wallInteractionRadius)
                 {
-                    distance3 = distance;
-                    id3 = id;
+                    distance3 = distanceCurrent;
+                    id3 = i;
                 }
                 else
                 {
-                    distance2 = distance;
-                    id2 = id;
+                    distance2 = distanceCurrent;
+                    id2 = i;
                 }
             }
-            distance = distanceCurrent;
-            id = i;
-        }
-        else if (distanceCurrent > -wallInteractionRadius)
-        {
-            if (distance2 > -wallInteractionRadius)
-            {
-                distance3 = distanceCurrent;
-                id3 = i;
-            }
-            else
-            {
-                distance2 = distanceCurrent;
-                id2 = i;
-            }
         }
     }
     
@@ -338,11 +406,11 @@ bool IntersectionOfWalls::getDistanceAndNormal(const Vec3D& position, Mdouble wa
             if (intersection_with_id2)
             {
                 //possible contact is with intersection of id,id2,id3
-                //we know id2<id3
-                unsigned int index =
-                        (id < id2) ? ((id3 - 2) * (id3 - 1) * id3 / 6 + (id2 - 1) * id2 / 2 + id) :
-                        (id < id3) ? ((id3 - 2) * (id3 - 1) * id3 / 6 + (id - 1) * id / 2 + id2) :
-                                     ((id - 2) * (id - 1) * id / 6 + (id3 - 1) * id3 / 2 + id2);
+                //id2<id3 does not always hold (e.g. if id was moved to id3 after id2 was set), so sort the indices l<m<n
+                unsigned int l = std::min(std::min(id, id2), id3);
+                unsigned int n = std::max(std::max(id, id2), id3);
+                unsigned int m = id + id2 + id3 - l - n;
+                unsigned int index = (n - 2) * (n - 1) * n / 6 + (m - 1) * m / 2 + l;
                 normal_return = position - C_[index];
                 distance = sqrt(normal_return.getLengthSquared());
                 if (distance >= wallInteractionRadius)
@@ -375,13 +443,143 @@ bool IntersectionOfWalls::getDistanceAndNormal(const Vec3D& position, Mdouble wa
     return true;
 }
 
+/*!
+ * \param[in] wallInteractionRadius The largest wall interaction radius of the particles.
+ * \param[out] min The lower corner of the box.
+ * \param[out] max The upper corner of the box.
+ * \return False if the region in which particles interact with this wall is unbounded.
+ */
+bool IntersectionOfWalls::getBoundingBox(Mdouble wallInteractionRadius, Vec3D& min, Vec3D& max) const
+{
+    return getBoundingBoxOfInteractionRegion(wallInteractionRadius, std::vector<Vec3D>(), std::vector<Mdouble>(), min, max);
+}
+
+/*!
+ * \param[out] normals The normals of the constraints normal*x>=offset.
+ * \param[out] offsets The offsets of the constraints.
+ * \details The positions passed to getDistanceAndNormal(const Vec3D&, Mdouble, Mdouble&, Vec3D&) 
+ * are arbitrary for an IntersectionOfWalls, so there are no constraints. Walls
+ * that evaluate it in a reduced frame, such as AxisymmetricIntersectionOfWalls, 
+ * restrict the region with these constraints, which bounds the interaction box 
+ * in that frame.
+ */
+void IntersectionOfWalls::getPositionConstraints(std::vector<Vec3D>& normals UNUSED, std::vector<Mdouble>& offsets UNUSED) const
+{
+}
+
+/*!
+ * \param[in] wallInteractionRadius The wall interaction radius for which the box is computed.
+ * \details The interaction region grows with the radius, so the box is valid 
+ * for all radii up to the given one. If the region is unbounded, e.g. for a 
+ * prism, hasInteractionBox_ is false and no position is rejected early.
+ */
+void IntersectionOfWalls::updateInteractionBox(Mdouble wallInteractionRadius) const
+{
+    std::vector<Vec3D> normals;
+    std::vector<Mdouble> offsets;
+    getPositionConstraints(normals, offsets);
+    interactionBoxRadius_ = wallInteractionRadius;
+    hasInteractionBox_ = getBoundingBoxOfInteractionRegion(wallInteractionRadius, normals, offsets, interactionBoxMin_, interactionBoxMax_);
+}
+
+/*!
+ * \param[in] wallInteractionRadius The largest wall interaction radius of the particles.
+ * \param[in] normals The normals of additional constraints normal*x>=offset on the region.
+ * \param[in] offsets The offsets of the additional constraints.
+ * \param[out] min The lower corner of the box.
+ * \param[out] max The upper corner of the box.
+ * \return False if the region is unbounded or empty.
+ * \details A particle at position x interacts with this wall only if its distance 
+ * to every InfiniteWall is smaller than its interaction radius, i.e. if 
+ * normal_i*x > normal_i*position_i-wallInteractionRadius for all i. Together with
+ * the additional constraints, this defines a convex polyhedron. It is bounded if 
+ * no edge direction (the cross product of two normals) satisfies all 
+ * constraints; its bounding box is then the bounding box of its vertices, the 
+ * intersection points of three planes that satisfy all other constraints.
+ */
+bool IntersectionOfWalls::getBoundingBoxOfInteractionRegion(Mdouble wallInteractionRadius, std::vector<Vec3D> normals, std::vector<Mdouble> offsets, Vec3D& min, Vec3D& max) const
+{
+    for (const InfiniteWall& wall : wallObjects_)
+    {
+        normals.push_back(wall.getNormal());
+        offsets.push_back(Vec3D::dot(wall.getNormal(), wall.getPosition()) - wallInteractionRadius);
+    }
+    const std::size_t n = normals.size();
+    //a bounded polyhedron needs at least four faces
+    if (n < 4)
+        return false;
+    const Mdouble tolerance = 1e-10;
+
+    //check that no direction of infinite extent exists
+    for (std::size_t i = 0; i < n; i++)
+    {
+        for (std::size_t j = 0; j < i; j++)
+        {
+            Vec3D direction = Vec3D::cross(normals[i], normals[j]);
+            Mdouble length = direction.getLength();
+            if (length < tolerance)
+                continue;
+            for (Mdouble sign : {1.0, -1.0})
+            {
+                bool isUnbounded = true;
+                for (std::size_t k = 0; k < n && isUnbounded; k++)
+                    isUnbounded = sign * Vec3D::dot(normals[k], direction) >= -tolerance * length;
+                if (isUnbounded)
+                    return false;
+            }
+        }
+    }
+
+    //the bounding box of the vertices
+    bool hasVertex = false;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        for (std::size_t j = 0; j < i; j++)
+        {
+            for (std::size_t k = 0; k < j; k++)
+            {
+                Vec3D jk = Vec3D::cross(normals[j], normals[k]);
+                Mdouble determinant = Vec3D::dot(normals[i], jk);
+                if (std::abs(determinant) < tolerance)
+                    continue;
+                Vec3D vertex = (offsets[i] * jk + offsets[j] * Vec3D::cross(normals[k], normals[i])
+                                + offsets[k] * Vec3D::cross(normals[i], normals[j])) / determinant;
+                Mdouble scale = 1.0 + vertex.getLength();
+                bool isVertex = true;
+                for (std::size_t l = 0; l < n && isVertex; l++)
+                    isVertex = Vec3D::dot(normals[l], vertex) >= offsets[l] - tolerance * scale;
+                if (!isVertex)
+                    continue;
+                if (!hasVertex)
+                {
+                    min = vertex;
+                    max = vertex;
+                    hasVertex = true;
+                }
+                else
+                {
+                    min = Vec3D(std::min(min.X, vertex.X), std::min(min.Y, vertex.Y), std::min(min.Z, vertex.Z));
+                    max = Vec3D(std::max(max.X, vertex.X), std::max(max.Y, vertex.Y), std::max(max.Z, vertex.Z));
+                }
+            }
+        }
+    }
+    if (!hasVertex)
+        return false;
+    //widen the box slightly, such that rounding errors cannot exclude an interaction
+    Vec3D margin = tolerance * (Vec3D(1.0, 1.0, 1.0) + (max - min));
+    min -= margin;
+    max += margin;
+    return true;
+}
+
 /*!
  * \param[in] move A reference to a Vec3D that denotes the direction and length 
  * it should be moved with.
  * \details A function that moves the InterSectionOfWalls in a certain direction
  * by both moving the walls and all intersections. Note that the directions of the 
  * intersections are not moved since they don't change when moving the IntersectionOfWalls
- * as a whole.
+ * as a whole. The packed points of the walls and the interaction box are shifted as well.
  * \todo We should use the position_ and orientation_ of the IntersectionOfWalls; 
  * that way, IntersectionOfWalls can be moved with the standard BaseInteractable::move function, 
  * getting rid of an anomaly in the code and removing the virtual from the move function. \author weinhartt
@@ -401,6 +599,14 @@ void IntersectionOfWalls::move(const Vec3D& move)
 	{
 		o.move(move);
 	}
+    for (unsigned int i = 0; i < pointX_.size(); i++)
+    {
+        pointX_[i] += move.X;
+        pointY_[i] += move.Y;
+        pointZ_[i] += move.Z;
+    }
+    interactionBoxMin_ += move;
+    interactionBoxMax_ += move;
 }
 
 /*!
@@ -444,6 +650,21 @@ std::string IntersectionOfWalls::getName() const
     return "IntersectionOfWalls";
 }
 
+/*!
+ * \return The size of this IntersectionOfWalls plus the memory used by its 
+ *         walls, the vectors describing their intersections, the packed arrays
+ *         and its list of interactions.
+ */
+std::size_t IntersectionOfWalls::getMemoryUsage() const
+{
+    std::size_t memoryUsage = sizeof(IntersectionOfWalls) + getInteractionListMemoryUsage();
+    memoryUsage += wallObjects_.capacity() * sizeof(InfiniteWall);
+    memoryUsage += (A_.capacity() + AB_.capacity() + C_.capacity()) * sizeof(Vec3D);
+    memoryUsage += (normalX_.capacity() + normalY_.capacity() + normalZ_.capacity()
+                    + pointX_.capacity() + pointY_.capacity() + pointZ_.capacity()) * sizeof(Mdouble);
+    return memoryUsage;
+}
+
 /*!
  * \param[in] p Pointer to the BaseParticle which we want to check the interaction for.
  * \param[in] timeStamp The time at which we want to look at the interaction.
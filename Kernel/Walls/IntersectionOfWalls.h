@@ -118,6 +118,11 @@ public:
      */
     bool getDistanceAndNormal(const Vec3D& postition, Mdouble wallInteractionRadius, Mdouble& distance, Vec3D& normal_return) const;
 
+    /*!
+     * \brief Computes a box that contains all positions at which a particle can interact with this IntersectionOfWalls, if it is bounded.
+     */
+    bool getBoundingBox(Mdouble wallInteractionRadius, Vec3D& min, Vec3D& max) const override;
+
     /*!
      * \brief Move the IntersectionOfWalls to a new position, which is a Vec3D from the old position.
      */
@@ -138,12 +143,33 @@ public:
      */
     std::string getName() const override;
 
+    /*!
+     * \brief Returns the number of bytes used by this IntersectionOfWalls, including its walls.
+     */
+    std::size_t getMemoryUsage() const override;
+
     /*!
      * \brief Get the interaction between this IntersectionOfWalls and given BaseParticle at a given time.
      */
     BaseInteraction* getInteractionWith(BaseParticle* p, Mdouble timeStamp, InteractionHandler* interactionHandler);
 
+protected:
+    /*!
+     * \brief Computes the bounding box of the positions that interact with all walls and satisfy the given additional constraints.
+     */
+    bool getBoundingBoxOfInteractionRegion(Mdouble wallInteractionRadius, std::vector<Vec3D> normals, std::vector<Mdouble> offsets, Vec3D& min, Vec3D& max) const;
+
+    /*!
+     * \brief Returns the constraints normal*x>=offset that all positions passed to getDistanceAndNormal(const Vec3D&, Mdouble, Mdouble&, Vec3D&) satisfy; none by default.
+     */
+    virtual void getPositionConstraints(std::vector<Vec3D>& normals, std::vector<Mdouble>& offsets) const;
+
 private:
+    /*!
+     * \brief Computes the bounding box of the interaction region for the given radius, which is used to reject distant positions early.
+     */
+    void updateInteractionBox(Mdouble wallInteractionRadius) const;
+
     /*!
      * \brief The wall "segments"/directions that together make up the finite wall. 
      * \details An intersection of walls exists of a number of infinite walls that
@@ -172,6 +198,28 @@ private:
      * l, m and n, l<m<n
      */
     std::vector<Vec3D> C_;
+
+    /*!
+     * \brief The normals and the points of the walls in wallObjects_, one array per coordinate.
+     * \details The distances to all walls are computed from these packed arrays
+     * in a loop that can be vectorised, instead of from the InfiniteWall objects.
+     */
+    std::vector<Mdouble> normalX_, normalY_, normalZ_, pointX_, pointY_, pointZ_;
+
+    /*!
+     * \brief The wall interaction radius for which interactionBoxMin_ and interactionBoxMax_ were computed, or -1 if they have to be recomputed.
+     */
+    mutable Mdouble interactionBoxRadius_;
+
+    /*!
+     * \brief True if the interaction region is bounded, such that positions outside the interaction box can be rejected.
+     */
+    mutable bool hasInteractionBox_;
+
+    /*!
+     * \brief The corners of the bounding box of the positions that interact with this wall, for radii up to interactionBoxRadius_.
+     */
+    mutable Vec3D interactionBoxMin_, interactionBoxMax_;
 };
 
 #endif
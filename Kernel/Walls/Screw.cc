@@ -27,6 +27,14 @@
 #include "InteractionHandler.h"
 #include "Math/ExtendedMath.h"
 #include "Particles/BaseParticle.h"
+#include "HelixParameterTable.h"
+#include <limits>
+
+/*!
+ * \details The Newton iterations normally converge in a handful of steps; the
+ * bound only guards against the rare cases in which they oscillate.
+ */
+static const unsigned int maximumNumberOfNewtonIterations = 50;
 
 /*!
  * \details Make a Screw which is centered in the origin, has a length of 1, one
@@ -42,6 +50,8 @@ Screw::Screw()
     omega_ = 1.0;
     offset_ = 0.0;
     thickness_ = 0.0;
+    useTabulatedInitialGuess_ = false;
+    numberOfUnconvergedNewtonIterations_ = 0;
     logger(DEBUG, "Screw() constructor finished.");              
 }
 
@@ -58,6 +68,8 @@ Screw::Screw(const Screw& other)
     omega_ = other.omega_;
     thickness_ = other.thickness_;
     offset_ = other.offset_;
+    useTabulatedInitialGuess_ = other.useTabulatedInitialGuess_;
+    numberOfUnconvergedNewtonIterations_ = 0;
     logger(DEBUG, "Screw(const Screw&) copy constructor finished.");
 }
 
@@ -80,6 +92,8 @@ Screw::Screw(Vec3D start, Mdouble l, Mdouble r, Mdouble n, Mdouble omega, Mdoubl
     omega_ = omega;
     thickness_ = thickness;
     offset_ = 0.0;
+    useTabulatedInitialGuess_ = false;
+    numberOfUnconvergedNewtonIterations_ = 0;
     logger(DEBUG, "Screw(Vec3D, Mdouble, Mdouble, Mdouble, Mdouble, Mdouble) constructor finished.");           
 }
 
@@ -88,6 +102,27 @@ Screw::~Screw()
     logger(DEBUG, "~Screw() finished, destroyed the Screw.");
 }
 
+/*!
+ * \param[in] useTabulatedInitialGuess If true, the Newton iteration for a particle
+ * that was not in contact with this Screw at the last time step starts from the 
+ * guess interpolated from HelixParameterTable::getScrewTable(), instead of the 
+ * minimum of the periodic term.
+ * \details The iteration stops at the same tolerance, so only the number of
+ * iterations changes. This setting is not written to the restart file.
+ */
+void Screw::setUseTabulatedInitialGuess(bool useTabulatedInitialGuess)
+{
+    useTabulatedInitialGuess_ = useTabulatedInitialGuess;
+}
+
+/*!
+ * \return True if the Newton iteration starts from a tabulated guess.
+ */
+bool Screw::getUseTabulatedInitialGuess() const
+{
+    return useTabulatedInitialGuess_;
+}
+
 /*!
  * \return A pointer to a copy of this Screw.
  */
@@ -105,18 +140,35 @@ Screw* Screw::copy() const
  * a given BaseParticle and this Screw. If there is a collision, this
  * function also computes the distance between the BaseParticle and Screw
  * and the normal of the IntersectionOfWalls at the intersection point. 
- * \todo Make this function readable and explain the steps in the details.
+ * As no initial guess is given, the Newton iteration starts at the minimum of 
+ * the periodic term, or at the tabulated guess if that is switched on.
  */
 bool Screw::getDistanceAndNormal(const BaseParticle& p, Mdouble& distance, Vec3D& normal_return) const
 {
-    Mdouble Rsqr = pow(p.getPosition().X - start_.X, 2) + pow(p.getPosition().Y - start_.Y, 2);
-    if (Rsqr > pow(maxR_ + p.getWallInteractionRadius() + thickness_, 2) || p.getPosition().Z > l_ + start_.Z + p.getWallInteractionRadius() + thickness_ || p.getPosition().Z < start_.Z - p.getWallInteractionRadius() - thickness_)
+    if (!isInBoundingCylinder(p))
     {
-        //std::cout<<"Particle is out of first bound checking"<<std::endl;
-        //std::cout<<"Rule 1: "<<Rsqr<<"<"<<pow(r+P.getRadius()+thickness_,2)<<std::endl;
-        //std::cout<<"Rule 2: "<<Start.Z-P.getRadius()-thickness_<<"<"<<P.getPosition().Z<<"<"<<L+Start.Z+P.getRadius()+thickness_<<std::endl;
         return false;
     }
+    Mdouble q = std::numeric_limits<Mdouble>::quiet_NaN();
+    return getDistanceNormalAndParameter(p, distance, normal_return, q);
+}
+
+/*!
+ * \param[in] p BaseParticle we want to calculate the distance and whether it collided of.
+ * \param[out] distance The distance of the BaseParticle to this wall.
+ * \param[out] normal_return If there was a collision, the normal vector to this wall will be placed here.
+ * \param[in,out] q On input, an initial guess for the helix parameter of the contact
+ * point, e.g. the one of the last time step, or NaN if there is none; on output, 
+ * the helix parameter found by the first Newton iteration (before the radius and
+ * the ends of the Screw are taken into account), if the particle is close enough
+ * to the Screw to compute it.
+ * \return A boolean which says whether or not there was a collision.
+ * \pre isInBoundingCylinder(p) is true; the caller does this cheap test first.
+ * \todo Make this function readable and explain the steps in the details.
+ */
+bool Screw::getDistanceNormalAndParameter(const BaseParticle& p, Mdouble& distance, Vec3D& normal_return, Mdouble& q) const
+{
+    Mdouble Rsqr = pow(p.getPosition().X - start_.X, 2) + pow(p.getPosition().Y - start_.Y, 2);
     Mdouble R = sqrt(Rsqr);
     Mdouble alpha = atan2(p.getPosition().Y - start_.Y, p.getPosition().X - start_.X);
     Mdouble dz = p.getPosition().Z - start_.Z;
@@ -138,66 +190,93 @@ bool Screw::getDistanceAndNormal(const BaseParticle& p, Mdouble& distance, Vec3D
     //Distance^2=R^2*sin^2(alpha-2*Pi*(offset+N*q))^2+(dz-q*L)^2
     //For this we use the Euler algoritm
     
-    Mdouble q; //Current guess
-    Mdouble dd; //Derivative at current guess
-    Mdouble ddd; //Second derivative at current guess
     Mdouble q0 = dz / l_; //Minimum of the parabolic part
             
-    //The initial guess will be in the minimum of the sin closest to the minimum of the parabolic part
+    //The default initial guess will be in the minimum of the sin closest to the minimum of the parabolic part
     //Minima of the sin are at
     //alpha-2*Pi*(offset+N*q)=k*Pi (k=integer)
     //q=alpha/(2*Pi*N)-k/(2*N)-offset/N (k=integer)
     
     Mdouble k = round(alpha / constants::pi - 2.0 * (offset_ + n_ * q0));
-    q = alpha / (2.0 * constants::pi * n_) - k / (2.0 * n_) - offset_ / n_;
+    Mdouble qValley = alpha / (2.0 * constants::pi * n_) - k / (2.0 * n_) - offset_ / n_;
     
-    //Now apply Newton's method
-    do
+    //The given initial guess is only used if it lies in the same valley of the sin (this also rejects NaN)
+    bool isDefaultGuess = !(fabs(q - qValley) < 0.25 / n_);
+    if (isDefaultGuess)
     {
-        dd = -2.0 * Rsqr * constants::pi * n_ * sin(2.0 * alpha - 4.0 * constants::pi * (n_ * q + offset_)) - 2.0 * l_ * (dz - q * l_);
-        ddd = 8.0 * Rsqr * constants::sqr_pi * n_ * n_ * cos(2.0 * alpha - 4.0 * constants::pi * (n_ * q + offset_)) + 2.0 * l_ * l_;
-        q -= dd / ddd;
-    } while (fabs(dd / ddd) > 1e-14);
+        q = qValley;
+        if (useTabulatedInitialGuess_)
+        {
+            //see HelixParameterTable for the scaling with the pitch s
+            const Mdouble s = l_ / (2.0 * constants::pi * n_);
+            const Mdouble phase = HelixParameterTable::getScrewTable().getPhase(Rsqr / (s * s), (dz - qValley * l_) / s);
+            if (!std::isnan(phase))
+            {
+                q += phase / (2.0 * constants::pi * n_);
+                isDefaultGuess = false;
+            }
+        }
+    }
+    
+    //Now apply Newton's method; the result of the given guess is only accepted if it is a minimum in the same valley
+    //as the default guess, which contains only one minimum; otherwise, the iteration is restarted from the default guess
+    bool isConverged;
+    const bool isMinimum = applyNewtonMethod(q, Rsqr, alpha, dz, isConverged);
+    if (!isDefaultGuess && !(isMinimum && fabs(q - qValley) < 0.25 / n_))
+    {
+        q = qValley;
+        applyNewtonMethod(q, Rsqr, alpha, dz, isConverged);
+    }
+    if (!isConverged)
+    {
+        warnNewtonMethodNotConverged();
+    }
+    Mdouble qContact = q;
     
     //Calculate r
-    Mdouble r = R * cos(2.0 * constants::pi * (offset_ + n_ * q) - alpha);
+    Mdouble r = R * cos(2.0 * constants::pi * (offset_ + n_ * qContact) - alpha);
     
     //Check if the location is actually on the screw:
     //First posibility is that the radius is to large:
     if (fabs(r) > maxR_) //Left boundary of the coil
     {
         r = mathsFunc::sign(r) * maxR_;
-        unsigned int steps = 0;
         //This case reduces to the coil problem
+        Mdouble dd; //Derivative at current guess
+        Mdouble ddd; //Second derivative at current guess
+        unsigned int steps = 0;
         do
         {
-            dd = -4.0 * R * r * constants::pi * n_ * sin(alpha - 2.0 * constants::pi * (n_ * q + offset_)) - 2.0 * l_ * (dz - q * l_);
-            ddd = 8.0 * R * r * constants::sqr_pi * n_ * n_ * cos(alpha - 2.0 * constants::pi * (n_ * q + offset_)) + 2.0 * l_ * l_;
-            q -= dd / ddd;
-            steps++;
-        } while (fabs(dd / ddd) > 1e-14);
+            dd = -4.0 * R * r * constants::pi * n_ * sin(alpha - 2.0 * constants::pi * (n_ * qContact + offset_)) - 2.0 * l_ * (dz - qContact * l_);
+            ddd = 8.0 * R * r * constants::sqr_pi * n_ * n_ * cos(alpha - 2.0 * constants::pi * (n_ * qContact + offset_)) + 2.0 * l_ * l_;
+            qContact -= dd / ddd;
+        } while (fabs(dd / ddd) > 1e-14 && ++steps < maximumNumberOfNewtonIterations);
+        if (fabs(dd / ddd) > 1e-14)
+        {
+            warnNewtonMethodNotConverged();
+        }
     }
     //Second possibility is that it occured before the start of after the end
-    if (q < 0)
+    if (qContact < 0)
     {
-        q = 0;
-        r = R * cos(alpha - 2.0 * constants::pi * (offset_ + q * n_));
+        qContact = 0;
+        r = R * cos(alpha - 2.0 * constants::pi * (offset_ + qContact * n_));
         if (fabs(r) > maxR_)
         {
             r = mathsFunc::sign(r) * maxR_;
         }
     }
-    else if (q > 1)
+    else if (qContact > 1)
     {
-        q = 1;
-        r = R * cos(alpha - 2.0 * constants::pi * (offset_ + q * n_));
+        qContact = 1;
+        r = R * cos(alpha - 2.0 * constants::pi * (offset_ + qContact * n_));
         if (fabs(r) > maxR_)
         {
             r = mathsFunc::sign(r) * maxR_;
         }
     }
     
-    distance = R * R * pow(sin(alpha - 2 * constants::pi * (offset_ + n_ * q)), 2) + pow(dz - q * l_, 2);
+    distance = R * R * pow(sin(alpha - 2 * constants::pi * (offset_ + n_ * qContact)), 2) + pow(dz - qContact * l_, 2);
     //If distance is to large there is no contact
     if (distance >= (p.getWallInteractionRadius() + thickness_) * (p.getWallInteractionRadius() + thickness_))
     {
@@ -206,14 +285,85 @@ bool Screw::getDistanceAndNormal(const BaseParticle& p, Mdouble& distance, Vec3D
     
     Vec3D ContactPoint;
     distance = sqrt(distance) - thickness_;
-    ContactPoint.X = start_.X + r * cos(2.0 * constants::pi * (offset_ + n_ * q));
-    ContactPoint.Y = start_.Y + r * sin(2.0 * constants::pi * (offset_ + n_ * q));
-    ContactPoint.Z = start_.Z + q * l_;
+    ContactPoint.X = start_.X + r * cos(2.0 * constants::pi * (offset_ + n_ * qContact));
+    ContactPoint.Y = start_.Y + r * sin(2.0 * constants::pi * (offset_ + n_ * qContact));
+    ContactPoint.Z = start_.Z + qContact * l_;
     normal_return = ContactPoint - p.getPosition();
     normal_return /= normal_return.getLength();
     return true;
 }
 
+/*!
+ * \param[in,out] q The initial guess of the helix parameter, which is replaced by the minimum found.
+ * \param[in] Rsqr The squared distance of the particle from the axis of the Screw.
+ * \param[in] alpha The polar angle of the particle around the axis of the Screw.
+ * \param[in] dz The height of the particle above the start of the Screw.
+ * \param[out] isConverged True if the last Newton step was smaller than 1e-14,
+ * false if the maximum number of iterations was reached first.
+ * \return True if the iteration converged and the second derivative is positive,
+ * i.e. a minimum was found; false if it ended in a maximum or did not converge.
+ */
+bool Screw::applyNewtonMethod(Mdouble& q, Mdouble Rsqr, Mdouble alpha, Mdouble dz, bool& isConverged) const
+{
+    Mdouble dd; //Derivative at current guess
+    Mdouble ddd; //Second derivative at current guess
+    unsigned int iteration = 0;
+    do
+    {
+        dd = -2.0 * Rsqr * constants::pi * n_ * sin(2.0 * alpha - 4.0 * constants::pi * (n_ * q + offset_)) - 2.0 * l_ * (dz - q * l_);
+        ddd = 8.0 * Rsqr * constants::sqr_pi * n_ * n_ * cos(2.0 * alpha - 4.0 * constants::pi * (n_ * q + offset_)) + 2.0 * l_ * l_;
+        q -= dd / ddd;
+    } while (fabs(dd / ddd) > 1e-14 && ++iteration < maximumNumberOfNewtonIterations);
+    isConverged = fabs(dd / ddd) <= 1e-14;
+    return isConverged && ddd > 0;
+}
+
+/*!
+ * \param[in] p The BaseParticle that is checked.
+ * \return True if the BaseParticle is within its wall interaction radius plus the
+ * thickness of the cylinder around the axis of the Screw.
+ */
+bool Screw::isInBoundingCylinder(const BaseParticle& p) const
+{
+    const Mdouble Rsqr = pow(p.getPosition().X - start_.X, 2) + pow(p.getPosition().Y - start_.Y, 2);
+    return !(Rsqr > pow(maxR_ + p.getWallInteractionRadius() + thickness_, 2) || p.getPosition().Z > l_ + start_.Z + p.getWallInteractionRadius() + thickness_ || p.getPosition().Z < start_.Z - p.getWallInteractionRadius() - thickness_);
+}
+
+/*!
+ * \details The unconverged helix parameter is still used, as it is usually close
+ * to the contact point; to keep the output readable when this happens at every
+ * time step, only the 1st, 10th, 100th, ... occurrence for this Screw is reported.
+ */
+void Screw::warnNewtonMethodNotConverged() const
+{
+    ++numberOfUnconvergedNewtonIterations_;
+    unsigned int count = numberOfUnconvergedNewtonIterations_;
+    while (count % 10 == 0)
+    {
+        count /= 10;
+    }
+    if (count == 1)
+    {
+        logger(WARN, "Screw %: the Newton iteration for the contact point did not converge in % iterations (% times so far)",
+               getIndex(), maximumNumberOfNewtonIterations, numberOfUnconvergedNewtonIterations_);
+    }
+}
+
+/*!
+ * \param[in] wallInteractionRadius The largest wall interaction radius of the particles.
+ * \param[out] min The lower corner of the box.
+ * \param[out] max The upper corner of the box.
+ * \return True, as a Screw is bounded by the cylinder of radius maxR_ and length l_ around its axis.
+ * \details The box does not depend on the rotation of the Screw, so it only changes with start_.
+ */
+bool Screw::getBoundingBox(Mdouble wallInteractionRadius, Vec3D& min, Vec3D& max) const
+{
+    const Mdouble margin = wallInteractionRadius + thickness_;
+    min = Vec3D(start_.X - maxR_ - margin, start_.Y - maxR_ - margin, start_.Z + std::min(l_, 0.0) - margin);
+    max = Vec3D(start_.X + maxR_ + margin, start_.Y + maxR_ + margin, start_.Z + std::max(l_, 0.0) + margin);
+    return true;
+}
+
 /*!
  * \param[in] dt The time for which the Screw has to be turned.
  */
@@ -278,6 +428,14 @@ std::string Screw::getName() const
     return "Screw";
 }
 
+/*!
+ * \return The size of this Screw plus the memory used by its list of interactions.
+ */
+std::size_t Screw::getMemoryUsage() const
+{
+    return sizeof(Screw) + getInteractionListMemoryUsage();
+}
+
 /*!
  * \param[in] p Pointer to the BaseParticle which we want to check the interaction for.
  * \param[in] timeStamp The time at which we want to look at the interaction.
@@ -290,9 +448,18 @@ BaseInteraction* Screw::getInteractionWith(BaseParticle* p, Mdouble timeStamp, I
     Mdouble distance;
     Vec3D normal;
 
-    if (getDistanceAndNormal(*p,distance,normal))
+    //the cheap bounding test comes first, so distant particles do not pay for the interaction lookup
+    if (!isInBoundingCylinder(*p))
+    {
+        return nullptr;
+    }
+    //the helix parameter of the last time step is the initial guess of the Newton iteration
+    BaseInteraction* c = interactionHandler->getExistingInteraction(p, this);
+    Mdouble q = (c == nullptr) ? std::numeric_limits<Mdouble>::quiet_NaN() : c->getWallContactParameter();
+    if (getDistanceNormalAndParameter(*p, distance, normal, q))
     {
-        BaseInteraction* c = interactionHandler->getInteraction(p, this, timeStamp);
+        c = interactionHandler->getInteraction(p, this, timeStamp);
+        c->setWallContactParameter(q);
         c->setNormal(-normal);
         c->setDistance(distance);
         c->setOverlap(p->getRadius() - distance);
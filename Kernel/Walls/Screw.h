@@ -59,6 +59,16 @@ public:
      */
     ~Screw();
 
+    /*!
+     * \brief Sets whether the Newton iteration for the contact point starts from a tabulated guess.
+     */
+    void setUseTabulatedInitialGuess(bool useTabulatedInitialGuess);
+
+    /*!
+     * \brief Returns whether the Newton iteration for the contact point starts from a tabulated guess.
+     */
+    bool getUseTabulatedInitialGuess() const;
+
     /*!
      * \brief Copy this screw and return a pointer to the copy.
      */
@@ -69,6 +79,11 @@ public:
      */
     bool getDistanceAndNormal(const BaseParticle& P, Mdouble& distance, Vec3D& normal_return) const final;
 
+    /*!
+     * \brief Computes a box that contains all positions at which a particle can interact with this Screw.
+     */
+    bool getBoundingBox(Mdouble wallInteractionRadius, Vec3D& min, Vec3D& max) const final;
+
     /*!
      * \brief Rotate the Screw for a period dt, so that the offset_ changes with omega_*dt.
      */
@@ -94,11 +109,37 @@ public:
      */
     std::string getName() const final;
 
+    /*!
+     * \brief Returns the number of bytes used by this Screw.
+     */
+    std::size_t getMemoryUsage() const override;
+
     /*!
      * \brief Get the interaction between this Screw and given BaseParticle at a given time.
      */
     BaseInteraction* getInteractionWith(BaseParticle* p, Mdouble timeStamp, InteractionHandler* interactionHandler) final;
 
+private:
+    /*!
+     * \brief Computes the distance and normal like getDistanceAndNormal, starting the Newton iteration from the given helix parameter.
+     */
+    bool getDistanceNormalAndParameter(const BaseParticle& p, Mdouble& distance, Vec3D& normal_return, Mdouble& q) const;
+
+    /*!
+     * \brief Minimises the distance to the particle over the helix parameter q with a bounded number of Newton steps.
+     */
+    bool applyNewtonMethod(Mdouble& q, Mdouble Rsqr, Mdouble alpha, Mdouble dz, bool& isConverged) const;
+
+    /*!
+     * \brief Returns whether the particle lies in the cylinder around the Screw, i.e. whether it can touch this Screw at all.
+     */
+    bool isInBoundingCylinder(const BaseParticle& p) const;
+
+    /*!
+     * \brief Counts a Newton iteration that did not converge, and warns at the 1st, 10th, 100th, ... occurrence.
+     */
+    void warnNewtonMethodNotConverged() const;
+
 private:
     /*!
      * \brief The centre of the lower end of the screw.
@@ -128,6 +169,15 @@ private:
      * \brief The thickness of the Screw.
      */
     Mdouble thickness_;
+    /*!
+     * \brief If true, the Newton iteration starts from the guess of HelixParameterTable::getScrewTable() when there is no contact at the last time step.
+     */
+    bool useTabulatedInitialGuess_;
+
+    /*!
+     * \brief The number of contact computations in which the Newton iteration did not converge; only used to limit the number of warnings.
+     */
+    mutable unsigned int numberOfUnconvergedNewtonIterations_;
 };
 
 #endif
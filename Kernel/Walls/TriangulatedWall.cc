@@ -0,0 +1,501 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TriangulatedWall.h"
+#include "InteractionHandler.h"
+#include "WallHandler.h"
+#include "Particles/BaseParticle.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+
+///The largest number of triangles in a leaf of the hierarchy
+static const unsigned int maxTrianglesPerLeaf = 4;
+
+TriangulatedWall::TriangulatedWall()
+{
+    //an orientation that is never used, such that the rotation is computed on first use
+    rotatedOrientation_ = Vec3D(std::numeric_limits<Mdouble>::quiet_NaN(), 0.0, 0.0);
+    logger(DEBUG, "TriangulatedWall() constructed.");
+}
+
+/*!
+ * \param[in] other The TriangulatedWall that must be copied.
+ */
+TriangulatedWall::TriangulatedWall(const TriangulatedWall& other)
+    : BaseWall(other)
+{
+    vertices_ = other.vertices_;
+    nodes_ = other.nodes_;
+    rotatedOrientation_ = other.rotatedOrientation_;
+    rotation_ = other.rotation_;
+    logger(DEBUG, "TriangulatedWall(const TriangulatedWall&) constructed.");
+}
+
+TriangulatedWall::~TriangulatedWall()
+{
+    logger(DEBUG, "~TriangulatedWall() has been called.");
+}
+
+/*!
+ * \return pointer to a TriangulatedWall object allocated using new.
+ */
+TriangulatedWall* TriangulatedWall::copy() const
+{
+    return new TriangulatedWall(*this);
+}
+
+/*!
+ * \param[in] a The first vertex, in the coordinates of the wall.
+ * \param[in] b The second vertex.
+ * \param[in] c The third vertex.
+ * \details Triangles without area are ignored, as they have no closest point 
+ * that is not also on a neighbouring triangle.
+ */
+void TriangulatedWall::addTriangle(const Vec3D& a, const Vec3D& b, const Vec3D& c)
+{
+    if (Vec3D::cross(b - a, c - a).getLengthSquared() == 0.0)
+    {
+        logger(VERBOSE, "TriangulatedWall::addTriangle: ignoring the triangle %, %, % without area", a, b, c);
+        return;
+    }
+    vertices_.push_back(a);
+    vertices_.push_back(b);
+    vertices_.push_back(c);
+    nodes_.clear();
+    //the shape changed, so the bounding box of this wall has to be recomputed
+    if (getHandler() != nullptr)
+        getHandler()->setBoundingVolumesOutdated();
+}
+
+/*!
+ * \param[in] fileName The name of the STL file.
+ * \param[in] scaleFactor The factor by which the coordinates in the file are multiplied, e.g. 0.001 for a file in mm.
+ * \details A file is read as binary STL if its size matches the number of 
+ * triangles in its header (84 bytes plus 50 bytes per triangle), and as ASCII
+ * STL otherwise, in which case the coordinates following each keyword "vertex"
+ * are read. The normals stored in the file are ignored. Binary files are 
+ * assumed to be little-endian, as required by the format.
+ */
+void TriangulatedWall::readSTL(const std::string& fileName, Mdouble scaleFactor)
+{
+    std::ifstream file(fileName.c_str(), std::ios::binary);
+    if (!file)
+        logger(ERROR, "TriangulatedWall::readSTL: could not open %", fileName);
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const unsigned int oldNumberOfTriangles = getNumberOfTriangles();
+
+    uint32_t numberOfTriangles = 0;
+    if (content.size() >= 84)
+        std::memcpy(&numberOfTriangles, content.data() + 80, sizeof(uint32_t));
+    if (content.size() >= 84 && content.size() == 84 + 50 * static_cast<std::size_t>(numberOfTriangles))
+    {
+        for (std::size_t t = 0; t < numberOfTriangles; t++)
+        {
+            //each triangle consists of a normal and three vertices (12 floats) and two attribute bytes
+            float coordinates[12];
+            std::memcpy(coordinates, content.data() + 84 + 50 * t, sizeof(coordinates));
+            Vec3D v[3];
+            for (unsigned int i = 0; i < 3; i++)
+                v[i] = scaleFactor * Vec3D(coordinates[3 + 3 * i], coordinates[4 + 3 * i], coordinates[5 + 3 * i]);
+            addTriangle(v[0], v[1], v[2]);
+        }
+    }
+    else
+    {
+        std::istringstream is(content);
+        std::string word;
+        std::vector<Vec3D> v;
+        while (is >> word)
+        {
+            if (word != "vertex")
+                continue;
+            Vec3D vertex;
+            if (!(is >> vertex.X >> vertex.Y >> vertex.Z))
+                logger(ERROR, "TriangulatedWall::readSTL: could not read vertex % of %", v.size(), fileName);
+            v.push_back(scaleFactor * vertex);
+        }
+        if (v.empty() || v.size() % 3 != 0)
+            logger(ERROR, "TriangulatedWall::readSTL: % is neither a binary STL file nor an ASCII STL file with three vertices per facet", fileName);
+        for (std::size_t i = 0; i < v.size(); i += 3)
+            addTriangle(v[i], v[i + 1], v[i + 2]);
+    }
+    logger(INFO, "TriangulatedWall::readSTL: read % triangles from %", getNumberOfTriangles() - oldNumberOfTriangles, fileName);
+}
+
+/*!
+ * \return The number of triangles of the wall.
+ */
+unsigned int TriangulatedWall::getNumberOfTriangles() const
+{
+    return vertices_.size() / 3;
+}
+
+/*!
+ * \details The hierarchy is built top-down: the triangles of a node are split
+ * at the median of their centroids in the direction in which the centroids 
+ * are spread most, until a node has at most maxTrianglesPerLeaf triangles.
+ */
+void TriangulatedWall::buildHierarchy() const
+{
+    if (!nodes_.empty() || vertices_.empty())
+        return;
+    nodes_.reserve(2 * getNumberOfTriangles() / maxTrianglesPerLeaf + 1);
+    buildNode(0, getNumberOfTriangles());
+}
+
+/*!
+ * \param[in] begin The index of the first triangle of the node.
+ * \param[in] end The index after the last triangle of the node.
+ */
+void TriangulatedWall::buildNode(unsigned int begin, unsigned int end) const
+{
+    unsigned int index = nodes_.size();
+    nodes_.push_back(Node());
+    Vec3D min = vertices_[3 * begin], max = min;
+    Vec3D centroidMin = (vertices_[3 * begin] + vertices_[3 * begin + 1] + vertices_[3 * begin + 2]) / 3.0;
+    Vec3D centroidMax = centroidMin;
+    for (unsigned int t = begin; t < end; t++)
+    {
+        for (unsigned int i = 3 * t; i < 3 * t + 3; i++)
+        {
+            min = Vec3D(std::min(min.X, vertices_[i].X), std::min(min.Y, vertices_[i].Y), std::min(min.Z, vertices_[i].Z));
+            max = Vec3D(std::max(max.X, vertices_[i].X), std::max(max.Y, vertices_[i].Y), std::max(max.Z, vertices_[i].Z));
+        }
+        Vec3D centroid = (vertices_[3 * t] + vertices_[3 * t + 1] + vertices_[3 * t + 2]) / 3.0;
+        centroidMin = Vec3D(std::min(centroidMin.X, centroid.X), std::min(centroidMin.Y, centroid.Y), std::min(centroidMin.Z, centroid.Z));
+        centroidMax = Vec3D(std::max(centroidMax.X, centroid.X), std::max(centroidMax.Y, centroid.Y), std::max(centroidMax.Z, centroid.Z));
+    }
+    nodes_[index].min = min;
+    nodes_[index].max = max;
+    if (end - begin <= maxTrianglesPerLeaf)
+    {
+        nodes_[index].first = begin;
+        nodes_[index].count = end - begin;
+        return;
+    }
+
+    //sort the triangles by the centroid along the direction of largest spread, and split at the median
+    Vec3D spread = centroidMax - centroidMin;
+    int direction = (spread.X >= spread.Y && spread.X >= spread.Z) ? 0 : (spread.Y >= spread.Z ? 1 : 2);
+    std::vector<unsigned int> order(end - begin);
+    for (unsigned int t = begin; t < end; t++)
+        order[t - begin] = t;
+    std::sort(order.begin(), order.end(), [this, direction](unsigned int a, unsigned int b)
+    {
+        return (vertices_[3 * a] + vertices_[3 * a + 1] + vertices_[3 * a + 2]).getComponent(direction)
+               < (vertices_[3 * b] + vertices_[3 * b + 1] + vertices_[3 * b + 2]).getComponent(direction);
+    });
+    std::vector<Vec3D> sorted;
+    sorted.reserve(3 * (end - begin));
+    for (unsigned int t : order)
+        sorted.insert(sorted.end(), vertices_.begin() + 3 * t, vertices_.begin() + 3 * t + 3);
+    std::copy(sorted.begin(), sorted.end(), vertices_.begin() + 3 * begin);
+
+    unsigned int middle = begin + (end - begin) / 2;
+    buildNode(begin, middle);
+    unsigned int second = nodes_.size();
+    buildNode(middle, end);
+    nodes_[index].first = second;
+    nodes_[index].count = 0;
+}
+
+/*!
+ * \return The matrix that rotates wall coordinates into real coordinates.
+ * \details The orientation_ is a rotation vector; the matrix follows from 
+ * Rodrigues' formula R = I + sin(a) K + (1-cos(a)) K^2, with a the length of 
+ * the rotation vector and K the cross-product matrix of its unit vector.
+ */
+const Matrix3D& TriangulatedWall::getRotation() const
+{
+    const Vec3D& orientation = getOrientation();
+    if (orientation.X == rotatedOrientation_.X && orientation.Y == rotatedOrientation_.Y && orientation.Z == rotatedOrientation_.Z)
+        return rotation_;
+    rotatedOrientation_ = orientation;
+    Mdouble angle = orientation.getLength();
+    if (angle == 0.0)
+    {
+        rotation_ = Matrix3D(1, 0, 0, 0, 1, 0, 0, 0, 1);
+        return rotation_;
+    }
+    Vec3D k = orientation / angle;
+    Mdouble s = std::sin(angle);
+    Mdouble c = 1.0 - std::cos(angle);
+    rotation_ = Matrix3D(1.0 - c * (k.Y * k.Y + k.Z * k.Z), -s * k.Z + c * k.X * k.Y, s * k.Y + c * k.X * k.Z,
+                         s * k.Z + c * k.X * k.Y, 1.0 - c * (k.X * k.X + k.Z * k.Z), -s * k.X + c * k.Y * k.Z,
+                         -s * k.Y + c * k.X * k.Z, s * k.X + c * k.Y * k.Z, 1.0 - c * (k.X * k.X + k.Y * k.Y));
+    return rotation_;
+}
+
+/*!
+ * \param[in] p The position, in wall coordinates.
+ * \param[in] a The first vertex of the triangle.
+ * \param[in] b The second vertex of the triangle.
+ * \param[in] c The third vertex of the triangle.
+ * \return The point of the triangle closest to p.
+ * \details Determines in which of the seven regions (three vertices, three 
+ * edges, interior) the closest point lies using barycentric coordinates, see 
+ * C. Ericson, Real-Time Collision Detection (2005), section 5.1.5.
+ */
+Vec3D TriangulatedWall::getClosestPointOnTriangle(const Vec3D& p, const Vec3D& a, const Vec3D& b, const Vec3D& c)
+{
+    const Vec3D ab = b - a;
+    const Vec3D ac = c - a;
+    const Vec3D ap = p - a;
+    const Mdouble d1 = Vec3D::dot(ab, ap);
+    const Mdouble d2 = Vec3D::dot(ac, ap);
+    if (d1 <= 0.0 && d2 <= 0.0)
+        return a; //vertex a
+
+    const Vec3D bp = p - b;
+    const Mdouble d3 = Vec3D::dot(ab, bp);
+    const Mdouble d4 = Vec3D::dot(ac, bp);
+    if (d3 >= 0.0 && d4 <= d3)
+        return b; //vertex b
+
+    const Mdouble vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+        return a + d1 / (d1 - d3) * ab; //edge ab
+
+    const Vec3D cp = p - c;
+    const Mdouble d5 = Vec3D::dot(ab, cp);
+    const Mdouble d6 = Vec3D::dot(ac, cp);
+    if (d6 >= 0.0 && d5 <= d6)
+        return c; //vertex c
+
+    const Mdouble vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+        return a + d2 / (d2 - d6) * ac; //edge ac
+
+    const Mdouble va = d3 * d6 - d5 * d4;
+    if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+        return b + (d4 - d3) / ((d4 - d3) + (d5 - d6)) * (c - b); //edge bc
+
+    //interior
+    const Mdouble denominator = 1.0 / (va + vb + vc);
+    return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+
+/*!
+ * \param[in] position The position, in wall coordinates.
+ * \param[in] maxDistance Points of the mesh further away than this are ignored.
+ * \param[out] closestPoint The point of the mesh closest to position.
+ * \param[out] triangle The index of the triangle containing closestPoint.
+ * \return Whether a point closer than maxDistance exists.
+ * \details Traverses the hierarchy depth-first, skipping nodes whose box is 
+ * further away than the closest point found so far.
+ */
+bool TriangulatedWall::getClosestPoint(const Vec3D& position, Mdouble maxDistance, Vec3D& closestPoint, unsigned int& triangle) const
+{
+    buildHierarchy();
+    if (nodes_.empty())
+        return false;
+    Mdouble closestDistanceSquared = maxDistance * maxDistance;
+    bool isFound = false;
+    unsigned int stack[64];
+    unsigned int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0)
+    {
+        const Node& node = nodes_[stack[--stackSize]];
+        //the squared distance between position and the box of the node
+        Mdouble dx = std::max(std::max(node.min.X - position.X, position.X - node.max.X), 0.0);
+        Mdouble dy = std::max(std::max(node.min.Y - position.Y, position.Y - node.max.Y), 0.0);
+        Mdouble dz = std::max(std::max(node.min.Z - position.Z, position.Z - node.max.Z), 0.0);
+        if (dx * dx + dy * dy + dz * dz >= closestDistanceSquared)
+            continue;
+        if (node.count == 0)
+        {
+            stack[stackSize++] = node.first;
+            stack[stackSize++] = &node - &nodes_[0] + 1;
+            continue;
+        }
+        for (unsigned int t = node.first; t < node.first + node.count; t++)
+        {
+            Vec3D point = getClosestPointOnTriangle(position, vertices_[3 * t], vertices_[3 * t + 1], vertices_[3 * t + 2]);
+            Mdouble distanceSquared = Vec3D::getDistanceSquared(point, position);
+            if (distanceSquared < closestDistanceSquared)
+            {
+                closestDistanceSquared = distanceSquared;
+                closestPoint = point;
+                triangle = t;
+                isFound = true;
+            }
+        }
+    }
+    return isFound;
+}
+
+/*!
+ * \param[in] p BaseParticle we want to calculate the distance and whether it collided of.
+ * \param[out] distance The distance of the BaseParticle to the closest point of the mesh.
+ * \param[out] normal_return If there was a collision, the unit vector from the particle to the closest point.
+ * \return A boolean which says whether or not there was a collision.
+ * \details The particle position is transformed into wall coordinates, in 
+ * which the closest point is found; the normal is rotated back. If the 
+ * particle centre lies on the mesh, the normal of the triangle is used.
+ */
+bool TriangulatedWall::getDistanceAndNormal(const BaseParticle& p, Mdouble& distance, Vec3D& normal_return) const
+{
+    const Matrix3D& R = getRotation();
+    //transform into wall coordinates, x = R^T (position - position_)
+    const Vec3D d = p.getPosition() - getPosition();
+    const Vec3D position(R.XX * d.X + R.YX * d.Y + R.ZX * d.Z,
+                         R.XY * d.X + R.YY * d.Y + R.ZY * d.Z,
+                         R.XZ * d.X + R.YZ * d.Y + R.ZZ * d.Z);
+    Vec3D closestPoint;
+    unsigned int triangle = 0;
+    if (!getClosestPoint(position, p.getWallInteractionRadius(), closestPoint, triangle))
+        return false;
+    Vec3D normal = closestPoint - position;
+    distance = normal.getLength();
+    if (distance > 0.0)
+    {
+        normal /= distance;
+    }
+    else
+    {
+        normal = Vec3D::cross(vertices_[3 * triangle + 1] - vertices_[3 * triangle], vertices_[3 * triangle + 2] - vertices_[3 * triangle]);
+        normal.normalize();
+    }
+    normal_return = R * normal;
+    return true;
+}
+
+/*!
+ * \param[in] wallInteractionRadius The largest wall interaction radius of the particles.
+ * \param[out] min The lower corner of the box.
+ * \param[out] max The upper corner of the box.
+ * \return False if the wall has no triangles.
+ * \details The corners of the box of the root of the hierarchy are moved into 
+ * real coordinates; their bounding box is widened by wallInteractionRadius.
+ */
+bool TriangulatedWall::getBoundingBox(Mdouble wallInteractionRadius, Vec3D& min, Vec3D& max) const
+{
+    buildHierarchy();
+    if (nodes_.empty())
+        return false;
+    const Matrix3D& R = getRotation();
+    for (unsigned int i = 0; i < 8; i++)
+    {
+        Vec3D corner((i & 1) ? nodes_[0].max.X : nodes_[0].min.X,
+                     (i & 2) ? nodes_[0].max.Y : nodes_[0].min.Y,
+                     (i & 4) ? nodes_[0].max.Z : nodes_[0].min.Z);
+        corner = R * corner + getPosition();
+        if (i == 0)
+        {
+            min = corner;
+            max = corner;
+        }
+        else
+        {
+            min = Vec3D(std::min(min.X, corner.X), std::min(min.Y, corner.Y), std::min(min.Z, corner.Z));
+            max = Vec3D(std::max(max.X, corner.X), std::max(max.Y, corner.Y), std::max(max.Z, corner.Z));
+        }
+    }
+    //widen the box slightly, such that rounding errors cannot exclude an interaction
+    Vec3D margin = Vec3D(1.0, 1.0, 1.0) * wallInteractionRadius + 1e-10 * (Vec3D(1.0, 1.0, 1.0) + (max - min));
+    min -= margin;
+    max += margin;
+    return true;
+}
+
+/*!
+ * \param[in] is The input stream from which the TriangulatedWall is read, usually a restart file.
+ */
+void TriangulatedWall::read(std::istream& is)
+{
+    BaseWall::read(is);
+    std::string dummy;
+    unsigned int n;
+    is >> dummy >> n;
+    vertices_.clear();
+    nodes_.clear();
+    Vec3D a, b, c;
+    for (unsigned int i = 0; i < n; i++)
+    {
+        is >> a >> b >> c;
+        addTriangle(a, b, c);
+    }
+}
+
+/*!
+ * \param[in] os The output stream where the TriangulatedWall must be written to, usually a restart file.
+ */
+void TriangulatedWall::write(std::ostream& os) const
+{
+    BaseWall::write(os);
+    os << " numberOfTriangles " << getNumberOfTriangles();
+    for (const Vec3D& v : vertices_)
+        os << ' ' << v;
+}
+
+/*!
+ * \return The string "TriangulatedWall".
+ */
+std::string TriangulatedWall::getName() const
+{
+    return "TriangulatedWall";
+}
+
+/*!
+ * \return The size of this TriangulatedWall plus the memory used by its 
+ *         triangles, its hierarchy and its list of interactions.
+ */
+std::size_t TriangulatedWall::getMemoryUsage() const
+{
+    return sizeof(TriangulatedWall) + getInteractionListMemoryUsage()
+           + vertices_.capacity() * sizeof(Vec3D) + nodes_.capacity() * sizeof(Node);
+}
+
+/*!
+ * \param[in] p Pointer to the BaseParticle which we want to check the interaction for.
+ * \param[in] timeStamp The time at which we want to look at the interaction.
+ * \param[in] interactionHandler A pointer to the InteractionHandler in which the interaction can be found.
+ * \return A pointer to the BaseInteraction that happened between this TriangulatedWall
+ * and the BaseParticle at the timeStamp.
+ */
+BaseInteraction* TriangulatedWall::getInteractionWith(BaseParticle* p, Mdouble timeStamp, InteractionHandler* interactionHandler)
+{
+    Mdouble distance;
+    Vec3D normal;
+    if (getDistanceAndNormal(*p, distance, normal))
+    {
+        BaseInteraction* c = interactionHandler->getInteraction(p, this, timeStamp);
+        c->setNormal(-normal);
+        c->setDistance(distance);
+        c->setOverlap(p->getRadius() - distance);
+        c->setContactPoint(p->getPosition() - (p->getRadius() - 0.5 * c->getOverlap()) * c->getNormal());
+        return c;
+    }
+    else
+    {
+        return nullptr;
+    }
+}
@@ -0,0 +1,188 @@
+//Copyright (c) 2013-2014, The MercuryDPM Developers Team. All rights reserved.
+//For the list of developers, see <http://www.MercuryDPM.org/Team>.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name MercuryDPM nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE MERCURYDPM DEVELOPERS TEAM BE LIABLE FOR ANY
+//DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef TRIANGULATEDWALL_H
+#define TRIANGULATEDWALL_H
+
+#include <vector>
+#include "BaseWall.h"
+#include "Math/Vector.h"
+#include "Math/Matrix.h"
+
+/*!
+ * \brief A wall defined by a triangle mesh, e.g. read from an STL file.
+ * \details The triangles are given in the coordinates of the wall, which are 
+ * mapped to real coordinates by rotating them by the orientation_ (interpreted
+ * as a rotation vector, i.e. the rotation axis times the angle, which is how
+ * BaseInteractable integrates the angular velocity) and translating them by 
+ * the position_. The wall can therefore be moved as a rigid body with 
+ * setPosition/setOrientation or setPrescribedPosition/setPrescribedOrientation
+ * without changing its triangles.
+ * 
+ * To find the triangles near a particle, the triangles are stored in a 
+ * bounding volume hierarchy in the coordinates of the wall, which is built 
+ * once, when the wall is first used after triangles were added.
+ * 
+ * A particle interacts with the point of the mesh closest to it, which can 
+ * be inside a triangle or on one of its edges or vertices; a contact with an 
+ * edge or vertex shared by several triangles is therefore a single contact. 
+ * The mesh is treated as a thin shell, so particles interact with both sides.
+ * As there is one interaction per particle and wall, a particle in a concave
+ * crease only interacts with the closer of the two sides; split the mesh into
+ * several walls where particles can touch two sides of a crease at once.
+ */
+class TriangulatedWall : public BaseWall
+{
+public:
+    /*!
+     * \brief Default constructor; creates a wall without triangles.
+     */
+    TriangulatedWall();
+
+    /*!
+     * \brief Copy constructor.
+     */
+    TriangulatedWall(const TriangulatedWall& other);
+
+    /*!
+     * \brief Destructor.
+     */
+    ~TriangulatedWall();
+
+    /*!
+     * \brief Wall copy method. It calls the copy constructor of this Wall, useful for polymorphism
+     */
+    TriangulatedWall* copy() const final;
+
+    /*!
+     * \brief Adds a triangle, given by its vertices in the coordinates of the wall.
+     */
+    void addTriangle(const Vec3D& a, const Vec3D& b, const Vec3D& c);
+
+    /*!
+     * \brief Reads the triangles from an ASCII or binary STL file and adds them to the wall.
+     */
+    void readSTL(const std::string& fileName, Mdouble scaleFactor = 1.0);
+
+    /*!
+     * \brief Returns the number of triangles of the wall.
+     */
+    unsigned int getNumberOfTriangles() const;
+
+    /*!
+     * \brief Computes the distance to the closest point of the mesh and the normal towards it, if the particle interacts with the wall.
+     */
+    bool getDistanceAndNormal(const BaseParticle& p, Mdouble& distance, Vec3D& normal_return) const final;
+
+    /*!
+     * \brief Computes a box that contains all positions at which a particle can interact with this wall.
+     */
+    bool getBoundingBox(Mdouble wallInteractionRadius, Vec3D& min, Vec3D& max) const final;
+
+    /*!
+     * \brief Reads a TriangulatedWall from an input stream, for example a restart file.
+     */
+    void read(std::istream& is) final;
+
+    /*!
+     * \brief Writes a TriangulatedWall to an output stream, for example a restart file.
+     */
+    void write(std::ostream& os) const final;
+
+    /*!
+     * \brief Returns the name of the object, here the string "TriangulatedWall".
+     */
+    std::string getName() const final;
+
+    /*!
+     * \brief Returns the number of bytes used by this TriangulatedWall, including its triangles and hierarchy.
+     */
+    std::size_t getMemoryUsage() const final;
+
+    /*!
+     * \brief Get the interaction between this TriangulatedWall and given BaseParticle at a given time.
+     */
+    BaseInteraction* getInteractionWith(BaseParticle* p, Mdouble timeStamp, InteractionHandler* interactionHandler) final;
+
+private:
+    /*!
+     * \brief A node of the bounding volume hierarchy of the triangles.
+     * \details A leaf stores the triangles [first, first+count); other nodes
+     * have count==0 and their children are the next node and node second.
+     */
+    struct Node
+    {
+        ///The lower corner of the box containing the triangles below this node
+        Vec3D min;
+        ///The upper corner of the box containing the triangles below this node
+        Vec3D max;
+        ///For a leaf, the index of its first triangle; otherwise, the index of the second child
+        unsigned int first;
+        ///For a leaf, the number of its triangles; otherwise 0
+        unsigned int count;
+    };
+
+    /*!
+     * \brief Builds the bounding volume hierarchy, if triangles were added since it was last built.
+     */
+    void buildHierarchy() const;
+
+    /*!
+     * \brief Builds the subtree of the triangles [begin,end), reordering them.
+     */
+    void buildNode(unsigned int begin, unsigned int end) const;
+
+    /*!
+     * \brief Computes the rotation matrix from the orientation, if the orientation changed.
+     */
+    const Matrix3D& getRotation() const;
+
+    /*!
+     * \brief Finds the point of the mesh closest to a position in wall coordinates, if it is closer than the given distance.
+     */
+    bool getClosestPoint(const Vec3D& position, Mdouble maxDistance, Vec3D& closestPoint, unsigned int& triangle) const;
+
+    /*!
+     * \brief Returns the point of a triangle closest to a position, which can be inside the triangle or on an edge or vertex.
+     */
+    static Vec3D getClosestPointOnTriangle(const Vec3D& p, const Vec3D& a, const Vec3D& b, const Vec3D& c);
+
+    /*!
+     * \brief The vertices of the triangles in wall coordinates, three per triangle.
+     * \details Mutable, as building the hierarchy reorders the triangles.
+     */
+    mutable std::vector<Vec3D> vertices_;
+
+    ///The nodes of the bounding volume hierarchy; empty if it has to be built
+    mutable std::vector<Node> nodes_;
+
+    ///The orientation for which rotation_ was computed
+    mutable Vec3D rotatedOrientation_;
+
+    ///The rotation matrix from wall to real coordinates
+    mutable Matrix3D rotation_;
+};
+
+#endif